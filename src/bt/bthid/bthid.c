@@ -8,6 +8,9 @@
 #include "devices/vendors/sony/ds4_bt.h"
 #include "devices/vendors/sony/ds5_bt.h"
 #include "core/services/storage/flash.h"
+#include "core/services/metrics/metrics.h"
+#include "usb/usbh/hid/devices/generic/hid_parse_cache.h"
+#include "hardware/structs/systick.h"
 #include <string.h>
 #include <stdio.h>
 
@@ -23,7 +26,7 @@
 // CONFIGURATION
 // ============================================================================
 
-#define BTHID_MAX_DRIVERS       8   // Max registered drivers
+#define BTHID_MAX_DRIVERS       16  // Max registered drivers
 
 // ============================================================================
 // STATIC DATA
@@ -43,6 +46,34 @@ static const bthid_driver_t* find_driver(const char* name, const uint8_t* cod,
 static bthid_device_type_t classify_device(const uint8_t* class_of_device);
 static bool try_reclassify_sony_device(bthid_device_t* device, uint8_t report_id);
 
+// Report cost in core clock cycles, read from SysTick (24-bit down-counter;
+// it wraps every ~134 ms at 125 MHz, far longer than any report takes).
+// SysTick is private to each core and may already belong to someone else:
+// bthid_init() only starts it when it is off, and reports are only timed on
+// a core where it is running on the core clock.
+#define REPORT_CYCLES_MASK 0x00FFFFFFu
+#define REPORT_CYCLES_CSR  (M0PLUS_SYST_CSR_CLKSOURCE_BITS | M0PLUS_SYST_CSR_ENABLE_BITS)
+
+static bool report_cycles_owned = false;   // bthid_init() started SysTick
+
+static inline bool report_cycles_now(uint32_t* now)
+{
+    if (!report_cycles_owned ||
+        (systick_hw->csr & REPORT_CYCLES_CSR) != REPORT_CYCLES_CSR) {
+        return false;
+    }
+    *now = systick_hw->cvr;
+    return true;
+}
+
+static inline void report_cycles_observe(bool timed, uint32_t start)
+{
+    uint32_t end;
+    if (timed && report_cycles_now(&end)) {
+        METRIC_OBSERVE(BT_HID_REPORT_CYCLES, (start - end) & REPORT_CYCLES_MASK);
+    }
+}
+
 // ============================================================================
 // INITIALIZATION
 // ============================================================================
@@ -51,6 +82,18 @@ void bthid_init(void)
 {
     memset(devices, 0, sizeof(devices));
     driver_count = 0;
+
+    // Free-running SysTick on the core clock for report cycle counts
+    // (CLKSOURCE | ENABLE, no interrupt), unless something else runs it
+    report_cycles_owned = !(systick_hw->csr & M0PLUS_SYST_CSR_ENABLE_BITS);
+    if (report_cycles_owned) {
+        systick_hw->rvr = REPORT_CYCLES_MASK;
+        systick_hw->cvr = 0;
+        systick_hw->csr = REPORT_CYCLES_CSR;
+    } else {
+        printf("[BTHID] SysTick in use, report cycle counts off\n");
+    }
+
     printf("[BTHID] Initialized\n");
 }
 
@@ -219,6 +262,64 @@ void bthid_update_device_info(uint8_t conn_index, const char* name,
     }
 }
 
+// ============================================================================
+// REPORT DESCRIPTOR (from SDP / HIDS Report Map)
+// ============================================================================
+
+static void set_descriptor(uint8_t conn_index, const uint8_t* desc, uint16_t len,
+                           uint32_t hash, bool id_prefixed)
+{
+    bthid_device_t* device = bthid_get_device(conn_index);
+    if (!device || !device->driver) {
+        return;
+    }
+
+    const bthid_driver_t* drv = (const bthid_driver_t*)device->driver;
+    if (drv->set_descriptor) {
+        drv->set_descriptor(device, desc, len, hash, id_prefixed);
+    }
+}
+
+void bthid_set_report_descriptor(uint8_t conn_index, const uint8_t* desc, uint16_t len,
+                                 bool id_prefixed)
+{
+    if (!desc || len == 0) {
+        return;
+    }
+    set_descriptor(conn_index, desc, len, hid_parse_cache_hash(desc, len), id_prefixed);
+}
+
+void bthid_set_report_descriptor_hash(uint8_t conn_index, uint32_t hash, uint16_t len,
+                                      bool id_prefixed)
+{
+    if (len == 0) {
+        return;
+    }
+    set_descriptor(conn_index, NULL, len, hash, id_prefixed);
+}
+
+// BT descriptors are cached under VID/PID 0 (bthid_gamepad): the key is
+// the descriptor itself, whichever device sent it
+bool bthid_get_compiled_descriptor(uint32_t hash, uint16_t len, hid_parse_cache_entry_t* entry)
+{
+    const hid_parse_cache_entry_t* cached = hid_parse_cache_lookup(0, 0, hash, len);
+    if (!cached) {
+        return false;
+    }
+    *entry = *cached;
+    return true;
+}
+
+void bthid_restore_compiled_descriptor(const hid_parse_cache_entry_t* entry)
+{
+    if (entry->vid != 0 || entry->pid != 0 || entry->prog.op_count > HID_EXTRACT_MAX_OPS) {
+        return;
+    }
+    if (!hid_parse_cache_lookup(0, 0, entry->hash, entry->desc_len)) {
+        hid_parse_cache_store(entry);
+    }
+}
+
 // ============================================================================
 // DRIVER MATCHING
 // ============================================================================
@@ -328,6 +429,7 @@ static bool try_reclassify_sony_device(bthid_device_t* device, uint8_t report_id
 void bt_on_hid_ready(uint8_t conn_index)
 {
     printf("[BTHID] HID ready on connection %d\n", conn_index);
+    METRIC_INC(BT_CONNECTS);
 
     const bt_connection_t* conn = bt_get_connection(conn_index);
     if (!conn) {
@@ -339,6 +441,7 @@ void bt_on_hid_ready(uint8_t conn_index)
         printf("[BTHID] No free device slots\n");
         return;
     }
+    METRIC_SET(BT_DEVICES, bthid_get_device_count());
 
     // Copy device info
     memcpy(device->bd_addr, conn->bd_addr, 6);
@@ -383,6 +486,7 @@ void bt_on_disconnect(uint8_t conn_index)
 {
     printf("[BTHID] Disconnect on connection %d\n", conn_index);
     remove_device(conn_index);
+    METRIC_SET(BT_DEVICES, bthid_get_device_count());
 
     // Check if we have pending flash writes now that BT may be idle
     flash_on_bt_disconnect();
@@ -390,18 +494,47 @@ void bt_on_disconnect(uint8_t conn_index)
 
 static bool bt_on_hid_report_debug_done = false;
 
-void bt_on_hid_report(uint8_t conn_index, const uint8_t* data, uint16_t len)
+// Route an input report (report ID first) to the device's driver. The data
+// is the stack's receive buffer; see bt_transport.h for its lifetime.
+static void dispatch_input_report(uint8_t conn_index, const uint8_t* report_data, uint16_t report_len)
 {
-    if (len < 1) {
-        return;
-    }
-
     bthid_device_t* device = bthid_get_device(conn_index);
     if (!device) {
         printf("[BTHID] Report for unknown device on conn %d\n", conn_index);
         return;
     }
 
+    // Check report ID for Sony device reclassification
+    // Only attempt if currently using a Sony driver or generic gamepad
+    // This prevents Xbox data (which may contain 0x11/0x31 bytes) from triggering reclassification
+    uint8_t report_id = report_data[0];
+    const bthid_driver_t* drv = (const bthid_driver_t*)device->driver;
+    bool is_sony_or_generic = (drv == &ds3_bt_driver || drv == &ds4_bt_driver ||
+                               drv == &ds5_bt_driver || drv == &bthid_gamepad_driver);
+    if (is_sony_or_generic && (report_id == SONY_REPORT_ID_DS4 || report_id == SONY_REPORT_ID_DS5)) {
+        // Try to reclassify based on actual report ID
+        if (try_reclassify_sony_device(device, report_id)) {
+            // Driver was swapped - it will process this report on next iteration
+            // after its init sequence completes
+            return;
+        }
+    }
+
+    // Input report - route to driver
+    if (drv && drv->process_report) {
+        drv->process_report(device, report_data, report_len);
+    }
+}
+
+void bt_on_hid_report(uint8_t conn_index, const uint8_t* data, uint16_t len)
+{
+    if (len < 1) {
+        return;
+    }
+    uint32_t start = 0;
+    bool timed = report_cycles_now(&start);
+    METRIC_INC(BT_HID_REPORTS);
+
     // Debug first report
     if (!bt_on_hid_report_debug_done) {
         printf("[BTHID] First report: conn=%d, len=%d, data[0]=0x%02X\n",
@@ -415,39 +548,12 @@ void bt_on_hid_report(uint8_t conn_index, const uint8_t* data, uint16_t len)
     uint8_t param = header & 0x0F;
 
     switch (trans_type) {
-        case BTHID_TRANS_DATA: {
+        case BTHID_TRANS_DATA:
             // Data report - param indicates report type
-            uint8_t report_type = param;
-            const uint8_t* report_data = data + 1;
-            uint16_t report_len = len - 1;
-
-            if (report_type == BTHID_REPORT_TYPE_INPUT && report_len >= 1) {
-                // Check report ID for Sony device reclassification
-                // Only attempt if currently using a Sony driver or generic gamepad
-                // This prevents Xbox data (which may contain 0x11/0x31 bytes) from triggering reclassification
-                uint8_t report_id = report_data[0];
-                const bthid_driver_t* drv = (const bthid_driver_t*)device->driver;
-                bool is_sony_or_generic = (drv == &ds3_bt_driver || drv == &ds4_bt_driver ||
-                                           drv == &ds5_bt_driver || drv == &bthid_gamepad_driver);
-                if (is_sony_or_generic && (report_id == SONY_REPORT_ID_DS4 || report_id == SONY_REPORT_ID_DS5)) {
-                    // Try to reclassify based on actual report ID
-                    if (try_reclassify_sony_device(device, report_id)) {
-                        // Driver was swapped - it will process this report on next iteration
-                        // after its init sequence completes
-                        return;
-                    }
-                }
-
-                // Input report - route to driver
-                if (device->driver) {
-                    const bthid_driver_t* drv = (const bthid_driver_t*)device->driver;
-                    if (drv->process_report) {
-                        drv->process_report(device, report_data, report_len);
-                    }
-                }
+            if (param == BTHID_REPORT_TYPE_INPUT && len >= 2) {
+                dispatch_input_report(conn_index, data + 1, len - 1);
             }
             break;
-        }
 
         case BTHID_TRANS_HANDSHAKE:
             printf("[BTHID] Handshake: result=%d\n", param);
@@ -457,6 +563,28 @@ void bt_on_hid_report(uint8_t conn_index, const uint8_t* data, uint16_t len)
             printf("[BTHID] Unhandled transaction: 0x%02X\n", trans_type);
             break;
     }
+
+    report_cycles_observe(timed, start);
+}
+
+void bt_on_hid_input(uint8_t conn_index, const uint8_t* report, uint16_t len)
+{
+    if (len < 1) {
+        return;
+    }
+    uint32_t start = 0;
+    bool timed = report_cycles_now(&start);
+    METRIC_INC(BT_HID_REPORTS);
+
+    if (!bt_on_hid_report_debug_done) {
+        printf("[BTHID] First report: conn=%d, len=%d, data[0]=0x%02X (no header)\n",
+               conn_index, len, report[0]);
+        bt_on_hid_report_debug_done = true;
+    }
+
+    dispatch_input_report(conn_index, report, len);
+
+    report_cycles_observe(timed, start);
 }
 
 // ============================================================================
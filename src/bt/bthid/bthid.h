@@ -6,6 +6,7 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include "usb/usbh/hid/devices/generic/hid_parse_cache.h"
 
 // ============================================================================
 // CONSTANTS
@@ -99,6 +100,12 @@ typedef struct {
     // Device disconnected
     void (*disconnect)(bthid_device_t* device);
 
+    // Report descriptor available (optional). desc is NULL when only its
+    // fingerprint is known (cached reconnect). id_prefixed: reports carry a
+    // report ID byte even if the descriptor declares none (BLE HIDS).
+    void (*set_descriptor)(bthid_device_t* device, const uint8_t* desc, uint16_t len,
+                           uint32_t hash, bool id_prefixed);
+
 } bthid_driver_t;
 
 // ============================================================================
@@ -121,6 +128,21 @@ uint8_t bthid_get_device_count(void);
 void bthid_update_device_info(uint8_t conn_index, const char* name,
                                uint16_t vendor_id, uint16_t product_id);
 
+// Hand the device's HID report descriptor (SDP HIDDescriptorList or HIDS
+// Report Map) to its driver. Call after bt_on_hid_ready().
+void bthid_set_report_descriptor(uint8_t conn_index, const uint8_t* desc, uint16_t len,
+                                 bool id_prefixed);
+
+// Same, when only the descriptor's hash and length are known (SDP/GATT cache)
+void bthid_set_report_descriptor_hash(uint8_t conn_index, uint32_t hash, uint16_t len,
+                                      bool id_prefixed);
+
+// The compiled form of a descriptor a driver has seen (its hid_parse_cache
+// entry), so a transport can persist it with its own cache and put it back
+// after a reboot, when it only has the hash to pass.
+bool bthid_get_compiled_descriptor(uint32_t hash, uint16_t len, hid_parse_cache_entry_t* entry);
+void bthid_restore_compiled_descriptor(const hid_parse_cache_entry_t* entry);
+
 // ============================================================================
 // DRIVER REGISTRATION
 // ============================================================================
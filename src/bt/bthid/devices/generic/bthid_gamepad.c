@@ -1,6 +1,12 @@
 // bthid_gamepad.c - Generic Bluetooth Gamepad Driver
 // Handles basic HID gamepads over Bluetooth
 // This is a fallback driver for gamepads without a specific driver
+//
+// Once the transport hands over the report descriptor (SDP or the HIDS
+// Report Map) it is compiled into a hid_extract program, the same one the
+// USB DirectInput driver uses, and shared with it through hid_parse_cache.
+// Until then, or if the descriptor doesn't describe a gamepad, reports are
+// read with a fixed buttons-then-axes layout.
 
 #include "bthid_gamepad.h"
 #include "bt/bthid/bthid.h"
@@ -9,9 +15,22 @@
 #include "core/router/router.h"
 #include "core/buttons.h"
 #include "core/services/players/manager.h"
+#include "usb/usbh/hid/devices/generic/hid_parser.h"
+#include "usb/usbh/hid/devices/generic/hid_extract.h"
+#include "usb/usbh/hid/devices/generic/hid_parse_cache.h"
 #include <string.h>
 #include <stdio.h>
 
+// hid_parse_cache entry types (HID_GAMEPAD etc. in the USB hid_gamepad.h)
+#define PARSE_TYPE_GAMEPAD  0x00
+#define PARSE_TYPE_OTHER    0x01
+
+// Generic Desktop usages that make a descriptor a mouse/keyboard
+#define PAGE_DESKTOP        0x01
+#define USAGE_MOUSE         0x02
+#define USAGE_KEYBOARD      0x06
+#define USAGE_WHEEL         0x38
+
 // ============================================================================
 // DRIVER DATA
 // ============================================================================
@@ -19,10 +38,81 @@
 typedef struct {
     input_event_t event;        // Current input state
     bool initialized;
+    bool compiled;              // prog is valid: decode from the descriptor
+    bool id_prefixed;           // Reports carry an ID byte the descriptor doesn't declare
+    hid_extract_program_t prog;
 } bthid_gamepad_data_t;
 
 static bthid_gamepad_data_t gamepad_data[BTHID_MAX_DEVICES];
 
+// Button usage n+1 -> JP button (same order as the fixed layout below)
+static const uint32_t usage_to_button[HID_EXTRACT_MAX_BUTTONS] = {
+    JP_BUTTON_B1, JP_BUTTON_B2, JP_BUTTON_B3, JP_BUTTON_B4,
+    JP_BUTTON_L1, JP_BUTTON_R1, JP_BUTTON_L2, JP_BUTTON_R2,
+    JP_BUTTON_S1, JP_BUTTON_S2, JP_BUTTON_L3, JP_BUTTON_R3,
+    JP_BUTTON_A1, JP_BUTTON_A2, 0, 0,
+};
+
+// Hat switch (0=N, clockwise to 7=NW, anything else released) -> d-pad
+static const uint32_t hat_to_dpad[9] = {
+    JP_BUTTON_DU, JP_BUTTON_DU | JP_BUTTON_DR, JP_BUTTON_DR, JP_BUTTON_DD | JP_BUTTON_DR,
+    JP_BUTTON_DD, JP_BUTTON_DD | JP_BUTTON_DL, JP_BUTTON_DL, JP_BUTTON_DU | JP_BUTTON_DL, 0,
+};
+
+// ============================================================================
+// DESCRIPTOR
+// ============================================================================
+
+static uint8_t classify_report(const HID_ReportInfo_t* info)
+{
+    for (const HID_ReportItem_t* item = info->FirstReportItem; item; item = item->Next) {
+        if (item->Attributes.Usage.Page != PAGE_DESKTOP) continue;
+        switch (item->Attributes.Usage.Usage) {
+            case USAGE_WHEEL:
+            case USAGE_MOUSE:
+            case USAGE_KEYBOARD:
+                return PARSE_TYPE_OTHER;
+        }
+    }
+    return PARSE_TYPE_GAMEPAD;
+}
+
+// Fill *prog from the parse cache, else by parsing desc (NULL = fingerprint
+// only). The cache key leaves VID/PID at 0: on BT they can arrive after the
+// descriptor, or never.
+static bool compile_descriptor(const uint8_t* desc, uint16_t len, uint32_t hash,
+                               hid_extract_program_t* prog)
+{
+    const hid_parse_cache_entry_t* cached = hid_parse_cache_lookup(0, 0, hash, len);
+    if (cached) {
+        *prog = cached->prog;
+        return cached->type == PARSE_TYPE_GAMEPAD;
+    }
+    if (!desc) {
+        return false;
+    }
+
+    HID_ReportInfo_t* info = NULL;
+    uint8_t ret = USB_ProcessHIDReport(0, 0, desc, len, &info);
+    if (ret != HID_PARSE_Successful) {
+        printf("[BTHID_GAMEPAD] Descriptor parse failed: %d\n", ret);
+        USB_FreeReportInfo(info);
+        return false;
+    }
+
+    hid_parse_cache_entry_t entry = {
+        .hash = hash,
+        .desc_len = len,
+        .type = classify_report(info),
+    };
+    hid_extract_compile(info, &entry.prog);
+    USB_FreeReportInfo(info);
+
+    hid_parse_cache_store(&entry);
+    *prog = entry.prog;
+    return entry.type == PARSE_TYPE_GAMEPAD;
+}
+
 // ============================================================================
 // DRIVER IMPLEMENTATION
 // ============================================================================
@@ -66,6 +156,7 @@ static bool gamepad_init(bthid_device_t* device)
             // Initialize input event with defaults
             init_input_event(&gamepad_data[i].event);
             gamepad_data[i].initialized = true;
+            gamepad_data[i].compiled = false;    // Until the descriptor arrives
 
             // Set device info
             gamepad_data[i].event.type = INPUT_TYPE_GAMEPAD;
@@ -80,6 +171,38 @@ static bool gamepad_init(bthid_device_t* device)
     return false;
 }
 
+// Decode through the compiled program: one load per axis/hat/button run
+static void process_compiled(bthid_gamepad_data_t* gp, const uint8_t* data, uint16_t len)
+{
+    const hid_extract_program_t* prog = &gp->prog;
+
+    if (gp->id_prefixed && prog->report_id == 0) {
+        data++;
+        len--;
+    }
+
+    hid_extract_values_t values;
+    if (!hid_extract_run(prog, data, len, &values)) {
+        return;     // Another report ID, or short
+    }
+
+    uint32_t buttons = hat_to_dpad[values.hat < 8 ? values.hat : 8];
+    for (uint16_t pressed = values.buttons; pressed; pressed &= pressed - 1) {
+        buttons |= usage_to_button[__builtin_ctz(pressed)];
+    }
+    gp->event.buttons = buttons;
+
+    // Extract slots X, Y, Z, Rz, Rx, Ry line up with LX, LY, RX, RY, L2, R2
+    for (int i = 0; i < HID_EXTRACT_AXIS_COUNT; i++) {
+        uint32_t max = prog->axis_max[i];
+        if (max == 0) continue;
+        uint32_t value = values.axis[i] < max ? values.axis[i] : max;
+        gp->event.analog[i] = (max == 0xFF) ? value : (uint8_t)((value * 0xFF) / max);
+    }
+
+    router_submit_input(&gp->event);
+}
+
 static void gamepad_process_report(bthid_device_t* device, const uint8_t* data, uint16_t len)
 {
     bthid_gamepad_data_t* gp = (bthid_gamepad_data_t*)device->driver_data;
@@ -87,6 +210,11 @@ static void gamepad_process_report(bthid_device_t* device, const uint8_t* data,
         return;
     }
 
+    if (gp->compiled) {
+        process_compiled(gp, data, len);
+        return;
+    }
+
     // Generic HID gamepad report parsing
     // Most gamepads follow a similar structure:
     // - First few bytes: buttons (varies)
@@ -143,6 +271,32 @@ static void gamepad_process_report(bthid_device_t* device, const uint8_t* data,
     router_submit_input(&gp->event);
 }
 
+static void gamepad_set_descriptor(bthid_device_t* device, const uint8_t* desc, uint16_t len,
+                                   uint32_t hash, bool id_prefixed)
+{
+    bthid_gamepad_data_t* gp = (bthid_gamepad_data_t*)device->driver_data;
+    if (!gp) {
+        return;
+    }
+
+    hid_extract_program_t prog;
+    if (!compile_descriptor(desc, len, hash, &prog) || prog.button_count == 0) {
+        // A fingerprint miss keeps what we have; the full descriptor may follow
+        if (desc) {
+            gp->compiled = false;
+            printf("[BTHID_GAMEPAD] %s: descriptor isn't a gamepad, using fixed layout\n",
+                   device->name);
+        }
+        return;
+    }
+
+    gp->prog = prog;
+    gp->id_prefixed = id_prefixed;
+    gp->compiled = true;
+    printf("[BTHID_GAMEPAD] %s: descriptor compiled, report ID %d, %d ops, %d buttons\n",
+           device->name, prog.report_id, prog.op_count, prog.button_count);
+}
+
 static void gamepad_task(bthid_device_t* device)
 {
     (void)device;
@@ -162,6 +316,7 @@ static void gamepad_disconnect(bthid_device_t* device)
 
         init_input_event(&gp->event);
         gp->initialized = false;
+        gp->compiled = false;
     }
 }
 
@@ -176,6 +331,7 @@ const bthid_driver_t bthid_gamepad_driver = {
     .process_report = gamepad_process_report,
     .task = gamepad_task,
     .disconnect = gamepad_disconnect,
+    .set_descriptor = gamepad_set_descriptor,
 };
 
 void bthid_gamepad_register(void)
@@ -52,7 +52,6 @@ typedef struct __attribute__((packed)) {
 
 typedef struct {
     input_event_t event;
-    stadia_report_t prev_report;
     bool initialized;
 } stadia_bt_data_t;
 
@@ -88,8 +87,6 @@ static bool stadia_init(bthid_device_t* device)
     for (int i = 0; i < BTHID_MAX_DEVICES; i++) {
         if (!stadia_data[i].initialized) {
             init_input_event(&stadia_data[i].event);
-            memset(&stadia_data[i].prev_report, 0, sizeof(stadia_report_t));
-            stadia_data[i].prev_report.dpad = 8;  // Neutral
             stadia_data[i].initialized = true;
 
             stadia_data[i].event.type = INPUT_TYPE_GAMEPAD;
@@ -121,14 +118,13 @@ static void stadia_process_report(bthid_device_t* device, const uint8_t* data, u
         return;
     }
 
-    stadia_report_t report;
-    memcpy(&report, data, sizeof(stadia_report_t));
+    const stadia_report_t* rpt = (const stadia_report_t*)data;
 
     // Parse D-pad (hat switch)
-    bool dpad_up    = (report.dpad == 0 || report.dpad == 1 || report.dpad == 7);
-    bool dpad_right = (report.dpad >= 1 && report.dpad <= 3);
-    bool dpad_down  = (report.dpad >= 3 && report.dpad <= 5);
-    bool dpad_left  = (report.dpad >= 5 && report.dpad <= 7);
+    bool dpad_up    = (rpt->dpad == 0 || rpt->dpad == 1 || rpt->dpad == 7);
+    bool dpad_right = (rpt->dpad >= 1 && rpt->dpad <= 3);
+    bool dpad_down  = (rpt->dpad >= 3 && rpt->dpad <= 5);
+    bool dpad_left  = (rpt->dpad >= 5 && rpt->dpad <= 7);
 
     // Map buttons to JP_BUTTON format
     uint32_t buttons = 0;
@@ -140,43 +136,41 @@ static void stadia_process_report(bthid_device_t* device, const uint8_t* data, u
     if (dpad_right) buttons |= JP_BUTTON_DR;
 
     // Face buttons (from buttons2)
-    if (report.buttons2 & STADIA_BTN2_B1) buttons |= JP_BUTTON_B1;  // A
-    if (report.buttons2 & STADIA_BTN2_B2) buttons |= JP_BUTTON_B2;  // B
-    if (report.buttons2 & STADIA_BTN2_B3) buttons |= JP_BUTTON_B3;  // X
-    if (report.buttons2 & STADIA_BTN2_B4) buttons |= JP_BUTTON_B4;  // Y
+    if (rpt->buttons2 & STADIA_BTN2_B1) buttons |= JP_BUTTON_B1;  // A
+    if (rpt->buttons2 & STADIA_BTN2_B2) buttons |= JP_BUTTON_B2;  // B
+    if (rpt->buttons2 & STADIA_BTN2_B3) buttons |= JP_BUTTON_B3;  // X
+    if (rpt->buttons2 & STADIA_BTN2_B4) buttons |= JP_BUTTON_B4;  // Y
 
     // Shoulders (from buttons2)
-    if (report.buttons2 & STADIA_BTN2_L1) buttons |= JP_BUTTON_L1;
-    if (report.buttons2 & STADIA_BTN2_R1) buttons |= JP_BUTTON_R1;
+    if (rpt->buttons2 & STADIA_BTN2_L1) buttons |= JP_BUTTON_L1;
+    if (rpt->buttons2 & STADIA_BTN2_R1) buttons |= JP_BUTTON_R1;
 
     // Triggers (from buttons1)
-    if (report.buttons1 & STADIA_BTN1_L2) buttons |= JP_BUTTON_L2;
-    if (report.buttons1 & STADIA_BTN1_R2) buttons |= JP_BUTTON_R2;
+    if (rpt->buttons1 & STADIA_BTN1_L2) buttons |= JP_BUTTON_L2;
+    if (rpt->buttons1 & STADIA_BTN1_R2) buttons |= JP_BUTTON_R2;
 
     // System buttons (from buttons1)
-    if (report.buttons1 & STADIA_BTN1_S1) buttons |= JP_BUTTON_S1;  // Options/Select
-    if (report.buttons1 & STADIA_BTN1_S2) buttons |= JP_BUTTON_S2;  // Menu/Start
+    if (rpt->buttons1 & STADIA_BTN1_S1) buttons |= JP_BUTTON_S1;  // Options/Select
+    if (rpt->buttons1 & STADIA_BTN1_S2) buttons |= JP_BUTTON_S2;  // Menu/Start
 
     // Stick clicks
-    if (report.buttons2 & STADIA_BTN2_L3) buttons |= JP_BUTTON_L3;
-    if (report.buttons1 & STADIA_BTN1_R3) buttons |= JP_BUTTON_R3;
+    if (rpt->buttons2 & STADIA_BTN2_L3) buttons |= JP_BUTTON_L3;
+    if (rpt->buttons1 & STADIA_BTN1_R3) buttons |= JP_BUTTON_R3;
 
     // Guide button (Stadia button)
-    if (report.buttons1 & STADIA_BTN1_A1) buttons |= JP_BUTTON_A1;
+    if (rpt->buttons1 & STADIA_BTN1_A1) buttons |= JP_BUTTON_A1;
 
     // Update event
     sd->event.buttons = buttons;
-    sd->event.analog[ANALOG_LX] = report.left_x;
-    sd->event.analog[ANALOG_LY] = report.left_y;
-    sd->event.analog[ANALOG_RX] = report.right_x;
-    sd->event.analog[ANALOG_RY] = report.right_y;
-    sd->event.analog[ANALOG_L2] = report.l2_trigger;
-    sd->event.analog[ANALOG_R2] = report.r2_trigger;
+    sd->event.analog[ANALOG_LX] = rpt->left_x;
+    sd->event.analog[ANALOG_LY] = rpt->left_y;
+    sd->event.analog[ANALOG_RX] = rpt->right_x;
+    sd->event.analog[ANALOG_RY] = rpt->right_y;
+    sd->event.analog[ANALOG_L2] = rpt->l2_trigger;
+    sd->event.analog[ANALOG_R2] = rpt->r2_trigger;
 
     // Submit to router
     router_submit_input(&sd->event);
-
-    sd->prev_report = report;
 }
 
 static void stadia_task(bthid_device_t* device)
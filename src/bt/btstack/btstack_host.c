@@ -12,6 +12,7 @@
 #include "btstack_defines.h"
 #include "btstack_event.h"
 #include "btstack_run_loop.h"
+#include "btstack_tlv.h"
 
 // Run loop depends on transport: embedded for USB dongle, async_context for CYW43
 #ifndef BTSTACK_USE_CYW43
@@ -51,13 +52,26 @@ extern void btstack_memory_init(void);
 
 #include "hci_dump.h"
 #include "hci_dump_embedded_stdout.h"
+#include "hci_capture.h"
+#include "sdp_cache.h"
+#include "gatt_cache.h"
+#include "usb/usbh/hid/devices/generic/hid_parse_cache.h"
+#include "core/services/metrics/metrics.h"
+#include "pico/time.h"
 
 // BTHID callbacks - for classic BT HID devices
 extern void bt_on_hid_ready(uint8_t conn_index);
 extern void bt_on_disconnect(uint8_t conn_index);
 extern void bt_on_hid_report(uint8_t conn_index, const uint8_t* data, uint16_t len);
+extern void bt_on_hid_input(uint8_t conn_index, const uint8_t* report, uint16_t len);
 extern void bthid_update_device_info(uint8_t conn_index, const char* name,
                                       uint16_t vendor_id, uint16_t product_id);
+extern void bthid_set_report_descriptor(uint8_t conn_index, const uint8_t* desc, uint16_t len,
+                                        bool id_prefixed);
+extern void bthid_set_report_descriptor_hash(uint8_t conn_index, uint32_t hash, uint16_t len,
+                                             bool id_prefixed);
+extern bool bthid_get_compiled_descriptor(uint32_t hash, uint16_t len, hid_parse_cache_entry_t* entry);
+extern void bthid_restore_compiled_descriptor(const hid_parse_cache_entry_t* entry);
 
 #include <stdio.h>
 #include <string.h>
@@ -96,14 +110,9 @@ static void btstack_erase_flash_banks(void) {
 // BLE HID REPORT ROUTING
 // ============================================================================
 
-// Deferred processing to avoid stack overflow in BTstack callback
-static uint8_t pending_ble_report[64];  // 64 bytes for Switch 2 reports
-static uint16_t pending_ble_report_len = 0;
-static uint8_t pending_ble_conn_index = 0;
-static volatile bool ble_report_pending = false;
-
-// Forward declare the function to route BLE reports through bthid layer
-static void route_ble_hid_report(uint8_t conn_index, const uint8_t* data, uint16_t len);
+// BLE input reports go to bthid straight from the GATT callback, decoded in
+// place in the ACL buffer (bt_on_hid_input). Largest accepted notification:
+#define BLE_HID_REPORT_MAX 64   // Switch 2 reports
 
 // Forward declare Switch 2 functions (defined later with state machine)
 static void switch2_retry_init_if_needed(void);
@@ -152,6 +161,10 @@ typedef struct {
     // Connection index for bthid layer (offset by MAX_CLASSIC_CONNECTIONS)
     uint8_t conn_index;
     bool hid_ready;
+
+    // Time-to-first-input
+    uint32_t connected_ms;
+    bool input_seen;
 } ble_connection_t;
 
 // BLE conn_index offset (BLE devices use conn_index >= this value)
@@ -159,8 +172,14 @@ typedef struct {
 
 typedef enum {
     GATT_IDLE,
+    // Handle map capture (cache miss, after hids_client is up)
     GATT_DISCOVERING_SERVICES,
     GATT_DISCOVERING_HID_CHARACTERISTICS,
+    GATT_DISCOVERING_SERVICE_CHANGED,
+    GATT_DISCOVERING_DESCRIPTORS,
+    GATT_READING_REPORT_REFERENCES,
+    GATT_ENABLING_SERVICE_CHANGED,
+    // Cache hit: writing the cached CCCs
     GATT_ENABLING_NOTIFICATIONS,
     GATT_READY
 } gatt_state_t;
@@ -198,9 +217,6 @@ static struct {
     // GATT discovery state
     gatt_state_t gatt_state;
     hci_con_handle_t gatt_handle;
-    uint16_t hid_service_start;
-    uint16_t hid_service_end;
-    gatt_client_characteristic_t report_characteristic;  // Full HID Report characteristic
 
     // Callbacks
     btstack_host_report_callback_t report_callback;
@@ -227,6 +243,33 @@ static gatt_client_notification_t switch2_hid_notification_listener;
 static gatt_client_characteristic_t switch2_hid_characteristic;
 static void switch2_hid_notification_handler(uint8_t packet_type, uint16_t channel, uint8_t *packet, uint16_t size);
 
+// GATT handle map (gatt_cache) for the connection in hid_state.gatt_handle
+#define GATT_MAP_MAX_CHARACTERISTICS 8  // Report characteristics looked at (input/output/feature)
+
+typedef struct {
+    gatt_client_characteristic_t characteristic;
+    uint16_t ccc_handle;
+    uint16_t reference_handle;
+    uint8_t report_id;
+    uint8_t report_type;        // From Report Reference: 1 = input
+} gatt_map_report_t;
+
+static struct {
+    gatt_cache_entry_t entry;   // What gets stored / what a cache hit replays
+    gatt_map_report_t reports[GATT_MAP_MAX_CHARACTERISTICS];
+    uint8_t num_reports;
+    uint8_t index;              // Report being worked on by per-report steps
+    uint16_t gatt_service_start;
+    uint16_t gatt_service_end;
+    gatt_client_characteristic_t service_changed;
+    bool cached;                // Reports come through the cached listeners, not hids_client
+    bool stale;                 // Service Changed seen while a query was in flight
+    hid_parse_cache_entry_t compiled;   // Report map program stored/restored with the entry
+} gatt_map;
+
+static gatt_client_notification_t gatt_map_report_listeners[GATT_CACHE_MAX_REPORTS];
+static gatt_client_notification_t gatt_map_service_changed_listener;
+
 // ============================================================================
 // CLASSIC BT HID HOST STATE
 // ============================================================================
@@ -234,15 +277,36 @@ static void switch2_hid_notification_handler(uint8_t packet_type, uint16_t chann
 #define MAX_CLASSIC_CONNECTIONS 4
 #define INQUIRY_DURATION 5  // Inquiry duration in 1.28s units
 
+// Per-link power/latency state for a classic HID connection (see
+// CLASSIC LINK POLICY)
+typedef struct {
+    bool input_active;          // Reports flowing: sniff not allowed
+    bool policy_pending;        // Link policy write still to send
+    bool qos_requested;
+    uint8_t mode;               // HCI mode from Mode Change (0 = active, 2 = sniff)
+    uint16_t sniff_interval;    // Slots, while in sniff
+    uint32_t qos_latency_us;    // Granted by QoS Setup Complete (0 = not yet)
+    bool timing;                // last_report_us valid (reset when the link wakes)
+    uint32_t last_report_ms;
+    uint32_t last_report_us;
+    uint32_t last_interval_us;  // 0 = none yet
+} classic_link_t;
+
 typedef struct {
     bool active;
     uint16_t hid_cid;           // BTstack HID connection ID
+    hci_con_handle_t acl_handle;
     bd_addr_t addr;
     char name[32];
     uint8_t class_of_device[3];
     uint16_t vendor_id;
     uint16_t product_id;
     bool hid_ready;
+    bool sdp_cached;            // Info came from sdp_cache: ready without waiting for SDP
+    bool ready_notified;        // bt_on_hid_ready() already called
+    uint16_t descriptor_len;    // HID descriptor from hid_host's SDP query (0 = not yet)
+    uint32_t descriptor_hash;
+    classic_link_t link;
 } classic_connection_t;
 
 static struct {
@@ -257,6 +321,7 @@ static struct {
     uint16_t pending_pid;
     bool pending_valid;
     bool pending_outgoing;  // True if we initiated the connection (hid_host_connect)
+    bool pending_cached;    // pending_vid/pid/name came from sdp_cache
     // Pending HID connect (deferred until encryption completes)
     bd_addr_t pending_hid_addr;
     hci_con_handle_t pending_hid_handle;
@@ -335,6 +400,23 @@ static int get_classic_conn_index(uint16_t hid_cid) {
     return -1;
 }
 
+// Remember a connection's SDP results for the next reconnect (once the
+// descriptor is in; sdp_cache skips the write if nothing changed)
+static void classic_sdp_cache_save(const classic_connection_t* conn) {
+    if (conn->descriptor_len == 0) return;
+
+    sdp_cache_entry_t entry;
+    memset(&entry, 0, sizeof(entry));
+    memcpy(entry.addr, conn->addr, 6);
+    memcpy(entry.class_of_device, conn->class_of_device, 3);
+    entry.vendor_id = conn->vendor_id;
+    entry.product_id = conn->product_id;
+    entry.descriptor_len = conn->descriptor_len;
+    entry.descriptor_hash = conn->descriptor_hash;
+    strncpy(entry.name, conn->name, sizeof(entry.name) - 1);
+    sdp_cache_store(&entry);
+}
+
 // Find free classic connection slot
 static classic_connection_t* find_free_classic_connection(void) {
     for (int i = 0; i < MAX_CLASSIC_CONNECTIONS; i++) {
@@ -345,6 +427,162 @@ static classic_connection_t* find_free_classic_connection(void) {
     return NULL;
 }
 
+// ============================================================================
+// CLASSIC LINK POLICY
+// ============================================================================
+//
+// The default link policy lets pads drop into sniff, which holds each input
+// report until the next sniff anchor. While a pad is sending input its link
+// policy leaves sniff out and the link is pulled out of sniff. A QoS request
+// asks for the shortest poll interval. After LINK_IDLE_MS without a report,
+// sniff is allowed again and requested. Flush timeouts stay at the default:
+// ours only applies to what we send, and the pad's can't be set from here.
+
+#ifndef LINK_IDLE_MS
+#define LINK_IDLE_MS 10000
+#endif
+
+#define LINK_POLICY_ACTIVE      LM_LINK_POLICY_ENABLE_ROLE_SWITCH
+#define LINK_POLICY_IDLE        (LM_LINK_POLICY_ENABLE_SNIFF_MODE | LM_LINK_POLICY_ENABLE_ROLE_SWITCH)
+
+// Idle sniff, in 0.625 ms slots
+#define LINK_IDLE_SNIFF_MIN     0x0020  // 20 ms
+#define LINK_IDLE_SNIFF_MAX     0x0050  // 50 ms
+#define LINK_IDLE_SNIFF_ATTEMPT 2
+#define LINK_IDLE_SNIFF_TIMEOUT 1
+
+// Guaranteed service at Tpoll's floor (6 slots). Token rate and peak
+// bandwidth 0 = not specified, delay variation 0xFFFFFFFF = don't care.
+#define LINK_QOS_LATENCY_US     3750
+
+#define HCI_MODE_SNIFF          2
+
+static classic_connection_t* find_classic_connection_by_acl_handle(hci_con_handle_t handle) {
+    for (int i = 0; i < MAX_CLASSIC_CONNECTIONS; i++) {
+        if (classic_state.connections[i].active && classic_state.connections[i].hid_ready &&
+            classic_state.connections[i].acl_handle == handle) {
+            return &classic_state.connections[i];
+        }
+    }
+    return NULL;
+}
+
+// Send the pending policy write, then the mode change that goes with it
+static void link_policy_apply(classic_connection_t* conn)
+{
+    classic_link_t* link = &conn->link;
+    if (!link->policy_pending || !hci_can_send_command_packet_now()) return;
+
+    hci_send_cmd(&hci_write_link_policy_settings, conn->acl_handle,
+                 link->input_active ? LINK_POLICY_ACTIVE : LINK_POLICY_IDLE);
+    link->policy_pending = false;
+
+    if (!link->input_active) {
+        gap_sniff_mode_enter(conn->acl_handle, LINK_IDLE_SNIFF_MIN, LINK_IDLE_SNIFF_MAX,
+                             LINK_IDLE_SNIFF_ATTEMPT, LINK_IDLE_SNIFF_TIMEOUT);
+        return;
+    }
+    if (link->mode == HCI_MODE_SNIFF) {
+        gap_sniff_mode_exit(conn->acl_handle);
+    }
+    if (!link->qos_requested) {
+        link->qos_requested = true;
+        gap_qos_set(conn->acl_handle, HCI_SERVICE_TYPE_GUARANTEED, 0, 0,
+                    LINK_QOS_LATENCY_US, 0xFFFFFFFF);
+    }
+}
+
+static void link_policy_set_active(classic_connection_t* conn, bool active)
+{
+    conn->link.input_active = active;
+    conn->link.policy_pending = true;
+    conn->link.timing = false;
+    conn->link.last_interval_us = 0;
+    printf("[BTSTACK_HOST] Link 0x%04X: %s\n", conn->acl_handle,
+           active ? "input active, sniff off" : "idle, sniff allowed");
+    link_policy_apply(conn);
+}
+
+// HID channels up: treat the link as active from the start
+static void link_policy_open(classic_connection_t* conn, hci_con_handle_t acl_handle)
+{
+    memset(&conn->link, 0, sizeof(conn->link));
+    conn->acl_handle = acl_handle;
+    conn->link.last_report_ms = btstack_run_loop_get_time_ms();
+    link_policy_set_active(conn, true);
+}
+
+// Every input report: wake the link and record report interval jitter
+static void link_policy_input(classic_connection_t* conn)
+{
+    classic_link_t* link = &conn->link;
+    uint32_t now_us = time_us_32();
+
+    if (!link->input_active) {
+        link_policy_set_active(conn, true);
+    } else if (link->timing) {
+        uint32_t interval = now_us - link->last_report_us;
+        if (link->last_interval_us) {
+            uint32_t jitter = interval > link->last_interval_us ?
+                              interval - link->last_interval_us : link->last_interval_us - interval;
+            METRIC_OBSERVE(BT_HID_REPORT_JITTER_US, jitter);
+        }
+        link->last_interval_us = interval;
+    }
+    link->timing = true;
+    link->last_report_us = now_us;
+    link->last_report_ms = btstack_run_loop_get_time_ms();
+}
+
+static void link_policy_on_mode_change(hci_con_handle_t handle, uint8_t mode, uint16_t interval)
+{
+    classic_connection_t* conn = find_classic_connection_by_acl_handle(handle);
+    if (!conn) return;
+
+    conn->link.mode = mode;
+    conn->link.sniff_interval = (mode == HCI_MODE_SNIFF) ? interval : 0;
+    printf("[BTSTACK_HOST] Link 0x%04X: mode=%d interval=%d slots\n", handle, mode, interval);
+
+    // Pad asked for sniff before our policy write landed
+    if (mode == HCI_MODE_SNIFF && conn->link.input_active && !conn->link.policy_pending) {
+        gap_sniff_mode_exit(handle);
+    }
+}
+
+static void link_policy_on_qos_complete(const uint8_t* packet)
+{
+    // Status, handle, flags, service type, token rate, peak bandwidth, latency, delay variation
+    uint8_t status = packet[2];
+    hci_con_handle_t handle = little_endian_read_16(packet, 3) & 0x0FFF;
+    uint32_t latency = little_endian_read_32(packet, 15);
+
+    classic_connection_t* conn = find_classic_connection_by_acl_handle(handle);
+    if (!conn) return;
+
+    printf("[BTSTACK_HOST] Link 0x%04X: QoS status=0x%02X latency=%lu us\n",
+           handle, status, (unsigned long)latency);
+    if (status == ERROR_CODE_SUCCESS) {
+        conn->link.qos_latency_us = latency;
+        METRIC_SET(BT_LINK_QOS_LATENCY_US, latency);
+    }
+}
+
+// Main loop: idle timeouts and policy writes that found the command queue busy
+static void link_policy_task(void)
+{
+    uint32_t now_ms = btstack_run_loop_get_time_ms();
+    for (int i = 0; i < MAX_CLASSIC_CONNECTIONS; i++) {
+        classic_connection_t* conn = &classic_state.connections[i];
+        if (!conn->active || !conn->hid_ready) continue;
+
+        if (conn->link.input_active && now_ms - conn->link.last_report_ms > LINK_IDLE_MS) {
+            link_policy_set_active(conn, false);
+        } else {
+            link_policy_apply(conn);
+        }
+    }
+}
+
 // ============================================================================
 // BLE CONNECTION HELPERS
 // ============================================================================
@@ -368,19 +606,6 @@ static int get_ble_conn_index_by_handle(hci_con_handle_t handle) {
     return -1;
 }
 
-// Route BLE HID report through bthid layer
-static void route_ble_hid_report(uint8_t conn_index, const uint8_t* data, uint16_t len)
-{
-    // Build BTHID-compatible packet: DATA|INPUT header + report
-    // Buffer needs to hold 1 byte header + up to 64 bytes of report data
-    static uint8_t hid_packet[65];
-    hid_packet[0] = 0xA1;  // DATA | INPUT header
-    if (len <= sizeof(hid_packet) - 1) {
-        memcpy(hid_packet + 1, data, len);
-        bt_on_hid_report(conn_index, hid_packet, len + 1);
-    }
-}
-
 // ============================================================================
 // FORWARD DECLARATIONS
 // ============================================================================
@@ -392,6 +617,10 @@ static void hid_host_packet_handler(uint8_t packet_type, uint16_t channel, uint8
 static ble_connection_t* find_connection_by_handle(hci_con_handle_t handle);
 static ble_connection_t* find_free_connection(void);
 static void start_hids_client(ble_connection_t *conn);
+static void gatt_map_start(ble_connection_t *conn);
+static void gatt_map_stop(void);
+static void gatt_cached_start(ble_connection_t *conn, const gatt_cache_entry_t *entry);
+static void ble_identity_addr(const ble_connection_t *conn, bd_addr_t addr);
 static void register_ble_hid_listener(hci_con_handle_t con_handle);
 static void register_switch2_hid_listener(hci_con_handle_t con_handle);
 
@@ -546,6 +775,9 @@ void btstack_host_init(const void* transport)
     // printf("[BTSTACK_HOST] Init HCI dump (for logging)...\n");
     // hci_dump_init(hci_dump_embedded_stdout_get_instance());
 
+    // Packet capture for replay (BT.CAPTURE.START over CDC), if armed
+    hci_capture_init();
+
     printf("[BTSTACK_HOST] Init memory pools...\n");
     btstack_memory_init();
 
@@ -576,6 +808,9 @@ void btstack_host_init_hid_handlers(void)
     memset(&hid_state, 0, sizeof(hid_state));
     // Note: hci_transport is not set here since BTstack was initialized externally
 
+    // Controller isn't powered yet, so an armed capture still sees HCI reset
+    hci_capture_init();
+
     // Set up HID handlers (BTstack core already initialized by btstack_cyw43_init or similar)
     setup_hid_handlers();
     printf("[BTSTACK_HOST] HID handlers initialized OK\n");
@@ -707,23 +942,43 @@ void btstack_host_process(void)
     }
 #endif
 
-    // Process any pending BLE HID report (deferred from BTstack callback to avoid stack overflow)
-    if (ble_report_pending) {
-        ble_report_pending = false;
-        route_ble_hid_report(pending_ble_conn_index, pending_ble_report, pending_ble_report_len);
-    }
-
     // Retry Switch 2 init if stuck (no ACK received)
     switch2_retry_init_if_needed();
 
     // Handle Switch 2 rumble/LED feedback passthrough
     switch2_handle_feedback();
+
+    // Classic links: sniff back on when idle, deferred policy writes
+    link_policy_task();
 }
 
 // ============================================================================
 // SDP QUERY CALLBACK (for VID/PID detection)
 // ============================================================================
 
+// Collect the PnP record's Vendor ID / Product ID attributes into *vid/*pid
+static void sdp_pnp_attribute(uint8_t* packet, uint16_t* vid, uint16_t* pid) {
+    uint16_t attr_len = sdp_event_query_attribute_byte_get_attribute_length(packet);
+    if (attr_len > sdp_attribute_value_buffer_size) return;
+
+    uint16_t offset = sdp_event_query_attribute_byte_get_data_offset(packet);
+    sdp_attribute_value[offset] = sdp_event_query_attribute_byte_get_data(packet);
+
+    // Check if we got all bytes for this attribute
+    if (offset + 1 != attr_len) return;
+
+    uint16_t attr_id = sdp_event_query_attribute_byte_get_attribute_id(packet);
+    uint16_t value;
+    if (!de_element_get_uint16(sdp_attribute_value, &value)) return;
+    if (attr_id == BLUETOOTH_ATTRIBUTE_VENDOR_ID) {
+        *vid = value;
+        printf("[BTSTACK_HOST] SDP VID: 0x%04X\n", value);
+    } else if (attr_id == BLUETOOTH_ATTRIBUTE_PRODUCT_ID) {
+        *pid = value;
+        printf("[BTSTACK_HOST] SDP PID: 0x%04X\n", value);
+    }
+}
+
 static void sdp_query_vid_pid_callback(uint8_t packet_type, uint16_t channel, uint8_t *packet, uint16_t size) {
     UNUSED(channel);
     UNUSED(size);
@@ -738,29 +993,9 @@ static void sdp_query_vid_pid_callback(uint8_t packet_type, uint16_t channel, ui
     }
 
     switch (event_type) {
-        case SDP_EVENT_QUERY_ATTRIBUTE_VALUE: {
-            uint16_t attr_len = sdp_event_query_attribute_byte_get_attribute_length(packet);
-            if (attr_len <= sdp_attribute_value_buffer_size) {
-                uint16_t offset = sdp_event_query_attribute_byte_get_data_offset(packet);
-                sdp_attribute_value[offset] = sdp_event_query_attribute_byte_get_data(packet);
-
-                // Check if we got all bytes for this attribute
-                if (offset + 1 == attr_len) {
-                    uint16_t attr_id = sdp_event_query_attribute_byte_get_attribute_id(packet);
-                    uint16_t value;
-                    if (de_element_get_uint16(sdp_attribute_value, &value)) {
-                        if (attr_id == BLUETOOTH_ATTRIBUTE_VENDOR_ID) {
-                            classic_state.pending_vid = value;
-                            printf("[BTSTACK_HOST] SDP VID: 0x%04X\n", value);
-                        } else if (attr_id == BLUETOOTH_ATTRIBUTE_PRODUCT_ID) {
-                            classic_state.pending_pid = value;
-                            printf("[BTSTACK_HOST] SDP PID: 0x%04X\n", value);
-                        }
-                    }
-                }
-            }
+        case SDP_EVENT_QUERY_ATTRIBUTE_VALUE:
+            sdp_pnp_attribute(packet, &classic_state.pending_vid, &classic_state.pending_pid);
             break;
-        }
         case SDP_EVENT_QUERY_COMPLETE:
             printf("[BTSTACK_HOST] SDP query complete: VID=0x%04X PID=0x%04X\n",
                    classic_state.pending_vid, classic_state.pending_pid);
@@ -774,6 +1009,7 @@ static void sdp_query_vid_pid_callback(uint8_t packet_type, uint16_t channel, ui
                         conn->product_id = classic_state.pending_pid;
                         printf("[BTSTACK_HOST] Updated conn[%d] VID/PID: 0x%04X/0x%04X\n",
                                i, conn->vendor_id, conn->product_id);
+                        classic_sdp_cache_save(conn);
 
                         // Notify bthid to re-evaluate driver selection with new VID/PID
                         bthid_update_device_info(i, conn->name,
@@ -795,6 +1031,81 @@ static void sdp_query_vid_pid_callback(uint8_t packet_type, uint16_t channel, ui
     }
 }
 
+// Background PnP query for a device that reconnected from the SDP cache.
+// Queued behind hid_host's descriptor query rather than competing with it,
+// one registration per connection slot so pads opening together each get
+// theirs. The registrations live outside classic_connection_t because sdp_client
+// keeps them linked until they run, and connection slots are memset on
+// disconnect. Results go to the slot's connection, not classic_state.pending_*,
+// which belongs to the incoming connection being set up.
+static struct {
+    btstack_context_callback_registration_t request;
+    bd_addr_t addr;
+    bool queued;
+} sdp_revalidate_slots[MAX_CLASSIC_CONNECTIONS];
+
+static int sdp_revalidate_running = -1;     // Slot whose query is in flight
+static uint16_t sdp_revalidate_vid;
+static uint16_t sdp_revalidate_pid;
+
+static void sdp_revalidate_callback(uint8_t packet_type, uint16_t channel, uint8_t *packet, uint16_t size) {
+    UNUSED(channel);
+    UNUSED(size);
+
+    if (packet_type != HCI_EVENT_PACKET) return;
+
+    switch (hci_event_packet_get_type(packet)) {
+        case SDP_EVENT_QUERY_ATTRIBUTE_VALUE:
+            sdp_pnp_attribute(packet, &sdp_revalidate_vid, &sdp_revalidate_pid);
+            break;
+        case SDP_EVENT_QUERY_COMPLETE: {
+            int slot = sdp_revalidate_running;
+            sdp_revalidate_running = -1;
+            if (slot < 0) break;
+
+            // The pad may have dropped (or its slot been reused) while queued
+            classic_connection_t* conn = &classic_state.connections[slot];
+            if (!conn->active || bd_addr_cmp(conn->addr, sdp_revalidate_slots[slot].addr) != 0) break;
+            if (!sdp_revalidate_vid && !sdp_revalidate_pid) break;
+
+            printf("[BTSTACK_HOST] SDP revalidate conn[%d]: VID=0x%04X PID=0x%04X\n",
+                   slot, sdp_revalidate_vid, sdp_revalidate_pid);
+            if (conn->vendor_id != sdp_revalidate_vid || conn->product_id != sdp_revalidate_pid) {
+                conn->vendor_id = sdp_revalidate_vid;
+                conn->product_id = sdp_revalidate_pid;
+                bthid_update_device_info(slot, conn->name, conn->vendor_id, conn->product_id);
+            }
+            classic_sdp_cache_save(conn);
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+static void sdp_revalidate_start(void* context) {
+    int slot = (int)(uintptr_t)context;
+    sdp_revalidate_slots[slot].queued = false;
+    sdp_revalidate_running = slot;
+    sdp_revalidate_vid = 0;
+    sdp_revalidate_pid = 0;
+    if (sdp_client_query_uuid16(&sdp_revalidate_callback, sdp_revalidate_slots[slot].addr,
+                                BLUETOOTH_SERVICE_CLASS_PNP_INFORMATION) != ERROR_CODE_SUCCESS) {
+        sdp_revalidate_running = -1;
+    }
+}
+
+static void sdp_revalidate(const classic_connection_t* conn) {
+    int slot = (int)(conn - classic_state.connections);
+    memcpy(sdp_revalidate_slots[slot].addr, conn->addr, 6);
+    if (sdp_revalidate_slots[slot].queued) return;  // Already waiting; runs for the new address
+
+    sdp_revalidate_slots[slot].queued = true;
+    sdp_revalidate_slots[slot].request.callback = &sdp_revalidate_start;
+    sdp_revalidate_slots[slot].request.context = (void*)(uintptr_t)slot;
+    sdp_client_register_query_callback(&sdp_revalidate_slots[slot].request);
+}
+
 // ============================================================================
 // HCI EVENT HANDLER
 // ============================================================================
@@ -1147,6 +1458,7 @@ static void packet_handler(uint8_t packet_type, uint16_t channel, uint8_t *packe
             classic_state.pending_pid = 0;
             classic_state.pending_valid = true;
             classic_state.pending_outgoing = false;  // Device initiated this connection
+            classic_state.pending_cached = false;
 
             if (is_wiimote && link_type == 0x01) {  // ACL link
                 // Wiimotes require us to be master - set policy before BTstack auto-accepts
@@ -1261,9 +1573,25 @@ static void packet_handler(uint8_t packet_type, uint16_t channel, uint8_t *packe
                             // Request remote name for driver matching (we don't have it from inquiry)
                             gap_remote_name_request(addr, 0, 0);
 
-                            // Query VID/PID via SDP (PnP Information service)
-                            sdp_client_query_uuid16(&sdp_query_vid_pid_callback, addr,
-                                                    BLUETOOTH_SERVICE_CLASS_PNP_INFORMATION);
+                            // Bonded pad we've seen before: take VID/PID/name from the
+                            // SDP cache so it's ready as soon as HID opens. The PnP query
+                            // then runs in the background (sdp_revalidate).
+                            sdp_cache_entry_t cached;
+                            if (sdp_cache_lookup(addr, &cached)) {
+                                classic_state.pending_vid = cached.vendor_id;
+                                classic_state.pending_pid = cached.product_id;
+                                if (classic_state.pending_name[0] == '\0') {
+                                    strncpy(classic_state.pending_name, cached.name,
+                                            sizeof(classic_state.pending_name) - 1);
+                                }
+                                classic_state.pending_cached = true;
+                                printf("[BTSTACK_HOST] SDP cache hit: VID=0x%04X PID=0x%04X name=%s\n",
+                                       cached.vendor_id, cached.product_id, cached.name);
+                            } else {
+                                // Query VID/PID via SDP (PnP Information service)
+                                sdp_client_query_uuid16(&sdp_query_vid_pid_callback, addr,
+                                                        BLUETOOTH_SERVICE_CLASS_PNP_INFORMATION);
+                            }
 
                             // Request authentication (Bluepad32 pattern)
                             gap_request_security_level(handle, LEVEL_2);
@@ -1376,6 +1704,8 @@ static void packet_handler(uint8_t packet_type, uint16_t channel, uint8_t *packe
                         conn->is_switch2 = hid_state.pending_is_switch2;
                         conn->vid = hid_state.pending_vid;
                         conn->pid = hid_state.pending_pid;
+                        conn->connected_ms = btstack_run_loop_get_time_ms();
+                        conn->input_seen = false;
 
                         printf("[BTSTACK_HOST] Connection stored: name='%s' switch2=%d vid=0x%04X pid=0x%04X\n",
                                conn->name, conn->is_switch2, conn->vid, conn->pid);
@@ -1426,6 +1756,7 @@ static void packet_handler(uint8_t packet_type, uint16_t channel, uint8_t *packe
                             strncpy(conn->name, name, sizeof(conn->name) - 1);
                             conn->name[sizeof(conn->name) - 1] = '\0';
                             printf("[BTSTACK_HOST] Updated conn[%d] name: %s\n", i, conn->name);
+                            classic_sdp_cache_save(conn);
 
                             // If this is a Wiimote and PID wasn't set, detect it now and update BTHID
                             if (conn->hid_ready && conn->vendor_id == 0x057E && conn->product_id == 0) {
@@ -1464,6 +1795,9 @@ static void packet_handler(uint8_t packet_type, uint16_t channel, uint8_t *packe
             printf("[BTSTACK_HOST] Disconnected: handle=0x%04X reason=0x%02X\n", handle, reason);
 
             ble_connection_t *conn = find_connection_by_handle(handle);
+            if (conn && handle == hid_state.gatt_handle) {
+                gatt_map_stop();
+            }
             if (conn && conn->conn_index > 0) {
                 // Notify bthid layer before clearing connection
                 // conn_index for BLE uses BLE_CONN_INDEX_OFFSET to distinguish from Classic
@@ -1627,6 +1961,18 @@ static void packet_handler(uint8_t packet_type, uint16_t channel, uint8_t *packe
             break;
         }
 
+        case HCI_EVENT_MODE_CHANGE: {
+            if (hci_event_mode_change_get_status(packet) != ERROR_CODE_SUCCESS) break;
+            link_policy_on_mode_change(hci_event_mode_change_get_handle(packet),
+                                       hci_event_mode_change_get_mode(packet),
+                                       hci_event_mode_change_get_interval(packet));
+            break;
+        }
+
+        case HCI_EVENT_QOS_SETUP_COMPLETE:
+            link_policy_on_qos_complete(packet);
+            break;
+
         case HCI_EVENT_ROLE_CHANGE: {
             uint8_t status = hci_event_role_change_get_status(packet);
             bd_addr_t addr;
@@ -1728,12 +2074,18 @@ static void sm_packet_handler(uint8_t packet_type, uint16_t channel, uint8_t *pa
                     hid_state.has_last_connected = true;
 
                     bool is_xbox = (strstr(conn->name, "Xbox") != NULL);
+                    bd_addr_t identity;
+                    gatt_cache_entry_t cached;
+                    ble_identity_addr(conn, identity);
                     if (is_xbox) {
                         printf("[BTSTACK_HOST] Xbox detected - using fast-path HID listener\n");
                         register_ble_hid_listener(handle);
                     } else if (conn->is_switch2) {
                         printf("[BTSTACK_HOST] Switch 2 detected - using fast-path notification enable\n");
                         register_switch2_hid_listener(handle);
+                    } else if (gatt_cache_lookup(identity, &cached)) {
+                        printf("[BTSTACK_HOST] GATT cache hit - skipping discovery\n");
+                        gatt_cached_start(conn, &cached);
                     } else {
                         printf("[BTSTACK_HOST] Non-Xbox BLE controller - starting GATT discovery\n");
                         start_hids_client(conn);
@@ -1746,6 +2098,13 @@ static void sm_packet_handler(uint8_t packet_type, uint16_t channel, uint8_t *pa
                 bd_addr_t addr;
                 sm_event_reencryption_complete_get_address(packet, addr);
                 bd_addr_type_t addr_type = sm_event_reencryption_complete_get_addr_type(packet);
+                ble_connection_t* conn = find_connection_by_handle(handle);
+                if (conn) {
+                    // Handle map goes with the bond (identity address needs the bond still there)
+                    bd_addr_t identity;
+                    ble_identity_addr(conn, identity);
+                    gatt_cache_remove(identity);
+                }
                 gap_delete_bonding(addr_type, addr);
                 sm_request_pairing(handle);
             }
@@ -1755,8 +2114,336 @@ static void sm_packet_handler(uint8_t packet_type, uint16_t channel, uint8_t *pa
 }
 
 // ============================================================================
-// GATT CLIENT
+// GATT HANDLE MAP (gatt_cache)
 // ============================================================================
+//
+// Cache miss: hids_client does its own discovery; once its notifications are
+// on, we walk the HID service again to record the handles it used (hids_client
+// doesn't expose them) and store them with a fingerprint of the report map.
+// Cache hit: write the cached CCCs and listen on the cached value handles,
+// hids_client never runs. A failed CCC write or a Service Changed indication
+// drops the entry and restarts the connection through hids_client.
+
+static uint8_t gatt_ccc_notify[] = { 0x01, 0x00 };
+
+static void gatt_client_callback(uint8_t packet_type, uint16_t channel, uint8_t *packet, uint16_t size);
+
+// Bonded devices with resolvable private addresses connect from a different
+// address each time - key the cache on the identity address from the bond
+static void ble_identity_addr(const ble_connection_t *conn, bd_addr_t addr)
+{
+    int index = sm_le_device_index(conn->handle);
+    if (index >= 0) {
+        int addr_type;
+        le_device_db_info(index, &addr_type, addr, NULL);
+        return;
+    }
+    memcpy(addr, conn->addr, 6);
+}
+
+// Cached input report: hand it over the way hids_client does (report ID, then
+// the value) without copying it. GATT_EVENT_NOTIFICATION is laid out as
+// type, length, con handle, value handle, value length (16 bit each), value,
+// so the byte before the value is the high byte of value_length. The ID is
+// written there for the dispatch and the byte is put back afterwards: the
+// same event goes on to gatt_client's other listeners for this handle.
+static void gatt_cached_report_handler(uint8_t packet_type, uint16_t channel, uint8_t *packet, uint16_t size)
+{
+    UNUSED(channel);
+    UNUSED(size);
+
+    if (packet_type != HCI_EVENT_PACKET) return;
+    if (hci_event_packet_get_type(packet) != GATT_EVENT_NOTIFICATION) return;
+
+    hci_con_handle_t con_handle = gatt_event_notification_get_handle(packet);
+    uint16_t value_handle = gatt_event_notification_get_value_handle(packet);
+    uint16_t value_length = gatt_event_notification_get_value_length(packet);
+    if (value_length == 0 || value_length >= BLE_HID_REPORT_MAX) return;
+
+    int conn_index = get_ble_conn_index_by_handle(con_handle);
+    if (conn_index < 0) return;
+
+    for (int i = 0; i < gatt_map.entry.num_reports; i++) {
+        if (gatt_map.entry.reports[i].value_handle != value_handle) continue;
+
+        uint8_t *report = (uint8_t*)gatt_event_notification_get_value(packet) - 1;
+        uint8_t header_byte = report[0];
+        report[0] = gatt_map.entry.reports[i].report_id;
+        bt_on_hid_input((uint8_t)conn_index, report, value_length + 1);
+
+        if (hid_state.report_callback) {
+            hid_state.report_callback(con_handle, report, value_length + 1);
+        }
+        report[0] = header_byte;
+        return;
+    }
+}
+
+static void gatt_service_changed_handler(uint8_t packet_type, uint16_t channel, uint8_t *packet, uint16_t size);
+
+static void gatt_map_listen(hci_con_handle_t con_handle, bool reports)
+{
+    gatt_client_characteristic_t characteristic;
+    memset(&characteristic, 0, sizeof(characteristic));
+
+    if (reports) {
+        for (int i = 0; i < gatt_map.entry.num_reports; i++) {
+            characteristic.value_handle = gatt_map.entry.reports[i].value_handle;
+            gatt_client_listen_for_characteristic_value_updates(
+                &gatt_map_report_listeners[i], gatt_cached_report_handler, con_handle, &characteristic);
+        }
+    }
+    if (gatt_map.entry.service_changed_handle) {
+        characteristic.value_handle = gatt_map.entry.service_changed_handle;
+        gatt_client_listen_for_characteristic_value_updates(
+            &gatt_map_service_changed_listener, gatt_service_changed_handler, con_handle, &characteristic);
+    }
+}
+
+// Connection gone (or falling back): drop listeners, forget the map
+static void gatt_map_stop(void)
+{
+    for (int i = 0; i < GATT_CACHE_MAX_REPORTS; i++) {
+        gatt_client_stop_listening_for_characteristic_value_updates(&gatt_map_report_listeners[i]);
+    }
+    gatt_client_stop_listening_for_characteristic_value_updates(&gatt_map_service_changed_listener);
+    memset(&gatt_map, 0, sizeof(gatt_map));
+    hid_state.gatt_state = GATT_IDLE;
+}
+
+// Cached handles didn't work out - forget them and discover from scratch
+static void gatt_cached_fallback(ble_connection_t *conn)
+{
+    printf("[BTSTACK_HOST] GATT cache stale for %s - falling back to discovery\n",
+           bd_addr_to_str(gatt_map.entry.addr));
+    gatt_cache_remove(gatt_map.entry.addr);
+    gatt_map_stop();
+
+    if (conn->hid_ready) {
+        // bthid already has the device; hids_client will announce it again
+        bt_on_disconnect(conn->conn_index);
+        conn->hid_ready = false;
+    }
+    start_hids_client(conn);
+}
+
+static void gatt_cached_start(ble_connection_t *conn, const gatt_cache_entry_t *entry)
+{
+    printf("[BTSTACK_HOST] Enabling %d cached input reports\n", entry->num_reports);
+
+    conn->state = BLE_STATE_DISCOVERING;
+    hid_state.gatt_handle = conn->handle;
+    memset(&gatt_map, 0, sizeof(gatt_map));
+    gatt_map.entry = *entry;
+    gatt_map.cached = true;
+    gatt_map_listen(conn->handle, true);
+
+    // CCCs one at a time; the first write goes out here
+    hid_state.gatt_state = GATT_ENABLING_NOTIFICATIONS;
+    gatt_map.index = 0;
+    uint8_t status = gatt_client_write_value_of_characteristic(
+        gatt_client_callback, conn->handle, entry->reports[0].ccc_handle,
+        sizeof(gatt_ccc_notify), gatt_ccc_notify);
+    if (status != ERROR_CODE_SUCCESS) {
+        gatt_cached_fallback(conn);
+    }
+}
+
+// All cached CCCs written: same hand-off as HIDS_SERVICE_CONNECTED
+static void gatt_cached_ready(ble_connection_t *conn)
+{
+    hid_state.gatt_state = GATT_READY;
+    conn->state = BLE_STATE_READY;
+    conn->hid_ready = true;
+    for (int i = 0; i < MAX_BLE_CONNECTIONS; i++) {
+        if (&hid_state.connections[i] == conn) {
+            conn->conn_index = BLE_CONN_INDEX_OFFSET + i;
+            break;
+        }
+    }
+
+    printf("[BTSTACK_HOST] Calling bt_on_hid_ready(%d) for BLE device '%s' (cached handles)\n",
+           conn->conn_index, conn->name);
+    bt_on_hid_ready(conn->conn_index);
+
+    // Report map wasn't read: the driver can only find it in hid_parse_cache,
+    // which starts empty after a reboot. Seed it from the compiled map stored
+    // with the handles.
+    if (gatt_cache_lookup_program(gatt_map.entry.addr, &gatt_map.compiled) &&
+        gatt_map.compiled.hash == gatt_map.entry.report_map_hash &&
+        gatt_map.compiled.desc_len == gatt_map.entry.report_map_len) {
+        bthid_restore_compiled_descriptor(&gatt_map.compiled);
+    }
+    bthid_set_report_descriptor_hash(conn->conn_index, gatt_map.entry.report_map_hash,
+                                     gatt_map.entry.report_map_len, true);
+}
+
+static void gatt_service_changed_handler(uint8_t packet_type, uint16_t channel, uint8_t *packet, uint16_t size)
+{
+    UNUSED(channel);
+    UNUSED(size);
+
+    if (packet_type != HCI_EVENT_PACKET) return;
+    if (hci_event_packet_get_type(packet) != GATT_EVENT_INDICATION) return;
+
+    ble_connection_t *conn = find_connection_by_handle(gatt_event_indication_get_handle(packet));
+    if (!conn) return;
+
+    printf("[BTSTACK_HOST] Service Changed from %s - dropping cached GATT handles\n",
+           bd_addr_to_str(gatt_map.entry.addr));
+    gatt_cache_remove(gatt_map.entry.addr);
+
+    // A query in flight finishes first; QUERY_COMPLETE picks this up
+    if (hid_state.gatt_state != GATT_IDLE && hid_state.gatt_state != GATT_READY) {
+        gatt_map.stale = true;
+    } else if (gatt_map.cached) {
+        gatt_cached_fallback(conn);
+    }
+}
+
+// Start recording the handle map once hids_client has the device running
+static void gatt_map_start(ble_connection_t *conn)
+{
+    if (hid_state.gatt_state != GATT_IDLE) return;
+
+    memset(&gatt_map, 0, sizeof(gatt_map));
+    ble_identity_addr(conn, gatt_map.entry.addr);
+
+    printf("[BTSTACK_HOST] Recording GATT handle map for %s...\n", bd_addr_to_str(gatt_map.entry.addr));
+    hid_state.gatt_state = GATT_DISCOVERING_SERVICES;
+    if (gatt_client_discover_primary_services(gatt_client_callback, conn->handle) != ERROR_CODE_SUCCESS) {
+        printf("[BTSTACK_HOST] GATT client busy - handle map not recorded\n");
+        hid_state.gatt_state = GATT_IDLE;
+    }
+}
+
+// Next report whose CCC and Report Reference were both found, from index on
+static uint8_t gatt_map_next_usable(uint8_t index)
+{
+    while (index < gatt_map.num_reports &&
+           (gatt_map.reports[index].ccc_handle == 0 || gatt_map.reports[index].reference_handle == 0)) {
+        index++;
+    }
+    return index;
+}
+
+static void gatt_map_store(void)
+{
+    gatt_cache_entry_t *entry = &gatt_map.entry;
+    entry->num_reports = 0;
+    for (int i = 0; i < gatt_map.num_reports && entry->num_reports < GATT_CACHE_MAX_REPORTS; i++) {
+        const gatt_map_report_t *report = &gatt_map.reports[i];
+        if (report->report_type != 1 || report->ccc_handle == 0) continue;  // Input reports only
+
+        gatt_cache_report_t *cached = &entry->reports[entry->num_reports++];
+        cached->value_handle = report->characteristic.value_handle;
+        cached->ccc_handle = report->ccc_handle;
+        cached->report_id = report->report_id;
+    }
+    if (entry->num_reports == 0) {
+        printf("[BTSTACK_HOST] No usable input reports - handle map not recorded\n");
+        return;
+    }
+
+    // Fingerprint the report map hids_client read, so the entry says which
+    // descriptor the handles belong to
+    entry->report_map_len = hids_client_descriptor_storage_get_descriptor_len(hid_state.hids_cid, 0);
+    entry->report_map_hash = hid_parse_cache_hash(
+        hids_client_descriptor_storage_get_descriptor_data(hid_state.hids_cid, 0), entry->report_map_len);
+
+    gatt_cache_store(entry);
+
+    // bthid compiled the report map when hids_client handed it over. Keep
+    // that too: hid_parse_cache is RAM-only, and a cached reconnect never
+    // reads the report map, so after a reboot the driver would have nothing
+    // to look its hash up in.
+    if (bthid_get_compiled_descriptor(entry->report_map_hash, entry->report_map_len, &gatt_map.compiled)) {
+        gatt_cache_store_program(entry->addr, &gatt_map.compiled);
+    }
+}
+
+// Issue the next handle map query. Returns false when there's nothing left.
+static bool gatt_map_next(hci_con_handle_t con_handle)
+{
+    switch (hid_state.gatt_state) {
+        case GATT_DISCOVERING_SERVICES:
+            if (gatt_map.entry.hid_service_start == 0) {
+                printf("[BTSTACK_HOST] No HID service found!\n");
+                return false;
+            }
+            hid_state.gatt_state = GATT_DISCOVERING_HID_CHARACTERISTICS;
+            gatt_client_discover_characteristics_for_handle_range_by_uuid16(
+                gatt_client_callback, con_handle,
+                gatt_map.entry.hid_service_start, gatt_map.entry.hid_service_end,
+                0x2A4D);  // HID Report UUID
+            return true;
+
+        case GATT_DISCOVERING_HID_CHARACTERISTICS:
+            if (gatt_map.num_reports == 0) {
+                printf("[BTSTACK_HOST] No HID Report characteristics found!\n");
+                return false;
+            }
+            if (gatt_map.gatt_service_start != 0) {
+                hid_state.gatt_state = GATT_DISCOVERING_SERVICE_CHANGED;
+                gatt_client_discover_characteristics_for_handle_range_by_uuid16(
+                    gatt_client_callback, con_handle,
+                    gatt_map.gatt_service_start, gatt_map.gatt_service_end,
+                    0x2A05);  // Service Changed UUID
+                return true;
+            }
+            // fall through - no Generic Attribute service
+        case GATT_DISCOVERING_SERVICE_CHANGED:
+            hid_state.gatt_state = GATT_DISCOVERING_DESCRIPTORS;
+            gatt_map.index = 0;
+            gatt_client_discover_characteristic_descriptors(
+                gatt_client_callback, con_handle, &gatt_map.reports[0].characteristic);
+            return true;
+
+        case GATT_DISCOVERING_DESCRIPTORS:
+            if (++gatt_map.index < gatt_map.num_reports) {
+                gatt_client_discover_characteristic_descriptors(
+                    gatt_client_callback, con_handle, &gatt_map.reports[gatt_map.index].characteristic);
+                return true;
+            }
+            hid_state.gatt_state = GATT_READING_REPORT_REFERENCES;
+            gatt_map.index = gatt_map_next_usable(0);
+            if (gatt_map.index >= gatt_map.num_reports) {
+                printf("[BTSTACK_HOST] HID Reports lack CCC/Report Reference descriptors\n");
+                return false;
+            }
+            gatt_client_read_value_of_characteristic_using_value_handle(
+                gatt_client_callback, con_handle, gatt_map.reports[gatt_map.index].reference_handle);
+            return true;
+
+        case GATT_READING_REPORT_REFERENCES:
+            gatt_map.index = gatt_map_next_usable(gatt_map.index + 1);
+            if (gatt_map.index < gatt_map.num_reports) {
+                gatt_client_read_value_of_characteristic_using_value_handle(
+                    gatt_client_callback, con_handle, gatt_map.reports[gatt_map.index].reference_handle);
+                return true;
+            }
+            if (gatt_map.service_changed.value_handle != 0) {
+                // Indications stay enabled across bonded connections, so this
+                // write is only needed once
+                hid_state.gatt_state = GATT_ENABLING_SERVICE_CHANGED;
+                gatt_client_write_client_characteristic_configuration(
+                    gatt_client_callback, con_handle, &gatt_map.service_changed,
+                    GATT_CLIENT_CHARACTERISTICS_CONFIGURATION_INDICATION);
+                return true;
+            }
+            gatt_map_store();
+            return false;
+
+        case GATT_ENABLING_SERVICE_CHANGED:
+            gatt_map.entry.service_changed_handle = gatt_map.service_changed.value_handle;
+            gatt_map_listen(con_handle, false);
+            gatt_map_store();
+            return false;
+
+        default:
+            return false;
+    }
+}
 
 static void gatt_client_callback(uint8_t packet_type, uint16_t channel, uint8_t *packet, uint16_t size)
 {
@@ -1774,11 +2461,12 @@ static void gatt_client_callback(uint8_t packet_type, uint16_t channel, uint8_t
             printf("[BTSTACK_HOST] GATT: Service 0x%04X-0x%04X UUID=0x%04X\n",
                    service.start_group_handle, service.end_group_handle,
                    service.uuid16);
-            // Save HID service handles (UUID 0x1812)
-            if (service.uuid16 == 0x1812) {
-                hid_state.hid_service_start = service.start_group_handle;
-                hid_state.hid_service_end = service.end_group_handle;
-                printf("[BTSTACK_HOST] Found HID Service!\n");
+            if (service.uuid16 == 0x1812) {         // HID
+                gatt_map.entry.hid_service_start = service.start_group_handle;
+                gatt_map.entry.hid_service_end = service.end_group_handle;
+            } else if (service.uuid16 == 0x1801) {  // Generic Attribute (Service Changed)
+                gatt_map.gatt_service_start = service.start_group_handle;
+                gatt_map.gatt_service_end = service.end_group_handle;
             }
             break;
         }
@@ -1789,69 +2477,77 @@ static void gatt_client_callback(uint8_t packet_type, uint16_t channel, uint8_t
             printf("[BTSTACK_HOST] GATT: Char handle=0x%04X value=0x%04X end=0x%04X props=0x%02X UUID=0x%04X\n",
                    characteristic.start_handle, characteristic.value_handle,
                    characteristic.end_handle, characteristic.properties, characteristic.uuid16);
-            // Save first Report characteristic (UUID 0x2A4D) with Notify property
-            if (characteristic.uuid16 == 0x2A4D && (characteristic.properties & 0x10) &&
-                hid_state.report_characteristic.value_handle == 0) {
-                hid_state.report_characteristic = characteristic;
-                printf("[BTSTACK_HOST] Found HID Report characteristic!\n");
+            if (hid_state.gatt_state == GATT_DISCOVERING_SERVICE_CHANGED) {
+                gatt_map.service_changed = characteristic;
+            } else if ((characteristic.properties & 0x10) &&      // Notify
+                       gatt_map.num_reports < GATT_MAP_MAX_CHARACTERISTICS) {
+                gatt_map.reports[gatt_map.num_reports++].characteristic = characteristic;
+            }
+            break;
+        }
+
+        case GATT_EVENT_ALL_CHARACTERISTIC_DESCRIPTORS_QUERY_RESULT: {
+            gatt_client_characteristic_descriptor_t descriptor;
+            gatt_event_all_characteristic_descriptors_query_result_get_characteristic_descriptor(packet, &descriptor);
+            gatt_map_report_t *report = &gatt_map.reports[gatt_map.index];
+            if (descriptor.uuid16 == 0x2902) {          // Client Characteristic Configuration
+                report->ccc_handle = descriptor.handle;
+            } else if (descriptor.uuid16 == 0x2908) {   // Report Reference
+                report->reference_handle = descriptor.handle;
+            }
+            break;
+        }
+
+        case GATT_EVENT_CHARACTERISTIC_VALUE_QUERY_RESULT: {
+            // Report Reference: report ID, report type
+            if (gatt_event_characteristic_value_query_result_get_value_length(packet) >= 2) {
+                const uint8_t *value = gatt_event_characteristic_value_query_result_get_value(packet);
+                gatt_map.reports[gatt_map.index].report_id = value[0];
+                gatt_map.reports[gatt_map.index].report_type = value[1];
             }
             break;
         }
 
         case GATT_EVENT_QUERY_COMPLETE: {
+            hci_con_handle_t con_handle = gatt_event_query_complete_get_handle(packet);
             uint8_t status = gatt_event_query_complete_get_att_status(packet);
-            printf("[BTSTACK_HOST] GATT: Query complete, status=0x%02X, gatt_state=%d\n",
-                   status, hid_state.gatt_state);
-
-            if (status != 0) break;
-
-            // State machine for GATT discovery
-            if (hid_state.gatt_state == GATT_DISCOVERING_SERVICES) {
-                if (hid_state.hid_service_start != 0) {
-                    // Found HID, now discover its characteristics
-                    printf("[BTSTACK_HOST] Discovering HID characteristics...\n");
-                    hid_state.gatt_state = GATT_DISCOVERING_HID_CHARACTERISTICS;
-                    gatt_client_discover_characteristics_for_handle_range_by_uuid16(
-                        gatt_client_callback, hid_state.gatt_handle,
-                        hid_state.hid_service_start, hid_state.hid_service_end,
-                        0x2A4D);  // HID Report UUID
+            ble_connection_t *conn = find_connection_by_handle(con_handle);
+            if (!conn) break;
+
+            if (hid_state.gatt_state == GATT_ENABLING_NOTIFICATIONS) {
+                // A rejected write means the handles moved
+                if (status != ATT_ERROR_SUCCESS || gatt_map.stale) {
+                    printf("[BTSTACK_HOST] GATT: Cached CCC write status=0x%02X\n", status);
+                    gatt_cached_fallback(conn);
+                } else if (++gatt_map.index < gatt_map.entry.num_reports) {
+                    gatt_client_write_value_of_characteristic(
+                        gatt_client_callback, con_handle, gatt_map.entry.reports[gatt_map.index].ccc_handle,
+                        sizeof(gatt_ccc_notify), gatt_ccc_notify);
                 } else {
-                    printf("[BTSTACK_HOST] No HID service found!\n");
+                    gatt_cached_ready(conn);
                 }
-            } else if (hid_state.gatt_state == GATT_DISCOVERING_HID_CHARACTERISTICS) {
-                if (hid_state.report_characteristic.value_handle != 0) {
-                    // Found Report char, enable notifications
-                    printf("[BTSTACK_HOST] Enabling notifications on 0x%04X (end=0x%04X)...\n",
-                           hid_state.report_characteristic.value_handle,
-                           hid_state.report_characteristic.end_handle);
-                    hid_state.gatt_state = GATT_ENABLING_NOTIFICATIONS;
-                    gatt_client_write_client_characteristic_configuration(
-                        gatt_client_callback, hid_state.gatt_handle,
-                        &hid_state.report_characteristic,
-                        GATT_CLIENT_CHARACTERISTICS_CONFIGURATION_NOTIFICATION);
+                break;
+            }
+
+            if (gatt_map.stale) {
+                // Database changed under us - record it on the next connection
+                hid_state.gatt_state = GATT_READY;
+                break;
+            }
+            if (status != ATT_ERROR_SUCCESS) {
+                if (hid_state.gatt_state == GATT_ENABLING_SERVICE_CHANGED) {
+                    // Store without change detection; a rejected CCC write still catches moved handles
+                    printf("[BTSTACK_HOST] GATT: Service Changed indications not enabled (0x%02X)\n", status);
+                    gatt_map_store();
                 } else {
-                    printf("[BTSTACK_HOST] No HID Report characteristic found!\n");
+                    printf("[BTSTACK_HOST] GATT: Handle map query failed, status=0x%02X gatt_state=%d\n",
+                           status, hid_state.gatt_state);
                 }
-            } else if (hid_state.gatt_state == GATT_ENABLING_NOTIFICATIONS) {
-                printf("[BTSTACK_HOST] Notifications enabled! Ready for HID reports.\n");
                 hid_state.gatt_state = GATT_READY;
+                break;
             }
-            break;
-        }
-
-        case GATT_EVENT_NOTIFICATION: {
-            hci_con_handle_t con_handle = gatt_event_notification_get_handle(packet);
-            uint16_t value_handle = gatt_event_notification_get_value_handle(packet);
-            uint16_t value_length = gatt_event_notification_get_value_length(packet);
-            const uint8_t *value = gatt_event_notification_get_value(packet);
-
-            // BLE HID Report characteristic (Xbox uses handle 0x001E)
-            // Route through bthid layer
-            if (value_handle == 0x001E && value_length >= 1) {
-                int conn_index = get_ble_conn_index_by_handle(con_handle);
-                if (conn_index >= 0) {
-                    route_ble_hid_report(conn_index, value, value_length);
-                }
+            if (!gatt_map_next(con_handle)) {
+                hid_state.gatt_state = GATT_READY;
             }
             break;
         }
@@ -1891,17 +2587,13 @@ static void ble_hid_notification_handler(uint8_t packet_type, uint16_t channel,
     }
 
     // Accept HID report notifications - filter by reasonable gamepad report length
-    if (value_length < 10 || value_length > sizeof(pending_ble_report)) return;
+    if (value_length < 10 || value_length > BLE_HID_REPORT_MAX) return;
 
     // Get conn_index for this BLE connection
     int conn_index = get_ble_conn_index_by_handle(con_handle);
     if (conn_index < 0) return;
 
-    // Defer processing to main loop to avoid stack overflow
-    memcpy(pending_ble_report, value, value_length);
-    pending_ble_report_len = value_length;
-    pending_ble_conn_index = (uint8_t)conn_index;
-    ble_report_pending = true;
+    bt_on_hid_input((uint8_t)conn_index, value, value_length);
 }
 
 // Register direct listener for BLE HID notifications and notify bthid layer
@@ -1975,19 +2667,92 @@ static void register_ble_hid_listener(hci_con_handle_t con_handle)
 #define SW2_SUBCMD_PAIRING_STEP3    0x02  // Send magic bytes 2
 #define SW2_SUBCMD_PAIRING_STEP4    0x03  // Complete pairing
 
-// Init state machine states (matching BlueRetro's sequence)
+// Init steps in the order they're sent (matching BlueRetro's sequence).
+// The player LED isn't one of them: switch2_handle_feedback sets it once
+// init is done, after input is already flowing.
 typedef enum {
     SW2_INIT_IDLE = 0,
     SW2_INIT_READ_INFO,             // Read device info from SPI
-    SW2_INIT_READ_LTK,              // Read LTK to check if paired
     SW2_INIT_PAIR_STEP1,            // Pairing step 1 (BD addr)
     SW2_INIT_PAIR_STEP2,            // Pairing step 2
     SW2_INIT_PAIR_STEP3,            // Pairing step 3
     SW2_INIT_PAIR_STEP4,            // Pairing step 4
-    SW2_INIT_SET_LED,               // Set player LED
     SW2_INIT_DONE                   // Init complete
 } sw2_init_state_t;
 
+// Init commands sent ahead of their ACKs. Commands are ATT write commands
+// and ACKs come back in order, so a step doesn't wait out the previous
+// step's round trip. 1 = lockstep.
+#ifndef SW2_INIT_WINDOW
+#define SW2_INIT_WINDOW 2
+#endif
+
+// Switch 2 init state machine
+static sw2_init_state_t sw2_init_state = SW2_INIT_IDLE;    // Oldest step not yet ACKed
+static sw2_init_state_t sw2_init_sent = SW2_INIT_IDLE;     // Newest step sent
+static hci_con_handle_t sw2_init_handle = 0;
+static bool sw2_led_sync = false;                           // Init done, player LED not sent yet
+
+// Controllers that completed the pairing steps with us. The pairing lives on
+// the controller, so a reconnect skips straight to done. One TLV tag, most
+// recent first; erased with the bonds.
+#define SW2_PAIRED_TAG  (((uint32_t)'S' << 24) | ((uint32_t)'W' << 16) | ((uint32_t)'2' << 8) | (uint32_t)'P')
+#define SW2_PAIRED_MAX  4
+
+static int switch2_paired_load(bd_addr_t list[SW2_PAIRED_MAX])
+{
+    const btstack_tlv_t* tlv = NULL;
+    void* context;
+    btstack_tlv_get_instance(&tlv, &context);
+    if (!tlv) return 0;
+
+    int size = tlv->get_tag(context, SW2_PAIRED_TAG, (uint8_t*)list, SW2_PAIRED_MAX * sizeof(bd_addr_t));
+    return size > 0 ? size / (int)sizeof(bd_addr_t) : 0;
+}
+
+static bool switch2_is_paired(const bd_addr_t addr)
+{
+    bd_addr_t list[SW2_PAIRED_MAX];
+    int count = switch2_paired_load(list);
+    for (int i = 0; i < count; i++) {
+        if (bd_addr_cmp(list[i], addr) == 0) return true;
+    }
+    return false;
+}
+
+static void switch2_remember_paired(const bd_addr_t addr)
+{
+    bd_addr_t list[SW2_PAIRED_MAX];
+    int count = switch2_paired_load(list);
+    if (count > 0 && bd_addr_cmp(list[0], addr) == 0) return;  // Already most recent
+
+    bd_addr_t updated[SW2_PAIRED_MAX];
+    int n = 0;
+    bd_addr_copy(updated[n++], addr);
+    for (int i = 0; i < count && n < SW2_PAIRED_MAX; i++) {
+        if (bd_addr_cmp(list[i], addr) != 0) {
+            bd_addr_copy(updated[n++], list[i]);
+        }
+    }
+
+    const btstack_tlv_t* tlv = NULL;
+    void* context;
+    btstack_tlv_get_instance(&tlv, &context);
+    if (tlv) {
+        tlv->store_tag(context, SW2_PAIRED_TAG, (const uint8_t*)updated, n * sizeof(bd_addr_t));
+    }
+}
+
+static void switch2_forget_paired(void)
+{
+    const btstack_tlv_t* tlv = NULL;
+    void* context;
+    btstack_tlv_get_instance(&tlv, &context);
+    if (tlv) {
+        tlv->delete_tag(context, SW2_PAIRED_TAG);
+    }
+}
+
 // Handle Switch 2 HID notifications
 static void switch2_hid_notification_handler(uint8_t packet_type, uint16_t channel, uint8_t *packet, uint16_t size)
 {
@@ -2016,21 +2781,27 @@ static void switch2_hid_notification_handler(uint8_t packet_type, uint16_t chann
 
     // Switch 2 input reports are 64 bytes on handle 0x000A
     if (value_handle != SW2_INPUT_REPORT_HANDLE) return;
-    if (value_length < 16 || value_length > sizeof(pending_ble_report)) return;
+    if (value_length < 16 || value_length > BLE_HID_REPORT_MAX) return;
 
     // Get conn_index for this BLE connection
     int conn_index = get_ble_conn_index_by_handle(con_handle);
     if (conn_index < 0) return;
 
-    // Defer processing to main loop to avoid stack overflow
-    memcpy(pending_ble_report, value, value_length);
-    pending_ble_report_len = value_length;
-    pending_ble_conn_index = (uint8_t)conn_index;
-    ble_report_pending = true;
+    ble_connection_t* conn = find_connection_by_handle(con_handle);
+    if (conn && !conn->input_seen) {
+        conn->input_seen = true;
+        uint32_t elapsed = btstack_run_loop_get_time_ms() - conn->connected_ms;
+        METRIC_OBSERVE(BT_SW2_FIRST_INPUT_MS, elapsed);
+        printf("[SW2_BLE] First input %lu ms after connect (init state=%d)\n",
+               (unsigned long)elapsed, sw2_init_state);
+    }
+
+    bt_on_hid_input((uint8_t)conn_index, value, value_length);
 }
 
 // Forward declarations for Switch 2
-static void switch2_send_next_init_cmd(hci_con_handle_t con_handle);
+static void switch2_ack_ccc_write_callback(uint8_t packet_type, uint16_t channel, uint8_t *packet, uint16_t size);
+static void switch2_init_start(hci_con_handle_t con_handle);
 
 // CCC write completion handler for Switch 2 input reports
 static void switch2_ccc_write_callback(uint8_t packet_type, uint16_t channel, uint8_t *packet, uint16_t size)
@@ -2062,6 +2833,12 @@ static void switch2_ccc_write_callback(uint8_t packet_type, uint16_t channel, ui
     } else {
         printf("[SW2_BLE] Failed to enable input notifications: status=0x%02X\n", status);
     }
+
+    // Input is on its way; now the command/ACK channel for init and feedback
+    static uint8_t ccc_enable[] = { 0x01, 0x00 };
+    printf("[SW2_BLE] Enabling ACK notifications on CCC handle 0x%04X\n", SW2_ACK_CCC_HANDLE);
+    gatt_client_write_value_of_characteristic(
+        switch2_ack_ccc_write_callback, handle, SW2_ACK_CCC_HANDLE, sizeof(ccc_enable), ccc_enable);
 }
 
 // CCC write completion handler for Switch 2 ACK notifications
@@ -2078,31 +2855,34 @@ static void switch2_ack_ccc_write_callback(uint8_t packet_type, uint16_t channel
 
     if (status == ATT_ERROR_SUCCESS) {
         printf("[SW2_BLE] ACK notifications enabled for handle 0x%04X\n", handle);
-
-        // Now enable input report notifications
-        static uint8_t ccc_enable[] = { 0x01, 0x00 };
-        printf("[SW2_BLE] Enabling input notifications on CCC handle 0x%04X\n", SW2_CCC_HANDLE);
-        gatt_client_write_value_of_characteristic(
-            switch2_ccc_write_callback, handle, SW2_CCC_HANDLE, sizeof(ccc_enable), ccc_enable);
-
-        // Start the pairing sequence
-        printf("[SW2_BLE] Starting pairing sequence\n");
-        switch2_send_next_init_cmd(handle);
+        switch2_init_start(handle);
     } else {
         printf("[SW2_BLE] Failed to enable ACK notifications: status=0x%02X\n", status);
     }
 }
 
-// Switch 2 init state machine
-static sw2_init_state_t sw2_init_state = SW2_INIT_IDLE;
-static hci_con_handle_t sw2_init_handle = 0;
-
 // ACK notification listener for Switch 2 commands
 static gatt_client_notification_t switch2_ack_notification_listener;
 static gatt_client_characteristic_t switch2_ack_characteristic;
 
 // Forward declare
-static void switch2_send_init_cmd(hci_con_handle_t con_handle);
+static void switch2_init_pump(hci_con_handle_t con_handle);
+static void switch2_init_done(hci_con_handle_t con_handle, bool paired);
+
+// Init step an ACK answers (IDLE if it isn't an init command's)
+static sw2_init_state_t switch2_ack_step(uint8_t cmd, uint8_t subcmd)
+{
+    if (cmd == SW2_CMD_READ_SPI) return SW2_INIT_READ_INFO;
+    if (cmd != SW2_CMD_PAIRING) return SW2_INIT_IDLE;
+
+    switch (subcmd) {
+        case SW2_SUBCMD_PAIRING_STEP1: return SW2_INIT_PAIR_STEP1;
+        case SW2_SUBCMD_PAIRING_STEP2: return SW2_INIT_PAIR_STEP2;
+        case SW2_SUBCMD_PAIRING_STEP3: return SW2_INIT_PAIR_STEP3;
+        case SW2_SUBCMD_PAIRING_STEP4: return SW2_INIT_PAIR_STEP4;
+        default:                       return SW2_INIT_IDLE;
+    }
+}
 
 static void switch2_ack_notification_handler(uint8_t packet_type, uint16_t channel, uint8_t *packet, uint16_t size)
 {
@@ -2134,70 +2914,34 @@ static void switch2_ack_notification_handler(uint8_t packet_type, uint16_t chann
     printf("[SW2_BLE] ACK: cmd=0x%02X subcmd=0x%02X state=%d len=%d\n",
            cmd, subcmd, sw2_init_state, value_length);
 
-    // Handle ACK based on current init state
-    switch (cmd) {
-        case SW2_CMD_READ_SPI:
-            if (sw2_init_state == SW2_INIT_READ_INFO) {
-                // Got device info, extract VID/PID if needed
-                if (value_length >= 34) {
-                    uint16_t vid = value[30] | (value[31] << 8);
-                    uint16_t pid = value[32] | (value[33] << 8);
-                    printf("[SW2_BLE] Device info: VID=0x%04X PID=0x%04X\n", vid, pid);
-                }
-                // Skip LTK check for now, go straight to pairing
-                sw2_init_state = SW2_INIT_PAIR_STEP1;
-                switch2_send_init_cmd(con_handle);
-            } else if (sw2_init_state == SW2_INIT_READ_LTK) {
-                // Check LTK, for now just proceed to pairing
-                sw2_init_state = SW2_INIT_PAIR_STEP1;
-                switch2_send_init_cmd(con_handle);
-            }
-            break;
+    sw2_init_state_t step = switch2_ack_step(cmd, subcmd);
+    if (step == SW2_INIT_IDLE || sw2_init_state == SW2_INIT_DONE ||
+        step < sw2_init_state || step > sw2_init_sent) {
+        return;     // Not an outstanding init step (feedback ACK, duplicate from a retry)
+    }
 
-        case SW2_CMD_PAIRING:
-            switch (subcmd) {
-                case SW2_SUBCMD_PAIRING_STEP1:
-                    if (sw2_init_state == SW2_INIT_PAIR_STEP1) {
-                        sw2_init_state = SW2_INIT_PAIR_STEP2;
-                        switch2_send_init_cmd(con_handle);
-                    }
-                    break;
-                case SW2_SUBCMD_PAIRING_STEP2:
-                    if (sw2_init_state == SW2_INIT_PAIR_STEP2) {
-                        sw2_init_state = SW2_INIT_PAIR_STEP3;
-                        switch2_send_init_cmd(con_handle);
-                    }
-                    break;
-                case SW2_SUBCMD_PAIRING_STEP3:
-                    if (sw2_init_state == SW2_INIT_PAIR_STEP3) {
-                        sw2_init_state = SW2_INIT_PAIR_STEP4;
-                        switch2_send_init_cmd(con_handle);
-                    }
-                    break;
-                case SW2_SUBCMD_PAIRING_STEP4:
-                    if (sw2_init_state == SW2_INIT_PAIR_STEP4) {
-                        printf("[SW2_BLE] Pairing complete! Setting LED...\n");
-                        sw2_init_state = SW2_INIT_SET_LED;
-                        switch2_send_init_cmd(con_handle);
-                    }
-                    break;
-            }
-            break;
+    if (step == SW2_INIT_READ_INFO && value_length >= 34) {
+        uint16_t vid = value[30] | (value[31] << 8);
+        uint16_t pid = value[32] | (value[33] << 8);
+        printf("[SW2_BLE] Device info: VID=0x%04X PID=0x%04X\n", vid, pid);
+    }
 
-        case SW2_CMD_SET_LED:
-            if (sw2_init_state == SW2_INIT_SET_LED) {
-                printf("[SW2_BLE] LED set! Init done.\n");
-                sw2_init_state = SW2_INIT_DONE;
-            }
-            break;
+    // ACKs come back in order, so this one covers any step before it too
+    sw2_init_state = (sw2_init_state_t)(step + 1);
+    if (sw2_init_state == SW2_INIT_DONE) {
+        printf("[SW2_BLE] Pairing complete!\n");
+        switch2_init_done(con_handle, true);
+    } else {
+        switch2_init_pump(con_handle);
     }
 }
 
-static void switch2_send_init_cmd(hci_con_handle_t con_handle)
+// Send one init step's command. Non-zero if it couldn't go out (ACL buffers full).
+static uint8_t switch2_send_init_cmd(hci_con_handle_t con_handle, sw2_init_state_t step)
 {
-    printf("[SW2_BLE] Sending init cmd, state=%d\n", sw2_init_state);
+    printf("[SW2_BLE] Sending init cmd, step=%d\n", step);
 
-    switch (sw2_init_state) {
+    switch (step) {
         case SW2_INIT_READ_INFO: {
             // Read device info from SPI (BlueRetro's first step)
             uint8_t read_info[] = {
@@ -2210,10 +2954,8 @@ static void switch2_send_init_cmd(hci_con_handle_t con_handle)
                 0x7e, 0x00, 0x00,       // Address type
                 0x00, 0x30, 0x01, 0x00  // SPI address
             };
-            gatt_client_write_value_of_characteristic_without_response(
+            return gatt_client_write_value_of_characteristic_without_response(
                 con_handle, SW2_CMD_HANDLE, sizeof(read_info), read_info);
-            printf("[SW2_BLE] READ_INFO sent\n");
-            break;
         }
 
         case SW2_INIT_PAIR_STEP1: {
@@ -2237,9 +2979,8 @@ static void switch2_send_init_cmd(hci_con_handle_t con_handle)
                 (uint8_t)(local_addr[0] - 1), local_addr[1], local_addr[2],
                 local_addr[3], local_addr[4], local_addr[5],
             };
-            gatt_client_write_value_of_characteristic_without_response(
+            return gatt_client_write_value_of_characteristic_without_response(
                 con_handle, SW2_CMD_HANDLE, sizeof(pair1), pair1);
-            break;
         }
 
         case SW2_INIT_PAIR_STEP2: {
@@ -2253,10 +2994,8 @@ static void switch2_send_init_cmd(hci_con_handle_t con_handle)
                 0xea, 0xbd, 0x47, 0x13, 0x89, 0x35, 0x42, 0xc6,
                 0x79, 0xee, 0x07, 0xf2, 0x53, 0x2c, 0x6c, 0x31
             };
-            gatt_client_write_value_of_characteristic_without_response(
+            return gatt_client_write_value_of_characteristic_without_response(
                 con_handle, SW2_CMD_HANDLE, sizeof(pair2), pair2);
-            printf("[SW2_BLE] Pair Step 2 sent\n");
-            break;
         }
 
         case SW2_INIT_PAIR_STEP3: {
@@ -2270,10 +3009,8 @@ static void switch2_send_init_cmd(hci_con_handle_t con_handle)
                 0x40, 0xb0, 0x8a, 0x5f, 0xcd, 0x1f, 0x9b, 0x41,
                 0x12, 0x5c, 0xac, 0xc6, 0x3f, 0x38, 0xa0, 0x73
             };
-            gatt_client_write_value_of_characteristic_without_response(
+            return gatt_client_write_value_of_characteristic_without_response(
                 con_handle, SW2_CMD_HANDLE, sizeof(pair3), pair3);
-            printf("[SW2_BLE] Pair Step 3 sent\n");
-            break;
         }
 
         case SW2_INIT_PAIR_STEP4: {
@@ -2285,48 +3022,69 @@ static void switch2_send_init_cmd(hci_con_handle_t con_handle)
                 SW2_SUBCMD_PAIRING_STEP4, // 0x03
                 0x00, 0x01, 0x00, 0x00, 0x00
             };
-            gatt_client_write_value_of_characteristic_without_response(
+            return gatt_client_write_value_of_characteristic_without_response(
                 con_handle, SW2_CMD_HANDLE, sizeof(pair4), pair4);
-            printf("[SW2_BLE] Pair Step 4 sent\n");
-            break;
         }
 
-        case SW2_INIT_SET_LED: {
-            // Set player LED
-            uint8_t led_cmd[] = {
-                SW2_CMD_SET_LED,        // 0x09
-                SW2_REQ_TYPE_REQ,       // 0x91
-                SW2_REQ_INT_BLE,        // 0x01
-                SW2_SUBCMD_SET_LED,     // 0x07
-                0x00, 0x08, 0x00, 0x00,
-                0x01,  // Player 1 LED pattern
-                0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-            };
-            gatt_client_write_value_of_characteristic_without_response(
-                con_handle, SW2_CMD_HANDLE, sizeof(led_cmd), led_cmd);
-            printf("[SW2_BLE] LED command sent\n");
-            break;
+        default:
+            printf("[SW2_BLE] Unknown init step: %d\n", step);
+            return ERROR_CODE_SUCCESS;
+    }
+}
+
+// Send init steps until SW2_INIT_WINDOW are waiting on ACKs
+static void switch2_init_pump(hci_con_handle_t con_handle)
+{
+    while (sw2_init_sent < SW2_INIT_PAIR_STEP4) {
+        int in_flight = sw2_init_sent >= sw2_init_state ? sw2_init_sent - sw2_init_state + 1 : 0;
+        if (in_flight >= SW2_INIT_WINDOW) break;
+
+        sw2_init_state_t next = (sw2_init_state_t)(sw2_init_sent + 1);
+        if (switch2_send_init_cmd(con_handle, next) != ERROR_CODE_SUCCESS) {
+            break;  // No ACL buffer; the main loop tops the window up again
         }
+        sw2_init_sent = next;
+    }
+}
 
-        default:
-            printf("[SW2_BLE] Unknown init state: %d\n", sw2_init_state);
-            break;
+static void switch2_init_done(hci_con_handle_t con_handle, bool paired)
+{
+    sw2_init_state = SW2_INIT_DONE;
+    sw2_led_sync = true;
+
+    ble_connection_t* conn = find_connection_by_handle(con_handle);
+    if (!conn) return;
+    if (paired) {
+        switch2_remember_paired(conn->addr);
     }
+    printf("[SW2_BLE] Init done %lu ms after connect\n",
+           (unsigned long)(btstack_run_loop_get_time_ms() - conn->connected_ms));
 }
 
-static void switch2_send_next_init_cmd(hci_con_handle_t con_handle)
+static void switch2_init_start(hci_con_handle_t con_handle)
 {
-    // Start the init sequence with READ_INFO (like BlueRetro does)
-    if (sw2_init_state == SW2_INIT_IDLE) {
-        printf("[SW2_BLE] Starting init sequence with READ_INFO...\n");
-        sw2_init_state = SW2_INIT_READ_INFO;
-        switch2_send_init_cmd(con_handle);
-    } else if (sw2_init_state == SW2_INIT_DONE) {
+    if (sw2_init_state == SW2_INIT_DONE) {
         printf("[SW2_BLE] Init already done\n");
-    } else {
-        // Init in progress, wait for ACK
+        return;
+    }
+    if (sw2_init_state != SW2_INIT_IDLE) {
         printf("[SW2_BLE] Init in progress (state=%d)\n", sw2_init_state);
+        return;
+    }
+
+    // Paired with us in an earlier session: nothing to redo (READ_INFO is only logged)
+    ble_connection_t* conn = find_connection_by_handle(con_handle);
+    if (conn && switch2_is_paired(conn->addr)) {
+        printf("[SW2_BLE] Controller already paired - skipping init sequence\n");
+        switch2_init_done(con_handle, false);
+        return;
     }
+
+    // Start the init sequence with READ_INFO (like BlueRetro does)
+    printf("[SW2_BLE] Starting init sequence with READ_INFO (window %d)...\n", SW2_INIT_WINDOW);
+    sw2_init_state = SW2_INIT_READ_INFO;
+    sw2_init_sent = SW2_INIT_IDLE;
+    switch2_init_pump(con_handle);
 }
 
 // Retry init if stuck (called from main loop)
@@ -2336,11 +3094,15 @@ static void switch2_retry_init_if_needed(void)
     retry_counter++;
 
     if (sw2_init_state != SW2_INIT_IDLE && sw2_init_state != SW2_INIT_DONE && sw2_init_handle != 0) {
-        // Retry every ~500ms (assuming ~120Hz main loop = 60 counts)
+        // Refill a window that stopped short on ACL buffers
+        switch2_init_pump(sw2_init_handle);
+
+        // Retry every ~500ms (assuming ~120Hz main loop = 60 counts), from the oldest unACKed step
         if (retry_counter % 60 == 0) {
             printf("[SW2_BLE] Retrying init cmd (state=%d, attempt=%lu)\n",
                    sw2_init_state, (unsigned long)(retry_counter / 60));
-            switch2_send_init_cmd(sw2_init_handle);
+            sw2_init_sent = (sw2_init_state_t)(sw2_init_state - 1);
+            switch2_init_pump(sw2_init_handle);
         }
     }
 }
@@ -2479,7 +3241,9 @@ static void switch2_handle_feedback(void)
     if (!fb) return;
 
     // --- Handle Player LED ---
-    if (fb->led_dirty) {
+    // (sw2_led_sync: first LED after init, which no longer sets one itself)
+    if (fb->led_dirty || sw2_led_sync) {
+        sw2_led_sync = false;
         // Determine LED pattern from feedback
         uint8_t led_pattern = 0x01;  // Default to player 1
 
@@ -2551,6 +3315,9 @@ static void register_switch2_hid_listener(hci_con_handle_t con_handle)
     conn->hid_ready = true;
     sw2_init_handle = con_handle;
     sw2_init_state = SW2_INIT_IDLE;
+    sw2_init_sent = SW2_INIT_IDLE;
+    sw2_led_sync = false;
+    sw2_last_player_led = 0;
 
     printf("[SW2_BLE] Connection: VID=0x%04X PID=0x%04X conn_index=%d\n",
            conn->vid, conn->pid, conn->conn_index);
@@ -2579,11 +3346,12 @@ static void register_switch2_hid_listener(hci_con_handle_t con_handle)
 
     printf("[SW2_BLE] Notification listeners registered\n");
 
-    // Enable notifications on ACK handle first (0x001B) - wait for confirmation
+    // Input notifications first (0x000B), so reports flow one round trip
+    // sooner; the ACK CCC and init follow from its completion
     static uint8_t ccc_enable[] = { 0x01, 0x00 };
-    printf("[SW2_BLE] Enabling ACK notifications on CCC handle 0x%04X\n", SW2_ACK_CCC_HANDLE);
+    printf("[SW2_BLE] Enabling input notifications on CCC handle 0x%04X\n", SW2_CCC_HANDLE);
     gatt_client_write_value_of_characteristic(
-        switch2_ack_ccc_write_callback, con_handle, SW2_ACK_CCC_HANDLE, sizeof(ccc_enable), ccc_enable);
+        switch2_ccc_write_callback, con_handle, SW2_CCC_HANDLE, sizeof(ccc_enable), ccc_enable);
 }
 
 static void start_hids_client(ble_connection_t *conn)
@@ -2633,6 +3401,12 @@ static void hids_client_handler(uint8_t packet_type, uint16_t channel, uint8_t *
                     printf("[BTSTACK_HOST] Calling bt_on_hid_ready(%d) for BLE device '%s'\n",
                            conn->conn_index, conn->name);
                     bt_on_hid_ready(conn->conn_index);
+
+                    // hids_client puts the report ID in front of every report
+                    bthid_set_report_descriptor(conn->conn_index,
+                            hids_client_descriptor_storage_get_descriptor_data(hid_state.hids_cid, 0),
+                            hids_client_descriptor_storage_get_descriptor_len(hid_state.hids_cid, 0),
+                            true);
                 }
 
                 // Explicitly enable notifications
@@ -2647,6 +3421,12 @@ static void hids_client_handler(uint8_t packet_type, uint16_t channel, uint8_t *
             uint8_t configuration = gattservice_subevent_hid_service_reports_notification_get_configuration(packet);
             printf("[BTSTACK_HOST] HID Reports Notification configured: %d\n", configuration);
             printf("[BTSTACK_HOST] Ready to receive HID reports!\n");
+
+            // Reports are flowing; record the handles so the next reconnect skips discovery
+            ble_connection_t *conn = find_connection_by_handle(hid_state.gatt_handle);
+            if (conn) {
+                gatt_map_start(conn);
+            }
             break;
         }
 
@@ -2657,7 +3437,7 @@ static void hids_client_handler(uint8_t packet_type, uint16_t channel, uint8_t *
             // Route BLE HID report through bthid layer
             int conn_index = get_ble_conn_index_by_handle(hid_state.gatt_handle);
             if (conn_index >= 0) {
-                route_ble_hid_report(conn_index, report, report_len);
+                bt_on_hid_input(conn_index, report, report_len);
             }
 
             // Forward to callback if set
@@ -2800,6 +3580,7 @@ static void hid_host_packet_handler(uint8_t packet_type, uint16_t channel, uint8
                             printf("[BTSTACK_HOST] Using pending VID/PID: 0x%04X/0x%04X\n",
                                    conn->vendor_id, conn->product_id);
                         }
+                        conn->sdp_cached = classic_state.pending_cached;
                         // DON'T clear pending_valid here - PIN code request may come after this
                         // It will be cleared in HID_SUBEVENT_CONNECTION_OPENED
                         printf("[BTSTACK_HOST] Using pending COD: 0x%06X\n", (unsigned)classic_state.pending_cod);
@@ -2839,6 +3620,7 @@ static void hid_host_packet_handler(uint8_t packet_type, uint16_t channel, uint8
             classic_connection_t* conn = find_classic_connection_by_cid(hid_cid);
             if (conn) {
                 conn->hid_ready = true;
+                link_policy_open(conn, hid_subevent_connection_opened_get_con_handle(packet));
 
                 // Check if this is a Wiimote by COD or name
                 // Wiimotes don't send standard HID descriptors, so we need to
@@ -2909,6 +3691,23 @@ static void hid_host_packet_handler(uint8_t packet_type, uint16_t channel, uint8
                             printf("[BTSTACK_HOST] Wiimote: waiting for L2CAP CIDs before ready\n");
                         }
                     }
+                } else if (conn->sdp_cached) {
+                    // Known device: ready now from the SDP cache instead of after
+                    // hid_host's descriptor query, then re-check PnP behind it
+                    int conn_index = get_classic_conn_index(hid_cid);
+                    if (conn_index >= 0) {
+                        printf("[BTSTACK_HOST] Calling bt_on_hid_ready(%d) from SDP cache\n", conn_index);
+                        conn->ready_notified = true;
+                        bt_on_hid_ready(conn_index);
+
+                        // Descriptor fingerprint until hid_host has the real one
+                        sdp_cache_entry_t cached;
+                        if (sdp_cache_lookup(conn->addr, &cached)) {
+                            bthid_set_report_descriptor_hash(conn_index, cached.descriptor_hash,
+                                                             cached.descriptor_len, false);
+                        }
+                    }
+                    sdp_revalidate(conn);
                 } else {
                     // For non-Wiimote devices, query SDP for VID/PID if we don't have it
                     if (conn->vendor_id == 0 && conn->product_id == 0) {
@@ -2944,12 +3743,35 @@ static void hid_host_packet_handler(uint8_t packet_type, uint16_t channel, uint8
                 break;
             }
 
-            // Notify bthid layer that device is ready (non-Wiimote devices)
+            // Cache the descriptor's fingerprint with the PnP results for the
+            // next reconnect (on a cache hit this revalidates the entry)
+            classic_connection_t* conn = find_classic_connection_by_cid(hid_cid);
+            if (conn && status == ERROR_CODE_SUCCESS) {
+                uint16_t desc_len = hid_descriptor_storage_get_descriptor_len(hid_cid);
+                uint32_t desc_hash = hid_parse_cache_hash(
+                        hid_descriptor_storage_get_descriptor_data(hid_cid), desc_len);
+                conn->descriptor_len = desc_len;
+                conn->descriptor_hash = desc_hash;
+                classic_sdp_cache_save(conn);
+            }
+
+            // Notify bthid layer that device is ready (non-Wiimote devices),
+            // unless that happened at CONNECTION_OPENED (SDP cache hit)
             int conn_index = get_classic_conn_index(hid_cid);
-            if (conn_index >= 0) {
+            if (conn_index < 0) {
+                break;
+            }
+            if (!conn || !conn->ready_notified) {
                 printf("[BTSTACK_HOST] Calling bt_on_hid_ready(%d)\n", conn_index);
+                if (conn) conn->ready_notified = true;
                 bt_on_hid_ready(conn_index);
             }
+
+            if (status == ERROR_CODE_SUCCESS) {
+                bthid_set_report_descriptor(conn_index,
+                        hid_descriptor_storage_get_descriptor_data(hid_cid),
+                        hid_descriptor_storage_get_descriptor_len(hid_cid), false);
+            }
             break;
         }
 
@@ -2970,6 +3792,7 @@ static void hid_host_packet_handler(uint8_t packet_type, uint16_t channel, uint8
             // BTstack report already includes 0xA1 header (DATA|INPUT)
             int conn_index = get_classic_conn_index(hid_cid);
             if (conn_index >= 0 && report_len > 0) {
+                link_policy_input(&classic_state.connections[conn_index]);
                 bt_on_hid_report(conn_index, report, report_len);
             }
             break;
@@ -3082,6 +3905,7 @@ static void wiimote_l2cap_packet_handler(uint8_t packet_type, uint16_t channel,
                                 conn->product_id = 0x0306;
                             }
                             conn->hid_ready = true;
+                            link_policy_open(conn, wiimote_conn.acl_handle);
 
                             // Get index
                             for (int i = 0; i < MAX_CLASSIC_CONNECTIONS; i++) {
@@ -3141,6 +3965,7 @@ static void wiimote_l2cap_packet_handler(uint8_t packet_type, uint16_t channel,
             if (wiimote_conn.active && wiimote_conn.state == WIIMOTE_STATE_CONNECTED) {
                 // Route to bthid layer
                 if (wiimote_conn.conn_index >= 0 && size > 0) {
+                    link_policy_input(&classic_state.connections[wiimote_conn.conn_index]);
                     bt_on_hid_report(wiimote_conn.conn_index, packet, size);
                 }
             } else {
@@ -3440,6 +4265,9 @@ void btstack_host_delete_all_bonds(void)
 #else
     // For CYW43, use BTstack's standard APIs
     gap_delete_all_link_keys();
+    sdp_cache_clear();
+    gatt_cache_clear();
+    switch2_forget_paired();
     printf("[BTSTACK_HOST] Classic BT link keys deleted\n");
 
     int ble_count = le_device_db_count();
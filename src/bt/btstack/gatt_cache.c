@@ -0,0 +1,116 @@
+// gatt_cache.c - Per-device cache of BLE HID attribute handles in BTstack TLV flash
+
+#include "gatt_cache.h"
+#include "tlv_slots.h"
+#include "btstack_util.h"
+#include <string.h>
+#include <stdio.h>
+
+// TLV tags 'GHC0'.. - one per slot (sdp_cache uses 'SDC0'..)
+#define GATT_CACHE_TAG(slot)  (((uint32_t)'G' << 24) | ((uint32_t)'H' << 16) | \
+                               ((uint32_t)'C' << 8) | (uint32_t)('0' + (slot)))
+
+// 'GHP0'.. - the device's compiled report map, too big to share its record
+#define GATT_CACHE_PROGRAM_TAG(slot)  (((uint32_t)'G' << 24) | ((uint32_t)'H' << 16) | \
+                                       ((uint32_t)'P' << 8) | (uint32_t)('0' + (slot)))
+
+// Bump when gatt_cache_entry_t changes; older records read as misses.
+// 2: entries are recorded together with the compiled report map.
+#define GATT_CACHE_VERSION 2
+
+// Bump when hid_parse_cache_entry_t / hid_extract_program_t change
+#define GATT_CACHE_PROGRAM_VERSION 1
+
+typedef struct {
+    tlv_slot_header_t header;
+    gatt_cache_entry_t entry;
+} gatt_cache_record_t;
+
+_Static_assert(sizeof(gatt_cache_record_t) <= TLV_SLOTS_RECORD_MAX, "gatt_cache record too large");
+
+static const tlv_slots_t gatt_cache_slots = {
+    .tag = GATT_CACHE_TAG(0),
+    .slots = GATT_CACHE_SLOTS,
+    .version = GATT_CACHE_VERSION,
+    .record_size = sizeof(gatt_cache_record_t),
+};
+
+typedef struct {
+    tlv_slot_header_t header;
+    bd_addr_t addr;
+    uint8_t reserved[2];
+    hid_parse_cache_entry_t compiled;
+} gatt_cache_program_record_t;
+
+_Static_assert(sizeof(gatt_cache_program_record_t) <= TLV_SLOTS_RECORD_MAX,
+               "gatt_cache program record too large");
+
+static const tlv_slots_t gatt_cache_program_slots = {
+    .tag = GATT_CACHE_PROGRAM_TAG(0),
+    .slots = GATT_CACHE_SLOTS,
+    .version = GATT_CACHE_PROGRAM_VERSION,
+    .record_size = sizeof(gatt_cache_program_record_t),
+};
+
+// ============================================================================
+// PUBLIC API
+// ============================================================================
+
+bool gatt_cache_lookup(const bd_addr_t addr, gatt_cache_entry_t* entry)
+{
+    gatt_cache_record_t record;
+    if (tlv_slots_find(&gatt_cache_slots, addr, &record) < 0) return false;
+    if (record.entry.num_reports > GATT_CACHE_MAX_REPORTS) return false;
+
+    *entry = record.entry;
+    return true;
+}
+
+void gatt_cache_store(const gatt_cache_entry_t* entry)
+{
+    gatt_cache_record_t record;
+    memset(&record, 0, sizeof(record));
+    memcpy(&record.entry, entry, sizeof(*entry));
+    int slot = tlv_slots_store(&gatt_cache_slots, &record);
+    if (slot < 0) return;
+
+    printf("[GATT_CACHE] Stored %s in slot %d: %d input reports, report map %u bytes\n",
+           bd_addr_to_str(entry->addr), slot, entry->num_reports, entry->report_map_len);
+}
+
+bool gatt_cache_lookup_program(const bd_addr_t addr, hid_parse_cache_entry_t* compiled)
+{
+    gatt_cache_program_record_t record;
+    if (tlv_slots_find(&gatt_cache_program_slots, addr, &record) < 0) return false;
+
+    *compiled = record.compiled;
+    return true;
+}
+
+void gatt_cache_store_program(const bd_addr_t addr, const hid_parse_cache_entry_t* compiled)
+{
+    gatt_cache_program_record_t record;
+    memset(&record, 0, sizeof(record));
+    memcpy(record.addr, addr, 6);
+    memcpy(&record.compiled, compiled, sizeof(*compiled));
+    int slot = tlv_slots_store(&gatt_cache_program_slots, &record);
+    if (slot < 0) return;
+
+    printf("[GATT_CACHE] Stored compiled report map for %s in slot %d: %d ops\n",
+           bd_addr_to_str(addr), slot, compiled->prog.op_count);
+}
+
+void gatt_cache_remove(const bd_addr_t addr)
+{
+    gatt_cache_record_t record;
+    tlv_slots_delete(&gatt_cache_slots, tlv_slots_find(&gatt_cache_slots, addr, &record));
+
+    gatt_cache_program_record_t program;
+    tlv_slots_delete(&gatt_cache_program_slots, tlv_slots_find(&gatt_cache_program_slots, addr, &program));
+}
+
+void gatt_cache_clear(void)
+{
+    tlv_slots_clear(&gatt_cache_slots);
+    tlv_slots_clear(&gatt_cache_program_slots);
+}
@@ -0,0 +1,67 @@
+// gatt_cache.h - Per-device cache of BLE HID attribute handles in BTstack TLV flash
+//
+// A bonded BLE pad that goes through hids_client pays for full GATT
+// discovery (services, characteristics, descriptors, report map) on every
+// reconnect before its first report. Discovery doesn't change between
+// connections, so the first connection records what it found:
+//   - HID service range
+//   - input report characteristics: value handle, CCC handle, report ID
+//   - Service Changed characteristic value handle
+//   - report map length and hash
+//   - the report map compiled by bthid (its hid_parse_cache entry), kept in
+//     a record of its own since hid_parse_cache is RAM-only by default
+// On reconnect btstack_host writes the cached CCCs directly and listens on
+// the cached value handles. A failed CCC write or a Service Changed
+// indication drops the entry and falls back to full discovery.
+//
+// Entries live in the same TLV store as the bonds and are erased with them.
+
+#ifndef GATT_CACHE_H
+#define GATT_CACHE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "bluetooth.h"
+#include "usb/usbh/hid/devices/generic/hid_parse_cache.h"
+
+#ifndef GATT_CACHE_SLOTS
+#define GATT_CACHE_SLOTS 4          // NVM_NUM_DEVICE_DB_ENTRIES
+#endif
+
+#define GATT_CACHE_MAX_REPORTS 4    // Input reports per device
+
+typedef struct {
+    uint16_t value_handle;
+    uint16_t ccc_handle;
+    uint8_t report_id;
+    uint8_t reserved;
+} gatt_cache_report_t;
+
+typedef struct {
+    bd_addr_t addr;
+    uint8_t num_reports;
+    uint8_t reserved;
+    uint16_t hid_service_start;
+    uint16_t hid_service_end;
+    uint16_t service_changed_handle;    // 0 = server has none
+    uint16_t report_map_len;
+    uint32_t report_map_hash;
+    gatt_cache_report_t reports[GATT_CACHE_MAX_REPORTS];
+} gatt_cache_entry_t;
+
+// Fill *entry for a device. False on miss.
+bool gatt_cache_lookup(const bd_addr_t addr, gatt_cache_entry_t* entry);
+
+// Store/refresh a device's entry (zero it before filling in). Writes flash
+// only when something changed.
+void gatt_cache_store(const gatt_cache_entry_t* entry);
+
+// The compiled report map stored for a device (false on miss) / store it
+bool gatt_cache_lookup_program(const bd_addr_t addr, hid_parse_cache_entry_t* compiled);
+void gatt_cache_store_program(const bd_addr_t addr, const hid_parse_cache_entry_t* compiled);
+
+// Forget one device (handles went stale, bond deleted) / every device
+void gatt_cache_remove(const bd_addr_t addr);
+void gatt_cache_clear(void);
+
+#endif // GATT_CACHE_H
@@ -0,0 +1,187 @@
+// hci_capture.c - HCI packet capture in PacketLogger format
+
+#include "hci_capture.h"
+#include "btstack_config.h"
+#include "btstack_defines.h"
+#include "bluetooth.h"
+#include "hci_dump.h"
+#include "core/services/metrics/metrics.h"
+#include "hardware/sync.h"
+#include "hardware/watchdog.h"
+#include "pico/time.h"
+#include <stdarg.h>
+#include <string.h>
+#include <stdio.h>
+
+#if (HCI_CAPTURE_BUFFER_SIZE & (HCI_CAPTURE_BUFFER_SIZE - 1)) != 0
+#error "HCI_CAPTURE_BUFFER_SIZE must be a power of two"
+#endif
+
+// Watchdog scratch 0-3 are free for the application (4-7 belong to the bootrom)
+#define HCI_CAPTURE_SCRATCH     3
+#define HCI_CAPTURE_BOOT_MAGIC  0x48434943  // "HCIC"
+
+// ============================================================================
+// STATE
+// ============================================================================
+
+// head/tail run freely; the ring index is the low bits. BTstack writes head
+// (from the CYW43 async context on Pico W), the CDC task reads tail.
+static struct {
+    volatile bool active;
+    volatile uint32_t head;
+    volatile uint32_t tail;
+    uint32_t packets;
+    uint32_t dropped;
+    bool registered;
+} capture;
+
+static uint8_t ring[HCI_CAPTURE_BUFFER_SIZE];
+
+// ============================================================================
+// HCI DUMP INSTANCE
+// ============================================================================
+
+static void ring_write(uint32_t pos, const uint8_t* data, uint32_t len)
+{
+    uint32_t idx = pos & (HCI_CAPTURE_BUFFER_SIZE - 1);
+    uint32_t first = HCI_CAPTURE_BUFFER_SIZE - idx;
+    if (first > len) first = len;
+    memcpy(&ring[idx], data, first);
+    memcpy(ring, data + first, len - first);
+}
+
+static void capture_log_packet(uint8_t packet_type, uint8_t in, uint8_t* packet, uint16_t len)
+{
+    if (!capture.active) return;
+
+    // Stack-internal events (0x60-0xFE) are generated on the host, not received
+    if (packet_type == HCI_EVENT_PACKET && len > 0 &&
+        packet[0] >= BTSTACK_EVENT_STATE && packet[0] != HCI_EVENT_VENDOR_SPECIFIC) {
+        return;
+    }
+
+    uint8_t header[HCI_DUMP_HEADER_SIZE_PACKETLOGGER];
+    uint64_t now = time_us_64();
+    uint16_t header_len = hci_dump_setup_header_packetlogger(header,
+            (uint32_t)(now / 1000000), (uint32_t)(now % 1000000), packet_type, in, len);
+    if (header_len == 0) return;    // No PacketLogger type for this packet
+
+    uint32_t head = capture.head;
+    uint32_t need = header_len + len;
+    if (HCI_CAPTURE_BUFFER_SIZE - (head - capture.tail) < need) {
+        capture.dropped++;
+        METRIC_INC(BT_HCI_CAPTURE_DROPS);
+        return;
+    }
+
+    ring_write(head, header, header_len);
+    ring_write(head + header_len, packet, len);
+    __dmb();    // Record complete before the reader can see it
+    capture.head = head + need;
+    capture.packets++;
+}
+
+static void capture_log_message(int log_level, const char* format, va_list argptr)
+{
+    // Log lines stay on the debug console; the capture holds packets only
+    (void)log_level;
+    (void)format;
+    (void)argptr;
+}
+
+static void capture_reset(void)
+{
+}
+
+static const hci_dump_t hci_capture_dump = {
+    .reset = capture_reset,
+    .log_packet = capture_log_packet,
+    .log_message = capture_log_message,
+};
+
+// ============================================================================
+// PUBLIC API
+// ============================================================================
+
+void hci_capture_init(void)
+{
+    if (watchdog_hw->scratch[HCI_CAPTURE_SCRATCH] != HCI_CAPTURE_BOOT_MAGIC) return;
+    watchdog_hw->scratch[HCI_CAPTURE_SCRATCH] = 0;
+
+    printf("[HCI_CAPTURE] Armed at boot, capturing from power-on\n");
+    hci_capture_start();
+}
+
+void hci_capture_arm_boot(void)
+{
+    watchdog_hw->scratch[HCI_CAPTURE_SCRATCH] = HCI_CAPTURE_BOOT_MAGIC;
+}
+
+void hci_capture_start(void)
+{
+    if (!capture.registered) {
+        hci_dump_init(&hci_capture_dump);
+        // Don't format log lines nobody records
+        hci_dump_enable_log_level(HCI_DUMP_LOG_LEVEL_DEBUG, 0);
+        hci_dump_enable_log_level(HCI_DUMP_LOG_LEVEL_INFO, 0);
+        hci_dump_enable_log_level(HCI_DUMP_LOG_LEVEL_ERROR, 0);
+        capture.registered = true;
+    }
+
+    uint32_t ints = save_and_disable_interrupts();
+    capture.head = 0;
+    capture.tail = 0;
+    capture.packets = 0;
+    capture.dropped = 0;
+    capture.active = true;
+    restore_interrupts(ints);
+}
+
+void hci_capture_stop(void)
+{
+    capture.active = false;
+}
+
+bool hci_capture_is_active(void)
+{
+    return capture.active;
+}
+
+uint16_t hci_capture_read(uint8_t* buf, uint16_t max, uint32_t* offset)
+{
+    uint32_t tail = capture.tail;
+    uint32_t avail = capture.head - tail;
+    if (avail > max) avail = max;
+
+    uint32_t idx = tail & (HCI_CAPTURE_BUFFER_SIZE - 1);
+    uint32_t first = HCI_CAPTURE_BUFFER_SIZE - idx;
+    if (first > avail) first = avail;
+    memcpy(buf, &ring[idx], first);
+    memcpy(buf + first, ring, avail - first);
+
+    __dmb();    // Bytes copied before the writer may reuse them
+    capture.tail = tail + avail;
+    *offset = tail;
+    return (uint16_t)avail;
+}
+
+uint32_t hci_capture_get_pending(void)
+{
+    return capture.head - capture.tail;
+}
+
+uint32_t hci_capture_get_total(void)
+{
+    return capture.head;
+}
+
+uint32_t hci_capture_get_packets(void)
+{
+    return capture.packets;
+}
+
+uint32_t hci_capture_get_dropped(void)
+{
+    return capture.dropped;
+}
@@ -0,0 +1,56 @@
+// hci_capture.h - HCI packet capture in PacketLogger format
+//
+// Records every HCI packet BTstack exchanges with the controller (commands,
+// events, ACL in both directions) through its hci_dump hook. The hook sits in
+// hci.c above the transport, so the USB dongle (H2/TinyUSB) and CYW43 builds
+// are captured the same way.
+//
+// Records go into a RAM ring in Apple PacketLogger (.pklg) format:
+//   [len:4 BE][sec:4 BE][usec:4 BE][type:1][packet...]   len = 9 + packet
+// which Wireshark opens directly and tools/bt_replay feeds back through the
+// host stack. The CDC port drains the ring (BT.CAPTURE.* in cdc_commands.c,
+// tools/bt_capture.py saves it to a file).
+//
+// A packet that doesn't fit in the ring is dropped whole and counted, so the
+// stream never holds a torn record - but a capture with drops won't replay.
+// BTstack-internal events (stack state, transport packet sent, L2CAP/GAP
+// events) are not recorded; they never crossed the wire and the stack
+// regenerates them on replay.
+//
+// Capturing from power-on: hci_capture_arm_boot() then reboot. The flag
+// survives the watchdog reset in a scratch register, and hci_capture_init()
+// starts the capture before the controller is powered up. The ring holds the
+// packets until the host opens the CDC port.
+
+#ifndef HCI_CAPTURE_H
+#define HCI_CAPTURE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifndef HCI_CAPTURE_BUFFER_SIZE
+#define HCI_CAPTURE_BUFFER_SIZE 16384   // Power of two
+#endif
+
+// Start capturing now if armed for this boot (call before powering on HCI)
+void hci_capture_init(void);
+
+// Capture from the next boot on (caller reboots)
+void hci_capture_arm_boot(void);
+
+// Start a fresh capture (discards anything not yet read) / stop recording.
+// Stopping keeps the unread bytes so the host can drain them.
+void hci_capture_start(void);
+void hci_capture_stop(void);
+bool hci_capture_is_active(void);
+
+// Copy up to max unread bytes out of the ring. *offset is the position of
+// the first byte in the capture stream, for gap detection on the host.
+uint16_t hci_capture_read(uint8_t* buf, uint16_t max, uint32_t* offset);
+
+uint32_t hci_capture_get_pending(void);     // Unread bytes
+uint32_t hci_capture_get_total(void);       // Bytes recorded since start
+uint32_t hci_capture_get_packets(void);     // Packets recorded since start
+uint32_t hci_capture_get_dropped(void);     // Packets dropped since start
+
+#endif // HCI_CAPTURE_H
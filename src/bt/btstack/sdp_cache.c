@@ -0,0 +1,76 @@
+// sdp_cache.c - Per-device cache of Classic SDP results in BTstack TLV flash
+
+#include "sdp_cache.h"
+#include "tlv_slots.h"
+#include "btstack_util.h"
+#include "gap.h"
+#include <string.h>
+#include <stdio.h>
+
+// TLV tags 'SDC0'.. - one per slot, next to BTstack's own 'BTD'/'BTM' tags
+#define SDP_CACHE_TAG(slot)  (((uint32_t)'S' << 24) | ((uint32_t)'D' << 16) | \
+                              ((uint32_t)'C' << 8) | (uint32_t)('0' + (slot)))
+
+// Bump when sdp_cache_entry_t changes; older records read as misses
+#define SDP_CACHE_VERSION 1
+
+typedef struct {
+    tlv_slot_header_t header;
+    sdp_cache_entry_t entry;
+} sdp_cache_record_t;
+
+_Static_assert(sizeof(sdp_cache_record_t) <= TLV_SLOTS_RECORD_MAX, "sdp_cache record too large");
+
+static const tlv_slots_t sdp_cache_slots = {
+    .tag = SDP_CACHE_TAG(0),
+    .slots = SDP_CACHE_SLOTS,
+    .version = SDP_CACHE_VERSION,
+    .record_size = sizeof(sdp_cache_record_t),
+};
+
+static bool is_bonded(const bd_addr_t addr)
+{
+    link_key_t key;
+    link_key_type_t type;
+    return gap_get_link_key_for_bd_addr((uint8_t*)addr, key, &type);
+}
+
+// ============================================================================
+// PUBLIC API
+// ============================================================================
+
+bool sdp_cache_lookup(const bd_addr_t addr, sdp_cache_entry_t* entry)
+{
+    sdp_cache_record_t record;
+    int slot = tlv_slots_find(&sdp_cache_slots, addr, &record);
+    if (slot < 0) return false;
+
+    if (!is_bonded(addr)) {
+        // Bond was dropped (re-paired elsewhere or deleted) - entry is stale
+        tlv_slots_delete(&sdp_cache_slots, slot);
+        return false;
+    }
+    *entry = record.entry;
+    return true;
+}
+
+bool sdp_cache_store(const sdp_cache_entry_t* entry)
+{
+    if (!is_bonded(entry->addr)) return false;
+
+    sdp_cache_record_t record;
+    memset(&record, 0, sizeof(record));
+    memcpy(&record.entry, entry, sizeof(*entry));
+    int slot = tlv_slots_store(&sdp_cache_slots, &record);
+    if (slot < 0) return false;
+
+    printf("[SDP_CACHE] Stored %s in slot %d: VID=0x%04X PID=0x%04X desc=%u\n",
+           bd_addr_to_str(entry->addr), slot, entry->vendor_id, entry->product_id,
+           entry->descriptor_len);
+    return true;
+}
+
+void sdp_cache_clear(void)
+{
+    tlv_slots_clear(&sdp_cache_slots);
+}
@@ -0,0 +1,47 @@
+// sdp_cache.h - Per-device cache of Classic SDP results in BTstack TLV flash
+//
+// A bonded Classic pad that wakes up pages us and waits while we run SDP:
+// the PnP query for VID/PID and hid_host's HID descriptor query. Together
+// they hold back the first routed report by a few hundred ms. The cache
+// keeps what those queries returned (VID/PID, class of device, name, and the
+// descriptor's length and hash) per BD_ADDR, so a reconnect can hand the
+// device to bthid as soon as the HID channels open. The queries still run
+// afterwards to revalidate, and the entry is rewritten only if they differ.
+//
+// Entries live in the same TLV store as the link keys, so they are erased
+// with the bonds. Only bonded devices are cached, and a hit needs the link
+// key to still be there. Eviction replaces the entry written longest ago.
+
+#ifndef SDP_CACHE_H
+#define SDP_CACHE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "bluetooth.h"
+
+#ifndef SDP_CACHE_SLOTS
+#define SDP_CACHE_SLOTS 8
+#endif
+
+typedef struct {
+    bd_addr_t addr;
+    uint8_t class_of_device[3];
+    uint8_t reserved;
+    uint16_t vendor_id;
+    uint16_t product_id;
+    uint16_t descriptor_len;    // 0 = descriptor not seen yet
+    uint32_t descriptor_hash;   // hid_parse_cache_hash() of the descriptor
+    char name[32];
+} sdp_cache_entry_t;
+
+// Fill *entry for a bonded device. False on miss (or the bond is gone).
+bool sdp_cache_lookup(const bd_addr_t addr, sdp_cache_entry_t* entry);
+
+// Store/refresh a device's entry (zero it before filling in). Writes flash
+// only when something changed; returns true if it did.
+bool sdp_cache_store(const sdp_cache_entry_t* entry);
+
+// Forget every device (bonds cleared)
+void sdp_cache_clear(void);
+
+#endif // SDP_CACHE_H
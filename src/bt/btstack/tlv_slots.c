@@ -0,0 +1,110 @@
+// tlv_slots.c - Fixed set of per-device records in BTstack TLV flash
+
+#include "tlv_slots.h"
+#include "btstack_tlv.h"
+#include "btstack_util.h"
+#include <string.h>
+
+// ============================================================================
+// TLV ACCESS
+// ============================================================================
+
+static const btstack_tlv_t* get_tlv(void** context)
+{
+    const btstack_tlv_t* tlv = NULL;
+    btstack_tlv_get_instance(&tlv, context);
+    return tlv;
+}
+
+static bool read_slot(const tlv_slots_t* store, const btstack_tlv_t* tlv, void* context,
+                      int slot, void* record)
+{
+    int size = tlv->get_tag(context, store->tag + slot, (uint8_t*)record, store->record_size);
+    return size == (int)store->record_size &&
+           ((const tlv_slot_header_t*)record)->version == store->version;
+}
+
+static const uint8_t* entry_of(const void* record)
+{
+    return (const uint8_t*)record + sizeof(tlv_slot_header_t);
+}
+
+// ============================================================================
+// PUBLIC API
+// ============================================================================
+
+int tlv_slots_find(const tlv_slots_t* store, const bd_addr_t addr, void* record)
+{
+    void* context;
+    const btstack_tlv_t* tlv = get_tlv(&context);
+    if (!tlv) return -1;
+
+    for (int slot = 0; slot < store->slots; slot++) {
+        if (read_slot(store, tlv, context, slot, record) &&
+            bd_addr_cmp(entry_of(record), addr) == 0) {
+            return slot;
+        }
+    }
+    return -1;
+}
+
+int tlv_slots_store(const tlv_slots_t* store, void* record)
+{
+    void* context;
+    const btstack_tlv_t* tlv = get_tlv(&context);
+    if (!tlv || store->record_size > TLV_SLOTS_RECORD_MAX) return -1;
+
+    const uint8_t* entry = entry_of(record);
+    uint16_t entry_size = store->record_size - sizeof(tlv_slot_header_t);
+
+    // Same device's slot, else a free one, else the oldest
+    int match = -1, free_slot = -1, oldest = 0;
+    uint32_t max_seq = 0, oldest_seq = UINT32_MAX;
+    static uint32_t scratch[TLV_SLOTS_RECORD_MAX / sizeof(uint32_t)];   // Off the stack; run loop only
+    const tlv_slot_header_t* header = (const tlv_slot_header_t*)scratch;
+    for (int slot = 0; slot < store->slots; slot++) {
+        if (!read_slot(store, tlv, context, slot, scratch)) {
+            if (free_slot < 0) free_slot = slot;
+            continue;
+        }
+        if (header->seq > max_seq) max_seq = header->seq;
+        if (header->seq < oldest_seq) {
+            oldest_seq = header->seq;
+            oldest = slot;
+        }
+        if (match < 0 && bd_addr_cmp(entry_of(scratch), entry) == 0) {
+            match = slot;
+            if (memcmp(entry_of(scratch), entry, entry_size) == 0) {
+                return -1;  // Unchanged - don't wear the flash
+            }
+        }
+    }
+    int slot = match >= 0 ? match : (free_slot >= 0 ? free_slot : oldest);
+
+    tlv_slot_header_t* out = (tlv_slot_header_t*)record;
+    memset(out, 0, sizeof(*out));
+    out->version = store->version;
+    out->seq = max_seq + 1;
+    tlv->store_tag(context, store->tag + slot, (const uint8_t*)record, store->record_size);
+    return slot;
+}
+
+void tlv_slots_delete(const tlv_slots_t* store, int slot)
+{
+    void* context;
+    const btstack_tlv_t* tlv = get_tlv(&context);
+    if (!tlv || slot < 0 || slot >= store->slots) return;
+
+    tlv->delete_tag(context, store->tag + slot);
+}
+
+void tlv_slots_clear(const tlv_slots_t* store)
+{
+    void* context;
+    const btstack_tlv_t* tlv = get_tlv(&context);
+    if (!tlv) return;
+
+    for (int slot = 0; slot < store->slots; slot++) {
+        tlv->delete_tag(context, store->tag + slot);
+    }
+}
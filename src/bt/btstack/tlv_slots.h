@@ -0,0 +1,42 @@
+// tlv_slots.h - Fixed set of per-device records in BTstack TLV flash
+//
+// sdp_cache and gatt_cache each keep one record per bonded device in a
+// small, fixed number of TLV tags ('SDC0'.., 'GHC0'..). A record is a
+// tlv_slot_header_t followed by the cache's entry, and every entry starts
+// with the device's bd_addr_t. Records written with another version read as
+// empty slots. A new device takes a free slot, else the one written longest
+// ago.
+
+#ifndef TLV_SLOTS_H
+#define TLV_SLOTS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "bluetooth.h"
+
+// Largest record a store may use (scratch buffer in tlv_slots_store)
+#define TLV_SLOTS_RECORD_MAX 256
+
+typedef struct {
+    uint8_t version;
+    uint32_t seq;               // Write order, for eviction
+} tlv_slot_header_t;
+
+typedef struct {
+    uint32_t tag;               // Slot 0's tag; slot n is tag + n
+    uint8_t slots;
+    uint8_t version;            // Bump when the entry layout changes
+    uint16_t record_size;       // sizeof(header + entry), <= TLV_SLOTS_RECORD_MAX
+} tlv_slots_t;
+
+// Read addr's record into *record. Returns its slot, -1 on miss.
+int tlv_slots_find(const tlv_slots_t* store, const bd_addr_t addr, void* record);
+
+// Write *record's entry (the header is filled in) to the device's slot.
+// Returns the slot, or -1 if the entry was unchanged or there's no TLV.
+int tlv_slots_store(const tlv_slots_t* store, void* record);
+
+void tlv_slots_delete(const tlv_slots_t* store, int slot);
+void tlv_slots_clear(const tlv_slots_t* store);
+
+#endif // TLV_SLOTS_H
@@ -50,3 +50,8 @@ __attribute__((weak)) void bt_on_hid_report(uint8_t conn_index, const uint8_t* d
 {
     printf("[BT] HID report on connection %d: %d bytes (weak handler)\n", conn_index, len);
 }
+
+__attribute__((weak)) void bt_on_hid_input(uint8_t conn_index, const uint8_t* report, uint16_t len)
+{
+    printf("[BT] HID input on connection %d: %d bytes (weak handler)\n", conn_index, len);
+}
@@ -143,7 +143,17 @@ extern void bt_on_hid_ready(uint8_t conn_index);
 // Called when a connection is lost
 extern void bt_on_disconnect(uint8_t conn_index);
 
-// Called when HID data is received on interrupt channel
+// Report buffers passed to the two calls below are the stack's own receive
+// buffers (the ACL payload, or the GATT notification value inside it). They
+// are only valid until the call returns: drivers decode in place and must
+// copy anything they keep. Reports are delivered from inside the stack's
+// packet handler, so handlers must not block.
+
+// Called when HID data is received on interrupt channel (with the
+// DATA|INPUT transaction header, as sent on Classic L2CAP)
 extern void bt_on_hid_report(uint8_t conn_index, const uint8_t* data, uint16_t len);
 
+// Called with a bare input report (BLE notifications carry no header)
+extern void bt_on_hid_input(uint8_t conn_index, const uint8_t* report, uint16_t len);
+
 #endif // BT_TRANSPORT_H
@@ -8,6 +8,7 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include <string.h>
+#include "key_bitmap.h"
 
 // ============================================================================
 // Device Type Classification
@@ -104,6 +105,7 @@ typedef struct {
     // Digital inputs
     uint32_t buttons;           // Button bitmap (JP_BUTTON_* defines from globals.h)
     uint32_t keys;              // Keyboard keys (modifier + scancodes)
+    key_bitmap_t key_state;     // Keyboard keys held, any number (key_bitmap.h)
 
     // Absolute analog inputs (0-255, centered at 128 for sticks, 0 for triggers)
     // All values are normalized regardless of device type
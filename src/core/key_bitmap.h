@@ -0,0 +1,68 @@
+// key_bitmap.h
+// NKRO keyboard state: one bit per HID keyboard usage (page 0x07)
+//
+// Bit n is set while usage n is held, modifiers included (0xE0-0xE7), so a
+// report-protocol keyboard with any number of keys down fits, and state from
+// several keyboards merges with a word-wide OR. Key-down/key-up are found by
+// XOR against the previous state, eight words per report regardless of how
+// many keys are held.
+
+#ifndef KEY_BITMAP_H
+#define KEY_BITMAP_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define KEY_BITMAP_WORDS 8
+
+typedef struct {
+    uint32_t w[KEY_BITMAP_WORDS];
+} key_bitmap_t;
+
+static inline void key_bitmap_set(key_bitmap_t* bm, uint8_t usage)
+{
+    bm->w[usage >> 5] |= 1u << (usage & 31);
+}
+
+static inline bool key_bitmap_test(const key_bitmap_t* bm, uint8_t usage)
+{
+    return (bm->w[usage >> 5] >> (usage & 31)) & 1;
+}
+
+static inline bool key_bitmap_empty(const key_bitmap_t* bm)
+{
+    uint32_t any = 0;
+    for (int i = 0; i < KEY_BITMAP_WORDS; i++) any |= bm->w[i];
+    return any == 0;
+}
+
+static inline void key_bitmap_or(key_bitmap_t* dst, const key_bitmap_t* src)
+{
+    for (int i = 0; i < KEY_BITMAP_WORDS; i++) dst->w[i] |= src->w[i];
+}
+
+// Split the difference between two states into newly pressed and released keys
+static inline void key_bitmap_diff(const key_bitmap_t* cur, const key_bitmap_t* prev,
+                                   key_bitmap_t* pressed, key_bitmap_t* released)
+{
+    for (int i = 0; i < KEY_BITMAP_WORDS; i++) {
+        uint32_t changed = cur->w[i] ^ prev->w[i];
+        pressed->w[i] = changed & cur->w[i];
+        released->w[i] = changed & prev->w[i];
+    }
+}
+
+// Next set usage at or after `from`, or -1. Skips empty words.
+static inline int key_bitmap_next(const key_bitmap_t* bm, int from)
+{
+    if (from < 0 || from > 255) return -1;
+    int i = from >> 5;
+    uint32_t word = bm->w[i] & (~0u << (from & 31));
+    while (!word) {
+        if (++i >= KEY_BITMAP_WORDS) return -1;
+        word = bm->w[i];
+    }
+    return (i << 5) + __builtin_ctz(word);
+}
+
+#endif // KEY_BITMAP_H
@@ -6,6 +6,8 @@
 
 #include "router.h"
 #include "core/services/players/manager.h"
+#include "core/services/metrics/metrics.h"
+#include "core/services/loopback/loopback.h"
 #include <string.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -482,6 +484,9 @@ static inline void router_simple_mode(const input_event_t* event, output_target_
                     player_index + 1, device_name, event->dev_addr, event->instance);
             }
         }
+        if (player_index < 0) {
+            METRIC_INC(ROUTER_UNASSIGNED);
+        }
     }
 
     if (player_index >= 0 && player_index < router_config.max_players_per_output[output]) {
@@ -522,7 +527,10 @@ static inline void router_merge_mode(const input_event_t* event, output_target_t
     }
 
     // Only process if player is registered
-    if (player_index < 0) return;
+    if (player_index < 0) {
+        METRIC_INC(ROUTER_UNASSIGNED);
+        return;
+    }
 
     // Create local copy for transformation
     input_event_t transformed = *event;
@@ -587,6 +595,7 @@ static inline void router_merge_mode(const input_event_t* event, output_target_t
 
                     // Keys: OR together (active-high)
                     out->current_state.keys |= dev->keys;
+                    key_bitmap_or(&out->current_state.key_state, &dev->key_state);
 
                     // Analog: use furthest from center for sticks, max for triggers
                     // New format: [0]=LX, [1]=LY, [2]=RX, [3]=RY, [4]=L2, [5]=R2
@@ -665,15 +674,23 @@ static inline void router_merge_mode(const input_event_t* event, output_target_t
     }
 }
 
+// LOOPBACK PROBE: routed like any input, but held apart from the player
+// slots so it never takes or overwrites a real controller's output
+static input_event_t router_probe_state;
+static bool router_probe_updated = false;
+
+static void router_probe_mode(const input_event_t* event, output_target_t output) {
+    router_probe_state = *event;
+    apply_transformations(&router_probe_state, output, -1);
+    router_probe_updated = true;
+}
+
 // Main input submission function (called by input drivers)
 void router_submit_input(const input_event_t* event) {
     if (!event) return;
     if (route_count == 0) return;
 
-    // Stream input to CDC for web config (if enabled)
-#ifdef CONFIG_USB
-    cdc_commands_send_input_event(event->buttons, event->analog);
-#endif
+    METRIC_INC(ROUTER_EVENTS);
 
     // Find first active route to determine output target
     output_target_t output = OUTPUT_TARGET_USB_DEVICE;
@@ -684,6 +701,16 @@ void router_submit_input(const input_event_t* event) {
         }
     }
 
+    if (event->dev_addr == LOOPBACK_DEV_ADDR) {
+        router_probe_mode(event, output);
+        return;
+    }
+
+    // Stream input to CDC for web config (if enabled)
+#ifdef CONFIG_USB
+    cdc_commands_send_input_event(event->buttons, event->analog);
+#endif
+
     // Route based on mode
     switch (router_config.mode) {
         case ROUTING_MODE_SIMPLE:
@@ -751,6 +778,7 @@ const input_event_t* __not_in_flash_func(router_get_output)(output_target_t outp
 
     if (router_outputs[output][player_id].updated) {
         router_outputs[output][player_id].updated = false;  // Mark as read
+        METRIC_INC(ROUTER_OUTPUT_READS);
         
         // Copy to static buffer so caller gets the deltas
         router_output_copy[output][player_id] = router_outputs[output][player_id].current_state;
@@ -766,6 +794,12 @@ const input_event_t* __not_in_flash_func(router_get_output)(output_target_t outp
     return NULL;
 }
 
+const input_event_t* router_get_probe_output(void) {
+    if (!router_probe_updated) return NULL;
+    router_probe_updated = false;
+    return &router_probe_state;
+}
+
 bool router_has_updates(output_target_t output) {
     if (output >= MAX_OUTPUTS) return false;
 
@@ -911,6 +945,7 @@ void router_device_disconnected(uint8_t dev_addr, int8_t instance) {
                 // Buttons: OR together
                 out_state->current_state.buttons |= dev->buttons;
                 out_state->current_state.keys |= dev->keys;
+                key_bitmap_or(&out_state->current_state.key_state, &dev->key_state);
 
                 // Analog: use furthest from center for sticks, max for triggers
                 // Format: [0]=LX, [1]=LY, [2]=RX, [3]=RY, [4]=L2, [5]=R2
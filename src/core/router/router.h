@@ -132,6 +132,10 @@ void router_submit_input(const input_event_t* event);
 // Lock-free read, zero-copy (returns pointer to internal state)
 const input_event_t* router_get_output(output_target_t output, uint8_t player_id);
 
+// Get the loopback probe's routed state (returns NULL if no update).
+// Events from LOOPBACK_DEV_ADDR are routed here instead of to a player.
+const input_event_t* router_get_probe_output(void);
+
 // Check if any player has new data (fast scan for multi-player outputs)
 bool router_has_updates(output_target_t output);
 
@@ -0,0 +1,82 @@
+// loopback.c
+// Input pipeline latency probe
+
+#include "loopback.h"
+#include "pico/time.h"
+#include <string.h>
+#include <stdio.h>
+
+static bool enabled = false;
+static loopback_encoder_t encoder = NULL;
+
+void loopback_set_encoder(loopback_encoder_t fn)
+{
+    encoder = fn;
+}
+
+void loopback_set_enabled(bool enable)
+{
+    enabled = enable;
+    printf("[loopback] %s\n", enable ? "Enabled" : "Disabled");
+}
+
+bool loopback_is_enabled(void)
+{
+    return enabled;
+}
+
+bool loopback_run(output_target_t output, uint32_t buttons, const uint8_t* analog,
+                  loopback_result_t* result)
+{
+    if (!enabled) return false;
+
+    memset(result, 0, sizeof(*result));
+
+    input_event_t event;
+    init_input_event(&event);
+    event.dev_addr = LOOPBACK_DEV_ADDR;
+    event.instance = 0;
+    event.type = INPUT_TYPE_GAMEPAD;
+    event.transport = INPUT_TRANSPORT_NATIVE;
+    event.buttons = buttons;
+    memcpy(event.analog, analog, ANALOG_COUNT);
+
+    uint32_t t_start = time_us_32();
+
+    // Router
+    router_submit_input(&event);
+    uint32_t t_router = time_us_32();
+
+    // Readout (what an output device polls)
+    const input_event_t* routed = router_get_probe_output();
+    uint32_t t_readout = time_us_32();
+
+    uint32_t t_profile = t_readout;
+    uint32_t t_encode = t_readout;
+    if (routed) {
+        result->flags |= LOOPBACK_FLAG_DELIVERED;
+
+        // Profile mapping
+        profile_output_t mapped;
+        profile_apply(profile_get_active(output), routed->buttons,
+                      routed->analog[ANALOG_LX], routed->analog[ANALOG_LY],
+                      routed->analog[ANALOG_RX], routed->analog[ANALOG_RY],
+                      routed->analog[ANALOG_L2], routed->analog[ANALOG_R2],
+                      &mapped);
+        result->buttons_out = mapped.buttons;
+        t_profile = time_us_32();
+
+        // Output encode
+        if (encoder && encoder(0, routed, &mapped, mapped.buttons)) {
+            result->flags |= LOOPBACK_FLAG_ENCODED;
+        }
+        t_encode = time_us_32();
+    }
+
+    result->stage_us[LOOPBACK_STAGE_ROUTER] = t_router - t_start;
+    result->stage_us[LOOPBACK_STAGE_READOUT] = t_readout - t_router;
+    result->stage_us[LOOPBACK_STAGE_PROFILE] = t_profile - t_readout;
+    result->stage_us[LOOPBACK_STAGE_ENCODE] = t_encode - t_profile;
+    result->total_us = t_encode - t_start;
+    return true;
+}
@@ -0,0 +1,63 @@
+// loopback.h
+// Input pipeline latency probe
+//
+// Runs a synthetic input event through the same stages a real controller
+// report takes - router, output readout, profile mapping, output encode -
+// and timestamps each stage. The config tools inject events over CDC and
+// collect the timings (tools/cdc_test.py --latency).
+//
+// The probe submits as its own device (LOOPBACK_DEV_ADDR). The router
+// keeps its state apart from the player slots, so a probe never takes a
+// player or reaches a real output, and the encoder writes to a scratch
+// buffer instead of the bus.
+
+#ifndef LOOPBACK_H
+#define LOOPBACK_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "core/input_event.h"
+#include "core/router/router.h"
+#include "core/services/profiles/profile.h"
+
+// Device address used for injected events (outside USB 1-127 and BT ranges)
+#define LOOPBACK_DEV_ADDR 0xF0
+
+typedef enum {
+    LOOPBACK_STAGE_ROUTER = 0,  // router_submit_input()
+    LOOPBACK_STAGE_READOUT,     // router_get_probe_output()
+    LOOPBACK_STAGE_PROFILE,     // profile_apply()
+    LOOPBACK_STAGE_ENCODE,      // Output encoder (see loopback_set_encoder)
+    LOOPBACK_STAGE_COUNT
+} loopback_stage_t;
+
+#define LOOPBACK_FLAG_DELIVERED (1 << 0)    // Routed state was read back
+#define LOOPBACK_FLAG_ENCODED   (1 << 1)    // Encoder ran and reported success
+
+typedef struct {
+    uint32_t stage_us[LOOPBACK_STAGE_COUNT];
+    uint32_t total_us;
+    uint32_t buttons_out;       // Buttons after profile mapping
+    uint8_t flags;              // LOOPBACK_FLAG_*
+} loopback_result_t;
+
+// Output encode stage. Called with the mapped output; returns true if a
+// report was encoded. Must not send it. NULL = no encode stage (timing
+// reads 0).
+typedef bool (*loopback_encoder_t)(uint8_t player_index,
+                                   const input_event_t* event,
+                                   const profile_output_t* profile_out,
+                                   uint32_t buttons);
+
+void loopback_set_encoder(loopback_encoder_t encoder);
+
+// Enable/disable injection
+void loopback_set_enabled(bool enabled);
+bool loopback_is_enabled(void);
+
+// Run one synthetic event through the pipeline for the given output.
+// analog: ANALOG_COUNT axes. Returns false if loopback is disabled.
+bool loopback_run(output_target_t output, uint32_t buttons, const uint8_t* analog,
+                  loopback_result_t* result);
+
+#endif // LOOPBACK_H
@@ -0,0 +1,114 @@
+// metrics.c
+// Joypad runtime metrics registry
+
+#include "metrics.h"
+#include <string.h>
+
+// ============================================================================
+// STORAGE
+// ============================================================================
+
+uint32_t metrics_scalars[METRIC_SCALAR_COUNT];
+uint32_t metrics_hists[METRIC_HIST_COUNT > 0 ? METRIC_HIST_COUNT : 1][METRICS_HIST_BUCKETS];
+
+#define METRIC_TOTAL_COUNT (METRIC_SCALAR_COUNT + METRIC_HIST_COUNT)
+#define METRIC_SLOT_COUNT  (METRIC_SCALAR_COUNT + METRIC_HIST_COUNT * METRICS_HIST_BUCKETS)
+
+_Static_assert(METRIC_SLOT_COUNT <= 255, "metric slots must fit in a byte");
+
+// Last values sent to a subscriber (for change detection)
+static uint32_t last_sent[METRIC_SLOT_COUNT];
+
+// ============================================================================
+// METADATA
+// ============================================================================
+// Order matches the slot layout: scalars (in METRICS_LIST order), then histograms
+
+#define METRIC_NAME(id, name) name,
+#define METRIC_NAME_NONE(id, name)
+#define METRIC_KIND_C(id, name) METRIC_KIND_COUNTER,
+#define METRIC_KIND_G(id, name) METRIC_KIND_GAUGE,
+#define METRIC_KIND_H(id, name) METRIC_KIND_HISTOGRAM,
+#define METRIC_KIND_NONE(id, name)
+
+static const char* const metric_names[METRIC_TOTAL_COUNT] = {
+    METRICS_LIST(METRIC_NAME, METRIC_NAME, METRIC_NAME_NONE)
+    METRICS_LIST(METRIC_NAME_NONE, METRIC_NAME_NONE, METRIC_NAME)
+};
+
+static const uint8_t metric_kinds[METRIC_TOTAL_COUNT] = {
+    METRICS_LIST(METRIC_KIND_C, METRIC_KIND_G, METRIC_KIND_NONE)
+    METRICS_LIST(METRIC_KIND_NONE, METRIC_KIND_NONE, METRIC_KIND_H)
+};
+
+// ============================================================================
+// READOUT
+// ============================================================================
+
+uint8_t metrics_get_count(void)
+{
+    return METRIC_TOTAL_COUNT;
+}
+
+const char* metrics_get_name(uint8_t index)
+{
+    return (index < METRIC_TOTAL_COUNT) ? metric_names[index] : NULL;
+}
+
+metric_kind_t metrics_get_kind(uint8_t index)
+{
+    return (index < METRIC_TOTAL_COUNT) ? (metric_kind_t)metric_kinds[index] : METRIC_KIND_COUNTER;
+}
+
+uint8_t metrics_get_first_slot(uint8_t index)
+{
+    if (index < METRIC_SCALAR_COUNT) {
+        return index;
+    }
+    return METRIC_SCALAR_COUNT + (index - METRIC_SCALAR_COUNT) * METRICS_HIST_BUCKETS;
+}
+
+uint8_t metrics_get_slot_count(void)
+{
+    return METRIC_SLOT_COUNT;
+}
+
+uint32_t metrics_read_slot(uint8_t slot)
+{
+    if (slot < METRIC_SCALAR_COUNT) {
+        return metrics_scalars[slot];
+    }
+    if (slot < METRIC_SLOT_COUNT) {
+        uint8_t h = slot - METRIC_SCALAR_COUNT;
+        return metrics_hists[h / METRICS_HIST_BUCKETS][h % METRICS_HIST_BUCKETS];
+    }
+    return 0;
+}
+
+uint16_t metrics_encode_changes(uint8_t* buf, uint16_t max_len)
+{
+    uint16_t pos = 0;
+
+    for (uint8_t slot = 0; slot < METRIC_SLOT_COUNT; slot++) {
+        uint32_t value = metrics_read_slot(slot);
+        if (value == last_sent[slot]) continue;
+        if (pos + 5 > max_len) break;  // Rest stays marked as changed
+
+        buf[pos++] = slot;
+        buf[pos++] = value & 0xFF;
+        buf[pos++] = (value >> 8) & 0xFF;
+        buf[pos++] = (value >> 16) & 0xFF;
+        buf[pos++] = (value >> 24) & 0xFF;
+        last_sent[slot] = value;
+    }
+
+    return pos;
+}
+
+void metrics_reset_snapshot(void)
+{
+    // Store the complement so every slot compares as changed
+    for (uint8_t slot = 0; slot < METRIC_SLOT_COUNT; slot++) {
+        last_sent[slot] = ~metrics_read_slot(slot);
+    }
+}
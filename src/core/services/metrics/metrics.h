@@ -0,0 +1,124 @@
+// metrics.h
+// Joypad runtime metrics registry
+//
+// Counters, gauges and histograms live in static arrays sized at compile
+// time from METRICS_LIST below. Updating a counter is a single array
+// increment, so hot paths (router, HID/BT report handlers) can be
+// instrumented freely. Values are read out over CDC (METRICS.LIST /
+// METRICS.SUBSCRIBE) by the config tools.
+//
+// Adding a metric: add one line to METRICS_LIST, then call
+// METRIC_INC(ID) / METRIC_SET(ID, v) / METRIC_OBSERVE(ID, v) where needed.
+
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// ============================================================================
+// METRIC DEFINITIONS
+// ============================================================================
+// COUNTER(id, name)   - monotonically increasing event count (wraps at 2^32)
+// GAUGE(id, name)     - last value set
+// HISTOGRAM(id, name) - log2 buckets: bucket 0 = value 0, bucket n = [2^(n-1), 2^n)
+
+#define METRICS_LIST(COUNTER, GAUGE, HISTOGRAM) \
+    COUNTER(ROUTER_EVENTS,       "router.events") \
+    COUNTER(ROUTER_UNASSIGNED,   "router.unassigned") \
+    COUNTER(ROUTER_OUTPUT_READS, "router.output_reads") \
+    COUNTER(USB_HID_MOUNTS,      "usb.hid.mounts") \
+    COUNTER(USB_HID_REPORTS,     "usb.hid.reports") \
+    COUNTER(USB_HID_REPORTS_DEDUPED, "usb.hid.reports_deduped") \
+    COUNTER(USB_XINPUT_REPORTS,  "usb.xinput.reports") \
+    COUNTER(USB_FEEDBACK_SENDS,  "usb.feedback.sends") \
+    COUNTER(HID_PARSE_CACHE_HITS,   "hid.parse_cache.hits") \
+    COUNTER(HID_PARSE_CACHE_MISSES, "hid.parse_cache.misses") \
+    COUNTER(BT_CONNECTS,         "bt.connects") \
+    COUNTER(BT_HID_REPORTS,      "bt.hid.reports") \
+    HISTOGRAM(BT_HID_REPORT_CYCLES, "bt.hid.report_cycles") \
+    HISTOGRAM(BT_HID_REPORT_JITTER_US, "bt.hid.report_jitter_us") \
+    GAUGE(BT_LINK_QOS_LATENCY_US, "bt.link.qos_latency_us") \
+    GAUGE(BT_DEVICES,            "bt.devices") \
+    COUNTER(BT_HCI_CAPTURE_DROPS, "bt.hci_capture.drops") \
+    HISTOGRAM(BT_SW2_FIRST_INPUT_MS, "bt.sw2.first_input_ms") \
+    COUNTER(CDC_COMMANDS,        "cdc.commands") \
+    HISTOGRAM(CDC_COMMAND_US,    "cdc.command_us")
+
+#define METRICS_HIST_BUCKETS 16
+
+// ============================================================================
+// GENERATED IDS
+// ============================================================================
+
+#define METRIC_ENUM_SCALAR(id, name) METRIC_##id,
+#define METRIC_ENUM_HIST(id, name) METRIC_HIST_##id,
+#define METRIC_ENUM_NONE(id, name)
+
+// Scalar metrics (counters and gauges) share one value array
+typedef enum {
+    METRICS_LIST(METRIC_ENUM_SCALAR, METRIC_ENUM_SCALAR, METRIC_ENUM_NONE)
+    METRIC_SCALAR_COUNT
+} metric_id_t;
+
+typedef enum {
+    METRICS_LIST(METRIC_ENUM_NONE, METRIC_ENUM_NONE, METRIC_ENUM_HIST)
+    METRIC_HIST_COUNT
+} metric_hist_id_t;
+
+typedef enum {
+    METRIC_KIND_COUNTER = 0,
+    METRIC_KIND_GAUGE,
+    METRIC_KIND_HISTOGRAM,
+} metric_kind_t;
+
+// ============================================================================
+// STORAGE (exposed so updates inline to a single load/add/store)
+// ============================================================================
+
+extern uint32_t metrics_scalars[METRIC_SCALAR_COUNT];
+extern uint32_t metrics_hists[METRIC_HIST_COUNT > 0 ? METRIC_HIST_COUNT : 1][METRICS_HIST_BUCKETS];
+
+static inline void metrics_hist_record(metric_hist_id_t id, uint32_t value)
+{
+    uint32_t bucket = value ? 32 - (uint32_t)__builtin_clz(value) : 0;
+    if (bucket >= METRICS_HIST_BUCKETS) bucket = METRICS_HIST_BUCKETS - 1;
+    metrics_hists[id][bucket]++;
+}
+
+#define METRIC_INC(id)          (metrics_scalars[METRIC_##id]++)
+#define METRIC_ADD(id, n)       (metrics_scalars[METRIC_##id] += (uint32_t)(n))
+#define METRIC_SET(id, v)       (metrics_scalars[METRIC_##id] = (uint32_t)(v))
+#define METRIC_OBSERVE(id, v)   metrics_hist_record(METRIC_HIST_##id, (uint32_t)(v))
+
+// ============================================================================
+// READOUT API
+// ============================================================================
+// Metrics are exported as a flat list of numbered slots: scalar metrics
+// first (one slot each), then each histogram's buckets in order.
+
+// Number of named metrics (scalars + histograms)
+uint8_t metrics_get_count(void);
+
+// Name/kind of metric by index (0..metrics_get_count()-1)
+const char* metrics_get_name(uint8_t index);
+metric_kind_t metrics_get_kind(uint8_t index);
+
+// First slot number used by metric at index
+uint8_t metrics_get_first_slot(uint8_t index);
+
+// Total number of exported slots
+uint8_t metrics_get_slot_count(void);
+
+// Read current value of a slot
+uint32_t metrics_read_slot(uint8_t slot);
+
+// Encode slots that changed since the last call as [slot:1][value:4 LE]
+// records. Stops when buf is full; remaining changes go out next call.
+// Returns bytes written.
+uint16_t metrics_encode_changes(uint8_t* buf, uint16_t max_len);
+
+// Forget what was last sent so the next encode includes every slot
+void metrics_reset_snapshot(void);
+
+#endif // METRICS_H
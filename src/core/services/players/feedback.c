@@ -14,8 +14,11 @@
 // ============================================================================
 
 static feedback_state_t feedback_states[MAX_PLAYERS];
+static uint32_t changed_players = 0;  // See feedback_take_changed()
 static bool initialized = false;
 
+_Static_assert(MAX_PLAYERS <= 32, "changed_players holds one bit per player");
+
 // Default player colors (PS4/DualSense style)
 static const uint8_t player_colors[4][3] = {
     {0x00, 0x00, 0xFF},  // Player 1: Blue
@@ -38,6 +41,7 @@ void feedback_init(void)
         feedback_states[i].led.pattern = FEEDBACK_LED_NONE;
     }
 
+    changed_players = FEEDBACK_CHANGED_ALL;
     initialized = true;
 }
 
@@ -60,6 +64,7 @@ void feedback_set_rumble_internal(uint8_t player_index, uint8_t left, uint8_t ri
         state->rumble.left = left;
         state->rumble.right = right;
         state->rumble_dirty = true;
+        changed_players |= 1u << player_index;
     }
 }
 
@@ -84,6 +89,7 @@ void feedback_set_rumble_ext(uint8_t player_index, const feedback_rumble_t* rumb
     if (memcmp(&state->rumble, rumble, sizeof(feedback_rumble_t)) != 0) {
         state->rumble = *rumble;
         state->rumble_dirty = true;
+        changed_players |= 1u << player_index;
     }
 }
 
@@ -115,6 +121,7 @@ void feedback_set_led_player_internal(uint8_t player_index, uint8_t player_num)
         state->led.g = g;
         state->led.b = b;
         state->led_dirty = true;
+        changed_players |= 1u << player_index;
     }
 }
 
@@ -142,6 +149,7 @@ void feedback_set_led_rgb_internal(uint8_t player_index, uint8_t r, uint8_t g, u
         state->led.g = g;
         state->led.b = b;
         state->led_dirty = true;
+        changed_players |= 1u << player_index;
     }
 }
 
@@ -166,6 +174,7 @@ void feedback_set_led(uint8_t player_index, const feedback_led_t* led)
     if (memcmp(&state->led, led, sizeof(feedback_led_t)) != 0) {
         state->led = *led;
         state->led_dirty = true;
+        changed_players |= 1u << player_index;
     }
 }
 
@@ -179,6 +188,7 @@ void feedback_set_trigger(uint8_t player_index, bool left, const feedback_trigge
     if (memcmp(target, trigger, sizeof(feedback_trigger_t)) != 0) {
         *target = *trigger;
         state->triggers_dirty = true;
+        changed_players |= 1u << player_index;
     }
 }
 
@@ -193,6 +203,7 @@ void feedback_clear(uint8_t player_index)
         state->rumble.left_trigger != 0 || state->rumble.right_trigger != 0) {
         memset(&state->rumble, 0, sizeof(feedback_rumble_t));
         state->rumble_dirty = true;
+        changed_players |= 1u << player_index;
     }
 
     // Clear LED (but keep brightness)
@@ -202,6 +213,7 @@ void feedback_clear(uint8_t player_index)
         memset(&state->led, 0, sizeof(feedback_led_t));
         state->led.brightness = brightness;
         state->led_dirty = true;
+        changed_players |= 1u << player_index;
     }
 
     // Clear triggers
@@ -210,6 +222,7 @@ void feedback_clear(uint8_t player_index)
         memset(&state->left_trigger, 0, sizeof(feedback_trigger_t));
         memset(&state->right_trigger, 0, sizeof(feedback_trigger_t));
         state->triggers_dirty = true;
+        changed_players |= 1u << player_index;
     }
 }
 
@@ -221,3 +234,15 @@ void feedback_clear_dirty(uint8_t player_index)
     feedback_states[player_index].led_dirty = false;
     feedback_states[player_index].triggers_dirty = false;
 }
+
+void feedback_mark_changed(uint8_t player_index)
+{
+    changed_players |= (player_index < MAX_PLAYERS) ? 1u << player_index : FEEDBACK_CHANGED_ALL;
+}
+
+uint32_t feedback_take_changed(void)
+{
+    uint32_t changed = changed_players;
+    changed_players = 0;
+    return changed;
+}
@@ -123,6 +123,23 @@ void feedback_clear(uint8_t player_index);
 // Clear dirty flags after device has applied feedback
 void feedback_clear_dirty(uint8_t player_index);
 
+// ============================================================================
+// CHANGE TRACKING
+// ============================================================================
+// Every setter that changes a player's state also sets the player's bit in a
+// changed mask. The USB host feedback task takes the mask once per pass and
+// rebuilds output only for those players. The *_dirty flags above stay for
+// the BT drivers, which clear them on their own schedule.
+
+#define FEEDBACK_CHANGED_ALL 0xFFFFFFFFu
+
+// Mark a player's output as changed. An index >= MAX_PLAYERS marks every
+// player, for changes that move pads between players.
+void feedback_mark_changed(uint8_t player_index);
+
+// Return the changed mask (bit n = player n) and clear it
+uint32_t feedback_take_changed(void);
+
 // ============================================================================
 // DEVICE CAPABILITY FLAGS
 // ============================================================================
@@ -168,12 +168,16 @@ int add_player(int dev_addr, int instance, input_transport_t transport, const ch
     playersCount++;
   } else {
     // FIXED MODE: Find first empty slot
+    player_index = -1;
     for (int i = 0; i < MAX_PLAYERS; i++) {
       if (players[i].dev_addr == -1) {
         player_index = i;
         break;
       }
     }
+    if (player_index < 0) {
+      return -1;
+    }
     // Update playersCount for LED indication
     if (player_index >= playersCount) {
       playersCount = player_index + 1;
@@ -194,6 +198,9 @@ int add_player(int dev_addr, int instance, input_transport_t transport, const ch
     players[player_index].name[0] = '\0';
   }
 
+  // The pad's output now follows this player's feedback
+  feedback_mark_changed(player_index);
+
   // Send CDC connect event for web config
 #if CFG_TUD_CDC > 0
   cdc_commands_send_connect_event(player_index,
@@ -298,6 +305,9 @@ void remove_players_by_address(int dev_addr, int instance)
     printf("[players] FIXED mode: playersCount now %d (highest occupied + 1)\n", playersCount);
   }
 
+  // SHIFT mode renumbers the players after the removed one
+  feedback_mark_changed(MAX_PLAYERS);
+
   // If all controllers disconnected, reset router outputs to neutral
   // This prevents stuck buttons from persisting after the last controller disconnects
   if (playersCount == 0) {
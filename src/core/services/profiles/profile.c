@@ -4,6 +4,7 @@
 // Supports per-output-target profile sets with shared fallback.
 
 #include "profile.h"
+#include "profile_blob.h"
 #include "pico/stdlib.h"
 #include <stdio.h>
 #include <string.h>
@@ -29,6 +30,10 @@ static uint8_t active_index[MAX_OUTPUT_TARGETS] = {0};
 // Per-player profile state
 static player_profile_state_t player_profiles[MAX_PLAYERS] = {0};
 
+// Uploaded profile (double-buffered so outputs never see a half-decoded blob)
+static profile_blob_runtime_t blob_slots[2];
+static const profile_t* volatile blob_profile = NULL;
+
 // Per-player switch combo state
 typedef struct {
     uint32_t p_select_hold_start;
@@ -152,6 +157,10 @@ void profile_set_output_mode_callback(output_mode_callback_t callback)
 
 const profile_t* profile_get_active(output_target_t output)
 {
+    if (blob_profile) {
+        return blob_profile;
+    }
+
     const profile_set_t* set = get_profile_set(output);
     if (!set || set->profile_count == 0) {
         return NULL;
@@ -279,6 +288,39 @@ void profile_cycle_prev(output_target_t output)
     profile_set_active(output, new_index);
 }
 
+// ============================================================================
+// UPLOADED PROFILE
+// ============================================================================
+
+const char* profile_activate_blob(const uint8_t* blob, uint16_t len)
+{
+    // Decode into whichever slot is not currently published
+    profile_blob_runtime_t* rt = (blob_profile == &blob_slots[0].profile) ?
+                                 &blob_slots[1] : &blob_slots[0];
+
+    const char* err = profile_blob_load(blob, len, rt);
+    if (err) {
+        printf("[profile] Blob rejected: %s\n", err);
+        return err;
+    }
+
+    blob_profile = &rt->profile;
+    printf("[profile] Activated uploaded profile '%s' (%d maps, %d combos)\n",
+           rt->name, rt->profile.button_map_count, rt->profile.combo_map_count);
+    return NULL;
+}
+
+void profile_clear_blob(void)
+{
+    blob_profile = NULL;
+}
+
+const char* profile_get_blob_name(void)
+{
+    const profile_t* p = blob_profile;
+    return p ? p->name : NULL;
+}
+
 // ============================================================================
 // PER-PLAYER PROFILE API
 // ============================================================================
@@ -287,6 +329,10 @@ const profile_t* profile_get_active_for_player(output_target_t output, uint8_t p
 {
     if (player_index >= MAX_PLAYERS) return NULL;
 
+    if (blob_profile) {
+        return blob_profile;
+    }
+
     const profile_set_t* set = get_profile_set(output);
     if (!set || set->profile_count == 0) {
         return NULL;
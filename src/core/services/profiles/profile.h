@@ -284,6 +284,24 @@ void profile_check_player_switch_combo(uint8_t player_index, uint32_t buttons);
 // Check if a specific player's switch combo is active
 bool profile_player_switch_combo_active(uint8_t player_index);
 
+// ============================================================================
+// UPLOADED PROFILE
+// ============================================================================
+// A profile blob (see profile_blob.h) can be activated at runtime. While
+// active it is returned by profile_get_active*() for every output and
+// player, in place of the configured profile sets. RAM only - cleared on
+// reboot.
+
+// Validate and activate blob. Returns NULL on success, or an error string
+// (the previously active profile stays in effect).
+const char* profile_activate_blob(const uint8_t* blob, uint16_t len);
+
+// Return to the configured profile sets
+void profile_clear_blob(void);
+
+// Name of the active uploaded profile, NULL if none
+const char* profile_get_blob_name(void);
+
 // ============================================================================
 // CALLBACKS
 // ============================================================================
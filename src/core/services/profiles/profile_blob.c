@@ -0,0 +1,177 @@
+// profile_blob.c - Binary profile format
+
+#include "profile_blob.h"
+#include <string.h>
+
+// ============================================================================
+// HELPERS
+// ============================================================================
+
+static inline uint16_t rd16(const uint8_t* p)
+{
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static inline uint32_t rd32(const uint8_t* p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) |
+           ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+// Header field offsets
+#define HDR_MAGIC       0
+#define HDR_VERSION     4
+#define HDR_SIZE        5
+#define HDR_TOTAL       6
+#define HDR_CRC         8
+#define HDR_MAP_COUNT   10
+#define HDR_COMBO_COUNT 11
+#define HDR_LMOD_COUNT  12
+#define HDR_RMOD_COUNT  13
+#define HDR_NAME        16
+
+// Settings field offsets (relative to settings section)
+#define SET_L2_BEHAVIOR 0
+#define SET_R2_BEHAVIOR 1
+#define SET_L2_THRESH   2
+#define SET_R2_THRESH   3
+#define SET_L2_VALUE    4
+#define SET_R2_VALUE    5
+#define SET_LEFT_SENS   6
+#define SET_RIGHT_SENS  7
+#define SET_SOCD        8
+#define SET_FLAGS       9
+
+uint16_t profile_blob_crc(const uint8_t* blob, uint16_t len)
+{
+    // CRC-16-CCITT (poly 0x1021, init 0xFFFF), same as the CDC protocol
+    uint16_t crc = 0xFFFF;
+    for (uint16_t i = 0; i < len; i++) {
+        uint8_t byte = (i == HDR_CRC || i == HDR_CRC + 1) ? 0 : blob[i];
+        crc ^= (uint16_t)byte << 8;
+        for (int b = 0; b < 8; b++) {
+            crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : crc << 1;
+        }
+    }
+    return crc;
+}
+
+// ============================================================================
+// VALIDATION
+// ============================================================================
+
+static const char* validate(const uint8_t* blob, uint16_t len)
+{
+    if (len < PROFILE_BLOB_HEADER_SIZE + PROFILE_BLOB_SETTINGS_SIZE) return "blob too short";
+    if (rd32(&blob[HDR_MAGIC]) != PROFILE_BLOB_MAGIC) return "bad magic";
+    if (blob[HDR_VERSION] != PROFILE_BLOB_VERSION) return "unsupported version";
+    if (blob[HDR_SIZE] != PROFILE_BLOB_HEADER_SIZE) return "bad header size";
+    if (rd16(&blob[HDR_TOTAL]) != len) return "size mismatch";
+
+    uint8_t maps = blob[HDR_MAP_COUNT];
+    uint8_t combos = blob[HDR_COMBO_COUNT];
+    uint8_t lmods = blob[HDR_LMOD_COUNT];
+    uint8_t rmods = blob[HDR_RMOD_COUNT];
+    if (maps > MAX_BUTTON_MAPPINGS || combos > MAX_BUTTON_COMBOS ||
+        lmods > PROFILE_BLOB_MAX_MODIFIERS || rmods > PROFILE_BLOB_MAX_MODIFIERS) {
+        return "too many entries";
+    }
+
+    uint32_t expected = PROFILE_BLOB_HEADER_SIZE + PROFILE_BLOB_SETTINGS_SIZE +
+                        maps * PROFILE_BLOB_MAP_SIZE +
+                        combos * PROFILE_BLOB_COMBO_SIZE +
+                        (lmods + rmods) * PROFILE_BLOB_MOD_SIZE;
+    if (expected != len) return "section size mismatch";
+
+    if (rd16(&blob[HDR_CRC]) != profile_blob_crc(blob, len)) return "crc mismatch";
+
+    const uint8_t* s = &blob[PROFILE_BLOB_HEADER_SIZE];
+    if (s[SET_L2_BEHAVIOR] > TRIGGER_DISABLED || s[SET_R2_BEHAVIOR] > TRIGGER_DISABLED) {
+        return "invalid trigger behavior";
+    }
+    if (s[SET_LEFT_SENS] > 100 || s[SET_RIGHT_SENS] > 100) return "invalid stick sensitivity";
+    if (s[SET_SOCD] > SOCD_LAST_WIN) return "invalid socd mode";
+
+    const uint8_t* p = s + PROFILE_BLOB_SETTINGS_SIZE;
+    for (uint8_t i = 0; i < maps; i++, p += PROFILE_BLOB_MAP_SIZE) {
+        if (p[8] > ANALOG_TARGET_R2_CUSTOM) return "invalid analog target";
+    }
+    p += combos * PROFILE_BLOB_COMBO_SIZE;
+    for (uint8_t i = 0; i < lmods + rmods; i++, p += PROFILE_BLOB_MOD_SIZE) {
+        if (p[4] > 100) return "invalid modifier sensitivity";
+    }
+
+    return NULL;
+}
+
+// ============================================================================
+// LOADER
+// ============================================================================
+
+static const uint8_t* decode_modifiers(const uint8_t* p, uint8_t count, stick_modifier_t* out)
+{
+    for (uint8_t i = 0; i < count; i++, p += PROFILE_BLOB_MOD_SIZE) {
+        out[i].trigger = rd32(&p[0]);
+        out[i].sensitivity = p[4] / 100.0f;
+        out[i].consume_trigger = (p[5] & PROFILE_BLOB_MOD_CONSUME) != 0;
+    }
+    return p;
+}
+
+const char* profile_blob_load(const uint8_t* blob, uint16_t len, profile_blob_runtime_t* rt)
+{
+    const char* err = validate(blob, len);
+    if (err) return err;
+
+    uint8_t maps = blob[HDR_MAP_COUNT];
+    uint8_t combos = blob[HDR_COMBO_COUNT];
+    uint8_t lmods = blob[HDR_LMOD_COUNT];
+    uint8_t rmods = blob[HDR_RMOD_COUNT];
+
+    memset(rt, 0, sizeof(*rt));
+    memcpy(rt->name, &blob[HDR_NAME], PROFILE_BLOB_NAME_LEN);
+    rt->name[PROFILE_BLOB_NAME_LEN] = '\0';
+
+    profile_t* prof = &rt->profile;
+    prof->name = rt->name;
+    prof->description = "Uploaded profile";
+
+    const uint8_t* s = &blob[PROFILE_BLOB_HEADER_SIZE];
+    prof->l2_behavior = (trigger_behavior_t)s[SET_L2_BEHAVIOR];
+    prof->r2_behavior = (trigger_behavior_t)s[SET_R2_BEHAVIOR];
+    prof->l2_threshold = s[SET_L2_THRESH];
+    prof->r2_threshold = s[SET_R2_THRESH];
+    prof->l2_analog_value = s[SET_L2_VALUE];
+    prof->r2_analog_value = s[SET_R2_VALUE];
+    prof->left_stick_sensitivity = s[SET_LEFT_SENS] / 100.0f;
+    prof->right_stick_sensitivity = s[SET_RIGHT_SENS] / 100.0f;
+    prof->socd_mode = (socd_mode_t)s[SET_SOCD];
+    prof->adaptive_triggers = (s[SET_FLAGS] & PROFILE_BLOB_FLAG_ADAPTIVE_TRIGGERS) != 0;
+
+    const uint8_t* p = s + PROFILE_BLOB_SETTINGS_SIZE;
+    for (uint8_t i = 0; i < maps; i++, p += PROFILE_BLOB_MAP_SIZE) {
+        rt->button_map[i].input = rd32(&p[0]);
+        rt->button_map[i].output = rd32(&p[4]);
+        rt->button_map[i].analog = (analog_target_t)p[8];
+        rt->button_map[i].analog_value = p[9];
+    }
+    for (uint8_t i = 0; i < combos; i++, p += PROFILE_BLOB_COMBO_SIZE) {
+        rt->combos[i].inputs = rd32(&p[0]);
+        rt->combos[i].output = rd32(&p[4]);
+        rt->combos[i].consume_inputs = (p[8] & PROFILE_BLOB_COMBO_CONSUME) != 0;
+        rt->combos[i].exclusive = (p[8] & PROFILE_BLOB_COMBO_EXCLUSIVE) != 0;
+    }
+    p = decode_modifiers(p, lmods, rt->left_modifiers);
+    decode_modifiers(p, rmods, rt->right_modifiers);
+
+    prof->button_map = maps ? rt->button_map : NULL;
+    prof->button_map_count = maps;
+    prof->combo_map = combos ? rt->combos : NULL;
+    prof->combo_map_count = combos;
+    prof->left_stick_modifiers = lmods ? rt->left_modifiers : NULL;
+    prof->left_stick_modifier_count = lmods;
+    prof->right_stick_modifiers = rmods ? rt->right_modifiers : NULL;
+    prof->right_stick_modifier_count = rmods;
+
+    return NULL;
+}
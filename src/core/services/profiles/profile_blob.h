@@ -0,0 +1,96 @@
+// profile_blob.h - Binary profile format
+//
+// A profile blob is a self-contained, versioned binary encoding of a
+// profile_t, produced by tools/profile_compiler.py from a readable JSON
+// description. The device validates a blob once, when it is activated, and
+// decodes it into a profile_blob_runtime_t - a profile_t plus the arrays it
+// points at - so profile_apply() runs on it exactly as on a built-in profile.
+//
+// Loading is bounded (every count is capped by the runtime arrays) and
+// allocation-free: the caller owns the runtime storage.
+//
+// Layout (little-endian, no padding):
+//
+//   Header (32 bytes)
+//     magic:4        "JPPB"
+//     version:1      PROFILE_BLOB_VERSION
+//     header_size:1  32 (lets later versions append header fields)
+//     size:2         Total blob size in bytes
+//     crc:2          CRC-16-CCITT over the blob with this field zeroed
+//     map_count:1    Button map records
+//     combo_count:1  Combo records
+//     lmod_count:1   Left stick modifier records
+//     rmod_count:1   Right stick modifier records
+//     reserved:2
+//     name:16        Null-padded, need not be terminated if all 16 used
+//
+//   Settings (12 bytes)
+//     l2_behavior:1, r2_behavior:1, l2_threshold:1, r2_threshold:1,
+//     l2_analog_value:1, r2_analog_value:1,
+//     left_sens:1, right_sens:1   Percent (0-100)
+//     socd_mode:1, flags:1        Bit 0: adaptive triggers
+//     reserved:2
+//
+//   Button maps  (10 bytes each): input:4, output:4, analog:1, analog_value:1
+//   Combos        (9 bytes each): inputs:4, output:4, flags:1 (bit 0 consume, bit 1 exclusive)
+//   Modifiers     (6 bytes each): trigger:4, sensitivity:1 (percent), flags:1 (bit 0 consume)
+//                                 (left stick records first, then right)
+
+#ifndef PROFILE_BLOB_H
+#define PROFILE_BLOB_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "profile.h"
+
+// ============================================================================
+// FORMAT CONSTANTS
+// ============================================================================
+
+#define PROFILE_BLOB_MAGIC          0x4250504A  // "JPPB"
+#define PROFILE_BLOB_VERSION        1
+#define PROFILE_BLOB_HEADER_SIZE    32
+#define PROFILE_BLOB_SETTINGS_SIZE  12
+#define PROFILE_BLOB_MAP_SIZE       10
+#define PROFILE_BLOB_COMBO_SIZE     9
+#define PROFILE_BLOB_MOD_SIZE       6
+#define PROFILE_BLOB_NAME_LEN       16
+
+#define PROFILE_BLOB_MAX_MODIFIERS  4   // Per stick
+
+#define PROFILE_BLOB_FLAG_ADAPTIVE_TRIGGERS (1 << 0)
+#define PROFILE_BLOB_COMBO_CONSUME          (1 << 0)
+#define PROFILE_BLOB_COMBO_EXCLUSIVE        (1 << 1)
+#define PROFILE_BLOB_MOD_CONSUME            (1 << 0)
+
+// Largest valid blob (all arrays full)
+#define PROFILE_BLOB_MAX_SIZE (PROFILE_BLOB_HEADER_SIZE + PROFILE_BLOB_SETTINGS_SIZE + \
+                               MAX_BUTTON_MAPPINGS * PROFILE_BLOB_MAP_SIZE + \
+                               MAX_BUTTON_COMBOS * PROFILE_BLOB_COMBO_SIZE + \
+                               2 * PROFILE_BLOB_MAX_MODIFIERS * PROFILE_BLOB_MOD_SIZE)
+
+// ============================================================================
+// RUNTIME FORM
+// ============================================================================
+
+typedef struct {
+    profile_t profile;          // Points into the arrays below
+    char name[PROFILE_BLOB_NAME_LEN + 1];
+    button_map_entry_t button_map[MAX_BUTTON_MAPPINGS];
+    button_combo_entry_t combos[MAX_BUTTON_COMBOS];
+    stick_modifier_t left_modifiers[PROFILE_BLOB_MAX_MODIFIERS];
+    stick_modifier_t right_modifiers[PROFILE_BLOB_MAX_MODIFIERS];
+} profile_blob_runtime_t;
+
+// ============================================================================
+// API
+// ============================================================================
+
+// Validate blob and decode it into rt. On failure rt is left untouched and
+// an error string is returned; on success returns NULL.
+const char* profile_blob_load(const uint8_t* blob, uint16_t len, profile_blob_runtime_t* rt);
+
+// CRC the loader expects in the header (crc field treated as zero)
+uint16_t profile_blob_crc(const uint8_t* blob, uint16_t len);
+
+#endif // PROFILE_BLOB_H
@@ -53,6 +53,9 @@ static void flush_output(void)
 #define FLASH_TARGET_OFFSET (PICO_FLASH_SIZE_BYTES - BTSTACK_FLASH_SIZE - FLASH_SECTOR_SIZE)
 #endif
 
+// Cache sector sits directly below settings
+#define FLASH_CACHE_OFFSET (FLASH_TARGET_OFFSET - FLASH_SECTOR_SIZE)
+
 // Journal configuration
 #define JOURNAL_SLOT_SIZE FLASH_PAGE_SIZE  // 256 bytes per slot
 #define JOURNAL_SLOT_COUNT (FLASH_SECTOR_SIZE / JOURNAL_SLOT_SIZE)  // 16 slots
@@ -340,6 +343,56 @@ bool flash_has_pending_write(void)
     return save_pending || erase_pending;
 }
 
+// ============================================================================
+// Cache Sector
+// ============================================================================
+
+static void __no_inline_not_in_flash_func(cache_erase_worker)(void* param)
+{
+    (void)param;
+    flash_range_erase(FLASH_CACHE_OFFSET, FLASH_SECTOR_SIZE);
+}
+
+const uint8_t* flash_cache_page(uint8_t index)
+{
+    if (index >= FLASH_CACHE_PAGE_COUNT) return NULL;
+    return (const uint8_t*)(XIP_BASE + FLASH_CACHE_OFFSET + (index * FLASH_PAGE_SIZE));
+}
+
+bool flash_cache_write_page(uint8_t index, const uint8_t* data)
+{
+    static uint8_t write_buffer[FLASH_PAGE_SIZE];  // Static to persist during flash ops
+    if (index >= FLASH_CACHE_PAGE_COUNT) return false;
+    memcpy(write_buffer, data, FLASH_PAGE_SIZE);
+
+    page_program_params_t params = {
+        .offset = FLASH_CACHE_OFFSET + (index * FLASH_PAGE_SIZE),
+        .data = write_buffer
+    };
+
+    int result = flash_safe_execute(page_program_worker, &params, UINT32_MAX);
+    if (result != PICO_OK) {
+        uint32_t ints = save_and_disable_interrupts();
+        flash_range_program(params.offset, write_buffer, FLASH_PAGE_SIZE);
+        restore_interrupts(ints);
+    }
+    return true;
+}
+
+bool flash_cache_erase(void)
+{
+    if (bt_is_active()) return false;
+
+    printf("[flash] Erasing cache sector at offset 0x%X\n", FLASH_CACHE_OFFSET);
+    int result = flash_safe_execute(cache_erase_worker, NULL, UINT32_MAX);
+    if (result != PICO_OK) {
+        uint32_t ints = save_and_disable_interrupts();
+        flash_range_erase(FLASH_CACHE_OFFSET, FLASH_SECTOR_SIZE);
+        restore_interrupts(ints);
+    }
+    return true;
+}
+
 // ============================================================================
 // Custom Profile Helpers
 // ============================================================================
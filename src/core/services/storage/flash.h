@@ -100,6 +100,24 @@ void flash_on_bt_disconnect(void);
 // Check if there's a pending flash write waiting for BT to be idle
 bool flash_has_pending_write(void);
 
+// ============================================================================
+// Cache Sector
+// ============================================================================
+// One sector below settings for data that can be rebuilt at any time (e.g.
+// parsed HID descriptors). Pages are written once into erased flash (BT-safe,
+// ~1ms); the whole sector is erased when full, only while BT is idle.
+
+#define FLASH_CACHE_PAGE_COUNT 16   // 256-byte pages
+
+// XIP pointer to a cache page (erased pages read as 0xFF)
+const uint8_t* flash_cache_page(uint8_t index);
+
+// Program one 256-byte page. The page must be erased.
+bool flash_cache_write_page(uint8_t index, const uint8_t* data);
+
+// Erase the cache sector. Returns false (and does nothing) while BT is active.
+bool flash_cache_erase(void);
+
 // ============================================================================
 // Custom Profile Helpers
 // ============================================================================
@@ -76,10 +76,96 @@ extern bool GamecubeConsole_WaitForPoll(GamecubeConsole* console);
 extern void GamecubeConsole_SendReport(GamecubeConsole* console, gc_report_t *report);
 extern void GamecubeConsole_SetMode(GamecubeConsole* console, GamecubeMode mode);
 
-uint8_t hid_to_gc_key[256] = {[0 ... 255] = GC_KEY_NOT_FOUND};
 uint8_t gc_last_rumble = 0;
 uint8_t gc_kb_counter = 0;
 
+// HID keyboard usage -> GameCube keyboard key (0 = GC_KEY_NOT_FOUND)
+static const uint8_t hid_to_gc_key[256] = {
+  [HID_KEY_A] = GC_KEY_A,
+  [HID_KEY_B] = GC_KEY_B,
+  [HID_KEY_C] = GC_KEY_C,
+  [HID_KEY_D] = GC_KEY_D,
+  [HID_KEY_E] = GC_KEY_E,
+  [HID_KEY_F] = GC_KEY_F,
+  [HID_KEY_G] = GC_KEY_G,
+  [HID_KEY_H] = GC_KEY_H,
+  [HID_KEY_I] = GC_KEY_I,
+  [HID_KEY_J] = GC_KEY_J,
+  [HID_KEY_K] = GC_KEY_K,
+  [HID_KEY_L] = GC_KEY_L,
+  [HID_KEY_M] = GC_KEY_M,
+  [HID_KEY_N] = GC_KEY_N,
+  [HID_KEY_O] = GC_KEY_O,
+  [HID_KEY_P] = GC_KEY_P,
+  [HID_KEY_Q] = GC_KEY_Q,
+  [HID_KEY_R] = GC_KEY_R,
+  [HID_KEY_S] = GC_KEY_S,
+  [HID_KEY_T] = GC_KEY_T,
+  [HID_KEY_U] = GC_KEY_U,
+  [HID_KEY_V] = GC_KEY_V,
+  [HID_KEY_W] = GC_KEY_W,
+  [HID_KEY_X] = GC_KEY_X,
+  [HID_KEY_Y] = GC_KEY_Y,
+  [HID_KEY_Z] = GC_KEY_Z,
+  [HID_KEY_1] = GC_KEY_1,
+  [HID_KEY_2] = GC_KEY_2,
+  [HID_KEY_3] = GC_KEY_3,
+  [HID_KEY_4] = GC_KEY_4,
+  [HID_KEY_5] = GC_KEY_5,
+  [HID_KEY_6] = GC_KEY_6,
+  [HID_KEY_7] = GC_KEY_7,
+  [HID_KEY_8] = GC_KEY_8,
+  [HID_KEY_9] = GC_KEY_9,
+  [HID_KEY_0] = GC_KEY_0,
+  [HID_KEY_MINUS] = GC_KEY_MINUS,
+  [HID_KEY_EQUAL] = GC_KEY_CARET,
+  [HID_KEY_GRAVE] = GC_KEY_GRAVE,
+  [HID_KEY_PRINT_SCREEN] = GC_KEY_AT,
+  [HID_KEY_BRACKET_LEFT] = GC_KEY_LEFTBRACKET,
+  [HID_KEY_SEMICOLON] = GC_KEY_SEMICOLON,
+  [HID_KEY_APOSTROPHE] = GC_KEY_COLON,
+  [HID_KEY_BRACKET_RIGHT] = GC_KEY_RIGHTBRACKET,
+  [HID_KEY_COMMA] = GC_KEY_COMMA,
+  [HID_KEY_PERIOD] = GC_KEY_PERIOD,
+  [HID_KEY_SLASH] = GC_KEY_SLASH,
+  [HID_KEY_BACKSLASH] = GC_KEY_BACKSLASH,
+  [HID_KEY_F1] = GC_KEY_F1,
+  [HID_KEY_F2] = GC_KEY_F2,
+  [HID_KEY_F3] = GC_KEY_F3,
+  [HID_KEY_F4] = GC_KEY_F4,
+  [HID_KEY_F5] = GC_KEY_F5,
+  [HID_KEY_F6] = GC_KEY_F6,
+  [HID_KEY_F7] = GC_KEY_F7,
+  [HID_KEY_F8] = GC_KEY_F8,
+  [HID_KEY_F9] = GC_KEY_F9,
+  [HID_KEY_F10] = GC_KEY_F10,
+  [HID_KEY_F11] = GC_KEY_F11,
+  [HID_KEY_F12] = GC_KEY_F12,
+  [HID_KEY_ESCAPE] = GC_KEY_ESC,
+  [HID_KEY_INSERT] = GC_KEY_INSERT,
+  [HID_KEY_DELETE] = GC_KEY_DELETE,
+  [HID_KEY_BACKSPACE] = GC_KEY_BACKSPACE,
+  [HID_KEY_TAB] = GC_KEY_TAB,
+  [HID_KEY_CAPS_LOCK] = GC_KEY_CAPSLOCK,
+  [HID_KEY_SHIFT_LEFT] = GC_KEY_LEFTSHIFT,
+  [HID_KEY_SHIFT_RIGHT] = GC_KEY_RIGHTSHIFT,
+  [HID_KEY_CONTROL_LEFT] = GC_KEY_LEFTCTRL,
+  [HID_KEY_ALT_LEFT] = GC_KEY_LEFTALT,
+  [HID_KEY_GUI_LEFT] = GC_KEY_LEFTUNK1,
+  [HID_KEY_SPACE] = GC_KEY_SPACE,
+  [HID_KEY_GUI_RIGHT] = GC_KEY_RIGHTUNK1,
+  [HID_KEY_APPLICATION] = GC_KEY_RIGHTUNK2,
+  [HID_KEY_ARROW_LEFT] = GC_KEY_LEFT,
+  [HID_KEY_ARROW_DOWN] = GC_KEY_DOWN,
+  [HID_KEY_ARROW_UP] = GC_KEY_UP,
+  [HID_KEY_ARROW_RIGHT] = GC_KEY_RIGHT,
+  [HID_KEY_ENTER] = GC_KEY_ENTER,
+  [HID_KEY_HOME] = GC_KEY_HOME,
+  [HID_KEY_END] = GC_KEY_END,
+  [HID_KEY_PAGE_DOWN] = GC_KEY_PAGEDOWN,
+  [HID_KEY_PAGE_UP] = GC_KEY_PAGEUP,
+};
+
 // Helper function to scale analog values relative to center (128)
 // Clamps to 1-255 range - some GameCube games reject 0 as invalid
 static inline uint8_t scale_toward_center(uint8_t val, float scale, uint8_t center)
@@ -92,94 +178,6 @@ static inline uint8_t scale_toward_center(uint8_t val, float scale, uint8_t cent
   return (uint8_t)result;
 }
 
-// init hid key to gc key lookup table
-void gc_kb_key_lookup_init()
-{
-  hid_to_gc_key[HID_KEY_A] = GC_KEY_A;
-  hid_to_gc_key[HID_KEY_B] = GC_KEY_B;
-  hid_to_gc_key[HID_KEY_C] = GC_KEY_C;
-  hid_to_gc_key[HID_KEY_D] = GC_KEY_D;
-  hid_to_gc_key[HID_KEY_E] = GC_KEY_E;
-  hid_to_gc_key[HID_KEY_F] = GC_KEY_F;
-  hid_to_gc_key[HID_KEY_G] = GC_KEY_G;
-  hid_to_gc_key[HID_KEY_H] = GC_KEY_H;
-  hid_to_gc_key[HID_KEY_I] = GC_KEY_I;
-  hid_to_gc_key[HID_KEY_J] = GC_KEY_J;
-  hid_to_gc_key[HID_KEY_K] = GC_KEY_K;
-  hid_to_gc_key[HID_KEY_L] = GC_KEY_L;
-  hid_to_gc_key[HID_KEY_M] = GC_KEY_M;
-  hid_to_gc_key[HID_KEY_N] = GC_KEY_N;
-  hid_to_gc_key[HID_KEY_O] = GC_KEY_O;
-  hid_to_gc_key[HID_KEY_P] = GC_KEY_P;
-  hid_to_gc_key[HID_KEY_Q] = GC_KEY_Q;
-  hid_to_gc_key[HID_KEY_R] = GC_KEY_R;
-  hid_to_gc_key[HID_KEY_S] = GC_KEY_S;
-  hid_to_gc_key[HID_KEY_T] = GC_KEY_T;
-  hid_to_gc_key[HID_KEY_U] = GC_KEY_U;
-  hid_to_gc_key[HID_KEY_V] = GC_KEY_V;
-  hid_to_gc_key[HID_KEY_W] = GC_KEY_W;
-  hid_to_gc_key[HID_KEY_X] = GC_KEY_X;
-  hid_to_gc_key[HID_KEY_Y] = GC_KEY_Y;
-  hid_to_gc_key[HID_KEY_Z] = GC_KEY_Z;
-  hid_to_gc_key[HID_KEY_1] = GC_KEY_1;
-  hid_to_gc_key[HID_KEY_2] = GC_KEY_2;
-  hid_to_gc_key[HID_KEY_3] = GC_KEY_3;
-  hid_to_gc_key[HID_KEY_4] = GC_KEY_4;
-  hid_to_gc_key[HID_KEY_5] = GC_KEY_5;
-  hid_to_gc_key[HID_KEY_6] = GC_KEY_6;
-  hid_to_gc_key[HID_KEY_7] = GC_KEY_7;
-  hid_to_gc_key[HID_KEY_8] = GC_KEY_8;
-  hid_to_gc_key[HID_KEY_9] = GC_KEY_9;
-  hid_to_gc_key[HID_KEY_0] = GC_KEY_0;
-  hid_to_gc_key[HID_KEY_MINUS] = GC_KEY_MINUS;
-  hid_to_gc_key[HID_KEY_EQUAL] = GC_KEY_CARET;
-  hid_to_gc_key[HID_KEY_GRAVE] = GC_KEY_YEN;
-  hid_to_gc_key[HID_KEY_PRINT_SCREEN] = GC_KEY_AT;
-  hid_to_gc_key[HID_KEY_BRACKET_LEFT] = GC_KEY_LEFTBRACKET;
-  hid_to_gc_key[HID_KEY_SEMICOLON] = GC_KEY_SEMICOLON;
-  hid_to_gc_key[HID_KEY_APOSTROPHE] = GC_KEY_COLON;
-  hid_to_gc_key[HID_KEY_BRACKET_RIGHT] = GC_KEY_RIGHTBRACKET;
-  hid_to_gc_key[HID_KEY_COMMA] = GC_KEY_COMMA;
-  hid_to_gc_key[HID_KEY_PERIOD] = GC_KEY_PERIOD;
-  hid_to_gc_key[HID_KEY_SLASH] = GC_KEY_SLASH;
-  hid_to_gc_key[HID_KEY_BACKSLASH] = GC_KEY_BACKSLASH;
-  hid_to_gc_key[HID_KEY_F1] = GC_KEY_F1;
-  hid_to_gc_key[HID_KEY_F2] = GC_KEY_F2;
-  hid_to_gc_key[HID_KEY_F3] = GC_KEY_F3;
-  hid_to_gc_key[HID_KEY_F4] = GC_KEY_F4;
-  hid_to_gc_key[HID_KEY_F5] = GC_KEY_F5;
-  hid_to_gc_key[HID_KEY_F6] = GC_KEY_F6;
-  hid_to_gc_key[HID_KEY_F7] = GC_KEY_F7;
-  hid_to_gc_key[HID_KEY_F8] = GC_KEY_F8;
-  hid_to_gc_key[HID_KEY_F9] = GC_KEY_F9;
-  hid_to_gc_key[HID_KEY_F10] = GC_KEY_F10;
-  hid_to_gc_key[HID_KEY_F11] = GC_KEY_F11;
-  hid_to_gc_key[HID_KEY_F12] = GC_KEY_F12;
-  hid_to_gc_key[HID_KEY_ESCAPE] = GC_KEY_ESC;
-  hid_to_gc_key[HID_KEY_INSERT] = GC_KEY_INSERT;
-  hid_to_gc_key[HID_KEY_DELETE] = GC_KEY_DELETE;
-  hid_to_gc_key[HID_KEY_GRAVE] = GC_KEY_GRAVE;
-  hid_to_gc_key[HID_KEY_BACKSPACE] = GC_KEY_BACKSPACE;
-  hid_to_gc_key[HID_KEY_TAB] = GC_KEY_TAB;
-  hid_to_gc_key[HID_KEY_CAPS_LOCK] = GC_KEY_CAPSLOCK;
-  hid_to_gc_key[HID_KEY_SHIFT_LEFT] = GC_KEY_LEFTSHIFT;
-  hid_to_gc_key[HID_KEY_SHIFT_RIGHT] = GC_KEY_RIGHTSHIFT;
-  hid_to_gc_key[HID_KEY_CONTROL_LEFT] = GC_KEY_LEFTCTRL;
-  hid_to_gc_key[HID_KEY_ALT_LEFT] = GC_KEY_LEFTALT;
-  hid_to_gc_key[HID_KEY_GUI_LEFT] = GC_KEY_LEFTUNK1;
-  hid_to_gc_key[HID_KEY_SPACE] = GC_KEY_SPACE;
-  hid_to_gc_key[HID_KEY_GUI_RIGHT] = GC_KEY_RIGHTUNK1;
-  hid_to_gc_key[HID_KEY_APPLICATION] = GC_KEY_RIGHTUNK2;
-  hid_to_gc_key[HID_KEY_ARROW_LEFT] = GC_KEY_LEFT;
-  hid_to_gc_key[HID_KEY_ARROW_DOWN] = GC_KEY_DOWN;
-  hid_to_gc_key[HID_KEY_ARROW_UP] = GC_KEY_UP;
-  hid_to_gc_key[HID_KEY_ARROW_RIGHT] = GC_KEY_RIGHT;
-  hid_to_gc_key[HID_KEY_ENTER] = GC_KEY_ENTER;
-  hid_to_gc_key[HID_KEY_HOME] = GC_KEY_HOME;
-  hid_to_gc_key[HID_KEY_END] = GC_KEY_END;
-  hid_to_gc_key[HID_KEY_PAGE_DOWN] = GC_KEY_PAGEDOWN;
-  hid_to_gc_key[HID_KEY_PAGE_UP] = GC_KEY_PAGEUP;
-}
 
 // init for gamecube communication
 void ngc_init()
@@ -230,7 +228,6 @@ void ngc_init()
 
   int sm = -1;
   int offset = -1;
-  gc_kb_key_lookup_init();
   GamecubeConsole_init(&gc, GC_DATA_PIN, pio, sm, offset);
   gc_report = default_gc_report;
 
@@ -240,11 +237,6 @@ void ngc_init()
   }
 }
 
-uint8_t gc_kb_key_lookup(uint8_t hid_key)
-{
-  return hid_to_gc_key[hid_key];
-}
-
 uint8_t furthest_from_center(uint8_t a, uint8_t b, uint8_t center)
 {
   int distance_a = abs(a - center);
@@ -429,11 +421,15 @@ void __not_in_flash_func(update_output)(void)
   }
   else
   {
-    // Keyboard mode
-    uint8_t gc_key = gc_kb_key_lookup(event->keys);
-    new_report.keyboard.keypress[0] = gc_key;
-    new_report.keyboard.keypress[1] = GC_KEY_NOT_FOUND;
-    new_report.keyboard.keypress[2] = GC_KEY_NOT_FOUND;
+    // Keyboard mode: the first three held keys the GameCube keyboard has
+    uint8_t n = 0;
+    for (int usage = key_bitmap_next(&event->key_state, 0); usage >= 0 && n < 3;
+         usage = key_bitmap_next(&event->key_state, usage + 1))
+    {
+      uint8_t gc_key = hid_to_gc_key[usage];
+      if (gc_key != GC_KEY_NOT_FOUND) new_report.keyboard.keypress[n++] = gc_key;
+    }
+    while (n < 3) new_report.keyboard.keypress[n++] = GC_KEY_NOT_FOUND;
     new_report.keyboard.checksum = new_report.keyboard.keypress[0] ^
                                   new_report.keyboard.keypress[1] ^
                                   new_report.keyboard.keypress[2] ^ gc_kb_counter;
@@ -279,6 +279,14 @@ uint32_t cdc_data_write_str(const char* str)
     return cdc_data_write((const uint8_t*)str, strlen(str));
 }
 
+uint32_t cdc_data_write_available(void)
+{
+    if (!tud_cdc_n_connected(CDC_PORT_DATA)) {
+        return 0;
+    }
+    return tud_cdc_n_write_available(CDC_PORT_DATA);
+}
+
 void cdc_data_flush(void)
 {
     tud_cdc_n_write_flush(CDC_PORT_DATA);
@@ -398,6 +406,7 @@ uint32_t cdc_data_read(uint8_t* buffer, uint32_t bufsize) { (void)buffer; (void)
 int32_t cdc_data_read_byte(void) { return -1; }
 uint32_t cdc_data_write(const uint8_t* buffer, uint32_t bufsize) { (void)buffer; (void)bufsize; return 0; }
 uint32_t cdc_data_write_str(const char* str) { (void)str; return 0; }
+uint32_t cdc_data_write_available(void) { return 0; }
 void cdc_data_flush(void) {}
 bool cdc_debug_connected(void) { return false; }
 int cdc_debug_printf(const char* format, ...) { (void)format; return 0; }
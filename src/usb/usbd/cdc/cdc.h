@@ -45,6 +45,9 @@ uint32_t cdc_data_write(const uint8_t* buffer, uint32_t bufsize);
 // Write string to data port
 uint32_t cdc_data_write_str(const char* str);
 
+// Free space in data port TX buffer (0 if not connected)
+uint32_t cdc_data_write_available(void);
+
 // Flush data port
 void cdc_data_flush(void);
 
@@ -0,0 +1,253 @@
+// cdc_bulk.c - Binary bulk transfers over the CDC protocol
+// SPDX-License-Identifier: Apache-2.0
+// Copyright 2024 Robert Dale Smith
+
+#include "cdc_bulk.h"
+#include "cdc.h"
+#include "core/services/storage/flash.h"
+#include "core/services/profiles/profile.h"
+#include <string.h>
+#include <stdio.h>
+
+// ============================================================================
+// STATE
+// ============================================================================
+
+typedef enum {
+    BULK_IDLE,
+    BULK_UPLOAD,        // Receiving chunks into buffer
+    BULK_READ,          // Streaming buffer to host
+} bulk_state_t;
+
+static struct {
+    bulk_state_t state;
+    uint8_t target;
+    uint16_t size;
+    uint16_t crc;
+    uint16_t offset;    // Upload: bytes received. Read: bytes sent.
+} bulk = {0};
+
+static uint8_t bulk_buf[CDC_BULK_BUFFER_SIZE];
+
+// ============================================================================
+// PROFILE SET TARGET
+// ============================================================================
+
+static uint16_t profiles_snapshot(uint8_t* buf)
+{
+    flash_t* settings = flash_get_settings();
+    if (!settings) return 0;
+
+    uint8_t count = settings->custom_profile_count;
+    if (count > CUSTOM_PROFILE_MAX_COUNT) count = CUSTOM_PROFILE_MAX_COUNT;
+
+    buf[0] = CDC_BULK_PROFILES_VERSION;
+    buf[1] = count;
+    buf[2] = settings->active_profile_index;
+    buf[3] = 0;
+    memcpy(&buf[CDC_BULK_PROFILES_HEADER], settings->profiles,
+           count * sizeof(custom_profile_t));
+
+    return CDC_BULK_PROFILES_HEADER + count * sizeof(custom_profile_t);
+}
+
+static const char* profiles_validate(const uint8_t* buf, uint16_t size)
+{
+    if (size < CDC_BULK_PROFILES_HEADER) return "image too short";
+    if (buf[0] != CDC_BULK_PROFILES_VERSION) return "unsupported version";
+
+    uint8_t count = buf[1];
+    if (count > CUSTOM_PROFILE_MAX_COUNT) return "too many profiles";
+    if (size != CDC_BULK_PROFILES_HEADER + count * sizeof(custom_profile_t)) {
+        return "size mismatch";
+    }
+
+    uint8_t active = buf[2];
+    if (active != CDC_BULK_ACTIVE_KEEP && active > count) return "invalid active index";
+
+    const custom_profile_t* profiles = (const custom_profile_t*)&buf[CDC_BULK_PROFILES_HEADER];
+    for (uint8_t i = 0; i < count; i++) {
+        const custom_profile_t* p = &profiles[i];
+        if (memchr(p->name, '\0', CUSTOM_PROFILE_NAME_LEN) == NULL) return "name not terminated";
+        if (p->left_stick_sens > 200 || p->right_stick_sens > 200) return "invalid stick sensitivity";
+        for (int b = 0; b < CUSTOM_PROFILE_BUTTON_COUNT; b++) {
+            uint8_t m = p->button_map[b];
+            if (m != BUTTON_MAP_DISABLED && m > CUSTOM_PROFILE_BUTTON_COUNT) return "invalid button map";
+        }
+    }
+    return NULL;
+}
+
+static void profiles_apply(const uint8_t* buf)
+{
+    flash_t* settings = flash_get_settings();
+    uint8_t count = buf[1];
+    uint8_t active = buf[2];
+
+    memset(settings->profiles, 0, sizeof(settings->profiles));
+    memcpy(settings->profiles, &buf[CDC_BULK_PROFILES_HEADER], count * sizeof(custom_profile_t));
+    settings->custom_profile_count = count;
+
+    if (active != CDC_BULK_ACTIVE_KEEP) {
+        settings->active_profile_index = active;
+    } else if (settings->active_profile_index > count) {
+        settings->active_profile_index = 0;
+    }
+
+    // Whole set lands in one debounced write
+    flash_save(settings);
+}
+
+// ============================================================================
+// UPLOAD
+// ============================================================================
+
+const char* cdc_bulk_begin(uint8_t target, uint16_t size, uint16_t crc,
+                           uint16_t* out_offset)
+{
+    if (target >= CDC_BULK_TARGET_COUNT) return "invalid target";
+    if (size == 0 || size > CDC_BULK_BUFFER_SIZE) return "invalid size";
+
+    // Same transfer as the one in progress - resume where it stopped
+    if (bulk.state == BULK_UPLOAD && bulk.target == target &&
+        bulk.size == size && bulk.crc == crc) {
+        *out_offset = bulk.offset;
+        return NULL;
+    }
+
+    bulk.state = BULK_UPLOAD;
+    bulk.target = target;
+    bulk.size = size;
+    bulk.crc = crc;
+    bulk.offset = 0;
+    *out_offset = 0;
+    return NULL;
+}
+
+static void send_chunk_reply(cdc_protocol_t* ctx, cdc_msg_type_t type, uint8_t seq)
+{
+    uint8_t reply[2] = { bulk.offset & 0xFF, (bulk.offset >> 8) & 0xFF };
+    cdc_protocol_send(ctx, type, seq, reply, sizeof(reply));
+}
+
+void cdc_bulk_handle_chunk(cdc_protocol_t* ctx, const cdc_packet_t* packet)
+{
+    if (bulk.state != BULK_UPLOAD || packet->length < CDC_BULK_CHUNK_HEADER) {
+        cdc_protocol_send_nak(ctx, packet->seq);
+        return;
+    }
+
+    uint16_t offset = packet->payload[1] | ((uint16_t)packet->payload[2] << 8);
+    uint16_t len = packet->length - CDC_BULK_CHUNK_HEADER;
+
+    // Duplicate of data we already have (host resent after a lost ACK)
+    if (offset + len <= bulk.offset) {
+        send_chunk_reply(ctx, CDC_MSG_ACK, packet->seq);
+        return;
+    }
+
+    // Gap or overrun - tell host where to restart
+    if (offset != bulk.offset || offset + len > bulk.size) {
+        send_chunk_reply(ctx, CDC_MSG_NAK, packet->seq);
+        return;
+    }
+
+    memcpy(&bulk_buf[offset], &packet->payload[CDC_BULK_CHUNK_HEADER], len);
+    bulk.offset += len;
+    send_chunk_reply(ctx, CDC_MSG_ACK, packet->seq);
+}
+
+const char* cdc_bulk_commit(void)
+{
+    if (bulk.state != BULK_UPLOAD) return "no upload";
+    if (bulk.offset != bulk.size) return "incomplete";
+
+    if (cdc_crc16(bulk_buf, bulk.size) != bulk.crc) {
+        // Data is bad - don't let a resume reuse it
+        bulk.state = BULK_IDLE;
+        return "crc mismatch";
+    }
+
+    const char* err = NULL;
+    switch (bulk.target) {
+        case CDC_BULK_TARGET_PROFILES:
+            err = profiles_validate(bulk_buf, bulk.size);
+            if (!err) profiles_apply(bulk_buf);
+            break;
+        case CDC_BULK_TARGET_PROFILE_BLOB:
+            err = profile_activate_blob(bulk_buf, bulk.size);
+            break;
+        default:
+            err = "invalid target";
+            break;
+    }
+
+    printf("[CDC] Bulk commit target %d (%d bytes): %s\n",
+           bulk.target, bulk.size, err ? err : "ok");
+    bulk.state = BULK_IDLE;
+    return err;
+}
+
+void cdc_bulk_abort(void)
+{
+    bulk.state = BULK_IDLE;
+}
+
+uint16_t cdc_bulk_get_offset(void)
+{
+    return (bulk.state == BULK_UPLOAD) ? bulk.offset : 0;
+}
+
+// ============================================================================
+// READ
+// ============================================================================
+
+const char* cdc_bulk_read(uint8_t target, uint16_t* out_size, uint16_t* out_crc)
+{
+    uint16_t size = 0;
+    switch (target) {
+        case CDC_BULK_TARGET_PROFILES:
+            size = profiles_snapshot(bulk_buf);
+            break;
+        default:
+            return "invalid target";
+    }
+    if (size == 0) {
+        bulk.state = BULK_IDLE;
+        return "not available";
+    }
+
+    bulk.state = BULK_READ;
+    bulk.target = target;
+    bulk.size = size;
+    bulk.crc = cdc_crc16(bulk_buf, size);
+    bulk.offset = 0;
+
+    *out_size = bulk.size;
+    *out_crc = bulk.crc;
+    return NULL;
+}
+
+void cdc_bulk_task(cdc_protocol_t* ctx)
+{
+    if (bulk.state != BULK_READ) return;
+
+    uint16_t len = bulk.size - bulk.offset;
+    if (len > CDC_BULK_CHUNK_MAX) len = CDC_BULK_CHUNK_MAX;
+
+    // Only send whole packets - a partial write would corrupt the stream
+    uint32_t packet_len = CDC_HEADER_SIZE + CDC_BULK_CHUNK_HEADER + len + CDC_CRC_SIZE;
+    if (cdc_data_write_available() < packet_len) return;
+
+    uint8_t chunk[CDC_MAX_PAYLOAD];
+    chunk[0] = CDC_DAT_STREAM_BULK;
+    chunk[1] = bulk.offset & 0xFF;
+    chunk[2] = (bulk.offset >> 8) & 0xFF;
+    memcpy(&chunk[CDC_BULK_CHUNK_HEADER], &bulk_buf[bulk.offset], len);
+    cdc_protocol_send_data(ctx, chunk, CDC_BULK_CHUNK_HEADER + len);
+
+    bulk.offset += len;
+    if (bulk.offset >= bulk.size) {
+        bulk.state = BULK_IDLE;
+    }
+}
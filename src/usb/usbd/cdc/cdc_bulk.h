@@ -0,0 +1,93 @@
+// cdc_bulk.h - Binary bulk transfers over the CDC protocol
+// SPDX-License-Identifier: Apache-2.0
+// Copyright 2024 Robert Dale Smith
+//
+// Moves whole images (e.g. the full custom profile set) in binary DAT chunks
+// instead of one JSON command per field:
+//
+//   BULK.BEGIN  {"target":0,"size":N,"crc":C}  -> {"ok":true,"offset":O,"chunk":K}
+//   DAT [CDC_DAT_STREAM_BULK][offset:2][data]  -> ACK/NAK [next_offset:2]
+//   BULK.COMMIT                                -> image CRC checked, applied,
+//                                                 one debounced flash write
+//
+// Chunks must arrive in order; the host may pipeline several before waiting
+// for ACKs. A NAK carries the offset the device expects next, so the host
+// rewinds and resends from there. Calling BULK.BEGIN again with the same
+// target/size/crc resumes an interrupted upload at the returned offset.
+//
+// BULK.READ streams the current image of a target back as DAT chunks
+// (same framing) so the host can verify or back up a profile library.
+//
+// Uploads are staged in RAM; nothing touches flash until commit succeeds.
+
+#ifndef CDC_BULK_H
+#define CDC_BULK_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "cdc_protocol.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ============================================================================
+// CONSTANTS
+// ============================================================================
+
+#define CDC_BULK_BUFFER_SIZE    4096    // Max image size (RAM staging buffer)
+#define CDC_BULK_CHUNK_HEADER   3       // stream(1) + offset(2)
+#define CDC_BULK_CHUNK_MAX      (CDC_MAX_PAYLOAD - CDC_BULK_CHUNK_HEADER)
+
+// ============================================================================
+// TARGETS
+// ============================================================================
+
+typedef enum {
+    // Custom profile set:
+    // [version:1][count:1][active:1][reserved:1][custom_profile_t x count]
+    // active: flash profile index (0=default, 1-N=custom), 0xFF = keep current
+    CDC_BULK_TARGET_PROFILES = 0,
+    // Profile blob (profile_blob.h), activated on commit. Write only.
+    CDC_BULK_TARGET_PROFILE_BLOB = 1,
+    CDC_BULK_TARGET_COUNT
+} cdc_bulk_target_t;
+
+#define CDC_BULK_PROFILES_VERSION   1
+#define CDC_BULK_PROFILES_HEADER    4
+#define CDC_BULK_ACTIVE_KEEP        0xFF
+
+// ============================================================================
+// API
+// ============================================================================
+
+// Start (or resume) an upload. Returns NULL on success with *out_offset set
+// to the first byte the host should send, or an error string.
+const char* cdc_bulk_begin(uint8_t target, uint16_t size, uint16_t crc,
+                           uint16_t* out_offset);
+
+// Handle a DAT chunk for CDC_DAT_STREAM_BULK (replies ACK or NAK)
+void cdc_bulk_handle_chunk(cdc_protocol_t* ctx, const cdc_packet_t* packet);
+
+// Verify CRC, validate and apply the staged upload.
+// Returns NULL on success, or an error string.
+const char* cdc_bulk_commit(void);
+
+// Drop any staged upload or pending read
+void cdc_bulk_abort(void);
+
+// Bytes received so far for the current upload (0 if idle)
+uint16_t cdc_bulk_get_offset(void);
+
+// Snapshot a target into the staging buffer and start streaming it.
+// Cancels any upload in progress. Returns NULL on success, or an error string.
+const char* cdc_bulk_read(uint8_t target, uint16_t* out_size, uint16_t* out_crc);
+
+// Send pending read chunks as TX space allows (call from main loop)
+void cdc_bulk_task(cdc_protocol_t* ctx);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CDC_BULK_H
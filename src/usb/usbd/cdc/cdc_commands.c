@@ -4,11 +4,16 @@
 
 #include "cdc_commands.h"
 #include "cdc_protocol.h"
+#include "cdc_json.h"
+#include "cdc_bulk.h"
 #include "../usbd.h"
+#include "../usbd_mode.h"
 #include "core/services/storage/flash.h"
 #include "core/services/profiles/profile.h"
 #include "core/services/players/manager.h"
 #include "core/services/players/feedback.h"
+#include "core/services/metrics/metrics.h"
+#include "core/services/loopback/loopback.h"
 #include "hardware/watchdog.h"
 #include "pico/unique_id.h"
 #include "pico/bootrom.h"
@@ -21,6 +26,7 @@
 // Optional BT support
 #ifdef ENABLE_BTSTACK
 #include "bt/btstack/btstack_host.h"
+#include "bt/btstack/hci_capture.h"
 #include "bt/bthid/devices/vendors/nintendo/wiimote_bt.h"
 #endif
 
@@ -48,83 +54,6 @@ static char response_buf[CDC_MAX_PAYLOAD];
 #define BOARD_NAME "unknown"
 #endif
 
-// ============================================================================
-// JSON HELPERS
-// ============================================================================
-
-// Simple JSON string extractor: finds "key":"value" and returns value
-// Returns NULL if not found, or pointer to value (not null-terminated)
-static const char* json_get_string(const char* json, const char* key,
-                                   int* out_len)
-{
-    char search[64];
-    snprintf(search, sizeof(search), "\"%s\":\"", key);
-
-    const char* start = strstr(json, search);
-    if (!start) return NULL;
-
-    start += strlen(search);
-    const char* end = strchr(start, '"');
-    if (!end) return NULL;
-
-    if (out_len) *out_len = end - start;
-    return start;
-}
-
-// Simple JSON integer extractor: finds "key":123 and returns value
-static bool json_get_int(const char* json, const char* key, int* out_val)
-{
-    char search[64];
-    snprintf(search, sizeof(search), "\"%s\":", key);
-
-    const char* start = strstr(json, search);
-    if (!start) return false;
-
-    start += strlen(search);
-    // Skip whitespace
-    while (*start == ' ' || *start == '\t') start++;
-
-    if (*start == '-' || (*start >= '0' && *start <= '9')) {
-        *out_val = atoi(start);
-        return true;
-    }
-    return false;
-}
-
-// Simple JSON bool extractor
-static bool json_get_bool(const char* json, const char* key, bool* out_val)
-{
-    char search[64];
-    snprintf(search, sizeof(search), "\"%s\":", key);
-
-    const char* start = strstr(json, search);
-    if (!start) return false;
-
-    start += strlen(search);
-    while (*start == ' ' || *start == '\t') start++;
-
-    if (strncmp(start, "true", 4) == 0) {
-        *out_val = true;
-        return true;
-    } else if (strncmp(start, "false", 5) == 0) {
-        *out_val = false;
-        return true;
-    }
-    return false;
-}
-
-// Extract command name from JSON
-static bool json_get_cmd(const char* json, char* cmd_buf, size_t buf_size)
-{
-    int len;
-    const char* cmd = json_get_string(json, "cmd", &len);
-    if (!cmd || len <= 0 || (size_t)len >= buf_size) return false;
-
-    memcpy(cmd_buf, cmd, len);
-    cmd_buf[len] = '\0';
-    return true;
-}
-
 // ============================================================================
 // RESPONSE HELPERS
 // ============================================================================
@@ -150,7 +79,7 @@ static void send_json(const char* json)
 // COMMAND HANDLERS
 // ============================================================================
 
-static void cmd_info(const char* json)
+static void cmd_info(const cdc_json_t* json)
 {
     (void)json;
 
@@ -164,13 +93,13 @@ static void cmd_info(const char* json)
     send_json(response_buf);
 }
 
-static void cmd_ping(const char* json)
+static void cmd_ping(const cdc_json_t* json)
 {
     (void)json;
     send_ok();
 }
 
-static void cmd_reboot(const char* json)
+static void cmd_reboot(const cdc_json_t* json)
 {
     (void)json;
     send_ok();
@@ -183,7 +112,7 @@ static void cmd_reboot(const char* json)
     while(1);
 }
 
-static void cmd_bootsel(const char* json)
+static void cmd_bootsel(const cdc_json_t* json)
 {
     (void)json;
     send_ok();
@@ -195,7 +124,7 @@ static void cmd_bootsel(const char* json)
     reset_usb_boot(0, 0);
 }
 
-static void cmd_mode_get(const char* json)
+static void cmd_mode_get(const cdc_json_t* json)
 {
     (void)json;
     usb_output_mode_t mode = usbd_get_mode();
@@ -205,10 +134,10 @@ static void cmd_mode_get(const char* json)
     send_json(response_buf);
 }
 
-static void cmd_mode_set(const char* json)
+static void cmd_mode_set(const cdc_json_t* json)
 {
     int mode;
-    if (!json_get_int(json, "mode", &mode)) {
+    if (!cdc_json_get_int(json, "mode", &mode)) {
         send_error("missing mode");
         return;
     }
@@ -239,7 +168,7 @@ static void cmd_mode_set(const char* json)
     usbd_set_mode((usb_output_mode_t)mode);
 }
 
-static void cmd_mode_list(const char* json)
+static void cmd_mode_list(const cdc_json_t* json)
 {
     (void)json;
     usb_output_mode_t current = usbd_get_mode();
@@ -319,7 +248,7 @@ static bool is_builtin_profile(int unified_idx)
 }
 
 // PROFILE.LIST - Unified list of all profiles
-static void cmd_profile_list(const char* json)
+static void cmd_profile_list(const cdc_json_t* json)
 {
     (void)json;
     uint8_t builtin_count = get_builtin_count();
@@ -373,10 +302,10 @@ static void cmd_profile_list(const char* json)
 }
 
 // PROFILE.GET - Get profile details
-static void cmd_profile_get(const char* json)
+static void cmd_profile_get(const cdc_json_t* json)
 {
     int index;
-    if (!json_get_int(json, "index", &index)) {
+    if (!cdc_json_get_int(json, "index", &index)) {
         // No index - return active profile info
         uint8_t builtin_count = get_builtin_count();
         int active;
@@ -441,10 +370,10 @@ static void cmd_profile_get(const char* json)
 }
 
 // PROFILE.SELECT - Select active profile (unified index)
-static void cmd_profile_set(const char* json)
+static void cmd_profile_set(const cdc_json_t* json)
 {
     int index;
-    if (!json_get_int(json, "index", &index)) {
+    if (!cdc_json_get_int(json, "index", &index)) {
         send_error("missing index");
         return;
     }
@@ -483,10 +412,10 @@ static void cmd_profile_set(const char* json)
     send_json(response_buf);
 }
 
-static void cmd_input_stream(const char* json)
+static void cmd_input_stream(const cdc_json_t* json)
 {
     bool enable;
-    if (!json_get_bool(json, "enable", &enable)) {
+    if (!cdc_json_get_bool(json, "enable", &enable)) {
         send_error("missing enable");
         return;
     }
@@ -495,47 +424,99 @@ static void cmd_input_stream(const char* json)
     send_ok();
 }
 
-// Parse JSON array of integers: [1,2,3,...]
-// Returns number of values parsed
-static int json_get_int_array(const char* json, const char* key,
-                               uint8_t* out, int max_count)
+// ============================================================================
+// LOOPBACK LATENCY PROBE
+// ============================================================================
+// Host injects: DAT [CDC_DAT_STREAM_LOOPBACK][id:4][buttons:4][axes:6]
+// Device echoes: DAT [CDC_DAT_STREAM_LOOPBACK][id:4][flags:1]
+//                    [router_us:4][readout_us:4][profile_us:4][encode_us:4]
+//                    [total_us:4][buttons_out:4]
+// All fields little-endian. See core/services/loopback/loopback.h.
+
+#define LOOPBACK_IN_LEN  (1 + 4 + 4 + ANALOG_COUNT)
+#define LOOPBACK_OUT_LEN (1 + 4 + 1 + 4 * (LOOPBACK_STAGE_COUNT + 2))
+
+// Encode stage: current USB output mode's encoder, into a scratch buffer
+// (nothing is sent to the attached host)
+static bool loopback_usbd_encode(uint8_t player_index, const input_event_t* event,
+                                 const profile_output_t* profile_out, uint32_t buttons)
 {
-    char search[64];
-    snprintf(search, sizeof(search), "\"%s\":[", key);
+    static uint8_t scratch[64];
 
-    const char* start = strstr(json, search);
-    if (!start) return 0;
+    const usbd_mode_t* mode = usbd_get_current_mode();
+    if (!mode || !mode->encode_report) {
+        return false;
+    }
+    return mode->encode_report(player_index, event, profile_out, buttons,
+                               scratch, sizeof(scratch)) > 0;
+}
+
+static inline uint8_t* put_u32(uint8_t* p, uint32_t v)
+{
+    p[0] = v & 0xFF;
+    p[1] = (v >> 8) & 0xFF;
+    p[2] = (v >> 16) & 0xFF;
+    p[3] = (v >> 24) & 0xFF;
+    return p + 4;
+}
+
+static inline uint32_t get_u32(const uint8_t* p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) |
+           ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
 
-    start += strlen(search);
-    int count = 0;
+static void loopback_handle_dat(const cdc_packet_t* packet)
+{
+    if (packet->length < LOOPBACK_IN_LEN) return;
 
-    while (*start && count < max_count) {
-        // Skip whitespace
-        while (*start == ' ' || *start == '\t') start++;
+    const uint8_t* in = &packet->payload[1];
+    uint32_t id = get_u32(&in[0]);
+    uint32_t buttons = get_u32(&in[4]);
 
-        if (*start == ']') break;
+    loopback_result_t result;
+    if (!loopback_run(router_get_primary_output(), buttons, &in[8], &result)) {
+        return;
+    }
 
-        // Parse number
-        if (*start == '-' || (*start >= '0' && *start <= '9')) {
-            out[count++] = (uint8_t)atoi(start);
-            // Skip past number
-            while (*start == '-' || (*start >= '0' && *start <= '9')) start++;
-        }
+    uint8_t out[LOOPBACK_OUT_LEN];
+    uint8_t* p = out;
+    *p++ = CDC_DAT_STREAM_LOOPBACK;
+    p = put_u32(p, id);
+    *p++ = result.flags;
+    for (int i = 0; i < LOOPBACK_STAGE_COUNT; i++) {
+        p = put_u32(p, result.stage_us[i]);
+    }
+    p = put_u32(p, result.total_us);
+    put_u32(p, result.buttons_out);
+    cdc_protocol_send_data(&protocol_ctx, out, sizeof(out));
+}
 
-        // Skip comma
-        while (*start == ' ' || *start == '\t') start++;
-        if (*start == ',') start++;
+// LOOPBACK.SET - Enable/disable synthetic input injection
+// {"cmd":"LOOPBACK.SET","enable":true}
+static void cmd_loopback_set(const cdc_json_t* json)
+{
+    bool enable;
+    if (!cdc_json_get_bool(json, "enable", &enable)) {
+        send_error("missing enable");
+        return;
     }
 
-    return count;
+    loopback_set_encoder(loopback_usbd_encode);
+    loopback_set_enabled(enable);
+
+    snprintf(response_buf, sizeof(response_buf),
+             "{\"ok\":true,\"enabled\":%s,\"output\":%d}",
+             enable ? "true" : "false", router_get_primary_output());
+    send_json(response_buf);
 }
 
 // PROFILE.SAVE - Create or update custom profile (unified index)
 // index=255 creates a new profile
-static void cmd_profile_save(const char* json)
+static void cmd_profile_save(const cdc_json_t* json)
 {
     int index;
-    if (!json_get_int(json, "index", &index)) {
+    if (!cdc_json_get_int(json, "index", &index)) {
         send_error("missing index");
         return;
     }
@@ -577,7 +558,7 @@ static void cmd_profile_save(const char* json)
 
     // Get name
     int name_len;
-    const char* name = json_get_string(json, "name", &name_len);
+    const char* name = cdc_json_get_string(json, "name", &name_len);
     if (name && name_len > 0) {
         int copy_len = name_len < CUSTOM_PROFILE_NAME_LEN - 1 ? name_len : CUSTOM_PROFILE_NAME_LEN - 1;
         memcpy(p->name, name, copy_len);
@@ -589,7 +570,7 @@ static void cmd_profile_save(const char* json)
 
     // Get button map
     uint8_t button_map[CUSTOM_PROFILE_BUTTON_COUNT];
-    int map_count = json_get_int_array(json, "button_map", button_map, CUSTOM_PROFILE_BUTTON_COUNT);
+    int map_count = cdc_json_get_int_array(json, "button_map", button_map, CUSTOM_PROFILE_BUTTON_COUNT);
     if (map_count == CUSTOM_PROFILE_BUTTON_COUNT) {
         memcpy(p->button_map, button_map, CUSTOM_PROFILE_BUTTON_COUNT);
     } else if (map_count == 0 && is_new) {
@@ -599,13 +580,13 @@ static void cmd_profile_save(const char* json)
 
     // Get stick sensitivities
     int sens;
-    if (json_get_int(json, "left_stick_sens", &sens)) {
+    if (cdc_json_get_int(json, "left_stick_sens", &sens)) {
         p->left_stick_sens = (uint8_t)(sens > 200 ? 200 : (sens < 0 ? 0 : sens));
     } else if (is_new) {
         p->left_stick_sens = 100;
     }
 
-    if (json_get_int(json, "right_stick_sens", &sens)) {
+    if (cdc_json_get_int(json, "right_stick_sens", &sens)) {
         p->right_stick_sens = (uint8_t)(sens > 200 ? 200 : (sens < 0 ? 0 : sens));
     } else if (is_new) {
         p->right_stick_sens = 100;
@@ -613,7 +594,7 @@ static void cmd_profile_save(const char* json)
 
     // Get flags
     int flags;
-    if (json_get_int(json, "flags", &flags)) {
+    if (cdc_json_get_int(json, "flags", &flags)) {
         p->flags = (uint8_t)flags;
     }
 
@@ -626,10 +607,10 @@ static void cmd_profile_save(const char* json)
 }
 
 // PROFILE.DELETE - Delete custom profile (unified index)
-static void cmd_profile_delete(const char* json)
+static void cmd_profile_delete(const cdc_json_t* json)
 {
     int index;
-    if (!json_get_int(json, "index", &index)) {
+    if (!cdc_json_get_int(json, "index", &index)) {
         send_error("missing index");
         return;
     }
@@ -676,10 +657,10 @@ static void cmd_profile_delete(const char* json)
 }
 
 // PROFILE.CLONE - Clone any profile (built-in or custom) to new custom profile
-static void cmd_profile_clone(const char* json)
+static void cmd_profile_clone(const cdc_json_t* json)
 {
     int source_index;
-    if (!json_get_int(json, "index", &source_index)) {
+    if (!cdc_json_get_int(json, "index", &source_index)) {
         send_error("missing index");
         return;
     }
@@ -709,7 +690,7 @@ static void cmd_profile_clone(const char* json)
     // Generate name for the new profile
     char new_name[CUSTOM_PROFILE_NAME_LEN];
     int name_len;
-    const char* json_name = json_get_string(json, "name", &name_len);
+    const char* json_name = cdc_json_get_string(json, "name", &name_len);
     if (json_name && name_len > 0) {
         int copy_len = name_len < CUSTOM_PROFILE_NAME_LEN - 1 ? name_len : CUSTOM_PROFILE_NAME_LEN - 1;
         memcpy(new_name, json_name, copy_len);
@@ -756,42 +737,51 @@ static void cmd_profile_clone(const char* json)
     send_json(response_buf);
 }
 
+// PROFILE.BLOB.CLEAR - Drop uploaded profile blob, back to configured profiles
+// (blobs are uploaded with BULK.BEGIN target 1 and activated by BULK.COMMIT)
+static void cmd_profile_blob_clear(const cdc_json_t* json)
+{
+    (void)json;
+    profile_clear_blob();
+    send_ok();
+}
+
 // Legacy alias for CPROFILE.SELECT (deprecated, use PROFILE.SET)
-static void cmd_cprofile_select(const char* json)
+static void cmd_cprofile_select(const cdc_json_t* json)
 {
     // Redirect to unified PROFILE.SET
     cmd_profile_set(json);
 }
 
 // Legacy alias for CPROFILE.LIST (deprecated, use PROFILE.LIST)
-static void cmd_cprofile_list(const char* json)
+static void cmd_cprofile_list(const cdc_json_t* json)
 {
     // Redirect to unified PROFILE.LIST
     cmd_profile_list(json);
 }
 
 // Legacy alias for CPROFILE.GET (deprecated, use PROFILE.GET)
-static void cmd_cprofile_get(const char* json)
+static void cmd_cprofile_get(const cdc_json_t* json)
 {
     // Redirect to unified PROFILE.GET
     cmd_profile_get(json);
 }
 
 // Legacy alias for CPROFILE.SET (deprecated, use PROFILE.SAVE)
-static void cmd_cprofile_set(const char* json)
+static void cmd_cprofile_set(const cdc_json_t* json)
 {
     // Redirect to unified PROFILE.SAVE
     cmd_profile_save(json);
 }
 
 // Legacy alias for CPROFILE.DELETE (deprecated, use PROFILE.DELETE)
-static void cmd_cprofile_delete(const char* json)
+static void cmd_cprofile_delete(const cdc_json_t* json)
 {
     // Redirect to unified PROFILE.DELETE
     cmd_profile_delete(json);
 }
 
-static void cmd_settings_get(const char* json)
+static void cmd_settings_get(const cdc_json_t* json)
 {
     (void)json;
     flash_t flash_data;
@@ -807,7 +797,7 @@ static void cmd_settings_get(const char* json)
     send_json(response_buf);
 }
 
-static void cmd_settings_reset(const char* json)
+static void cmd_settings_reset(const cdc_json_t* json)
 {
     (void)json;
 
@@ -828,7 +818,7 @@ static void cmd_settings_reset(const char* json)
 }
 
 #ifdef ENABLE_BTSTACK
-static void cmd_bt_status(const char* json)
+static void cmd_bt_status(const cdc_json_t* json)
 {
     (void)json;
     snprintf(response_buf, sizeof(response_buf),
@@ -839,14 +829,89 @@ static void cmd_bt_status(const char* json)
     send_json(response_buf);
 }
 
-static void cmd_bt_bonds_clear(const char* json)
+static void cmd_bt_bonds_clear(const cdc_json_t* json)
 {
     (void)json;
     btstack_host_delete_all_bonds();
     send_ok();
 }
 
-static void cmd_wiimote_orient_get(const char* json)
+#define HCI_CAPTURE_CHUNK_HEADER 5  // stream(1) + offset(4)
+
+static void send_capture_status(void)
+{
+    snprintf(response_buf, sizeof(response_buf),
+             "{\"ok\":true,\"active\":%s,\"bytes\":%lu,\"packets\":%lu,\"dropped\":%lu}",
+             hci_capture_is_active() ? "true" : "false",
+             (unsigned long)hci_capture_get_total(),
+             (unsigned long)hci_capture_get_packets(),
+             (unsigned long)hci_capture_get_dropped());
+    send_json(response_buf);
+}
+
+// BT.CAPTURE.START - Record HCI traffic and stream it as DAT chunks
+// {"cmd":"BT.CAPTURE.START","boot":true}
+// boot=true reboots and captures from controller power-on (needed for
+// replay); otherwise a fresh capture starts now. The ring is drained to
+// the host whenever the data port is open.
+static void cmd_bt_capture_start(const cdc_json_t* json)
+{
+    bool boot = false;
+    cdc_json_get_bool(json, "boot", &boot);
+
+    if (!boot) {
+        hci_capture_start();
+        send_capture_status();
+        return;
+    }
+
+    hci_capture_arm_boot();
+    snprintf(response_buf, sizeof(response_buf),
+             "{\"ok\":true,\"reboot\":true}");
+    send_json(response_buf);
+
+    // Reboot
+    tud_task();
+    sleep_ms(50);
+    tud_task();
+    watchdog_enable(100, false);
+    while(1);
+}
+
+// BT.CAPTURE.STOP - Stop recording; unread bytes keep streaming
+// Response "bytes" is the final stream length
+static void cmd_bt_capture_stop(const cdc_json_t* json)
+{
+    (void)json;
+    hci_capture_stop();
+    send_capture_status();
+}
+
+static void hci_capture_stream_task(void)
+{
+    if (hci_capture_get_pending() == 0) return;
+
+    // Only send whole packets - a partial write would corrupt the stream
+    uint32_t space = cdc_data_write_available();
+    uint32_t overhead = CDC_HEADER_SIZE + HCI_CAPTURE_CHUNK_HEADER + CDC_CRC_SIZE;
+    if (space <= overhead) return;
+    uint32_t max = space - overhead;
+    if (max > CDC_MAX_PAYLOAD - HCI_CAPTURE_CHUNK_HEADER) {
+        max = CDC_MAX_PAYLOAD - HCI_CAPTURE_CHUNK_HEADER;
+    }
+
+    uint8_t chunk[CDC_MAX_PAYLOAD];
+    uint32_t offset;
+    uint16_t len = hci_capture_read(&chunk[HCI_CAPTURE_CHUNK_HEADER], (uint16_t)max, &offset);
+    chunk[0] = CDC_DAT_STREAM_HCI_CAPTURE;
+    chunk[1] = offset & 0xFF;
+    chunk[2] = (offset >> 8) & 0xFF;
+    chunk[3] = (offset >> 16) & 0xFF;
+    chunk[4] = (offset >> 24) & 0xFF;
+    cdc_protocol_send_data(&protocol_ctx, chunk, HCI_CAPTURE_CHUNK_HEADER + len);
+}
+
+static void cmd_wiimote_orient_get(const cdc_json_t* json)
 {
     (void)json;
     uint8_t mode = wiimote_get_orient_mode();
@@ -856,10 +921,10 @@ static void cmd_wiimote_orient_get(const char* json)
     send_json(response_buf);
 }
 
-static void cmd_wiimote_orient_set(const char* json)
+static void cmd_wiimote_orient_set(const cdc_json_t* json)
 {
     int mode;
-    if (!json_get_int(json, "mode", &mode)) {
+    if (!cdc_json_get_int(json, "mode", &mode)) {
         send_error("missing mode");
         return;
     }
@@ -888,7 +953,7 @@ static void cmd_wiimote_orient_set(const char* json)
 // ============================================================================
 
 // PLAYERS.LIST - Get list of connected players/controllers
-static void cmd_players_list(const char* json)
+static void cmd_players_list(const cdc_json_t* json)
 {
     (void) json;
 
@@ -943,17 +1008,17 @@ static struct {
 // player: 0-based index, or -1 for all players
 // left/right: motor intensity 0-255
 // duration: optional, ms (default 500, max 5000)
-static void cmd_rumble_test(const char* json)
+static void cmd_rumble_test(const cdc_json_t* json)
 {
     int player = 0;
     int left = 128;
     int right = 128;
     int duration = 500;
 
-    json_get_int(json, "player", &player);
-    json_get_int(json, "left", &left);
-    json_get_int(json, "right", &right);
-    json_get_int(json, "duration", &duration);
+    cdc_json_get_int(json, "player", &player);
+    cdc_json_get_int(json, "left", &left);
+    cdc_json_get_int(json, "right", &right);
+    cdc_json_get_int(json, "duration", &duration);
 
     // Clamp values
     if (left < 0) left = 0;
@@ -996,10 +1061,10 @@ static void cmd_rumble_test(const char* json)
 }
 
 // RUMBLE.STOP - Stop rumble on a player's controller
-static void cmd_rumble_stop(const char* json)
+static void cmd_rumble_stop(const cdc_json_t* json)
 {
     int player = -1;
-    json_get_int(json, "player", &player);
+    cdc_json_get_int(json, "player", &player);
 
     if (player == -1) {
         // All players
@@ -1016,9 +1081,185 @@ static void cmd_rumble_stop(const char* json)
     send_ok();
 }
 
+// ============================================================================
+// BULK TRANSFER
+// ============================================================================
+
+// BULK.BEGIN - Start or resume a binary upload (chunks follow as DAT packets)
+// {"cmd":"BULK.BEGIN","target":0,"size":228,"crc":4660}
+// Response: {"ok":true,"offset":0,"chunk":509}
+static void cmd_bulk_begin(const cdc_json_t* json)
+{
+    int target, size, crc;
+    if (!cdc_json_get_int(json, "target", &target) ||
+        !cdc_json_get_int(json, "size", &size) ||
+        !cdc_json_get_int(json, "crc", &crc)) {
+        send_error("missing target, size or crc");
+        return;
+    }
+    if (target < 0 || target > 0xFF || size < 0 || size > 0xFFFF || crc < 0 || crc > 0xFFFF) {
+        send_error("invalid args");
+        return;
+    }
+
+    uint16_t offset;
+    const char* err = cdc_bulk_begin((uint8_t)target, (uint16_t)size, (uint16_t)crc, &offset);
+    if (err) {
+        send_error(err);
+        return;
+    }
+
+    snprintf(response_buf, sizeof(response_buf),
+             "{\"ok\":true,\"offset\":%d,\"chunk\":%d}", offset, CDC_BULK_CHUNK_MAX);
+    send_json(response_buf);
+}
+
+// BULK.COMMIT - Verify and apply the staged upload
+static void cmd_bulk_commit(const cdc_json_t* json)
+{
+    (void)json;
+    const char* err = cdc_bulk_commit();
+    if (err) {
+        send_error(err);
+        return;
+    }
+    send_ok();
+}
+
+// BULK.ABORT - Discard staged upload / stop a read
+static void cmd_bulk_abort(const cdc_json_t* json)
+{
+    (void)json;
+    cdc_bulk_abort();
+    send_ok();
+}
+
+// BULK.READ - Stream a target image back as DAT chunks
+// {"cmd":"BULK.READ","target":0}
+// Response: {"ok":true,"size":228,"crc":4660}, then DAT chunks
+static void cmd_bulk_read(const cdc_json_t* json)
+{
+    int target;
+    if (!cdc_json_get_int(json, "target", &target) || target < 0 || target > 0xFF) {
+        send_error("missing target");
+        return;
+    }
+
+    uint16_t size, crc;
+    const char* err = cdc_bulk_read((uint8_t)target, &size, &crc);
+    if (err) {
+        send_error(err);
+        return;
+    }
+
+    snprintf(response_buf, sizeof(response_buf),
+             "{\"ok\":true,\"size\":%d,\"crc\":%d}", size, crc);
+    send_json(response_buf);
+}
+
+// ============================================================================
+// METRICS
+// ============================================================================
+
+#define METRICS_INTERVAL_MIN_MS 10
+#define METRICS_INTERVAL_MAX_MS 10000
+
+static struct {
+    uint32_t interval_ms;   // 0 = not subscribed
+    uint32_t last_ms;
+} metrics_sub = {0};
+
+// METRICS.LIST - Describe exported metrics and their slot numbers
+// {"cmd":"METRICS.LIST","start":0}
+// Response: {"ok":true,"buckets":16,"slots":27,"metrics":[["router.events","c",0],...],"next":N}
+// kind: c=counter, g=gauge, h=histogram (occupies "buckets" slots from its first slot)
+// "next" is present when the list was truncated; request again with start=next
+static void cmd_metrics_list(const cdc_json_t* json)
+{
+    int start = 0;
+    cdc_json_get_int(json, "start", &start);
+    if (start < 0) start = 0;
+
+    uint8_t count = metrics_get_count();
+    int pos = snprintf(response_buf, sizeof(response_buf),
+                       "{\"ok\":true,\"buckets\":%d,\"slots\":%d,\"metrics\":[",
+                       METRICS_HIST_BUCKETS, metrics_get_slot_count());
+
+    int i;
+    for (i = start; i < count && pos < (int)sizeof(response_buf) - 64; i++) {
+        static const char kind_chars[] = {'c', 'g', 'h'};
+        pos += snprintf(response_buf + pos, sizeof(response_buf) - pos,
+                        "%s[\"%s\",\"%c\",%d]",
+                        i > start ? "," : "",
+                        metrics_get_name(i),
+                        kind_chars[metrics_get_kind(i)],
+                        metrics_get_first_slot(i));
+    }
+
+    if (i < count) {
+        snprintf(response_buf + pos, sizeof(response_buf) - pos, "],\"next\":%d}", i);
+    } else {
+        snprintf(response_buf + pos, sizeof(response_buf) - pos, "]}");
+    }
+    send_json(response_buf);
+}
+
+// METRICS.SUBSCRIBE - Stream changed metric slots as binary DAT packets
+// {"cmd":"METRICS.SUBSCRIBE","interval_ms":100}  (0 = unsubscribe)
+// The first packet after subscribing carries every slot.
+static void cmd_metrics_subscribe(const cdc_json_t* json)
+{
+    int interval;
+    if (!cdc_json_get_int(json, "interval_ms", &interval)) {
+        send_error("missing interval_ms");
+        return;
+    }
+
+    if (interval <= 0) {
+        metrics_sub.interval_ms = 0;
+    } else {
+        if (interval < METRICS_INTERVAL_MIN_MS) interval = METRICS_INTERVAL_MIN_MS;
+        if (interval > METRICS_INTERVAL_MAX_MS) interval = METRICS_INTERVAL_MAX_MS;
+        metrics_sub.interval_ms = (uint32_t)interval;
+        metrics_sub.last_ms = to_ms_since_boot(get_absolute_time()) - metrics_sub.interval_ms;
+        metrics_reset_snapshot();
+    }
+
+    snprintf(response_buf, sizeof(response_buf),
+             "{\"ok\":true,\"interval_ms\":%lu}", (unsigned long)metrics_sub.interval_ms);
+    send_json(response_buf);
+}
+
+static void metrics_stream_task(void)
+{
+    if (metrics_sub.interval_ms == 0) return;
+
+    uint32_t now = to_ms_since_boot(get_absolute_time());
+    if (now - metrics_sub.last_ms < metrics_sub.interval_ms) return;
+    metrics_sub.last_ms = now;
+
+    uint8_t buf[CDC_MAX_PAYLOAD];
+    buf[0] = CDC_DAT_STREAM_METRICS;
+    buf[1] = now & 0xFF;
+    buf[2] = (now >> 8) & 0xFF;
+    buf[3] = (now >> 16) & 0xFF;
+    buf[4] = (now >> 24) & 0xFF;
+
+    uint16_t len = metrics_encode_changes(&buf[5], sizeof(buf) - 5);
+    if (len > 0) {
+        cdc_protocol_send_data(&protocol_ctx, buf, 5 + len);
+    }
+}
+
 // Call from main loop to auto-stop rumble after duration
 void cdc_commands_task(void)
 {
+    metrics_stream_task();
+    cdc_bulk_task(&protocol_ctx);
+#ifdef ENABLE_BTSTACK
+    hci_capture_stream_task();
+#endif
+
     if (rumble_test_state.active) {
         uint32_t now = to_ms_since_boot(get_absolute_time());
         if (now - rumble_test_state.start_ms >= rumble_test_state.duration_ms) {
@@ -1041,80 +1282,136 @@ void cdc_commands_task(void)
 // COMMAND DISPATCH
 // ============================================================================
 
-typedef void (*cmd_handler_t)(const char* json);
+typedef void (*cmd_handler_t)(const cdc_json_t* json);
 
 typedef struct {
     const char* name;
     cmd_handler_t handler;
 } cmd_entry_t;
 
+// Sorted by name (strcmp order) for binary search - keep it that way when
+// adding commands. The order must hold with and without ENABLE_BTSTACK.
 static const cmd_entry_t commands[] = {
-    {"INFO", cmd_info},
-    {"PING", cmd_ping},
-    {"REBOOT", cmd_reboot},
     {"BOOTSEL", cmd_bootsel},
-    {"MODE.GET", cmd_mode_get},
-    {"MODE.SET", cmd_mode_set},
-    {"MODE.LIST", cmd_mode_list},
-    // Unified profile commands
-    {"PROFILE.LIST", cmd_profile_list},
-    {"PROFILE.GET", cmd_profile_get},
-    {"PROFILE.SET", cmd_profile_set},
-    {"PROFILE.SAVE", cmd_profile_save},
-    {"PROFILE.DELETE", cmd_profile_delete},
-    {"PROFILE.CLONE", cmd_profile_clone},
+#ifdef ENABLE_BTSTACK
+    {"BT.BONDS.CLEAR", cmd_bt_bonds_clear},
+    {"BT.CAPTURE.START", cmd_bt_capture_start},
+    {"BT.CAPTURE.STOP", cmd_bt_capture_stop},
+    {"BT.STATUS", cmd_bt_status},
+#endif
+    // Binary bulk transfer (chunks arrive as DAT packets)
+    {"BULK.ABORT", cmd_bulk_abort},
+    {"BULK.BEGIN", cmd_bulk_begin},
+    {"BULK.COMMIT", cmd_bulk_commit},
+    {"BULK.READ", cmd_bulk_read},
     // Legacy CPROFILE.* aliases (deprecated - redirect to unified commands)
-    {"CPROFILE.LIST", cmd_cprofile_list},
-    {"CPROFILE.GET", cmd_cprofile_get},
-    {"CPROFILE.SET", cmd_cprofile_set},
     {"CPROFILE.DELETE", cmd_cprofile_delete},
+    {"CPROFILE.GET", cmd_cprofile_get},
+    {"CPROFILE.LIST", cmd_cprofile_list},
     {"CPROFILE.SELECT", cmd_cprofile_select},
+    {"CPROFILE.SET", cmd_cprofile_set},
+    {"INFO", cmd_info},
     {"INPUT.STREAM", cmd_input_stream},
-    {"SETTINGS.GET", cmd_settings_get},
-    {"SETTINGS.RESET", cmd_settings_reset},
+    {"LOOPBACK.SET", cmd_loopback_set},
+    {"METRICS.LIST", cmd_metrics_list},
+    {"METRICS.SUBSCRIBE", cmd_metrics_subscribe},
+    {"MODE.GET", cmd_mode_get},
+    {"MODE.LIST", cmd_mode_list},
+    {"MODE.SET", cmd_mode_set},
+    {"PING", cmd_ping},
     // Player management
     {"PLAYERS.LIST", cmd_players_list},
+    // Unified profile commands
+    {"PROFILE.BLOB.CLEAR", cmd_profile_blob_clear},
+    {"PROFILE.CLONE", cmd_profile_clone},
+    {"PROFILE.DELETE", cmd_profile_delete},
+    {"PROFILE.GET", cmd_profile_get},
+    {"PROFILE.LIST", cmd_profile_list},
+    {"PROFILE.SAVE", cmd_profile_save},
+    {"PROFILE.SET", cmd_profile_set},
+    {"REBOOT", cmd_reboot},
     // Rumble testing
-    {"RUMBLE.TEST", cmd_rumble_test},
     {"RUMBLE.STOP", cmd_rumble_stop},
+    {"RUMBLE.TEST", cmd_rumble_test},
+    {"SETTINGS.GET", cmd_settings_get},
+    {"SETTINGS.RESET", cmd_settings_reset},
 #ifdef ENABLE_BTSTACK
-    {"BT.STATUS", cmd_bt_status},
-    {"BT.BONDS.CLEAR", cmd_bt_bonds_clear},
     {"WIIMOTE.ORIENT.GET", cmd_wiimote_orient_get},
     {"WIIMOTE.ORIENT.SET", cmd_wiimote_orient_set},
 #endif
-    {NULL, NULL}
 };
 
+#define COMMAND_COUNT (sizeof(commands) / sizeof(commands[0]))
+
+// Compare table name against a non-terminated name of length len
+static int cmd_name_cmp(const char* entry, const char* name, size_t len)
+{
+    int c = strncmp(entry, name, len);
+    if (c != 0) return c;
+    return entry[len] ? 1 : 0;  // Longer table name sorts after
+}
+
+// Binary search the sorted command table
+static const cmd_entry_t* find_command(const char* name, size_t len)
+{
+    size_t lo = 0;
+    size_t hi = COMMAND_COUNT;
+    while (lo < hi) {
+        size_t mid = (lo + hi) / 2;
+        int c = cmd_name_cmp(commands[mid].name, name, len);
+        if (c == 0) return &commands[mid];
+        if (c < 0) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return NULL;
+}
+
 // ============================================================================
 // PACKET HANDLER
 // ============================================================================
 
 static void packet_handler(const cdc_packet_t* packet)
 {
+    if (packet->type == CDC_MSG_DAT) {
+        if (packet->length == 0) return;
+        if (packet->payload[0] == CDC_DAT_STREAM_BULK) {
+            cdc_bulk_handle_chunk(&protocol_ctx, packet);
+        } else if (packet->payload[0] == CDC_DAT_STREAM_LOOPBACK) {
+            loopback_handle_dat(packet);
+        }
+        return;
+    }
+
     if (packet->type != CDC_MSG_CMD) {
-        // Only handle CMD packets here
         return;
     }
 
-    // Null-terminate payload for string operations
-    char json[CDC_MAX_PAYLOAD + 1];
-    memcpy(json, packet->payload, packet->length);
-    json[packet->length] = '\0';
+    // Index all keys in one pass (tokens point into the packet payload)
+    static cdc_json_t doc;
+    if (!cdc_json_parse(&doc, (const char*)packet->payload, packet->length)) {
+        send_error("invalid json");
+        return;
+    }
 
     // Extract command name
-    char cmd[32];
-    if (!json_get_cmd(json, cmd, sizeof(cmd))) {
+    int cmd_len;
+    const char* cmd = cdc_json_get_string(&doc, "cmd", &cmd_len);
+    if (!cmd || cmd_len <= 0) {
         send_error("invalid command format");
         return;
     }
 
     // Find and execute handler
-    for (const cmd_entry_t* entry = commands; entry->name; entry++) {
-        if (strcmp(cmd, entry->name) == 0) {
-            entry->handler(json);
-            return;
-        }
+    const cmd_entry_t* entry = find_command(cmd, (size_t)cmd_len);
+    if (entry) {
+        uint32_t start_us = time_us_32();
+        entry->handler(&doc);
+        METRIC_INC(CDC_COMMANDS);
+        METRIC_OBSERVE(CDC_COMMAND_US, time_us_32() - start_us);
+        return;
     }
 
     send_error("unknown command");
@@ -1128,6 +1425,13 @@ void cdc_commands_init(void)
 {
     cdc_protocol_init(&protocol_ctx, packet_handler);
 
+    // Catch out-of-order additions to the command table early
+    for (size_t i = 1; i < COMMAND_COUNT; i++) {
+        if (strcmp(commands[i - 1].name, commands[i].name) >= 0) {
+            printf("[CDC] ERROR: command table not sorted at %s\n", commands[i].name);
+        }
+    }
+
     // Debug: print build info at startup
     printf("[CDC] Build Info Debug:\n");
     printf("[CDC]   APP_NAME: %s\n", APP_NAME);
@@ -0,0 +1,230 @@
+// cdc_json.c - Single-pass JSON key index for CDC commands
+// SPDX-License-Identifier: Apache-2.0
+// Copyright 2024 Robert Dale Smith
+
+#include "cdc_json.h"
+#include <string.h>
+
+// ============================================================================
+// HELPERS
+// ============================================================================
+
+// FNV-1a, folded to 16 bits (only used to skip most memcmp calls)
+static uint16_t key_hash(const char* s, size_t len)
+{
+    uint32_t h = 2166136261u;
+    for (size_t i = 0; i < len; i++) {
+        h ^= (uint8_t)s[i];
+        h *= 16777619u;
+    }
+    return (uint16_t)(h ^ (h >> 16));
+}
+
+static inline bool is_space(char c)
+{
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+// ============================================================================
+// TOKENIZER
+// ============================================================================
+
+typedef struct {
+    char close;             // '}' or ']'
+    int8_t token;           // Token that owns this container, -1 if none
+} json_frame_t;
+
+bool cdc_json_parse(cdc_json_t* doc, const char* json, size_t len)
+{
+    json_frame_t stack[CDC_JSON_MAX_DEPTH];
+    int depth = 0;
+
+    // Key waiting for its value
+    const char* key = NULL;
+    uint16_t key_len = 0;
+
+    doc->count = 0;
+
+    size_t i = 0;
+    while (i < len) {
+        char c = json[i];
+
+        if (is_space(c) || c == ',' || c == ':') {
+            i++;
+            continue;
+        }
+
+        int8_t slot = -1;
+        if (key && doc->count < CDC_JSON_MAX_KEYS) {
+            slot = (int8_t)doc->count++;
+            cdc_json_token_t* t = &doc->tokens[slot];
+            t->key = key;
+            t->key_len = key_len;
+            t->key_hash = key_hash(key, key_len);
+            t->val = &json[i];
+            t->depth = (uint8_t)(depth > 0 ? depth - 1 : 0);
+        }
+        bool had_key = (key != NULL);
+        key = NULL;
+
+        if (c == '{' || c == '[') {
+            if (depth >= CDC_JSON_MAX_DEPTH) return false;
+            stack[depth].close = (c == '{') ? '}' : ']';
+            stack[depth].token = slot;
+            depth++;
+            if (slot >= 0) {
+                doc->tokens[slot].type = (c == '{') ? CDC_JSON_OBJECT : CDC_JSON_ARRAY;
+            }
+            i++;
+            continue;
+        }
+
+        if (c == '}' || c == ']') {
+            if (had_key || depth == 0 || stack[depth - 1].close != c) return false;
+            depth--;
+            int8_t owner = stack[depth].token;
+            if (owner >= 0) {
+                cdc_json_token_t* t = &doc->tokens[owner];
+                t->val_len = (uint16_t)(&json[i + 1] - t->val);
+            }
+            i++;
+            continue;
+        }
+
+        if (c == '"') {
+            size_t start = ++i;
+            while (i < len && json[i] != '"') {
+                if (json[i] == '\\') i++;
+                i++;
+            }
+            if (i >= len) return false;  // Unterminated string
+            size_t slen = i - start;
+            i++;  // Closing quote
+
+            bool in_object = depth > 0 && stack[depth - 1].close == '}';
+            if (in_object && !had_key) {
+                // This string is a key - value follows the ':'
+                key = &json[start];
+                key_len = (uint16_t)slen;
+            } else if (slot >= 0) {
+                cdc_json_token_t* t = &doc->tokens[slot];
+                t->type = CDC_JSON_STRING;
+                t->val = &json[start];
+                t->val_len = (uint16_t)slen;
+            }
+            continue;
+        }
+
+        // Bare scalar: number, true, false, null
+        size_t start = i;
+        while (i < len && !is_space(json[i]) && json[i] != ',' &&
+               json[i] != '}' && json[i] != ']') {
+            i++;
+        }
+        if (slot >= 0) {
+            cdc_json_token_t* t = &doc->tokens[slot];
+            t->val_len = (uint16_t)(i - start);
+            if (c == 't' || c == 'f') {
+                t->type = CDC_JSON_BOOL;
+            } else if (c == 'n') {
+                t->type = CDC_JSON_NULL;
+            } else {
+                t->type = CDC_JSON_NUMBER;
+            }
+        }
+    }
+
+    return depth == 0 && key == NULL;
+}
+
+// ============================================================================
+// LOOKUP
+// ============================================================================
+
+const cdc_json_token_t* cdc_json_find(const cdc_json_t* doc, const char* key)
+{
+    size_t len = strlen(key);
+    uint16_t hash = key_hash(key, len);
+
+    for (uint8_t i = 0; i < doc->count; i++) {
+        const cdc_json_token_t* t = &doc->tokens[i];
+        if (t->key_hash == hash && t->key_len == len &&
+            memcmp(t->key, key, len) == 0) {
+            return t;
+        }
+    }
+    return NULL;
+}
+
+// Bounded integer parse (payload is not null-terminated)
+static bool parse_int(const char* s, size_t len, int* out_val)
+{
+    size_t i = 0;
+    bool neg = false;
+    if (i < len && s[i] == '-') {
+        neg = true;
+        i++;
+    }
+    if (i >= len || s[i] < '0' || s[i] > '9') return false;
+
+    int val = 0;
+    while (i < len && s[i] >= '0' && s[i] <= '9') {
+        val = val * 10 + (s[i] - '0');
+        i++;
+    }
+    *out_val = neg ? -val : val;
+    return true;
+}
+
+const char* cdc_json_get_string(const cdc_json_t* doc, const char* key, int* out_len)
+{
+    const cdc_json_token_t* t = cdc_json_find(doc, key);
+    if (!t || t->type != CDC_JSON_STRING) return NULL;
+
+    if (out_len) *out_len = t->val_len;
+    return t->val;
+}
+
+bool cdc_json_get_int(const cdc_json_t* doc, const char* key, int* out_val)
+{
+    const cdc_json_token_t* t = cdc_json_find(doc, key);
+    if (!t || t->type != CDC_JSON_NUMBER) return false;
+
+    return parse_int(t->val, t->val_len, out_val);
+}
+
+bool cdc_json_get_bool(const cdc_json_t* doc, const char* key, bool* out_val)
+{
+    const cdc_json_token_t* t = cdc_json_find(doc, key);
+    if (!t || t->type != CDC_JSON_BOOL) return false;
+
+    *out_val = (t->val[0] == 't');
+    return true;
+}
+
+int cdc_json_get_int_array(const cdc_json_t* doc, const char* key,
+                           uint8_t* out, int max_count)
+{
+    const cdc_json_token_t* t = cdc_json_find(doc, key);
+    if (!t || t->type != CDC_JSON_ARRAY) return 0;
+
+    // Skip '[' and stop before ']'
+    const char* p = t->val + 1;
+    const char* end = t->val + t->val_len - 1;
+    int count = 0;
+
+    while (p < end && count < max_count) {
+        while (p < end && (is_space(*p) || *p == ',')) p++;
+        if (p >= end) break;
+
+        const char* num = p;
+        while (p < end && *p != ',' && !is_space(*p)) p++;
+
+        int val;
+        if (parse_int(num, (size_t)(p - num), &val)) {
+            out[count++] = (uint8_t)val;
+        }
+    }
+
+    return count;
+}
@@ -0,0 +1,81 @@
+// cdc_json.h - Single-pass JSON key index for CDC commands
+// SPDX-License-Identifier: Apache-2.0
+// Copyright 2024 Robert Dale Smith
+//
+// Scans a command payload once and records every "key":value pair it sees
+// (at any nesting depth, so {"cmd":"X","args":{"index":1}} exposes "index").
+// Values are not copied - tokens point back into the caller's buffer, which
+// must stay valid while the index is in use. No heap allocation.
+
+#ifndef CDC_JSON_H
+#define CDC_JSON_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ============================================================================
+// CONSTANTS
+// ============================================================================
+
+#define CDC_JSON_MAX_KEYS   32      // Keys indexed per payload (extra keys ignored)
+#define CDC_JSON_MAX_DEPTH  8       // Max object/array nesting
+
+// ============================================================================
+// TYPES
+// ============================================================================
+
+typedef enum {
+    CDC_JSON_STRING,        // val points past the opening quote, raw (escapes kept)
+    CDC_JSON_NUMBER,
+    CDC_JSON_BOOL,
+    CDC_JSON_NULL,
+    CDC_JSON_ARRAY,         // val points at '[', val_len covers through ']'
+    CDC_JSON_OBJECT,        // val points at '{', val_len covers through '}'
+} cdc_json_type_t;
+
+typedef struct {
+    const char* key;        // Key text (not null-terminated)
+    const char* val;        // Value text (not null-terminated)
+    uint16_t key_len;
+    uint16_t val_len;
+    uint16_t key_hash;      // FNV-1a of key, checked before memcmp
+    uint8_t type;           // cdc_json_type_t
+    uint8_t depth;          // 0 = top-level object
+} cdc_json_token_t;
+
+typedef struct {
+    cdc_json_token_t tokens[CDC_JSON_MAX_KEYS];
+    uint8_t count;
+} cdc_json_t;
+
+// ============================================================================
+// API
+// ============================================================================
+
+// Index all keys in json[0..len). Returns false on malformed input.
+bool cdc_json_parse(cdc_json_t* doc, const char* json, size_t len);
+
+// Find first token with the given key (document order), NULL if absent
+const cdc_json_token_t* cdc_json_find(const cdc_json_t* doc, const char* key);
+
+// Typed getters - return false (and leave *out untouched) if key is missing
+// or has the wrong type
+const char* cdc_json_get_string(const cdc_json_t* doc, const char* key, int* out_len);
+bool cdc_json_get_int(const cdc_json_t* doc, const char* key, int* out_val);
+bool cdc_json_get_bool(const cdc_json_t* doc, const char* key, bool* out_val);
+
+// Parse array of integers: "key":[1,2,3,...]
+// Returns number of values parsed (0 if missing)
+int cdc_json_get_int_array(const cdc_json_t* doc, const char* key,
+                           uint8_t* out, int max_count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CDC_JSON_H
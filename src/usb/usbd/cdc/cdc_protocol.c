@@ -191,6 +191,13 @@ uint16_t cdc_protocol_send_event(cdc_protocol_t* ctx, const char* json)
                              (const uint8_t*)json, strlen(json));
 }
 
+uint16_t cdc_protocol_send_data(cdc_protocol_t* ctx,
+                                const uint8_t* data, uint16_t len)
+{
+    uint8_t seq = ctx->tx_seq++;
+    return cdc_protocol_send(ctx, CDC_MSG_DAT, seq, data, len);
+}
+
 uint16_t cdc_protocol_send_nak(cdc_protocol_t* ctx, uint8_t seq)
 {
     return cdc_protocol_send(ctx, CDC_MSG_NAK, seq, NULL, 0);
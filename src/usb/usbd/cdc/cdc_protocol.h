@@ -42,6 +42,14 @@ typedef enum {
     CDC_MSG_DAT = 0x10,     // Data stream chunk
 } cdc_msg_type_t;
 
+// DAT payloads start with a stream ID byte
+typedef enum {
+    CDC_DAT_STREAM_METRICS = 0x01,  // [time_ms:4][slot:1][value:4]...
+    CDC_DAT_STREAM_BULK    = 0x02,  // [offset:2][data...] (see cdc_bulk.h)
+    CDC_DAT_STREAM_LOOPBACK = 0x03, // Latency probe (see LOOPBACK.SET in cdc_commands.c)
+    CDC_DAT_STREAM_HCI_CAPTURE = 0x04, // [offset:4][PacketLogger bytes...] (see hci_capture.h)
+} cdc_dat_stream_t;
+
 // ============================================================================
 // PACKET STRUCTURE
 // ============================================================================
@@ -123,6 +131,10 @@ uint16_t cdc_protocol_send_response(cdc_protocol_t* ctx,
 uint16_t cdc_protocol_send_event(cdc_protocol_t* ctx,
                                  const char* json);
 
+// Convenience: send binary data stream chunk (DAT)
+uint16_t cdc_protocol_send_data(cdc_protocol_t* ctx,
+                                const uint8_t* data, uint16_t len);
+
 // Convenience: send NAK
 uint16_t cdc_protocol_send_nak(cdc_protocol_t* ctx, uint8_t seq);
 
@@ -256,6 +256,43 @@ static bool gc_adapter_mode_is_ready(void)
     return ready;
 }
 
+static void gc_adapter_mode_encode(gc_adapter_in_report_t* report, uint8_t port,
+                                   const profile_output_t* profile_out,
+                                   uint32_t buttons)
+{
+    // Mark this port as connected (0x14 = controller connected + rumble power)
+    report->port[port].status = GC_ADAPTER_STATUS_CONNECTED;
+
+    // Map buttons
+    report->port[port].a = (buttons & JP_BUTTON_B2) ? 1 : 0;
+    report->port[port].b = (buttons & JP_BUTTON_B1) ? 1 : 0;
+    report->port[port].x = (buttons & JP_BUTTON_B4) ? 1 : 0;
+    report->port[port].y = (buttons & JP_BUTTON_B3) ? 1 : 0;
+    report->port[port].z = (buttons & JP_BUTTON_R1) ? 1 : 0;
+    report->port[port].l = (buttons & JP_BUTTON_L2) ? 1 : 0;
+    report->port[port].r = (buttons & JP_BUTTON_R2) ? 1 : 0;
+    report->port[port].start = (buttons & JP_BUTTON_S2) ? 1 : 0;
+    report->port[port].dpad_up = (buttons & JP_BUTTON_DU) ? 1 : 0;
+    report->port[port].dpad_down = (buttons & JP_BUTTON_DD) ? 1 : 0;
+    report->port[port].dpad_left = (buttons & JP_BUTTON_DL) ? 1 : 0;
+    report->port[port].dpad_right = (buttons & JP_BUTTON_DR) ? 1 : 0;
+
+    // Analog sticks (Y inverted for GC)
+    report->port[port].stick_x = profile_out->left_x;
+    report->port[port].stick_y = 255 - profile_out->left_y;
+    report->port[port].cstick_x = profile_out->right_x;
+    report->port[port].cstick_y = 255 - profile_out->right_y;
+
+    // Analog triggers
+    report->port[port].trigger_l = profile_out->l2_analog;
+    report->port[port].trigger_r = profile_out->r2_analog;
+
+    if (report->port[port].trigger_l == 0 && (buttons & JP_BUTTON_L2))
+        report->port[port].trigger_l = 0xFF;
+    if (report->port[port].trigger_r == 0 && (buttons & JP_BUTTON_R2))
+        report->port[port].trigger_r = 0xFF;
+}
+
 static bool gc_adapter_mode_send_report(uint8_t player_index,
                                          const input_event_t* event,
                                          const profile_output_t* profile_out,
@@ -267,37 +304,7 @@ static bool gc_adapter_mode_send_report(uint8_t player_index,
     uint8_t port = player_index;
     if (port >= 4) port = 0;
 
-    // Mark this port as connected (0x14 = controller connected + rumble power)
-    gc_adapter_report.port[port].status = GC_ADAPTER_STATUS_CONNECTED;
-
-    // Map buttons
-    gc_adapter_report.port[port].a = (buttons & JP_BUTTON_B2) ? 1 : 0;
-    gc_adapter_report.port[port].b = (buttons & JP_BUTTON_B1) ? 1 : 0;
-    gc_adapter_report.port[port].x = (buttons & JP_BUTTON_B4) ? 1 : 0;
-    gc_adapter_report.port[port].y = (buttons & JP_BUTTON_B3) ? 1 : 0;
-    gc_adapter_report.port[port].z = (buttons & JP_BUTTON_R1) ? 1 : 0;
-    gc_adapter_report.port[port].l = (buttons & JP_BUTTON_L2) ? 1 : 0;
-    gc_adapter_report.port[port].r = (buttons & JP_BUTTON_R2) ? 1 : 0;
-    gc_adapter_report.port[port].start = (buttons & JP_BUTTON_S2) ? 1 : 0;
-    gc_adapter_report.port[port].dpad_up = (buttons & JP_BUTTON_DU) ? 1 : 0;
-    gc_adapter_report.port[port].dpad_down = (buttons & JP_BUTTON_DD) ? 1 : 0;
-    gc_adapter_report.port[port].dpad_left = (buttons & JP_BUTTON_DL) ? 1 : 0;
-    gc_adapter_report.port[port].dpad_right = (buttons & JP_BUTTON_DR) ? 1 : 0;
-
-    // Analog sticks (Y inverted for GC)
-    gc_adapter_report.port[port].stick_x = profile_out->left_x;
-    gc_adapter_report.port[port].stick_y = 255 - profile_out->left_y;
-    gc_adapter_report.port[port].cstick_x = profile_out->right_x;
-    gc_adapter_report.port[port].cstick_y = 255 - profile_out->right_y;
-
-    // Analog triggers
-    gc_adapter_report.port[port].trigger_l = profile_out->l2_analog;
-    gc_adapter_report.port[port].trigger_r = profile_out->r2_analog;
-
-    if (gc_adapter_report.port[port].trigger_l == 0 && (buttons & JP_BUTTON_L2))
-        gc_adapter_report.port[port].trigger_l = 0xFF;
-    if (gc_adapter_report.port[port].trigger_r == 0 && (buttons & JP_BUTTON_R2))
-        gc_adapter_report.port[port].trigger_r = 0xFF;
+    gc_adapter_mode_encode(&gc_adapter_report, port, profile_out, buttons);
 
     // Send using our custom driver endpoint
     if (!usbd_edpt_claim(rhport, _gc_itf.ep_in)) {
@@ -311,6 +318,26 @@ static bool gc_adapter_mode_send_report(uint8_t player_index,
     return usbd_edpt_xfer(rhport, _gc_itf.ep_in, _gc_itf.epin_buf, sizeof(gc_adapter_in_report_t));
 }
 
+// Encode into buf without sending (loopback latency probe)
+static uint16_t gc_adapter_mode_encode_report(uint8_t player_index,
+                                              const input_event_t* event,
+                                              const profile_output_t* profile_out,
+                                              uint32_t buttons,
+                                              uint8_t* buf, uint16_t bufsize)
+{
+    (void)event;
+
+    uint8_t port = player_index;
+    if (port >= 4) port = 0;
+
+    gc_adapter_in_report_t report = gc_adapter_report;
+    gc_adapter_mode_encode(&report, port, profile_out, buttons);
+    report.report_id = GC_ADAPTER_REPORT_ID_INPUT;
+    if (bufsize < sizeof(report)) return 0;
+    memcpy(buf, &report, sizeof(report));
+    return sizeof(report);
+}
+
 void gc_adapter_mode_handle_output(uint8_t report_id, const uint8_t* data, uint16_t len)
 {
     // If report_id is 0, first byte of data is the report ID
@@ -411,6 +438,7 @@ const usbd_mode_t gc_adapter_mode = {
 
     .init = gc_adapter_mode_init,
     .send_report = gc_adapter_mode_send_report,
+    .encode_report = gc_adapter_mode_encode_report,
     .is_ready = gc_adapter_mode_is_ready,
 
     .handle_output = gc_adapter_mode_handle_output,
@@ -86,48 +86,72 @@ static bool hid_mode_is_ready(void)
     return tud_hid_ready();
 }
 
-static bool hid_mode_send_report(uint8_t player_index,
-                                  const input_event_t* event,
-                                  const profile_output_t* profile_out,
-                                  uint32_t buttons)
+static void hid_mode_encode(joypad_hid_report_t* report,
+                            const input_event_t* event,
+                            const profile_output_t* profile_out,
+                            uint32_t buttons)
 {
-    (void)player_index;
     (void)event;
 
     // Convert buttons to HID format (18 buttons across 3 bytes)
     uint32_t hid_buttons = convert_buttons(buttons);
-    hid_report.buttons_lo = hid_buttons & 0xFF;
-    hid_report.buttons_mid = (hid_buttons >> 8) & 0xFF;
-    hid_report.buttons_hi = (hid_buttons >> 16) & 0x03;
-    hid_report.hat = convert_dpad_to_hat(buttons);
+    report->buttons_lo = hid_buttons & 0xFF;
+    report->buttons_mid = (hid_buttons >> 8) & 0xFF;
+    report->buttons_hi = (hid_buttons >> 16) & 0x03;
+    report->hat = convert_dpad_to_hat(buttons);
 
     // Analog sticks (HID convention: 0=up, 255=down)
-    hid_report.lx = profile_out->left_x;
-    hid_report.ly = profile_out->left_y;
-    hid_report.rx = profile_out->right_x;
-    hid_report.ry = profile_out->right_y;
+    report->lx = profile_out->left_x;
+    report->ly = profile_out->left_y;
+    report->rx = profile_out->right_x;
+    report->ry = profile_out->right_y;
 
     // Analog triggers
-    hid_report.lt = profile_out->l2_analog;
-    hid_report.rt = profile_out->r2_analog;
+    report->lt = profile_out->l2_analog;
+    report->rt = profile_out->r2_analog;
 
     // PS3 pressure axes (0x00 = released, 0xFF = fully pressed)
-    hid_report.pressure_dpad_right = (buttons & JP_BUTTON_DR) ? 0xFF : 0x00;
-    hid_report.pressure_dpad_left  = (buttons & JP_BUTTON_DL) ? 0xFF : 0x00;
-    hid_report.pressure_dpad_up    = (buttons & JP_BUTTON_DU) ? 0xFF : 0x00;
-    hid_report.pressure_dpad_down  = (buttons & JP_BUTTON_DD) ? 0xFF : 0x00;
-    hid_report.pressure_triangle   = (hid_buttons & USB_GAMEPAD_MASK_B4) ? 0xFF : 0x00;
-    hid_report.pressure_circle     = (hid_buttons & USB_GAMEPAD_MASK_B2) ? 0xFF : 0x00;
-    hid_report.pressure_cross      = (hid_buttons & USB_GAMEPAD_MASK_B1) ? 0xFF : 0x00;
-    hid_report.pressure_square     = (hid_buttons & USB_GAMEPAD_MASK_B3) ? 0xFF : 0x00;
-    hid_report.pressure_l1         = (hid_buttons & USB_GAMEPAD_MASK_L1) ? 0xFF : 0x00;
-    hid_report.pressure_r1         = (hid_buttons & USB_GAMEPAD_MASK_R1) ? 0xFF : 0x00;
-    hid_report.pressure_l2         = profile_out->l2_analog;
-    hid_report.pressure_r2         = profile_out->r2_analog;
+    report->pressure_dpad_right = (buttons & JP_BUTTON_DR) ? 0xFF : 0x00;
+    report->pressure_dpad_left  = (buttons & JP_BUTTON_DL) ? 0xFF : 0x00;
+    report->pressure_dpad_up    = (buttons & JP_BUTTON_DU) ? 0xFF : 0x00;
+    report->pressure_dpad_down  = (buttons & JP_BUTTON_DD) ? 0xFF : 0x00;
+    report->pressure_triangle   = (hid_buttons & USB_GAMEPAD_MASK_B4) ? 0xFF : 0x00;
+    report->pressure_circle     = (hid_buttons & USB_GAMEPAD_MASK_B2) ? 0xFF : 0x00;
+    report->pressure_cross      = (hid_buttons & USB_GAMEPAD_MASK_B1) ? 0xFF : 0x00;
+    report->pressure_square     = (hid_buttons & USB_GAMEPAD_MASK_B3) ? 0xFF : 0x00;
+    report->pressure_l1         = (hid_buttons & USB_GAMEPAD_MASK_L1) ? 0xFF : 0x00;
+    report->pressure_r1         = (hid_buttons & USB_GAMEPAD_MASK_R1) ? 0xFF : 0x00;
+    report->pressure_l2         = profile_out->l2_analog;
+    report->pressure_r2         = profile_out->r2_analog;
+}
+
+static bool hid_mode_send_report(uint8_t player_index,
+                                  const input_event_t* event,
+                                  const profile_output_t* profile_out,
+                                  uint32_t buttons)
+{
+    (void)player_index;
 
+    hid_mode_encode(&hid_report, event, profile_out, buttons);
     return tud_hid_report(0, &hid_report, sizeof(hid_report));
 }
 
+// Encode into buf without sending (loopback latency probe)
+static uint16_t hid_mode_encode_report(uint8_t player_index,
+                                       const input_event_t* event,
+                                       const profile_output_t* profile_out,
+                                       uint32_t buttons,
+                                       uint8_t* buf, uint16_t bufsize)
+{
+    (void)player_index;
+
+    joypad_hid_report_t report = hid_report;
+    hid_mode_encode(&report, event, profile_out, buttons);
+    if (bufsize < sizeof(report)) return 0;
+    memcpy(buf, &report, sizeof(report));
+    return sizeof(report);
+}
+
 static const uint8_t* hid_mode_get_report_descriptor(void)
 {
     return hid_report_descriptor;
@@ -151,6 +175,7 @@ const usbd_mode_t hid_mode = {
 
     .init = hid_mode_init,
     .send_report = hid_mode_send_report,
+    .encode_report = hid_mode_encode_report,
     .is_ready = hid_mode_is_ready,
 
     // No feedback support for generic HID
@@ -63,6 +63,28 @@ static bool kbmouse_mode_send_report(uint8_t player_index,
     }
 }
 
+// Encode into buf without sending (loopback latency probe). Encodes the
+// report send_report would send next; doesn't advance the alternation.
+static uint16_t kbmouse_mode_encode_report(uint8_t player_index,
+                                           const input_event_t* event,
+                                           const profile_output_t* profile_out,
+                                           uint32_t buttons,
+                                           uint8_t* buf, uint16_t bufsize)
+{
+    (void)player_index;
+    (void)event;
+
+    kbmouse_keyboard_report_t kb_report;
+    kbmouse_mouse_report_t mouse_report;
+    kbmouse_convert(buttons, profile_out, &kb_report, &mouse_report);
+
+    const void* report = send_keyboard_next ? (const void*)&kb_report : (const void*)&mouse_report;
+    uint16_t len = send_keyboard_next ? sizeof(kb_report) : sizeof(mouse_report);
+    if (bufsize < len) return 0;
+    memcpy(buf, report, len);
+    return len;
+}
+
 // Special handling for when no new input - still need to send mouse for continuous movement
 bool kbmouse_mode_send_idle_mouse(void)
 {
@@ -118,6 +140,7 @@ const usbd_mode_t kbmouse_mode = {
 
     .init = kbmouse_mode_init,
     .send_report = kbmouse_mode_send_report,
+    .encode_report = kbmouse_mode_encode_report,
     .is_ready = kbmouse_mode_is_ready,
 
     .handle_output = kbmouse_mode_handle_output,
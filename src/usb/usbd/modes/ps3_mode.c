@@ -33,96 +33,120 @@ static bool ps3_mode_is_ready(void)
     return tud_hid_ready();
 }
 
-static bool ps3_mode_send_report(uint8_t player_index,
-                                  const input_event_t* event,
-                                  const profile_output_t* profile_out,
-                                  uint32_t buttons)
+static void ps3_mode_encode(ps3_in_report_t* report,
+                            const input_event_t* event,
+                            const profile_output_t* profile_out,
+                            uint32_t buttons)
 {
-    (void)player_index;
-
     // Digital buttons byte 0
-    ps3_report.buttons[0] = 0;
-    if (buttons & JP_BUTTON_S1) ps3_report.buttons[0] |= PS3_BTN_SELECT;
-    if (buttons & JP_BUTTON_L3) ps3_report.buttons[0] |= PS3_BTN_L3;
-    if (buttons & JP_BUTTON_R3) ps3_report.buttons[0] |= PS3_BTN_R3;
-    if (buttons & JP_BUTTON_S2) ps3_report.buttons[0] |= PS3_BTN_START;
-    if (buttons & JP_BUTTON_DU) ps3_report.buttons[0] |= PS3_BTN_DPAD_UP;
-    if (buttons & JP_BUTTON_DR) ps3_report.buttons[0] |= PS3_BTN_DPAD_RIGHT;
-    if (buttons & JP_BUTTON_DD) ps3_report.buttons[0] |= PS3_BTN_DPAD_DOWN;
-    if (buttons & JP_BUTTON_DL) ps3_report.buttons[0] |= PS3_BTN_DPAD_LEFT;
+    report->buttons[0] = 0;
+    if (buttons & JP_BUTTON_S1) report->buttons[0] |= PS3_BTN_SELECT;
+    if (buttons & JP_BUTTON_L3) report->buttons[0] |= PS3_BTN_L3;
+    if (buttons & JP_BUTTON_R3) report->buttons[0] |= PS3_BTN_R3;
+    if (buttons & JP_BUTTON_S2) report->buttons[0] |= PS3_BTN_START;
+    if (buttons & JP_BUTTON_DU) report->buttons[0] |= PS3_BTN_DPAD_UP;
+    if (buttons & JP_BUTTON_DR) report->buttons[0] |= PS3_BTN_DPAD_RIGHT;
+    if (buttons & JP_BUTTON_DD) report->buttons[0] |= PS3_BTN_DPAD_DOWN;
+    if (buttons & JP_BUTTON_DL) report->buttons[0] |= PS3_BTN_DPAD_LEFT;
 
     // Digital buttons byte 1
-    ps3_report.buttons[1] = 0;
-    if (buttons & JP_BUTTON_L2) ps3_report.buttons[1] |= PS3_BTN_L2;
-    if (buttons & JP_BUTTON_R2) ps3_report.buttons[1] |= PS3_BTN_R2;
-    if (buttons & JP_BUTTON_L1) ps3_report.buttons[1] |= PS3_BTN_L1;
-    if (buttons & JP_BUTTON_R1) ps3_report.buttons[1] |= PS3_BTN_R1;
-    if (buttons & JP_BUTTON_B4) ps3_report.buttons[1] |= PS3_BTN_TRIANGLE;
-    if (buttons & JP_BUTTON_B2) ps3_report.buttons[1] |= PS3_BTN_CIRCLE;
-    if (buttons & JP_BUTTON_B1) ps3_report.buttons[1] |= PS3_BTN_CROSS;
-    if (buttons & JP_BUTTON_B3) ps3_report.buttons[1] |= PS3_BTN_SQUARE;
+    report->buttons[1] = 0;
+    if (buttons & JP_BUTTON_L2) report->buttons[1] |= PS3_BTN_L2;
+    if (buttons & JP_BUTTON_R2) report->buttons[1] |= PS3_BTN_R2;
+    if (buttons & JP_BUTTON_L1) report->buttons[1] |= PS3_BTN_L1;
+    if (buttons & JP_BUTTON_R1) report->buttons[1] |= PS3_BTN_R1;
+    if (buttons & JP_BUTTON_B4) report->buttons[1] |= PS3_BTN_TRIANGLE;
+    if (buttons & JP_BUTTON_B2) report->buttons[1] |= PS3_BTN_CIRCLE;
+    if (buttons & JP_BUTTON_B1) report->buttons[1] |= PS3_BTN_CROSS;
+    if (buttons & JP_BUTTON_B3) report->buttons[1] |= PS3_BTN_SQUARE;
 
     // Digital buttons byte 2 (PS button)
-    ps3_report.buttons[2] = 0;
-    if (buttons & JP_BUTTON_A1) ps3_report.buttons[2] |= PS3_BTN_PS;
+    report->buttons[2] = 0;
+    if (buttons & JP_BUTTON_A1) report->buttons[2] |= PS3_BTN_PS;
 
     // Analog sticks (HID convention: 0=up, 255=down - no inversion needed)
-    ps3_report.lx = profile_out->left_x;
-    ps3_report.ly = profile_out->left_y;
-    ps3_report.rx = profile_out->right_x;
-    ps3_report.ry = profile_out->right_y;
+    report->lx = profile_out->left_x;
+    report->ly = profile_out->left_y;
+    report->rx = profile_out->right_x;
+    report->ry = profile_out->right_y;
 
     // Pressure-sensitive buttons - use actual pressure data if available
     if (profile_out->has_pressure) {
         // D-pad pressure
-        ps3_report.pressure_up    = profile_out->pressure[0];
-        ps3_report.pressure_right = profile_out->pressure[1];
-        ps3_report.pressure_down  = profile_out->pressure[2];
-        ps3_report.pressure_left  = profile_out->pressure[3];
+        report->pressure_up    = profile_out->pressure[0];
+        report->pressure_right = profile_out->pressure[1];
+        report->pressure_down  = profile_out->pressure[2];
+        report->pressure_left  = profile_out->pressure[3];
         // Triggers/bumpers pressure
-        ps3_report.pressure_l2    = profile_out->pressure[4];
-        ps3_report.pressure_r2    = profile_out->pressure[5];
-        ps3_report.pressure_l1    = profile_out->pressure[6];
-        ps3_report.pressure_r1    = profile_out->pressure[7];
+        report->pressure_l2    = profile_out->pressure[4];
+        report->pressure_r2    = profile_out->pressure[5];
+        report->pressure_l1    = profile_out->pressure[6];
+        report->pressure_r1    = profile_out->pressure[7];
         // Face buttons pressure
-        ps3_report.pressure_triangle = profile_out->pressure[8];
-        ps3_report.pressure_circle   = profile_out->pressure[9];
-        ps3_report.pressure_cross    = profile_out->pressure[10];
-        ps3_report.pressure_square   = profile_out->pressure[11];
+        report->pressure_triangle = profile_out->pressure[8];
+        report->pressure_circle   = profile_out->pressure[9];
+        report->pressure_cross    = profile_out->pressure[10];
+        report->pressure_square   = profile_out->pressure[11];
     } else {
         // Fall back to digital (0xFF pressed, 0x00 released)
-        ps3_report.pressure_up    = (buttons & JP_BUTTON_DU) ? 0xFF : 0x00;
-        ps3_report.pressure_right = (buttons & JP_BUTTON_DR) ? 0xFF : 0x00;
-        ps3_report.pressure_down  = (buttons & JP_BUTTON_DD) ? 0xFF : 0x00;
-        ps3_report.pressure_left  = (buttons & JP_BUTTON_DL) ? 0xFF : 0x00;
-        ps3_report.pressure_l2    = profile_out->l2_analog;
-        ps3_report.pressure_r2    = profile_out->r2_analog;
-        ps3_report.pressure_l1    = (buttons & JP_BUTTON_L1) ? 0xFF : 0x00;
-        ps3_report.pressure_r1    = (buttons & JP_BUTTON_R1) ? 0xFF : 0x00;
-        ps3_report.pressure_triangle = (buttons & JP_BUTTON_B4) ? 0xFF : 0x00;
-        ps3_report.pressure_circle   = (buttons & JP_BUTTON_B2) ? 0xFF : 0x00;
-        ps3_report.pressure_cross    = (buttons & JP_BUTTON_B1) ? 0xFF : 0x00;
-        ps3_report.pressure_square   = (buttons & JP_BUTTON_B3) ? 0xFF : 0x00;
+        report->pressure_up    = (buttons & JP_BUTTON_DU) ? 0xFF : 0x00;
+        report->pressure_right = (buttons & JP_BUTTON_DR) ? 0xFF : 0x00;
+        report->pressure_down  = (buttons & JP_BUTTON_DD) ? 0xFF : 0x00;
+        report->pressure_left  = (buttons & JP_BUTTON_DL) ? 0xFF : 0x00;
+        report->pressure_l2    = profile_out->l2_analog;
+        report->pressure_r2    = profile_out->r2_analog;
+        report->pressure_l1    = (buttons & JP_BUTTON_L1) ? 0xFF : 0x00;
+        report->pressure_r1    = (buttons & JP_BUTTON_R1) ? 0xFF : 0x00;
+        report->pressure_triangle = (buttons & JP_BUTTON_B4) ? 0xFF : 0x00;
+        report->pressure_circle   = (buttons & JP_BUTTON_B2) ? 0xFF : 0x00;
+        report->pressure_cross    = (buttons & JP_BUTTON_B1) ? 0xFF : 0x00;
+        report->pressure_square   = (buttons & JP_BUTTON_B3) ? 0xFF : 0x00;
     }
 
     // Motion data (SIXAXIS) - big-endian 16-bit values
     if (event->has_motion) {
-        ps3_report.accel_x = __builtin_bswap16((uint16_t)event->accel[0]);
-        ps3_report.accel_y = __builtin_bswap16((uint16_t)event->accel[1]);
-        ps3_report.accel_z = __builtin_bswap16((uint16_t)event->accel[2]);
-        ps3_report.gyro_z  = __builtin_bswap16((uint16_t)event->gyro[2]);
+        report->accel_x = __builtin_bswap16((uint16_t)event->accel[0]);
+        report->accel_y = __builtin_bswap16((uint16_t)event->accel[1]);
+        report->accel_z = __builtin_bswap16((uint16_t)event->accel[2]);
+        report->gyro_z  = __builtin_bswap16((uint16_t)event->gyro[2]);
     } else {
         // Neutral motion (center at 512 = 0x0200, big-endian = 0x0002)
-        ps3_report.accel_x = PS3_SIXAXIS_MID_BE;
-        ps3_report.accel_y = PS3_SIXAXIS_MID_BE;
-        ps3_report.accel_z = PS3_SIXAXIS_MID_BE;
-        ps3_report.gyro_z  = PS3_SIXAXIS_MID_BE;
+        report->accel_x = PS3_SIXAXIS_MID_BE;
+        report->accel_y = PS3_SIXAXIS_MID_BE;
+        report->accel_z = PS3_SIXAXIS_MID_BE;
+        report->gyro_z  = PS3_SIXAXIS_MID_BE;
     }
+}
+
+static bool ps3_mode_send_report(uint8_t player_index,
+                                  const input_event_t* event,
+                                  const profile_output_t* profile_out,
+                                  uint32_t buttons)
+{
+    (void)player_index;
+
+    ps3_mode_encode(&ps3_report, event, profile_out, buttons);
 
     // Send full report including report_id
     return tud_hid_report(0, &ps3_report, sizeof(ps3_report));
 }
 
+// Encode into buf without sending (loopback latency probe)
+static uint16_t ps3_mode_encode_report(uint8_t player_index,
+                                       const input_event_t* event,
+                                       const profile_output_t* profile_out,
+                                       uint32_t buttons,
+                                       uint8_t* buf, uint16_t bufsize)
+{
+    (void)player_index;
+
+    ps3_in_report_t report = ps3_report;
+    ps3_mode_encode(&report, event, profile_out, buttons);
+    if (bufsize < sizeof(report)) return 0;
+    memcpy(buf, &report, sizeof(report));
+    return sizeof(report);
+}
+
 static void ps3_mode_handle_output(uint8_t report_id, const uint8_t* data, uint16_t len)
 {
     (void)report_id;
@@ -242,6 +266,7 @@ const usbd_mode_t ps3_mode = {
 
     .init = ps3_mode_init,
     .send_report = ps3_mode_send_report,
+    .encode_report = ps3_mode_encode_report,
     .is_ready = ps3_mode_is_ready,
 
     .handle_output = ps3_mode_handle_output,
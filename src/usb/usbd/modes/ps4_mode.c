@@ -65,22 +65,21 @@ static bool ps4_mode_is_ready(void)
 //   Byte 8:    Left trigger analog (0x00-0xFF)
 //   Byte 9:    Right trigger analog (0x00-0xFF)
 //   Bytes 10-63: Timestamp, sensor data, touchpad data, padding
-static bool ps4_mode_send_report(uint8_t player_index,
-                                  const input_event_t* event,
-                                  const profile_output_t* profile_out,
-                                  uint32_t buttons)
+static void ps4_mode_encode(uint8_t* report, uint8_t counter,
+                            const input_event_t* event,
+                            const profile_output_t* profile_out,
+                            uint32_t buttons)
 {
-    (void)player_index;
     (void)event;
 
     // Byte 0: Report ID
-    ps4_report_buffer[0] = 0x01;
+    report[0] = 0x01;
 
     // Bytes 1-4: Analog sticks (HID convention: 0=up, 255=down - no inversion needed)
-    ps4_report_buffer[1] = profile_out->left_x;          // LX
-    ps4_report_buffer[2] = profile_out->left_y;          // LY
-    ps4_report_buffer[3] = profile_out->right_x;         // RX
-    ps4_report_buffer[4] = profile_out->right_y;         // RY
+    report[1] = profile_out->left_x;          // LX
+    report[2] = profile_out->left_y;          // LY
+    report[3] = profile_out->right_x;         // RX
+    report[4] = profile_out->right_y;         // RY
 
     // Byte 5: D-pad (bits 0-3) + face buttons (bits 4-7)
     uint8_t up = (buttons & JP_BUTTON_DU) ? 1 : 0;
@@ -105,7 +104,7 @@ static bool ps4_mode_send_report(uint8_t player_index,
     if (buttons & JP_BUTTON_B2) face_buttons |= 0x40;  // Circle
     if (buttons & JP_BUTTON_B4) face_buttons |= 0x80;  // Triangle
 
-    ps4_report_buffer[5] = dpad | face_buttons;
+    report[5] = dpad | face_buttons;
 
     // Byte 6: Shoulder buttons + other buttons
     uint8_t byte6 = 0;
@@ -117,27 +116,52 @@ static bool ps4_mode_send_report(uint8_t player_index,
     if (buttons & JP_BUTTON_S2) byte6 |= 0x20;  // Options
     if (buttons & JP_BUTTON_L3) byte6 |= 0x40;  // L3
     if (buttons & JP_BUTTON_R3) byte6 |= 0x80;  // R3
-    ps4_report_buffer[6] = byte6;
+    report[6] = byte6;
 
     // Byte 7: PS + Touchpad + Counter (6-bit)
     uint8_t byte7 = 0;
     if (buttons & JP_BUTTON_A1) byte7 |= 0x01;  // PS button
     if (buttons & JP_BUTTON_A2) byte7 |= 0x02;  // Touchpad click
-    byte7 |= ((ps4_report_counter++ & 0x3F) << 2);       // Counter in bits 2-7
-    ps4_report_buffer[7] = byte7;
+    byte7 |= ((counter & 0x3F) << 2);       // Counter in bits 2-7
+    report[7] = byte7;
 
     // Bytes 8-9: Analog triggers
-    ps4_report_buffer[8] = profile_out->l2_analog;  // Left trigger
-    ps4_report_buffer[9] = profile_out->r2_analog;  // Right trigger
+    report[8] = profile_out->l2_analog;  // Left trigger
+    report[9] = profile_out->r2_analog;  // Right trigger
 
     // Bytes 10-11: Timestamp (we can just increment)
     // Bytes 12-63: Leave as initialized (sensor data, touchpad, padding)
+}
+
+static bool ps4_mode_send_report(uint8_t player_index,
+                                  const input_event_t* event,
+                                  const profile_output_t* profile_out,
+                                  uint32_t buttons)
+{
+    (void)player_index;
+
+    ps4_mode_encode(ps4_report_buffer, ps4_report_counter++, event, profile_out, buttons);
 
     // Send with report_id=0x01, letting TinyUSB prepend it
     // Skip byte 0 of buffer (our report_id) and send 63 bytes of data
     return tud_hid_report(0x01, &ps4_report_buffer[1], 63);
 }
 
+// Encode into buf without sending (loopback latency probe)
+static uint16_t ps4_mode_encode_report(uint8_t player_index,
+                                       const input_event_t* event,
+                                       const profile_output_t* profile_out,
+                                       uint32_t buttons,
+                                       uint8_t* buf, uint16_t bufsize)
+{
+    (void)player_index;
+
+    if (bufsize < sizeof(ps4_report_buffer)) return 0;
+    memcpy(buf, ps4_report_buffer, sizeof(ps4_report_buffer));
+    ps4_mode_encode(buf, ps4_report_counter, event, profile_out, buttons);
+    return sizeof(ps4_report_buffer);
+}
+
 static void ps4_mode_handle_output(uint8_t report_id, const uint8_t* data, uint16_t len)
 {
     // PS4 output report (rumble/LED) - Report ID 5
@@ -296,6 +320,7 @@ const usbd_mode_t ps4_mode = {
 
     .init = ps4_mode_init,
     .send_report = ps4_mode_send_report,
+    .encode_report = ps4_mode_encode_report,
     .is_ready = ps4_mode_is_ready,
 
     .handle_output = ps4_mode_handle_output,
@@ -29,17 +29,16 @@ static bool psclassic_mode_is_ready(void)
     return tud_hid_ready();
 }
 
-static bool psclassic_mode_send_report(uint8_t player_index,
-                                        const input_event_t* event,
-                                        const profile_output_t* profile_out,
-                                        uint32_t buttons)
+static void psclassic_mode_encode(psclassic_in_report_t* report,
+                                  const input_event_t* event,
+                                  const profile_output_t* profile_out,
+                                  uint32_t buttons)
 {
-    (void)player_index;
     (void)event;
     (void)profile_out;
 
     // Start with D-pad centered
-    psclassic_report.buttons = PSCLASSIC_DPAD_CENTER;
+    report->buttons = PSCLASSIC_DPAD_CENTER;
 
     // D-pad encoding (bits 10-13)
     uint8_t up = (buttons & JP_BUTTON_DU) ? 1 : 0;
@@ -47,17 +46,17 @@ static bool psclassic_mode_send_report(uint8_t player_index,
     uint8_t left = (buttons & JP_BUTTON_DL) ? 1 : 0;
     uint8_t right = (buttons & JP_BUTTON_DR) ? 1 : 0;
 
-    if (up && right)        psclassic_report.buttons = PSCLASSIC_DPAD_UP_RIGHT;
-    else if (up && left)    psclassic_report.buttons = PSCLASSIC_DPAD_UP_LEFT;
-    else if (down && right) psclassic_report.buttons = PSCLASSIC_DPAD_DOWN_RIGHT;
-    else if (down && left)  psclassic_report.buttons = PSCLASSIC_DPAD_DOWN_LEFT;
-    else if (up)            psclassic_report.buttons = PSCLASSIC_DPAD_UP;
-    else if (down)          psclassic_report.buttons = PSCLASSIC_DPAD_DOWN;
-    else if (left)          psclassic_report.buttons = PSCLASSIC_DPAD_LEFT;
-    else if (right)         psclassic_report.buttons = PSCLASSIC_DPAD_RIGHT;
+    if (up && right)        report->buttons = PSCLASSIC_DPAD_UP_RIGHT;
+    else if (up && left)    report->buttons = PSCLASSIC_DPAD_UP_LEFT;
+    else if (down && right) report->buttons = PSCLASSIC_DPAD_DOWN_RIGHT;
+    else if (down && left)  report->buttons = PSCLASSIC_DPAD_DOWN_LEFT;
+    else if (up)            report->buttons = PSCLASSIC_DPAD_UP;
+    else if (down)          report->buttons = PSCLASSIC_DPAD_DOWN;
+    else if (left)          report->buttons = PSCLASSIC_DPAD_LEFT;
+    else if (right)         report->buttons = PSCLASSIC_DPAD_RIGHT;
 
     // Face buttons and shoulders (bits 0-9)
-    psclassic_report.buttons |=
+    report->buttons |=
           (buttons & JP_BUTTON_B4 ? PSCLASSIC_MASK_TRIANGLE : 0)
         | (buttons & JP_BUTTON_B2 ? PSCLASSIC_MASK_CIRCLE   : 0)
         | (buttons & JP_BUTTON_B1 ? PSCLASSIC_MASK_CROSS    : 0)
@@ -68,10 +67,35 @@ static bool psclassic_mode_send_report(uint8_t player_index,
         | (buttons & JP_BUTTON_R2 ? PSCLASSIC_MASK_R2       : 0)
         | (buttons & JP_BUTTON_S1 ? PSCLASSIC_MASK_SELECT   : 0)
         | (buttons & JP_BUTTON_S2 ? PSCLASSIC_MASK_START    : 0);
+}
+
+static bool psclassic_mode_send_report(uint8_t player_index,
+                                        const input_event_t* event,
+                                        const profile_output_t* profile_out,
+                                        uint32_t buttons)
+{
+    (void)player_index;
 
+    psclassic_mode_encode(&psclassic_report, event, profile_out, buttons);
     return tud_hid_report(0, &psclassic_report, sizeof(psclassic_report));
 }
 
+// Encode into buf without sending (loopback latency probe)
+static uint16_t psclassic_mode_encode_report(uint8_t player_index,
+                                             const input_event_t* event,
+                                             const profile_output_t* profile_out,
+                                             uint32_t buttons,
+                                             uint8_t* buf, uint16_t bufsize)
+{
+    (void)player_index;
+
+    psclassic_in_report_t report = psclassic_report;
+    psclassic_mode_encode(&report, event, profile_out, buttons);
+    if (bufsize < sizeof(report)) return 0;
+    memcpy(buf, &report, sizeof(report));
+    return sizeof(report);
+}
+
 static const uint8_t* psclassic_mode_get_device_descriptor(void)
 {
     return (const uint8_t*)&psclassic_device_descriptor;
@@ -101,6 +125,7 @@ const usbd_mode_t psclassic_mode = {
 
     .init = psclassic_mode_init,
     .send_report = psclassic_mode_send_report,
+    .encode_report = psclassic_mode_encode_report,
     .is_ready = psclassic_mode_is_ready,
 
     // No feedback support for PS Classic
@@ -58,49 +58,73 @@ static bool switch_mode_is_ready(void)
     return tud_hid_ready();
 }
 
-static bool switch_mode_send_report(uint8_t player_index,
-                                     const input_event_t* event,
-                                     const profile_output_t* profile_out,
-                                     uint32_t buttons)
+static void switch_mode_encode(switch_in_report_t* report,
+                               const input_event_t* event,
+                               const profile_output_t* profile_out,
+                               uint32_t buttons)
 {
-    (void)player_index;
     (void)event;
 
     // Buttons (16-bit) - position-based mapping (matches GP2040-CE)
-    switch_report.buttons = 0;
-    if (buttons & JP_BUTTON_B1) switch_report.buttons |= SWITCH_MASK_B;     // B1 (Sud)  -> B
-    if (buttons & JP_BUTTON_B2) switch_report.buttons |= SWITCH_MASK_A;     // B2 (Est)  -> A
-    if (buttons & JP_BUTTON_B3) switch_report.buttons |= SWITCH_MASK_Y;     // B3 (Ouest)-> Y
-    if (buttons & JP_BUTTON_B4) switch_report.buttons |= SWITCH_MASK_X;     // B4 (Nord) -> X
-    if (buttons & JP_BUTTON_L1) switch_report.buttons |= SWITCH_MASK_L;     // L
-    if (buttons & JP_BUTTON_R1) switch_report.buttons |= SWITCH_MASK_R;     // R
+    report->buttons = 0;
+    if (buttons & JP_BUTTON_B1) report->buttons |= SWITCH_MASK_B;     // B1 (Sud)  -> B
+    if (buttons & JP_BUTTON_B2) report->buttons |= SWITCH_MASK_A;     // B2 (Est)  -> A
+    if (buttons & JP_BUTTON_B3) report->buttons |= SWITCH_MASK_Y;     // B3 (Ouest)-> Y
+    if (buttons & JP_BUTTON_B4) report->buttons |= SWITCH_MASK_X;     // B4 (Nord) -> X
+    if (buttons & JP_BUTTON_L1) report->buttons |= SWITCH_MASK_L;     // L
+    if (buttons & JP_BUTTON_R1) report->buttons |= SWITCH_MASK_R;     // R
     
     // --- TES GACHETTES ZL / ZR SONT ICI ---
-    if (buttons & JP_BUTTON_L2) switch_report.buttons |= SWITCH_MASK_ZL;    // ZL
-    if (buttons & JP_BUTTON_R2) switch_report.buttons |= SWITCH_MASK_ZR;    // ZR
+    if (buttons & JP_BUTTON_L2) report->buttons |= SWITCH_MASK_ZL;    // ZL
+    if (buttons & JP_BUTTON_R2) report->buttons |= SWITCH_MASK_ZR;    // ZR
     // --------------------------------------
 
-    if (buttons & JP_BUTTON_S1) switch_report.buttons |= SWITCH_MASK_MINUS; // Minus
-    if (buttons & JP_BUTTON_S2) switch_report.buttons |= SWITCH_MASK_PLUS;  // Plus
-    if (buttons & JP_BUTTON_L3) switch_report.buttons |= SWITCH_MASK_L3;    // L3
-    if (buttons & JP_BUTTON_R3) switch_report.buttons |= SWITCH_MASK_R3;    // R3
-    if (buttons & JP_BUTTON_A1) switch_report.buttons |= SWITCH_MASK_HOME;  // Home
-    if (buttons & JP_BUTTON_A2) switch_report.buttons |= SWITCH_MASK_CAPTURE; // Capture
+    if (buttons & JP_BUTTON_S1) report->buttons |= SWITCH_MASK_MINUS; // Minus
+    if (buttons & JP_BUTTON_S2) report->buttons |= SWITCH_MASK_PLUS;  // Plus
+    if (buttons & JP_BUTTON_L3) report->buttons |= SWITCH_MASK_L3;    // L3
+    if (buttons & JP_BUTTON_R3) report->buttons |= SWITCH_MASK_R3;    // R3
+    if (buttons & JP_BUTTON_A1) report->buttons |= SWITCH_MASK_HOME;  // Home
+    if (buttons & JP_BUTTON_A2) report->buttons |= SWITCH_MASK_CAPTURE; // Capture
 
     // D-pad as hat switch
-    switch_report.hat = convert_dpad_to_hat(buttons);
+    report->hat = convert_dpad_to_hat(buttons);
 
     // Analog sticks
-    switch_report.lx = profile_out->left_x;
-    switch_report.ly = profile_out->left_y;
-    switch_report.rx = profile_out->right_x;
-    switch_report.ry = profile_out->right_y;
+    report->lx = profile_out->left_x;
+    report->ly = profile_out->left_y;
+    report->rx = profile_out->right_x;
+    report->ry = profile_out->right_y;
 
-    switch_report.vendor = 0;
+    report->vendor = 0;
+}
+
+static bool switch_mode_send_report(uint8_t player_index,
+                                     const input_event_t* event,
+                                     const profile_output_t* profile_out,
+                                     uint32_t buttons)
+{
+    (void)player_index;
 
+    switch_mode_encode(&switch_report, event, profile_out, buttons);
     return tud_hid_report(0, &switch_report, sizeof(switch_report));
 }
 
+// Encode into buf without sending (loopback latency probe)
+static uint16_t switch_mode_encode_report(uint8_t player_index,
+                                          const input_event_t* event,
+                                          const profile_output_t* profile_out,
+                                          uint32_t buttons,
+                                          uint8_t* buf, uint16_t bufsize)
+{
+    (void)player_index;
+
+    switch_in_report_t report = switch_report;
+    switch_mode_encode(&report, event, profile_out, buttons);
+    if (bufsize < sizeof(report)) return 0;
+    memcpy(buf, &report, sizeof(report));
+    return sizeof(report);
+}
+
 static const uint8_t* switch_mode_get_device_descriptor(void)
 {
     return (const uint8_t*)&switch_device_descriptor;
@@ -131,6 +155,7 @@ const usbd_mode_t switch_mode = {
 
     .init = switch_mode_init,
     .send_report = switch_mode_send_report,
+    .encode_report = switch_mode_encode_report,
     .is_ready = switch_mode_is_ready,
 
     // Pas de rumble/feedback
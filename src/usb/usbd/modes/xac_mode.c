@@ -53,22 +53,21 @@ static bool xac_mode_is_ready(void)
     return tud_hid_ready();
 }
 
-static bool xac_mode_send_report(uint8_t player_index,
-                                  const input_event_t* event,
-                                  const profile_output_t* profile_out,
-                                  uint32_t buttons)
+static void xac_mode_encode(xac_in_report_t* report,
+                            const input_event_t* event,
+                            const profile_output_t* profile_out,
+                            uint32_t buttons)
 {
-    (void)player_index;
     (void)event;
 
     // Analog sticks (HID convention: 0=up, 255=down - no inversion needed)
-    xac_report.lx = profile_out->left_x;
-    xac_report.ly = profile_out->left_y;
-    xac_report.rx = profile_out->right_x;
-    xac_report.ry = profile_out->right_y;
+    report->lx = profile_out->left_x;
+    report->ly = profile_out->left_y;
+    report->rx = profile_out->right_x;
+    report->ry = profile_out->right_y;
 
     // D-pad as hat switch
-    xac_report.hat = convert_dpad_to_hat(buttons);
+    report->hat = convert_dpad_to_hat(buttons);
 
     // Buttons (12 total, split into low 4 bits and high 8 bits)
     uint16_t xac_buttons = 0;
@@ -85,12 +84,37 @@ static bool xac_mode_send_report(uint8_t player_index,
     if (buttons & JP_BUTTON_L3) xac_buttons |= XAC_MASK_L3;  // LS
     if (buttons & JP_BUTTON_R3) xac_buttons |= XAC_MASK_R3;  // RS
 
-    xac_report.buttons_lo = xac_buttons & 0x0F;
-    xac_report.buttons_hi = (xac_buttons >> 4) & 0xFF;
+    report->buttons_lo = xac_buttons & 0x0F;
+    report->buttons_hi = (xac_buttons >> 4) & 0xFF;
+}
+
+static bool xac_mode_send_report(uint8_t player_index,
+                                  const input_event_t* event,
+                                  const profile_output_t* profile_out,
+                                  uint32_t buttons)
+{
+    (void)player_index;
 
+    xac_mode_encode(&xac_report, event, profile_out, buttons);
     return tud_hid_report(0, &xac_report, sizeof(xac_report));
 }
 
+// Encode into buf without sending (loopback latency probe)
+static uint16_t xac_mode_encode_report(uint8_t player_index,
+                                       const input_event_t* event,
+                                       const profile_output_t* profile_out,
+                                       uint32_t buttons,
+                                       uint8_t* buf, uint16_t bufsize)
+{
+    (void)player_index;
+
+    xac_in_report_t report = xac_report;
+    xac_mode_encode(&report, event, profile_out, buttons);
+    if (bufsize < sizeof(report)) return 0;
+    memcpy(buf, &report, sizeof(report));
+    return sizeof(report);
+}
+
 static const uint8_t* xac_mode_get_device_descriptor(void)
 {
     return (const uint8_t*)&xac_device_descriptor;
@@ -120,6 +144,7 @@ const usbd_mode_t xac_mode = {
 
     .init = xac_mode_init,
     .send_report = xac_mode_send_report,
+    .encode_report = xac_mode_encode_report,
     .is_ready = xac_mode_is_ready,
 
     // XAC mode has no rumble or feedback
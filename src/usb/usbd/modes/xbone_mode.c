@@ -43,61 +43,85 @@ static bool xbone_mode_is_ready(void)
     return xbone_is_powered_on() && tud_xbone_ready();
 }
 
-static bool xbone_mode_send_report(uint8_t player_index,
-                                    const input_event_t* event,
-                                    const profile_output_t* profile_out,
-                                    uint32_t buttons)
+static void xbone_mode_encode(gip_input_report_t* report,
+                              const input_event_t* event,
+                              const profile_output_t* profile_out,
+                              uint32_t buttons)
 {
-    (void)player_index;
     (void)event;
 
     // Clear report
-    memset(&xbone_report, 0, sizeof(gip_input_report_t));
+    memset(report, 0, sizeof(*report));
 
     // Buttons
-    xbone_report.a = (buttons & JP_BUTTON_B1) ? 1 : 0;
-    xbone_report.b = (buttons & JP_BUTTON_B2) ? 1 : 0;
-    xbone_report.x = (buttons & JP_BUTTON_B3) ? 1 : 0;
-    xbone_report.y = (buttons & JP_BUTTON_B4) ? 1 : 0;
+    report->a = (buttons & JP_BUTTON_B1) ? 1 : 0;
+    report->b = (buttons & JP_BUTTON_B2) ? 1 : 0;
+    report->x = (buttons & JP_BUTTON_B3) ? 1 : 0;
+    report->y = (buttons & JP_BUTTON_B4) ? 1 : 0;
 
-    xbone_report.left_shoulder = (buttons & JP_BUTTON_L1) ? 1 : 0;
-    xbone_report.right_shoulder = (buttons & JP_BUTTON_R1) ? 1 : 0;
+    report->left_shoulder = (buttons & JP_BUTTON_L1) ? 1 : 0;
+    report->right_shoulder = (buttons & JP_BUTTON_R1) ? 1 : 0;
 
-    xbone_report.back = (buttons & JP_BUTTON_S1) ? 1 : 0;
-    xbone_report.start = (buttons & JP_BUTTON_S2) ? 1 : 0;
+    report->back = (buttons & JP_BUTTON_S1) ? 1 : 0;
+    report->start = (buttons & JP_BUTTON_S2) ? 1 : 0;
 
-    xbone_report.guide = (buttons & JP_BUTTON_A1) ? 1 : 0;
-    xbone_report.sync = (buttons & JP_BUTTON_A2) ? 1 : 0;
+    report->guide = (buttons & JP_BUTTON_A1) ? 1 : 0;
+    report->sync = (buttons & JP_BUTTON_A2) ? 1 : 0;
 
-    xbone_report.left_thumb = (buttons & JP_BUTTON_L3) ? 1 : 0;
-    xbone_report.right_thumb = (buttons & JP_BUTTON_R3) ? 1 : 0;
+    report->left_thumb = (buttons & JP_BUTTON_L3) ? 1 : 0;
+    report->right_thumb = (buttons & JP_BUTTON_R3) ? 1 : 0;
 
-    xbone_report.dpad_up = (buttons & JP_BUTTON_DU) ? 1 : 0;
-    xbone_report.dpad_down = (buttons & JP_BUTTON_DD) ? 1 : 0;
-    xbone_report.dpad_left = (buttons & JP_BUTTON_DL) ? 1 : 0;
-    xbone_report.dpad_right = (buttons & JP_BUTTON_DR) ? 1 : 0;
+    report->dpad_up = (buttons & JP_BUTTON_DU) ? 1 : 0;
+    report->dpad_down = (buttons & JP_BUTTON_DD) ? 1 : 0;
+    report->dpad_left = (buttons & JP_BUTTON_DL) ? 1 : 0;
+    report->dpad_right = (buttons & JP_BUTTON_DR) ? 1 : 0;
 
     // Triggers (0-1023)
     // Map from profile analog (0-255) to Xbox One range (0-1023)
-    xbone_report.left_trigger = (uint16_t)profile_out->l2_analog * 4;
-    xbone_report.right_trigger = (uint16_t)profile_out->r2_analog * 4;
+    report->left_trigger = (uint16_t)profile_out->l2_analog * 4;
+    report->right_trigger = (uint16_t)profile_out->r2_analog * 4;
 
     // Fallback to digital if analog is 0 but button pressed
-    if (xbone_report.left_trigger == 0 && (buttons & JP_BUTTON_L2))
-        xbone_report.left_trigger = 1023;
-    if (xbone_report.right_trigger == 0 && (buttons & JP_BUTTON_R2))
-        xbone_report.right_trigger = 1023;
+    if (report->left_trigger == 0 && (buttons & JP_BUTTON_L2))
+        report->left_trigger = 1023;
+    if (report->right_trigger == 0 && (buttons & JP_BUTTON_R2))
+        report->right_trigger = 1023;
 
     // Analog sticks (signed 16-bit, -32768 to +32767)
     // Y-axis inverted: input 0=down, output positive=up
-    xbone_report.left_stick_x = convert_axis_to_s16(profile_out->left_x);
-    xbone_report.left_stick_y = -convert_axis_to_s16(profile_out->left_y);
-    xbone_report.right_stick_x = convert_axis_to_s16(profile_out->right_x);
-    xbone_report.right_stick_y = -convert_axis_to_s16(profile_out->right_y);
+    report->left_stick_x = convert_axis_to_s16(profile_out->left_x);
+    report->left_stick_y = -convert_axis_to_s16(profile_out->left_y);
+    report->right_stick_x = convert_axis_to_s16(profile_out->right_x);
+    report->right_stick_y = -convert_axis_to_s16(profile_out->right_y);
+}
 
+static bool xbone_mode_send_report(uint8_t player_index,
+                                    const input_event_t* event,
+                                    const profile_output_t* profile_out,
+                                    uint32_t buttons)
+{
+    (void)player_index;
+
+    xbone_mode_encode(&xbone_report, event, profile_out, buttons);
     return tud_xbone_send_report(&xbone_report);
 }
 
+// Encode into buf without sending (loopback latency probe)
+static uint16_t xbone_mode_encode_report(uint8_t player_index,
+                                         const input_event_t* event,
+                                         const profile_output_t* profile_out,
+                                         uint32_t buttons,
+                                         uint8_t* buf, uint16_t bufsize)
+{
+    (void)player_index;
+
+    gip_input_report_t report = xbone_report;
+    xbone_mode_encode(&report, event, profile_out, buttons);
+    if (bufsize < sizeof(report)) return 0;
+    memcpy(buf, &report, sizeof(report));
+    return sizeof(report);
+}
+
 static void xbone_mode_task(void)
 {
     // Update Xbox One driver (handles GIP protocol state machine)
@@ -133,6 +157,7 @@ const usbd_mode_t xbone_mode = {
 
     .init = xbone_mode_init,
     .send_report = xbone_mode_send_report,
+    .encode_report = xbone_mode_encode_report,
     .is_ready = xbone_mode_is_ready,
 
     // Xbox One rumble is handled via GIP protocol in tud_xbone driver
@@ -67,41 +67,65 @@ static bool xid_mode_is_ready(void)
     return tud_xid_ready();
 }
 
-static bool xid_mode_send_report(uint8_t player_index,
-                                  const input_event_t* event,
-                                  const profile_output_t* profile_out,
-                                  uint32_t buttons)
+static void xid_mode_encode(xbox_og_in_report_t* report,
+                            const input_event_t* event,
+                            const profile_output_t* profile_out,
+                            uint32_t buttons)
 {
-    (void)player_index;
     (void)event;
 
     // Digital buttons (DPAD, Start, Back, L3, R3)
-    xid_report.buttons = convert_xid_digital_buttons(buttons);
+    report->buttons = convert_xid_digital_buttons(buttons);
 
     // Analog face buttons (0 = not pressed, 255 = fully pressed)
-    xid_report.a     = (buttons & JP_BUTTON_B1) ? 0xFF : 0x00;
-    xid_report.b     = (buttons & JP_BUTTON_B2) ? 0xFF : 0x00;
-    xid_report.x     = (buttons & JP_BUTTON_B3) ? 0xFF : 0x00;
-    xid_report.y     = (buttons & JP_BUTTON_B4) ? 0xFF : 0x00;
-    xid_report.black = (buttons & JP_BUTTON_L1) ? 0xFF : 0x00;  // L1 -> Black
-    xid_report.white = (buttons & JP_BUTTON_R1) ? 0xFF : 0x00;  // R1 -> White
+    report->a     = (buttons & JP_BUTTON_B1) ? 0xFF : 0x00;
+    report->b     = (buttons & JP_BUTTON_B2) ? 0xFF : 0x00;
+    report->x     = (buttons & JP_BUTTON_B3) ? 0xFF : 0x00;
+    report->y     = (buttons & JP_BUTTON_B4) ? 0xFF : 0x00;
+    report->black = (buttons & JP_BUTTON_L1) ? 0xFF : 0x00;  // L1 -> Black
+    report->white = (buttons & JP_BUTTON_R1) ? 0xFF : 0x00;  // R1 -> White
 
     // Analog triggers (0-255)
     // Use profile analog values, fall back to digital if analog is 0 but button pressed
-    xid_report.trigger_l = profile_out->l2_analog;
-    xid_report.trigger_r = profile_out->r2_analog;
-    if (xid_report.trigger_l == 0 && (buttons & JP_BUTTON_L2)) xid_report.trigger_l = 0xFF;
-    if (xid_report.trigger_r == 0 && (buttons & JP_BUTTON_R2)) xid_report.trigger_r = 0xFF;
+    report->trigger_l = profile_out->l2_analog;
+    report->trigger_r = profile_out->r2_analog;
+    if (report->trigger_l == 0 && (buttons & JP_BUTTON_L2)) report->trigger_l = 0xFF;
+    if (report->trigger_r == 0 && (buttons & JP_BUTTON_R2)) report->trigger_r = 0xFF;
 
     // Analog sticks (signed 16-bit, -32768 to +32767)
-    xid_report.stick_lx = convert_axis_to_s16(profile_out->left_x);
-    xid_report.stick_ly = convert_axis_to_s16(profile_out->left_y);
-    xid_report.stick_rx = convert_axis_to_s16(profile_out->right_x);
-    xid_report.stick_ry = convert_axis_to_s16(profile_out->right_y);
+    report->stick_lx = convert_axis_to_s16(profile_out->left_x);
+    report->stick_ly = convert_axis_to_s16(profile_out->left_y);
+    report->stick_rx = convert_axis_to_s16(profile_out->right_x);
+    report->stick_ry = convert_axis_to_s16(profile_out->right_y);
+}
+
+static bool xid_mode_send_report(uint8_t player_index,
+                                  const input_event_t* event,
+                                  const profile_output_t* profile_out,
+                                  uint32_t buttons)
+{
+    (void)player_index;
 
+    xid_mode_encode(&xid_report, event, profile_out, buttons);
     return tud_xid_send_report(&xid_report);
 }
 
+// Encode into buf without sending (loopback latency probe)
+static uint16_t xid_mode_encode_report(uint8_t player_index,
+                                       const input_event_t* event,
+                                       const profile_output_t* profile_out,
+                                       uint32_t buttons,
+                                       uint8_t* buf, uint16_t bufsize)
+{
+    (void)player_index;
+
+    xbox_og_in_report_t report = xid_report;
+    xid_mode_encode(&report, event, profile_out, buttons);
+    if (bufsize < sizeof(report)) return 0;
+    memcpy(buf, &report, sizeof(report));
+    return sizeof(report);
+}
+
 static void xid_mode_task(void)
 {
     // Check for rumble updates
@@ -156,6 +180,7 @@ const usbd_mode_t xid_mode = {
 
     .init = xid_mode_init,
     .send_report = xid_mode_send_report,
+    .encode_report = xid_mode_encode_report,
     .is_ready = xid_mode_is_ready,
 
     // Feedback support
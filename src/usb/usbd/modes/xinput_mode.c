@@ -60,51 +60,75 @@ static bool xinput_mode_is_ready(void)
     return tud_xinput_ready();
 }
 
-static bool xinput_mode_send_report(uint8_t player_index,
-                                     const input_event_t* event,
-                                     const profile_output_t* profile_out,
-                                     uint32_t buttons)
+static void xinput_mode_encode(xinput_in_report_t* report,
+                               const input_event_t* event,
+                               const profile_output_t* profile_out,
+                               uint32_t buttons)
 {
-    (void)player_index;
     (void)event;
 
     // Digital buttons byte 0 (DPAD, Start, Back, L3, R3)
-    xinput_report.buttons0 = 0;
-    if (buttons & JP_BUTTON_DU) xinput_report.buttons0 |= XINPUT_BTN_DPAD_UP;
-    if (buttons & JP_BUTTON_DD) xinput_report.buttons0 |= XINPUT_BTN_DPAD_DOWN;
-    if (buttons & JP_BUTTON_DL) xinput_report.buttons0 |= XINPUT_BTN_DPAD_LEFT;
-    if (buttons & JP_BUTTON_DR) xinput_report.buttons0 |= XINPUT_BTN_DPAD_RIGHT;
-    if (buttons & JP_BUTTON_S2) xinput_report.buttons0 |= XINPUT_BTN_START;
-    if (buttons & JP_BUTTON_S1) xinput_report.buttons0 |= XINPUT_BTN_BACK;
-    if (buttons & JP_BUTTON_L3) xinput_report.buttons0 |= XINPUT_BTN_L3;
-    if (buttons & JP_BUTTON_R3) xinput_report.buttons0 |= XINPUT_BTN_R3;
+    report->buttons0 = 0;
+    if (buttons & JP_BUTTON_DU) report->buttons0 |= XINPUT_BTN_DPAD_UP;
+    if (buttons & JP_BUTTON_DD) report->buttons0 |= XINPUT_BTN_DPAD_DOWN;
+    if (buttons & JP_BUTTON_DL) report->buttons0 |= XINPUT_BTN_DPAD_LEFT;
+    if (buttons & JP_BUTTON_DR) report->buttons0 |= XINPUT_BTN_DPAD_RIGHT;
+    if (buttons & JP_BUTTON_S2) report->buttons0 |= XINPUT_BTN_START;
+    if (buttons & JP_BUTTON_S1) report->buttons0 |= XINPUT_BTN_BACK;
+    if (buttons & JP_BUTTON_L3) report->buttons0 |= XINPUT_BTN_L3;
+    if (buttons & JP_BUTTON_R3) report->buttons0 |= XINPUT_BTN_R3;
 
     // Digital buttons byte 1 (LB, RB, Guide, A, B, X, Y)
-    xinput_report.buttons1 = 0;
-    if (buttons & JP_BUTTON_L1) xinput_report.buttons1 |= XINPUT_BTN_LB;
-    if (buttons & JP_BUTTON_R1) xinput_report.buttons1 |= XINPUT_BTN_RB;
-    if (buttons & JP_BUTTON_A1) xinput_report.buttons1 |= XINPUT_BTN_GUIDE;
-    if (buttons & JP_BUTTON_B1) xinput_report.buttons1 |= XINPUT_BTN_A;
-    if (buttons & JP_BUTTON_B2) xinput_report.buttons1 |= XINPUT_BTN_B;
-    if (buttons & JP_BUTTON_B3) xinput_report.buttons1 |= XINPUT_BTN_X;
-    if (buttons & JP_BUTTON_B4) xinput_report.buttons1 |= XINPUT_BTN_Y;
+    report->buttons1 = 0;
+    if (buttons & JP_BUTTON_L1) report->buttons1 |= XINPUT_BTN_LB;
+    if (buttons & JP_BUTTON_R1) report->buttons1 |= XINPUT_BTN_RB;
+    if (buttons & JP_BUTTON_A1) report->buttons1 |= XINPUT_BTN_GUIDE;
+    if (buttons & JP_BUTTON_B1) report->buttons1 |= XINPUT_BTN_A;
+    if (buttons & JP_BUTTON_B2) report->buttons1 |= XINPUT_BTN_B;
+    if (buttons & JP_BUTTON_B3) report->buttons1 |= XINPUT_BTN_X;
+    if (buttons & JP_BUTTON_B4) report->buttons1 |= XINPUT_BTN_Y;
 
     // Analog triggers (0-255)
-    xinput_report.trigger_l = profile_out->l2_analog;
-    xinput_report.trigger_r = profile_out->r2_analog;
-    if (xinput_report.trigger_l == 0 && (buttons & JP_BUTTON_L2)) xinput_report.trigger_l = 0xFF;
-    if (xinput_report.trigger_r == 0 && (buttons & JP_BUTTON_R2)) xinput_report.trigger_r = 0xFF;
+    report->trigger_l = profile_out->l2_analog;
+    report->trigger_r = profile_out->r2_analog;
+    if (report->trigger_l == 0 && (buttons & JP_BUTTON_L2)) report->trigger_l = 0xFF;
+    if (report->trigger_r == 0 && (buttons & JP_BUTTON_R2)) report->trigger_r = 0xFF;
 
     // Analog sticks (signed 16-bit, -32768 to +32767)
     // Y-axis inverted: input 0=down, XInput convention positive=up
-    xinput_report.stick_lx = convert_axis_to_s16(profile_out->left_x);
-    xinput_report.stick_ly = convert_axis_to_s16_inverted(profile_out->left_y);
-    xinput_report.stick_rx = convert_axis_to_s16(profile_out->right_x);
-    xinput_report.stick_ry = convert_axis_to_s16_inverted(profile_out->right_y);
+    report->stick_lx = convert_axis_to_s16(profile_out->left_x);
+    report->stick_ly = convert_axis_to_s16_inverted(profile_out->left_y);
+    report->stick_rx = convert_axis_to_s16(profile_out->right_x);
+    report->stick_ry = convert_axis_to_s16_inverted(profile_out->right_y);
+}
+
+static bool xinput_mode_send_report(uint8_t player_index,
+                                     const input_event_t* event,
+                                     const profile_output_t* profile_out,
+                                     uint32_t buttons)
+{
+    (void)player_index;
 
+    xinput_mode_encode(&xinput_report, event, profile_out, buttons);
     return tud_xinput_send_report(&xinput_report);
 }
 
+// Encode into buf without sending (loopback latency probe)
+static uint16_t xinput_mode_encode_report(uint8_t player_index,
+                                          const input_event_t* event,
+                                          const profile_output_t* profile_out,
+                                          uint32_t buttons,
+                                          uint8_t* buf, uint16_t bufsize)
+{
+    (void)player_index;
+
+    xinput_in_report_t report = xinput_report;
+    xinput_mode_encode(&report, event, profile_out, buttons);
+    if (bufsize < sizeof(report)) return 0;
+    memcpy(buf, &report, sizeof(report));
+    return sizeof(report);
+}
+
 static void xinput_mode_task(void)
 {
     // Check for rumble output from host
@@ -160,6 +184,7 @@ const usbd_mode_t xinput_mode = {
 
     .init = xinput_mode_init,
     .send_report = xinput_mode_send_report,
+    .encode_report = xinput_mode_encode_report,
     .is_ready = xinput_mode_is_ready,
 
     .handle_output = NULL,  // Output handled via tud_xinput_get_output
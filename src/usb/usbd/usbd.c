@@ -63,6 +63,10 @@ void usbd_register_modes(void) {
 // Pour gagner de la place ici, garde tes fonctions usbd_init, usbd_task, etc.
 // Mais assure-toi que usbd_init appelle bien usbd_register_modes() !
 
+const usbd_mode_t* usbd_get_current_mode(void) {
+    return current_mode;
+}
+
 void usbd_init(void) {
     usbd_register_modes();
     flash_init();
@@ -34,6 +34,15 @@ typedef struct {
                         const profile_output_t* profile_out,
                         uint32_t buttons);
 
+    // Encode the report send_report would send into buf, without sending
+    // it or changing mode state (optional - NULL if not supported).
+    // Returns the report length, 0 if buf is too small.
+    uint16_t (*encode_report)(uint8_t player_index,
+                              const input_event_t* event,
+                              const profile_output_t* profile_out,
+                              uint32_t buttons,
+                              uint8_t* buf, uint16_t bufsize);
+
     // Ready check - returns true if USB is ready to send
     bool (*is_ready)(void);
 
@@ -0,0 +1,152 @@
+// hid_extract.c
+// Compiled report extraction for generic HID gamepads
+
+#include "hid_extract.h"
+#include <string.h>
+
+// Usage IDs (HID Usage Tables 1.12), spelled out so this file builds
+// without TinyUSB for the host benchmark (tools/hid_extract_bench.c)
+#define PAGE_DESKTOP   0x01
+#define PAGE_BUTTON    0x09
+#define USAGE_X        0x30
+#define USAGE_RZ       0x35
+#define USAGE_HAT      0x39
+
+static hid_extract_op_t* add_op(hid_extract_program_t* prog, uint16_t bit, uint8_t bits,
+                                uint8_t dest, uint8_t arg)
+{
+  uint8_t shift = bit % 8;
+  uint8_t nbytes = (shift + bits + 7) / 8;
+
+  // One 32-bit load per op
+  if (bits == 0 || nbytes > 4) return NULL;
+  if (prog->op_count >= HID_EXTRACT_MAX_OPS) return NULL;
+
+  hid_extract_op_t* op = &prog->ops[prog->op_count++];
+  op->byte = bit / 8;
+  op->nbytes = nbytes;
+  op->shift = shift;
+  op->dest = dest;
+  op->arg = arg;
+  op->mask = (bits >= 32) ? 0xFFFFFFFF : ((1u << bits) - 1);
+
+  if (op->byte + nbytes > prog->min_len) {
+    prog->min_len = op->byte + nbytes;
+  }
+  return op;
+}
+
+// Try to append a 1-bit button to the previous op's run
+static bool extend_button_run(hid_extract_program_t* prog, uint16_t bit, uint8_t index)
+{
+  if (prog->op_count == 0) return false;
+
+  hid_extract_op_t* op = &prog->ops[prog->op_count - 1];
+  if (op->dest != HID_EXTRACT_BUTTONS) return false;
+
+  uint8_t run = __builtin_popcount(op->mask);
+  uint16_t next_bit = op->byte * 8 + op->shift + run;
+  if (bit != next_bit || index != op->arg + run) return false;
+  if (op->shift + run + 1 > 32) return false;
+
+  op->nbytes = (op->shift + run + 1 + 7) / 8;
+  op->mask = (op->mask << 1) | 1;
+  if (op->byte + op->nbytes > prog->min_len) {
+    prog->min_len = op->byte + op->nbytes;
+  }
+  return true;
+}
+
+void hid_extract_compile(const HID_ReportInfo_t* info, hid_extract_program_t* prog)
+{
+  memset(prog, 0, sizeof(*prog));
+  if (!info || !info->FirstReportItem) return;
+
+  const HID_ReportItem_t* item = info->FirstReportItem;
+  prog->report_id = item->ReportID;
+  uint16_t id_bits = prog->report_id ? 8 : 0;
+
+  for (; item; item = item->Next) {
+    if (item->ReportID != prog->report_id) continue;
+
+    uint16_t bit = item->BitOffset + id_bits;
+    uint8_t bits = item->Attributes.BitSize;
+    uint16_t page = item->Attributes.Usage.Page;
+    uint16_t usage = item->Attributes.Usage.Usage;
+
+    if (page == PAGE_BUTTON) {
+      prog->button_count++;
+      if (usage < 1 || usage > HID_EXTRACT_MAX_BUTTONS) continue;
+
+      // Only the first bit of a multi-bit button is read
+      uint8_t index = usage - 1;
+      if (!extend_button_run(prog, bit, index)) {
+        add_op(prog, bit, 1, HID_EXTRACT_BUTTONS, index);
+      }
+    } else if (page == PAGE_DESKTOP) {
+      if (usage >= USAGE_X && usage <= USAGE_RZ) {
+        // X, Y, Z, Rx, Ry, Rz usage order -> X, Y, Z, Rz, Rx, Ry slots
+        static const uint8_t slot[] = {
+          HID_EXTRACT_X, HID_EXTRACT_Y, HID_EXTRACT_Z,
+          HID_EXTRACT_RX, HID_EXTRACT_RY, HID_EXTRACT_RZ,
+        };
+        uint8_t dest = slot[usage - USAGE_X];
+        if (add_op(prog, bit, bits, dest, 0)) {
+          prog->axis_max[dest] = item->Attributes.Logical.Maximum;
+        }
+      } else if (usage == USAGE_HAT) {
+        add_op(prog, bit, bits, HID_EXTRACT_HAT, 0);
+      }
+    }
+  }
+}
+
+bool hid_extract_run(const hid_extract_program_t* prog,
+                     const uint8_t* report, uint16_t len,
+                     hid_extract_values_t* out)
+{
+  if (len < prog->min_len) return false;
+  if (prog->report_id && report[0] != prog->report_id) return false;
+
+  memset(out->axis, 0, sizeof(out->axis));
+  out->hat = HID_EXTRACT_HAT_RELEASED;
+  out->buttons = 0;
+
+  for (uint8_t i = 0; i < prog->op_count; i++) {
+    const hid_extract_op_t* op = &prog->ops[i];
+    const uint8_t* p = &report[op->byte];
+
+    uint32_t word = p[0];
+    if (op->nbytes > 1) word |= (uint32_t)p[1] << 8;
+    if (op->nbytes > 2) word |= (uint32_t)p[2] << 16;
+    if (op->nbytes > 3) word |= (uint32_t)p[3] << 24;
+    uint32_t value = (word >> op->shift) & op->mask;
+
+    if (op->dest < HID_EXTRACT_AXIS_COUNT) {
+      out->axis[op->dest] = value;
+    } else if (op->dest == HID_EXTRACT_HAT) {
+      out->hat = value;
+    } else {
+      out->buttons |= value << op->arg;
+    }
+  }
+  return true;
+}
+
+uint16_t hid_extract_report_mask(const hid_extract_program_t* prog,
+                                 uint8_t* mask, uint16_t max_len)
+{
+  if (prog->op_count == 0 || prog->min_len > max_len) return 0;
+
+  memset(mask, 0, prog->min_len);
+  if (prog->report_id) mask[0] = 0xFF;
+
+  for (uint8_t i = 0; i < prog->op_count; i++) {
+    const hid_extract_op_t* op = &prog->ops[i];
+    uint32_t bits = op->mask << op->shift;
+    for (uint8_t b = 0; b < op->nbytes; b++) {
+      mask[op->byte + b] |= (bits >> (b * 8)) & 0xFF;
+    }
+  }
+  return prog->min_len;
+}
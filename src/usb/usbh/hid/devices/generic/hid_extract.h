@@ -0,0 +1,74 @@
+// hid_extract.h
+// Compiled report extraction for generic HID gamepads
+//
+// At mount the parsed descriptor is compiled into a short list of ops, one
+// per axis/hat plus one per run of contiguous buttons. Each op is a single
+// little-endian load, shift and mask, so processing a report no longer
+// walks the parser's item list or tests buttons one bit at a time.
+//
+// Only items belonging to the first input report ID are compiled; reports
+// carrying a different ID (or too short to cover every op) are rejected.
+
+#ifndef HID_EXTRACT_H
+#define HID_EXTRACT_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "hid_parser.h"
+
+#define HID_EXTRACT_MAX_OPS      16
+#define HID_EXTRACT_MAX_BUTTONS  16     // Button usages 1..16
+#define HID_EXTRACT_HAT_RELEASED 8
+
+// Op destinations
+typedef enum {
+  HID_EXTRACT_X = 0,
+  HID_EXTRACT_Y,
+  HID_EXTRACT_Z,
+  HID_EXTRACT_RZ,
+  HID_EXTRACT_RX,
+  HID_EXTRACT_RY,
+  HID_EXTRACT_AXIS_COUNT,
+  HID_EXTRACT_HAT = HID_EXTRACT_AXIS_COUNT,
+  HID_EXTRACT_BUTTONS,
+} hid_extract_dest_t;
+
+typedef struct {
+  uint8_t byte;       // First report byte
+  uint8_t nbytes;     // Bytes loaded (1-4)
+  uint8_t shift;      // Bit offset within the loaded word
+  uint8_t dest;       // hid_extract_dest_t
+  uint8_t arg;        // BUTTONS: bit index of the first button in the run
+  uint32_t mask;      // Applied after the shift
+} hid_extract_op_t;
+
+typedef struct {
+  hid_extract_op_t ops[HID_EXTRACT_MAX_OPS];
+  uint8_t op_count;
+  uint8_t report_id;      // 0 = device doesn't use report IDs
+  uint16_t min_len;       // Shortest report covering every op
+  uint8_t button_count;   // Button page items in the compiled report
+  uint32_t axis_max[HID_EXTRACT_AXIS_COUNT];  // Logical max, 0 = axis absent
+} hid_extract_program_t;
+
+typedef struct {
+  uint32_t axis[HID_EXTRACT_AXIS_COUNT];
+  uint8_t hat;            // HID_EXTRACT_HAT_RELEASED if absent
+  uint16_t buttons;       // Bit n = button usage n+1
+} hid_extract_values_t;
+
+// Build the program from a parsed descriptor
+void hid_extract_compile(const HID_ReportInfo_t* info, hid_extract_program_t* prog);
+
+// Run the program over one input report. Returns false if the report
+// doesn't belong to the compiled report ID or is too short.
+bool hid_extract_run(const hid_extract_program_t* prog,
+                     const uint8_t* report, uint16_t len,
+                     hid_extract_values_t* out);
+
+// Build a per-byte AND mask covering every bit the program reads (and the
+// report ID). Returns the mask length, or 0 if it doesn't fit in max_len.
+uint16_t hid_extract_report_mask(const hid_extract_program_t* prog,
+                                 uint8_t* mask, uint16_t max_len);
+
+#endif // HID_EXTRACT_H
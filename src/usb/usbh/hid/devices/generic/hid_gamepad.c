@@ -1,40 +1,24 @@
 // hid_gamepad.c
 #include "hid_gamepad.h"
 #include "hid_parser.h"
+#include "hid_extract.h"
+#include "hid_parse_cache.h"
 #include "core/buttons.h"
 #include "core/router/router.h"
-#include "core/router/router.h"
 #include "core/input_event.h"
+#include <string.h>
 
+// Generic HID instance state (slot context, see hid_slot_ctx())
 typedef struct
 {
-  uint8_t byteIndex;
-  uint16_t bitMask;
-  uint32_t max;
-} dinput_usage_t;
-
-// Generic HID instance state
-typedef struct TU_ATTR_PACKED
-{
-  dinput_usage_t xLoc;
-  dinput_usage_t yLoc;
-  dinput_usage_t zLoc;
-  dinput_usage_t rzLoc;
-  dinput_usage_t rxLoc;
-  dinput_usage_t ryLoc;
-  dinput_usage_t hatLoc;
-  dinput_usage_t buttonLoc[MAX_BUTTONS]; // assuming a maximum of 12 buttons
+  hid_extract_program_t prog;   // compiled on mount
+  dinput_gamepad_t previous;
   uint8_t buttonCnt;
   uint8_t type;
 } dinput_instance_t;
 
-// Cached device report properties on mount
-typedef struct TU_ATTR_PACKED
-{
-  dinput_instance_t instances[CFG_TUH_HID];
-} dinput_device_t;
-
-static dinput_device_t hid_devices[MAX_DEVICES] = { 0 };
+// Classification result while mounting, copied to the slot only for gamepads
+static dinput_instance_t mount_scratch;
 
 // hid_parser info
 HID_ReportInfo_t *info;
@@ -42,216 +26,115 @@ HID_ReportInfo_t *info;
 //(hat format, 8 is released, 0=N, 1=NE, 2=E, 3=SE, 4=S, 5=SW, 6=W, 7=NW)
 static const uint8_t HAT_SWITCH_TO_DIRECTION_BUTTONS[] = {0b0001, 0b0011, 0b0010, 0b0110, 0b0100, 0b1100, 0b1000, 0b1001, 0b0000};
 
-// Gets HID descriptor report item for specific ReportID
-static inline bool USB_GetHIDReportItemInfoWithReportId(const uint8_t *ReportData, HID_ReportItem_t *const ReportItem)
+// Classifies the parsed descriptor and compiles its extraction program
+static void parse_descriptor(uint8_t dev_addr, uint8_t instance, dinput_instance_t* inst)
 {
-  if (HID_DEBUG) TU_LOG1("ReportID: %d ", ReportItem->ReportID);
-  if (ReportItem->ReportID)
-  {
-    // if (ReportItem->ReportID != ReportData[0])
-    //   return false;
+  HID_ReportItem_t *item = info->FirstReportItem;
 
-    ReportData++;
+  if (info->DroppedReportItems)
+  {
+    TU_LOG1("DINPUT[%d|%d]: parser arena full, %d report items dropped\r\n",
+            dev_addr, instance, info->DroppedReportItems);
   }
-  return USB_GetHIDReportItemInfo(ReportItem->ReportID, ReportData, ReportItem);
-}
-
-// Parses HID descriptor into byteIndex/buttonMasks
-void parse_descriptor(uint8_t dev_addr, uint8_t instance)
-{
-  HID_ReportItem_t *item = info->FirstReportItem;
-  //iterate filtered reports info to match report from data
-  uint8_t btns_count = 0;
-  uint8_t idOffset = 0;
 
   // check if reportID exists within input report
   if (item->ReportID)
   {
     TU_LOG1("ReportID in report = %04x\r\n", item->ReportID);
-    idOffset = 8;
   }
 
+  inst->type = HID_GAMEPAD;
   while (item)
   {
-    uint8_t midValue = (item->Attributes.Logical.Maximum - item->Attributes.Logical.Minimum) / 2;
-    uint8_t bitSize = item->Attributes.BitSize ? item->Attributes.BitSize : 0; // bits per usage
-    uint8_t bitOffset = (item->BitOffset ? item->BitOffset : 0) + idOffset; // bits offset from start
-    uint16_t bitMask = ((0xFFFF >> (16 - bitSize)) << bitOffset % 8); // usage bits byte mask
-    uint8_t byteIndex = (int)(bitOffset / 8); // usage start byte
-
     if (HID_DEBUG) {
+      TU_LOG1("PAGE: 0x%x USAGE: 0x%x ", item->Attributes.Usage.Page, item->Attributes.Usage.Usage);
       TU_LOG1("minimum: %d ", item->Attributes.Logical.Minimum);
-      TU_LOG1("mid: %d ", midValue);
       TU_LOG1("maximum: %d ", item->Attributes.Logical.Maximum);
-      TU_LOG1("bitSize: %d ", bitSize);
-      TU_LOG1("bitOffset: %d ", bitOffset);
-      TU_LOG1("bitMask: 0x%x ", bitMask);
-      TU_LOG1("byteIndex: %d ", byteIndex);
+      TU_LOG1("bitSize: %d ", item->Attributes.BitSize);
+      TU_LOG1("bitOffset: %d\n", item->BitOffset);
     }
-    // TODO: this is limiting to repordId 0..
-    // Need to parse reportId and match later with received reports.
-    // Also helpful if multiple reportId maps can be saved per instance and report as individual
-    // players for single instance HID reports that contain multiple reportIds.
-    //
-    uint8_t report[1] = {0}; // reportId = 0; original ex maps report to descriptor data structure
-    if (USB_GetHIDReportItemInfoWithReportId(report, item))
-    {
-      if (HID_DEBUG) TU_LOG1("PAGE: %d ", item->Attributes.Usage.Page);
-      hid_devices[dev_addr].instances[instance].type = HID_GAMEPAD;
 
-      switch (item->Attributes.Usage.Page)
+    if (item->Attributes.Usage.Page == HID_USAGE_PAGE_DESKTOP)
+    {
+      switch (item->Attributes.Usage.Usage)
       {
-        case HID_USAGE_PAGE_DESKTOP:
-        {
-          switch (item->Attributes.Usage.Usage)
-          {
-          case HID_USAGE_DESKTOP_WHEEL:
-          {
-            if (HID_DEBUG) TU_LOG1(" HID_USAGE_DESKTOP_WHEEL ");
-            hid_devices[dev_addr].instances[instance].type = HID_MOUSE;
-            break;
-          }
-          case HID_USAGE_DESKTOP_MOUSE:
-          {
-            if (HID_DEBUG) TU_LOG1(" HID_USAGE_DESKTOP_MOUSE ");
-            hid_devices[dev_addr].instances[instance].type = HID_MOUSE;
-            break;
-          }
-          case HID_USAGE_DESKTOP_KEYBOARD:
-          {
-            if (HID_DEBUG) TU_LOG1(" HID_USAGE_DESKTOP_KEYBOARD ");
-            hid_devices[dev_addr].instances[instance].type = HID_KEYBOARD;
-            break;
-          }
-          case HID_USAGE_DESKTOP_X: // Left Analog X
-          {
-            if (HID_DEBUG) TU_LOG1(" HID_USAGE_DESKTOP_X ");
-            hid_devices[dev_addr].instances[instance].xLoc.byteIndex = byteIndex;
-            hid_devices[dev_addr].instances[instance].xLoc.bitMask = bitMask;
-            hid_devices[dev_addr].instances[instance].xLoc.max = item->Attributes.Logical.Maximum;
-            break;
-          }
-          case HID_USAGE_DESKTOP_Y: // Left Analog Y
-          {
-            if (HID_DEBUG) TU_LOG1(" HID_USAGE_DESKTOP_Y ");
-            hid_devices[dev_addr].instances[instance].yLoc.byteIndex = byteIndex;
-            hid_devices[dev_addr].instances[instance].yLoc.bitMask = bitMask;
-            hid_devices[dev_addr].instances[instance].yLoc.max = item->Attributes.Logical.Maximum;
-            break;
-          }
-          case HID_USAGE_DESKTOP_Z: // Right Analog X
-          {
-            if (HID_DEBUG) TU_LOG1(" HID_USAGE_DESKTOP_Z ");
-            hid_devices[dev_addr].instances[instance].zLoc.byteIndex = byteIndex;
-            hid_devices[dev_addr].instances[instance].zLoc.bitMask = bitMask;
-            hid_devices[dev_addr].instances[instance].zLoc.max = item->Attributes.Logical.Maximum;
-            break;
-          }
-          case HID_USAGE_DESKTOP_RZ: // Right Analog Y
-          {
-            if (HID_DEBUG) TU_LOG1(" HID_USAGE_DESKTOP_RZ ");
-            hid_devices[dev_addr].instances[instance].rzLoc.byteIndex = byteIndex;
-            hid_devices[dev_addr].instances[instance].rzLoc.bitMask = bitMask;
-            hid_devices[dev_addr].instances[instance].rzLoc.max = item->Attributes.Logical.Maximum;
-            break;
-          }
-          case HID_USAGE_DESKTOP_RX: // Left Analog Trigger
-          {
-            if (HID_DEBUG) TU_LOG1(" HID_USAGE_DESKTOP_RX ");
-            hid_devices[dev_addr].instances[instance].rxLoc.byteIndex = byteIndex;
-            hid_devices[dev_addr].instances[instance].rxLoc.bitMask = bitMask;
-            hid_devices[dev_addr].instances[instance].rxLoc.max = item->Attributes.Logical.Maximum;
-            break;
-          }
-          case HID_USAGE_DESKTOP_RY: // Right Analog Trigger
-          {
-            if (HID_DEBUG) TU_LOG1(" HID_USAGE_DESKTOP_RY ");
-            hid_devices[dev_addr].instances[instance].ryLoc.byteIndex = byteIndex;
-            hid_devices[dev_addr].instances[instance].ryLoc.bitMask = bitMask;
-            hid_devices[dev_addr].instances[instance].ryLoc.max = item->Attributes.Logical.Maximum;
-            break;
-          }
-          case HID_USAGE_DESKTOP_HAT_SWITCH:
-          {
-            if (HID_DEBUG) TU_LOG1(" HID_USAGE_DESKTOP_HAT_SWITCH ");
-            hid_devices[dev_addr].instances[instance].hatLoc.byteIndex = byteIndex;
-            hid_devices[dev_addr].instances[instance].hatLoc.bitMask = bitMask;
-            break;
-          }
-          default:
-            if (HID_DEBUG) TU_LOG1(" HID_USAGE_DESKTOP_NOT_HANDLED 0x%x", item->Attributes.Usage.Usage);
-            break;
-          // case HID_USAGE_DESKTOP_SLIDER:
-          // case HID_USAGE_DESKTOP_DIAL:
-          //   break;
-          // case HID_USAGE_DESKTOP_DPAD_UP:
-          //   current.up |= 1;
-          //   break;
-          // case HID_USAGE_DESKTOP_DPAD_RIGHT:
-          //   current.right |= 1;
-          //   break;
-          // case HID_USAGE_DESKTOP_DPAD_DOWN:
-          //   current.down |= 1;
-          //   break;
-          // case HID_USAGE_DESKTOP_DPAD_LEFT:
-          //   current.left |= 1;
-          //   break;
-          }
-          break;
-        }
-        case HID_USAGE_PAGE_BUTTON:
-        {
-          if (HID_DEBUG) TU_LOG1(" HID_USAGE_PAGE_BUTTON ");
-          uint8_t usage = item->Attributes.Usage.Usage;
-
-          if (usage >= 1 && usage <= MAX_BUTTONS) {
-            hid_devices[dev_addr].instances[instance].buttonLoc[usage - 1].byteIndex = byteIndex;
-            hid_devices[dev_addr].instances[instance].buttonLoc[usage - 1].bitMask = bitMask;
-          }
-          btns_count++;
+        case HID_USAGE_DESKTOP_WHEEL:
+        case HID_USAGE_DESKTOP_MOUSE:
+          inst->type = HID_MOUSE;
           break;
-        }
-        default:
-          if (HID_DEBUG) TU_LOG1(" HID_USAGE_PAGE_NOT_HANDLED 0x%x", item->Attributes.Usage.Page);
+        case HID_USAGE_DESKTOP_KEYBOARD:
+          inst->type = HID_KEYBOARD;
           break;
       }
     }
     item = item->Next;
-    if (HID_DEBUG) TU_LOG1("\n\n");
   }
 
-  hid_devices[dev_addr].instances[instance].buttonCnt = btns_count;
-  // hid_devices[dev_addr].instances[instance].reportID = item->ReportID;
-}
-
-//
-bool is_hid_gamepad(uint16_t vid, uint16_t pid)
-{
-  return false;
+  hid_extract_compile(info, &inst->prog);
+  inst->buttonCnt = inst->prog.button_count;
+
+  if (HID_DEBUG) {
+    TU_LOG1("DINPUT[%d|%d]: %d ops, min len %d\r\n", dev_addr, instance,
+            inst->prog.op_count, inst->prog.min_len);
+    for (uint8_t i = 0; i < inst->prog.op_count; i++) {
+      const hid_extract_op_t* op = &inst->prog.ops[i];
+      TU_LOG1("  op%d: byte %d x%d >>%d &0x%lx -> dest %d arg %d\r\n", i, op->byte,
+              op->nbytes, op->shift, (unsigned long)op->mask, op->dest, op->arg);
+      (void)op;
+    }
+  }
 }
 
-// hid_parser
+// hid_parser (skipped when the descriptor is already in the parse cache)
 bool parse_hid_gamepad(uint8_t dev_addr, uint8_t instance, uint8_t const* desc_report, uint16_t desc_len)
 {
-  uint8_t ret = USB_ProcessHIDReport(dev_addr, instance, desc_report, desc_len, &(info));
-  if(ret == HID_PARSE_Successful)
+  dinput_instance_t* inst = &mount_scratch;
+  memset(inst, 0, sizeof(*inst));
+  uint16_t vid = 0, pid = 0;
+  tuh_vid_pid_get(dev_addr, &vid, &pid);
+  uint32_t hash = hid_parse_cache_hash(desc_report, desc_len);
+
+  const hid_parse_cache_entry_t* cached = hid_parse_cache_lookup(vid, pid, hash, desc_len);
+  if (cached)
   {
-    parse_descriptor(dev_addr, instance);
+    TU_LOG1("DINPUT[%d|%d]: descriptor cache hit\r\n", dev_addr, instance);
+    inst->prog = cached->prog;
+    inst->type = cached->type;
+    inst->buttonCnt = cached->prog.button_count;
   }
   else
   {
-    TU_LOG1("Error: USB_ProcessHIDReport failed: %d\r\n", ret);
-  }
+    uint8_t ret = USB_ProcessHIDReport(dev_addr, instance, desc_report, desc_len, &(info));
+    if(ret == HID_PARSE_Successful)
+    {
+      parse_descriptor(dev_addr, instance, inst);
+
+      hid_parse_cache_entry_t entry = {
+        .vid = vid,
+        .pid = pid,
+        .hash = hash,
+        .desc_len = desc_len,
+        .type = inst->type,
+        .prog = inst->prog,
+      };
+      hid_parse_cache_store(&entry);
+    }
+    else
+    {
+      TU_LOG1("Error: USB_ProcessHIDReport failed: %d\r\n", ret);
+    }
 
-  // free up memory for next report to be parsed
-  USB_FreeReportInfo(info);
-  info = NULL;
+    // free up memory for next report to be parsed
+    USB_FreeReportInfo(info);
+    info = NULL;
+  }
 
   // assume it is d-input device if buttons exist on report
-  if (hid_devices[dev_addr].instances[instance].buttonCnt > 0 &&
-     hid_devices[dev_addr].instances[instance].type == HID_GAMEPAD
-  ) {
-    return true;  
+  if (inst->buttonCnt > 0 && inst->type == HID_GAMEPAD) {
+    dinput_instance_t* ctx = hid_slot_ctx(dev_addr, instance);
+    if (!ctx) return false;
+    *ctx = *inst;
+    return true;
   }
 
   return false;
@@ -320,142 +203,49 @@ uint8_t scale_analog_hid_gamepad(uint16_t value, uint32_t max_value)
   return scaled_value;
 }
 
-// process generic usb hid input reports (from parsed HID descriptor byteIndexes & bitMasks)
-void process_hid_gamepad(uint8_t dev_addr, uint8_t instance, uint8_t const* report, uint16_t len)
+// process generic usb hid input reports (from the compiled extraction program)
+void process_hid_gamepad(uint8_t dev_addr, uint8_t instance, uint8_t const* report, uint16_t len, void* ctx)
 {
+  dinput_instance_t* inst = ctx;
+  const hid_extract_program_t* prog = &inst->prog;
   uint32_t buttons = 0;
-  static dinput_gamepad_t previous[5][5];
   dinput_gamepad_t current = {0};
   current.value = 0;
 
-  uint16_t xValue, yValue, zValue, rzValue, rxValue, ryValue;
-
-  if (hid_devices[dev_addr].instances[instance].xLoc.bitMask > 0xFF) { // if bitmask is larger than 8 bits
-    // Combine the current byte and the next byte into a 16-bit value
-    uint16_t combinedBytes = ((uint16_t)report[hid_devices[dev_addr].instances[instance].xLoc.byteIndex] << 8) | report[hid_devices[dev_addr].instances[instance].xLoc.byteIndex + 1];
-    // Apply the bitmask to the combined 16-bit value
-    xValue = (combinedBytes & hid_devices[dev_addr].instances[instance].xLoc.bitMask) >> (__builtin_ctz(hid_devices[dev_addr].instances[instance].xLoc.bitMask));
-  } else if (hid_devices[dev_addr].instances[instance].xLoc.bitMask) {
-    // Apply the bitmask to the single byte value (your existing implementation)
-    xValue = report[hid_devices[dev_addr].instances[instance].xLoc.byteIndex] & hid_devices[dev_addr].instances[instance].xLoc.bitMask;
-  }
-
-  if (hid_devices[dev_addr].instances[instance].yLoc.bitMask > 0xFF) { // if bitmask is larger than 8 bits
-    // Combine the current byte and the next byte into a 16-bit value
-    uint16_t combinedBytes = ((uint16_t)report[hid_devices[dev_addr].instances[instance].yLoc.byteIndex] << 8) | report[hid_devices[dev_addr].instances[instance].yLoc.byteIndex + 1];
-    // Apply the bitmask to the combined 16-bit value
-    yValue = (combinedBytes & hid_devices[dev_addr].instances[instance].yLoc.bitMask) >> (__builtin_ctz(hid_devices[dev_addr].instances[instance].yLoc.bitMask));
-  } else if (hid_devices[dev_addr].instances[instance].yLoc.bitMask) {
-    // Apply the bitmask to the single byte value (your existing implementation)
-    yValue = report[hid_devices[dev_addr].instances[instance].yLoc.byteIndex] & hid_devices[dev_addr].instances[instance].yLoc.bitMask;
-  }
-
-  if (hid_devices[dev_addr].instances[instance].zLoc.bitMask > 0xFF) { // if bitmask is larger than 8 bits
-    // Combine the current byte and the next byte into a 16-bit value
-    uint16_t combinedBytes = ((uint16_t)report[hid_devices[dev_addr].instances[instance].zLoc.byteIndex] << 8) | report[hid_devices[dev_addr].instances[instance].zLoc.byteIndex + 1];
-    // Apply the bitmask to the combined 16-bit value
-    zValue = (combinedBytes & hid_devices[dev_addr].instances[instance].zLoc.bitMask) >> (__builtin_ctz(hid_devices[dev_addr].instances[instance].zLoc.bitMask));
-  } else if (hid_devices[dev_addr].instances[instance].zLoc.bitMask) {
-    // Apply the bitmask to the single byte value (your existing implementation)
-    zValue = report[hid_devices[dev_addr].instances[instance].zLoc.byteIndex] & hid_devices[dev_addr].instances[instance].zLoc.bitMask;
-  }
-
-  if (hid_devices[dev_addr].instances[instance].rzLoc.bitMask > 0xFF) { // if bitmask is larger than 8 bits
-    // Combine the current byte and the next byte into a 16-bit value
-    uint16_t combinedBytes = ((uint16_t)report[hid_devices[dev_addr].instances[instance].rzLoc.byteIndex] << 8) | report[hid_devices[dev_addr].instances[instance].rzLoc.byteIndex + 1];
-    // Apply the bitmask to the combined 16-bit value
-    rzValue = (combinedBytes & hid_devices[dev_addr].instances[instance].rzLoc.bitMask) >> (__builtin_ctz(hid_devices[dev_addr].instances[instance].rzLoc.bitMask));
-  } else if (hid_devices[dev_addr].instances[instance].rzLoc.bitMask) {
-    // Apply the bitmask to the single byte value (your existing implementation)
-    rzValue = report[hid_devices[dev_addr].instances[instance].rzLoc.byteIndex] & hid_devices[dev_addr].instances[instance].rzLoc.bitMask;
-  }
-
-  if (hid_devices[dev_addr].instances[instance].rxLoc.bitMask > 0xFF) { // if bitmask is larger than 8 bits
-    // Combine the current byte and the next byte into a 16-bit value
-    uint16_t combinedBytes = ((uint16_t)report[hid_devices[dev_addr].instances[instance].rxLoc.byteIndex] << 8) | report[hid_devices[dev_addr].instances[instance].rxLoc.byteIndex + 1];
-    // Apply the bitmask to the combined 16-bit value
-    rxValue = (combinedBytes & hid_devices[dev_addr].instances[instance].rxLoc.bitMask) >> (__builtin_ctz(hid_devices[dev_addr].instances[instance].rxLoc.bitMask));
-  } else if (hid_devices[dev_addr].instances[instance].rxLoc.bitMask) {
-    // Apply the bitmask to the single byte value (your existing implementation)
-    rxValue = report[hid_devices[dev_addr].instances[instance].rxLoc.byteIndex] & hid_devices[dev_addr].instances[instance].rxLoc.bitMask;
-  }
-
-  if (hid_devices[dev_addr].instances[instance].ryLoc.bitMask > 0xFF) { // if bitmask is larger than 8 bits
-    // Combine the current byte and the next byte into a 16-bit value
-    uint16_t combinedBytes = ((uint16_t)report[hid_devices[dev_addr].instances[instance].ryLoc.byteIndex] << 8) | report[hid_devices[dev_addr].instances[instance].ryLoc.byteIndex + 1];
-    // Apply the bitmask to the combined 16-bit value
-    ryValue = (combinedBytes & hid_devices[dev_addr].instances[instance].ryLoc.bitMask) >> (__builtin_ctz(hid_devices[dev_addr].instances[instance].ryLoc.bitMask));
-  } else if (hid_devices[dev_addr].instances[instance].ryLoc.bitMask) {
-    // Apply the bitmask to the single byte value (your existing implementation)
-    ryValue = report[hid_devices[dev_addr].instances[instance].ryLoc.byteIndex] & hid_devices[dev_addr].instances[instance].ryLoc.bitMask;
-  }
-
-  uint8_t hatValue = report[hid_devices[dev_addr].instances[instance].hatLoc.byteIndex] & hid_devices[dev_addr].instances[instance].hatLoc.bitMask;
+  hid_extract_values_t values;
+  if (!hid_extract_run(prog, report, len, &values)) return;
 
   // parse hat from report
-  if (hid_devices[dev_addr].instances[instance].hatLoc.bitMask) {
-    uint8_t direction = hatValue <= 8 ? hatValue : 8; // fix for hats with pressed state greater than 8
-    current.all_direction |= HAT_SWITCH_TO_DIRECTION_BUTTONS[direction];
-  } else {
-    hatValue = 8;
-  }
+  uint8_t hatValue = values.hat <= 8 ? values.hat : 8; // fix for hats with pressed state greater than 8
+  current.all_direction = HAT_SWITCH_TO_DIRECTION_BUTTONS[hatValue];
 
   // parse buttons from report
-  current.all_buttons = 0;
-  for (int i = 0; i < 12; i++) {
-    if (report[hid_devices[dev_addr].instances[instance].buttonLoc[i].byteIndex] & hid_devices[dev_addr].instances[instance].buttonLoc[i].bitMask) {
-      current.all_buttons |= (0x01 << i);
-    }
-  }
-
-  // parse analog from report
-  if (hid_devices[dev_addr].instances[instance].xLoc.max) {
-    current.x = scale_analog_hid_gamepad(xValue, hid_devices[dev_addr].instances[instance].xLoc.max);
-  } else {
-    current.x = 128;
-  }
-  if (hid_devices[dev_addr].instances[instance].yLoc.max) {
-    current.y = scale_analog_hid_gamepad(yValue, hid_devices[dev_addr].instances[instance].yLoc.max);
-  } else {
-    current.y = 128;
-  }
-  if (hid_devices[dev_addr].instances[instance].zLoc.max) {
-    current.z = scale_analog_hid_gamepad(zValue, hid_devices[dev_addr].instances[instance].zLoc.max);
-  } else {
-    current.z = 128;
-  }
-  if (hid_devices[dev_addr].instances[instance].rzLoc.max) {
-    current.rz = scale_analog_hid_gamepad(rzValue, hid_devices[dev_addr].instances[instance].rzLoc.max);
-  } else {
-    current.rz = 128;
-  }
-  if (hid_devices[dev_addr].instances[instance].rxLoc.max) {
-    current.rx = scale_analog_hid_gamepad(rxValue, hid_devices[dev_addr].instances[instance].rxLoc.max);
-  } else {
-    current.rx = 0;
-  }
-  if (hid_devices[dev_addr].instances[instance].ryLoc.max) {
-    current.ry = scale_analog_hid_gamepad(ryValue, hid_devices[dev_addr].instances[instance].ryLoc.max);
-  } else {
-    current.ry = 0;
-  }
-
-  // TODO: based on diff report rather than current's datastructure in order to get subtle analog changes
-  if (previous[dev_addr-1][instance].value != current.value)
+  current.all_buttons = values.buttons & ((1 << MAX_BUTTONS) - 1);
+
+  // parse analog from report (centered sticks / released triggers when absent)
+  current.x = prog->axis_max[HID_EXTRACT_X] ? scale_analog_hid_gamepad(values.axis[HID_EXTRACT_X], prog->axis_max[HID_EXTRACT_X]) : 128;
+  current.y = prog->axis_max[HID_EXTRACT_Y] ? scale_analog_hid_gamepad(values.axis[HID_EXTRACT_Y], prog->axis_max[HID_EXTRACT_Y]) : 128;
+  current.z = prog->axis_max[HID_EXTRACT_Z] ? scale_analog_hid_gamepad(values.axis[HID_EXTRACT_Z], prog->axis_max[HID_EXTRACT_Z]) : 128;
+  current.rz = prog->axis_max[HID_EXTRACT_RZ] ? scale_analog_hid_gamepad(values.axis[HID_EXTRACT_RZ], prog->axis_max[HID_EXTRACT_RZ]) : 128;
+  current.rx = prog->axis_max[HID_EXTRACT_RX] ? scale_analog_hid_gamepad(values.axis[HID_EXTRACT_RX], prog->axis_max[HID_EXTRACT_RX]) : 0;
+  current.ry = prog->axis_max[HID_EXTRACT_RY] ? scale_analog_hid_gamepad(values.axis[HID_EXTRACT_RY], prog->axis_max[HID_EXTRACT_RY]) : 0;
+
+  // hid.c already skipped raw-identical reports; this drops changes lost in scaling
+  if (inst->previous.value != current.value)
   {
-    previous[dev_addr-1][instance] = current;
+    inst->previous = current;
 
     if (HID_DEBUG) {
       TU_LOG1("Super HID Report: ");
-      TU_LOG1("Button Count: %d\n", hid_devices[dev_addr].instances[instance].buttonCnt);
+      TU_LOG1("Button Count: %d\n", inst->buttonCnt);
       TU_LOG1(" x:%d, y:%d, z:%d, rz:%d dPad:%d \n", current.x, current.y, current.z, current.rz, hatValue);
       for (int i = 0; i < 12; i++) {
-        TU_LOG1(" B%d:%d", i + 1, (report[hid_devices[dev_addr].instances[instance].buttonLoc[i].byteIndex] & hid_devices[dev_addr].instances[instance].buttonLoc[i].bitMask) ? 1 : 0 );
+        TU_LOG1(" B%d:%d", i + 1, (current.all_buttons >> i) & 1);
       }
       TU_LOG1("\n");
     }
 
-    uint8_t buttonCount = hid_devices[dev_addr].instances[instance].buttonCnt;
+    uint8_t buttonCount = inst->buttonCnt;
     if (buttonCount > 12) buttonCount = 12;
     bool buttonSelect = current.all_buttons & (0x01 << (buttonCount-2));
     bool buttonStart = current.all_buttons & (0x01 << (buttonCount-1));
@@ -519,42 +309,28 @@ void process_hid_gamepad(uint8_t dev_addr, uint8_t instance, uint8_t const* repo
   }
 }
 
+// raw report bits read by the compiled program (hid.c dedups on them)
+uint16_t report_mask_hid_gamepad(uint8_t dev_addr, uint8_t instance, uint8_t* mask, uint16_t max_len)
+{
+  dinput_instance_t* inst = hid_slot_ctx(dev_addr, instance);
+  return inst ? hid_extract_report_mask(&inst->prog, mask, max_len) : 0;
+}
+
 // resets default values in case devices are hotswapped
 void unmount_hid_gamepad(uint8_t dev_addr, uint8_t instance)
 {
   TU_LOG1("DINPUT[%d|%d]: Unmount Reset\r\n", dev_addr, instance);
-  hid_devices[dev_addr].instances[instance].xLoc.byteIndex = 0;
-  hid_devices[dev_addr].instances[instance].xLoc.bitMask = 0;
-  hid_devices[dev_addr].instances[instance].xLoc.max = 0;
-  hid_devices[dev_addr].instances[instance].yLoc.byteIndex = 0;
-  hid_devices[dev_addr].instances[instance].yLoc.bitMask = 0;
-  hid_devices[dev_addr].instances[instance].yLoc.max = 0;
-  hid_devices[dev_addr].instances[instance].zLoc.byteIndex = 0;
-  hid_devices[dev_addr].instances[instance].zLoc.bitMask = 0;
-  hid_devices[dev_addr].instances[instance].zLoc.max = 0;
-  hid_devices[dev_addr].instances[instance].rzLoc.byteIndex = 0;
-  hid_devices[dev_addr].instances[instance].rzLoc.bitMask = 0;
-  hid_devices[dev_addr].instances[instance].rzLoc.max = 0;
-  hid_devices[dev_addr].instances[instance].rxLoc.byteIndex = 0;
-  hid_devices[dev_addr].instances[instance].rxLoc.bitMask = 0;
-  hid_devices[dev_addr].instances[instance].rxLoc.max = 0;
-  hid_devices[dev_addr].instances[instance].ryLoc.byteIndex = 0;
-  hid_devices[dev_addr].instances[instance].ryLoc.bitMask = 0;
-  hid_devices[dev_addr].instances[instance].ryLoc.max = 0;
-  hid_devices[dev_addr].instances[instance].hatLoc.byteIndex = 0;
-  hid_devices[dev_addr].instances[instance].hatLoc.bitMask = 0;
-  hid_devices[dev_addr].instances[instance].buttonCnt = 0;
-  for (int i = 0; i < MAX_BUTTONS; i++) {
-    hid_devices[dev_addr].instances[instance].buttonLoc[i].byteIndex = 0;
-    hid_devices[dev_addr].instances[instance].buttonLoc[i].bitMask = 0;
-  }
+  dinput_instance_t* inst = hid_slot_ctx(dev_addr, instance);
+  if (inst) memset(inst, 0, sizeof(dinput_instance_t));
 }
 
+HID_SLOT_CTX_CHECK(dinput_instance_t);
+
 DeviceInterface hid_gamepad_interface = {
   .name = "DirectInput",
-  .is_device = is_hid_gamepad,
   .check_descriptor = parse_hid_gamepad,
   .process = process_hid_gamepad,
   .unmount = unmount_hid_gamepad,
   .init = NULL,
+  .report_mask = report_mask_hid_gamepad,
 };
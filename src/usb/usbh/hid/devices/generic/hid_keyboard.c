@@ -4,28 +4,48 @@
 #include "core/router/router.h"
 #include "core/router/router.h"
 #include "core/input_event.h"
+#include "core/key_bitmap.h"
 #include "pico/time.h"
+#include <string.h>
 
 // Analog stick intensity values (canonical - console layer can scale if needed)
 #define KB_ANALOG_MID 64
 #define KB_ANALOG_MAX 128
 
-// DualSense instance state
-typedef struct TU_ATTR_PACKED
-{
-  bool init;
-  bool ready;
-  uint8_t leds;
-  uint8_t rumble;
-} hid_kb_instance_t;
+// Keyboard fields of an input report (report ID excluded). Bitmap fields
+// carry one bit per usage, array fields carry one keycode per byte.
+#define KB_MAX_FIELDS 4
+#define KB_HELD_MAX 16  // Held keys kept in press order for the stick/hat maps
+#define KB_ERROR_ROLLOVER 0x01  // Array keycode sent when too many keys are down
 
-// Cached device report properties on mount
-typedef struct TU_ATTR_PACKED
+typedef struct
 {
-  hid_kb_instance_t instances[CFG_TUH_HID];
-} hid_kb_device_t;
+  uint16_t bit;        // Offset of the field
+  uint16_t count;      // Bits (bitmap) or keycode bytes (array)
+  uint8_t usage_min;   // Usage of the first bitmap bit
+  bool bitmap;
+} kb_field_t;
+
+// Boot protocol: modifier bitmap, reserved byte, 6 keycodes
+static const kb_field_t boot_fields[] = {
+  { .bit = 0,  .count = 8, .usage_min = HID_KEY_CONTROL_LEFT, .bitmap = true },
+  { .bit = 16, .count = 6, .bitmap = false },
+};
 
-static hid_kb_device_t hid_kb_devices[MAX_DEVICES] = { 0 };
+// Per-interface context
+typedef struct
+{
+  key_bitmap_t keys;           // Keys held in the previous report
+  uint8_t held[KB_HELD_MAX];   // Held non-modifier keys, oldest first
+  uint8_t held_count;
+  uint8_t field_count;         // 0 = boot layout
+  uint8_t report_id;           // Report ID the fields belong to, 0 = none
+  kb_field_t fields[KB_MAX_FIELDS];
+  bool ready;                  // First report seen, LED init may go out
+  bool init;                   // LED init sent
+  uint8_t leds;                // Last LED state sent
+  uint8_t rumble;
+} kb_ctx_t;
 
 // Keyboard LED control
 static uint8_t kbd_leds = 0;
@@ -222,21 +242,178 @@ void calculate_coordinates(uint32_t stick_keys, int intensity, uint8_t *x_value,
   return;
 }
 
-// look up new key in previous keys
-static inline bool find_key_in_report(hid_keyboard_report_t const *report, uint8_t keycode)
+// Decode a report into a key bitmap. Returns false on a phantom (rollover)
+// report, which carries no key state.
+static bool decode_keys(const kb_field_t* fields, uint8_t field_count,
+                        uint8_t const* report, uint16_t len, key_bitmap_t* keys)
 {
-  for(uint8_t i=0; i<6; i++) {
-    if (report->keycode[i] == keycode)  return true;
+  memset(keys, 0, sizeof(*keys));
+
+  for (uint8_t i = 0; i < field_count; i++)
+  {
+    const kb_field_t* f = &fields[i];
+    if (f->bitmap)
+    {
+      // Byte-aligned bitmaps (the usual NKRO layout) go in a byte at a time
+      uint16_t b = 0;
+      if (f->bit % 8 == 0 && f->usage_min % 8 == 0)
+      {
+        for (; b + 8 <= f->count && f->bit / 8 + b / 8 < len; b += 8)
+        {
+          uint16_t usage = f->usage_min + b;
+          if (usage > 0xFF) break;
+          keys->w[usage >> 5] |= (uint32_t)report[f->bit / 8 + b / 8] << (usage & 31);
+        }
+      }
+      for (; b < f->count; b++)
+      {
+        uint16_t bit = f->bit + b;
+        uint16_t usage = f->usage_min + b;
+        if (bit / 8 >= len || usage > 0xFF) break;
+        if (report[bit / 8] & (1 << (bit % 8))) key_bitmap_set(keys, usage);
+      }
+    }
+    else
+    {
+      for (uint16_t k = 0; k < f->count && f->bit / 8 + k < len; k++)
+      {
+        uint8_t code = report[f->bit / 8 + k];
+        if (code == KB_ERROR_ROLLOVER) return false;
+        if (code >= HID_KEY_A) key_bitmap_set(keys, code);
+      }
+    }
+  }
+  return true;
+}
+
+// Keep held keys in press order: drop released ones, append new presses
+static void update_held(kb_ctx_t* kb, const key_bitmap_t* pressed, const key_bitmap_t* released)
+{
+  uint8_t n = 0;
+  for (uint8_t i = 0; i < kb->held_count; i++)
+  {
+    if (!key_bitmap_test(released, kb->held[i])) kb->held[n++] = kb->held[i];
+  }
+
+  for (int usage = key_bitmap_next(pressed, 0);
+       usage >= 0 && usage < HID_KEY_CONTROL_LEFT && n < KB_HELD_MAX;
+       usage = key_bitmap_next(pressed, usage + 1))
+  {
+    kb->held[n++] = usage;
+  }
+  kb->held_count = n;
+}
+
+// Report-protocol keyboards (NKRO) lay keys out as they like; pick the
+// keyboard-page input fields of the first report ID that has any. hid.c
+// calls this for interfaces mounted without the boot keyboard protocol.
+static bool check_descriptor_hid_keyboard(uint8_t dev_addr, uint8_t instance, uint8_t const* desc_report, uint16_t desc_len)
+{
+  kb_ctx_t* kb = hid_slot_ctx(dev_addr, instance);
+  if (!kb) return false;
+
+  // Running input bit offset per report ID
+  struct { uint8_t id; uint16_t bits; } offsets[8] = { { 0, 0 } };
+  uint8_t id_count = 1, cur = 0;
+  int16_t kb_id = -1;
+
+  uint16_t usage_page = 0;
+  uint8_t usage_min = 0;
+  uint32_t report_size = 0, report_count = 0;
+
+  kb->field_count = 0;
+  kb->report_id = 0;
+  uint8_t const* p = desc_report;
+  uint8_t const* end = desc_report + desc_len;
+
+  while (p < end)
+  {
+    uint8_t prefix = *p++;
+    if (prefix == 0xFE)  // Long item
+    {
+      if (p >= end) break;
+      p += 2 + *p;
+      continue;
+    }
+
+    uint8_t size = prefix & 0x03;
+    if (size == 3) size = 4;
+    if (p + size > end) break;
+
+    uint32_t data = 0;
+    for (uint8_t i = 0; i < size; i++) data |= (uint32_t)p[i] << (8 * i);
+    p += size;
+
+    switch (prefix & 0xFC)
+    {
+    case 0x04: usage_page = data; break;    // Usage Page
+    case 0x74: report_size = data; break;   // Report Size
+    case 0x94: report_count = data; break;  // Report Count
+    case 0x18: usage_min = data; break;     // Usage Minimum
+    case 0x84:                              // Report ID
+      for (cur = 0; cur < id_count && offsets[cur].id != data; cur++) {}
+      if (cur == id_count)
+      {
+        if (id_count == 8) return false;
+        offsets[id_count].id = data;
+        offsets[id_count++].bits = 0;
+      }
+      break;
+    case 0x80:                              // Input
+      if (usage_page == HID_USAGE_PAGE_KEYBOARD && !(data & 0x01))
+      {
+        if (kb_id < 0) kb_id = offsets[cur].id;
+        bool variable = data & 0x02;
+        if (offsets[cur].id == kb_id && kb->field_count < KB_MAX_FIELDS &&
+            ((variable && report_size == 1) || (!variable && report_size == 8)))
+        {
+          kb_field_t* f = &kb->fields[kb->field_count++];
+          f->bit = offsets[cur].bits;
+          f->count = report_count;
+          f->usage_min = variable ? usage_min : 0;
+          f->bitmap = variable;
+        }
+      }
+      offsets[cur].bits += report_size * report_count;
+      usage_min = 0;
+      break;
+    case 0x90: case 0xA0: case 0xB0: case 0xC0:  // Output, Collection, Feature, End
+      usage_min = 0;
+      break;
+    default:
+      break;
+    }
+  }
+
+  if (kb->field_count)
+  {
+    kb->report_id = kb_id;
+    printf("[kb] %d:%d report protocol, %d key fields\n", dev_addr, instance, kb->field_count);
   }
-  return false;
+  return kb->field_count > 0;
 }
 
 // process usb hid input reports
-void process_hid_keyboard(uint8_t dev_addr, uint8_t instance, uint8_t const* hid_kb_report, uint16_t len)
+void process_hid_keyboard(uint8_t dev_addr, uint8_t instance, uint8_t const* hid_kb_report, uint16_t len, void* ctx)
 {
   uint32_t buttons;
-  hid_keyboard_report_t const* report = (hid_keyboard_report_t const*)hid_kb_report;
-  static hid_keyboard_report_t prev_report = { 0, 0, {0} }; // previous report to check key released
+  kb_ctx_t* kb = ctx;
+
+  // The fields only describe kb_id's layout; composite keyboards also send
+  // consumer, system and vendor reports on the same interface
+  if (kb->field_count && hid_slot_report_id(dev_addr, instance) != kb->report_id) return;
+
+  const kb_field_t* fields = kb->field_count ? kb->fields : boot_fields;
+  uint8_t field_count = kb->field_count ? kb->field_count : TU_ARRAY_SIZE(boot_fields);
+
+  key_bitmap_t keys, pressed, released;
+  if (!decode_keys(fields, field_count, hid_kb_report, len, &keys)) return;
+  key_bitmap_diff(&keys, &kb->keys, &pressed, &released);
+  update_held(kb, &pressed, &released);
+  kb->keys = keys;
+
+  uint8_t const modifier = keys.w[HID_KEY_CONTROL_LEFT >> 5] >> (HID_KEY_CONTROL_LEFT & 31);
+  uint8_t const* held = kb->held;
 
   uint8_t analog_left_x = 128;
   uint8_t analog_left_y = 128;
@@ -256,15 +433,18 @@ void process_hid_keyboard(uint8_t dev_addr, uint8_t instance, uint8_t const* hid
   uint8_t leftIndex = 0;
   uint8_t rightIndex = 0;
 
-  bool const is_shift = report->modifier & (KEYBOARD_MODIFIER_LEFTSHIFT | KEYBOARD_MODIFIER_RIGHTSHIFT);
-  bool const is_ctrl = report->modifier & (KEYBOARD_MODIFIER_LEFTCTRL | KEYBOARD_MODIFIER_RIGHTCTRL);
-  bool const is_alt = report->modifier & (KEYBOARD_MODIFIER_LEFTALT | KEYBOARD_MODIFIER_RIGHTALT);
+  bool const is_shift = modifier & (KEYBOARD_MODIFIER_LEFTSHIFT | KEYBOARD_MODIFIER_RIGHTSHIFT);
+  bool const is_ctrl = modifier & (KEYBOARD_MODIFIER_LEFTCTRL | KEYBOARD_MODIFIER_RIGHTCTRL);
+  bool const is_alt = modifier & (KEYBOARD_MODIFIER_LEFTALT | KEYBOARD_MODIFIER_RIGHTALT);
 
   // parse 3 keycode bytes into single word to return
-  uint32_t reportKeys = report->keycode[0] | (report->keycode[1] << 8) | (report->keycode[2] << 16);
-  if (report->modifier & (KEYBOARD_MODIFIER_LEFTSHIFT)) {
+  uint32_t reportKeys = 0;
+  for (uint8_t i = 0; i < 3 && i < kb->held_count; i++) {
+    reportKeys |= (uint32_t)held[i] << (8 * i);
+  }
+  if (modifier & (KEYBOARD_MODIFIER_LEFTSHIFT)) {
     reportKeys = reportKeys << 8 | HID_KEY_SHIFT_LEFT;
-  } else if (report->modifier & (KEYBOARD_MODIFIER_RIGHTSHIFT)) {
+  } else if (modifier & (KEYBOARD_MODIFIER_RIGHTSHIFT)) {
     reportKeys = reportKeys << 8 | HID_KEY_SHIFT_RIGHT;
   }
   if (is_ctrl) {
@@ -273,34 +453,31 @@ void process_hid_keyboard(uint8_t dev_addr, uint8_t instance, uint8_t const* hid
   if (is_alt) {
     reportKeys = reportKeys << 8 | HID_KEY_ALT_LEFT;
   }
-  if (report->modifier & (KEYBOARD_MODIFIER_LEFTGUI)) {
+  if (modifier & (KEYBOARD_MODIFIER_LEFTGUI)) {
     reportKeys = reportKeys << 8 | HID_KEY_GUI_LEFT;
-  } else if (report->modifier & (KEYBOARD_MODIFIER_RIGHTGUI)) {
+  } else if (modifier & (KEYBOARD_MODIFIER_RIGHTGUI)) {
     reportKeys = reportKeys << 8 | HID_KEY_GUI_RIGHT;
   }
 
   // wait until first report before sending init led output report
-  if (!hid_kb_devices[dev_addr].instances[instance].ready) {
-    hid_kb_devices[dev_addr].instances[instance].ready = true;
-  }
+  kb->ready = true;
 
   //------------- example code ignore control (non-printable) key affects -------------//
-  for(uint8_t i=0; i<6; i++)
+  for(uint8_t i=0; i<kb->held_count; i++)
   {
-    if ( report->keycode[i] )
     {
-      if (report->keycode[i] == HID_KEY_ESCAPE || report->keycode[i] == HID_KEY_EQUAL) btns_run = true; // Start
-      if (report->keycode[i] == HID_KEY_P || report->keycode[i] == HID_KEY_MINUS) btns_sel = true; // Select
+      if (held[i] == HID_KEY_ESCAPE || held[i] == HID_KEY_EQUAL) btns_run = true; // Start
+      if (held[i] == HID_KEY_P || held[i] == HID_KEY_MINUS) btns_sel = true; // Select
 
       // Canonical button mapping (console layer handles any reordering)
-      if (report->keycode[i] == HID_KEY_J || report->keycode[i] == HID_KEY_ENTER) btns_b1 = true;
-      if (report->keycode[i] == HID_KEY_K || report->keycode[i] == HID_KEY_BACKSPACE) btns_b2 = true;
-      if (report->keycode[i] == HID_KEY_L) btns_b4 = true;
-      if (report->keycode[i] == HID_KEY_SEMICOLON) btns_b3 = true;
-      if (report->keycode[i] == HID_KEY_U || report->keycode[i] == HID_KEY_PAGE_UP) btns_l1 = true;
-      if (report->keycode[i] == HID_KEY_I || report->keycode[i] == HID_KEY_PAGE_DOWN) btns_r1 = true;
+      if (held[i] == HID_KEY_J || held[i] == HID_KEY_ENTER) btns_b1 = true;
+      if (held[i] == HID_KEY_K || held[i] == HID_KEY_BACKSPACE) btns_b2 = true;
+      if (held[i] == HID_KEY_L) btns_b4 = true;
+      if (held[i] == HID_KEY_SEMICOLON) btns_b3 = true;
+      if (held[i] == HID_KEY_U || held[i] == HID_KEY_PAGE_UP) btns_l1 = true;
+      if (held[i] == HID_KEY_I || held[i] == HID_KEY_PAGE_DOWN) btns_r1 = true;
       // HAT SWITCH
-      switch (report->keycode[i])
+      switch (held[i])
       {
       case HID_KEY_1:
       case HID_KEY_ARROW_UP:
@@ -327,7 +504,7 @@ void process_hid_keyboard(uint8_t dev_addr, uint8_t instance, uint8_t const* hid
       }
 
       // LEFT STICK
-      switch (report->keycode[i])
+      switch (held[i])
       {
       case HID_KEY_W:
           leftStickKeys |= (0x1 << (4 * leftIndex));
@@ -350,7 +527,7 @@ void process_hid_keyboard(uint8_t dev_addr, uint8_t instance, uint8_t const* hid
       }
 
       // RIGHT STICK
-      switch (report->keycode[i])
+      switch (held[i])
       {
       case HID_KEY_M:
           rightStickKeys |= (0x1 << (4 * rightIndex));
@@ -373,20 +550,17 @@ void process_hid_keyboard(uint8_t dev_addr, uint8_t instance, uint8_t const* hid
       }
 
       // Ctrl+Alt+Delete -> Home/Guide button (console layer can map to IGR if needed)
-      if (is_ctrl && is_alt && report->keycode[i] == HID_KEY_DELETE)
+      if (is_ctrl && is_alt && held[i] == HID_KEY_DELETE)
       {
         btns_a1 = true;
       }
 
-      if ( find_key_in_report(&prev_report, report->keycode[i]) )
+      if ( key_bitmap_test(&pressed, held[i]) )
       {
-        // exist in previous report means the current key is holding
-      }else
-      {
-        // TU_LOG1("keycode(%d)\r\n", report->keycode[i]);
-        // not existed in previous report means the current key is pressed
-        // bool const is_shift = report->modifier & (KEYBOARD_MODIFIER_LEFTSHIFT | KEYBOARD_MODIFIER_RIGHTSHIFT);
-        // uint8_t ch = keycode2ascii[report->keycode[i]][is_shift ? 1 : 0];
+        // TU_LOG1("keycode(%d)\r\n", held[i]);
+        // newly pressed in this report
+        // bool const is_shift = modifier & (KEYBOARD_MODIFIER_LEFTSHIFT | KEYBOARD_MODIFIER_RIGHTSHIFT);
+        // uint8_t ch = keycode2ascii[held[i]][is_shift ? 1 : 0];
         // putchar(ch);
         // if ( ch == '\r' ) putchar('\n'); // added new line for enter key
 
@@ -442,11 +616,10 @@ void process_hid_keyboard(uint8_t dev_addr, uint8_t instance, uint8_t const* hid
     .buttons = buttons,
     .button_count = 6,  // Keyboard maps to 6 face buttons (B1-B4, L1, R1)
     .analog = {analog_left_x, analog_left_y, analog_right_x, analog_right_y, analog_l, analog_r},
-    .keys = reportKeys
+    .keys = reportKeys,
+    .key_state = keys
   };
   router_submit_input(&event);
-
-  prev_report = *report;
 }
 
 // process usb hid output reports
@@ -456,14 +629,17 @@ void output_hid_keyboard(uint8_t dev_addr, uint8_t instance, device_output_confi
   static uint8_t kbd_leds = 0;
   static uint8_t prev_kbd_leds = 0xFF;
 
-  if (!hid_kb_devices[dev_addr].instances[instance].init && hid_kb_devices[dev_addr].instances[instance].ready)
+  kb_ctx_t* kb = hid_slot_ctx(dev_addr, instance);
+  if (!kb) return;
+
+  if (!kb->init && kb->ready)
   {
-    hid_kb_devices[dev_addr].instances[instance].init = true;
+    kb->init = true;
 
     // kbd_leds = KEYBOARD_LED_NUMLOCK;
     tuh_hid_set_report(dev_addr, instance, 0, HID_REPORT_TYPE_OUTPUT, &kbd_leds, sizeof(kbd_leds));
   }
-  else if (config->leds != hid_kb_devices[dev_addr].instances[instance].leds || config->test)
+  else if (config->leds != kb->leds || config->test)
   {
     // LED state can be controlled externally via config->leds (from console/main.c)
     // or animated during fun mode. We use a local copy to preserve config as read-only.
@@ -487,9 +663,9 @@ void output_hid_keyboard(uint8_t dev_addr, uint8_t instance, device_output_confi
     else kbd_leds &= ~KEYBOARD_LED_SCROLLLOCK;
 
     tuh_hid_set_report(dev_addr, instance, 0, HID_REPORT_TYPE_OUTPUT, &kbd_leds, sizeof(kbd_leds));
-    hid_kb_devices[dev_addr].instances[instance].leds = leds;  // Store for next comparison
+    kb->leds = leds;  // Store for next comparison
   }
-  if (config->rumble != hid_kb_devices[dev_addr].instances[instance].rumble)
+  if (config->rumble != kb->rumble)
   {
     if (config->rumble)
     {
@@ -497,7 +673,7 @@ void output_hid_keyboard(uint8_t dev_addr, uint8_t instance, device_output_confi
     } else {
       kbd_leds = 0; // kbd_leds &= ~KEYBOARD_LED_CAPSLOCK;
     }
-    hid_kb_devices[dev_addr].instances[instance].rumble = config->rumble;
+    kb->rumble = config->rumble;
 
     if (kbd_leds != prev_kbd_leds)
     {
@@ -507,33 +683,14 @@ void output_hid_keyboard(uint8_t dev_addr, uint8_t instance, device_output_confi
   }
 }
 
-// process usb hid output reports
-void task_hid_keyboard(uint8_t dev_addr, uint8_t instance, device_output_config_t* config)
-{
-  const uint32_t interval_ms = 20;
-  static uint32_t start_ms = 0;
-
-  uint32_t current_time_ms = to_ms_since_boot(get_absolute_time());
-  if (current_time_ms - start_ms >= interval_ms)
-  {
-    start_ms = current_time_ms;
-    output_hid_keyboard(dev_addr, instance, config);
-  }
-}
-
-// resets default values in case devices are hotswapped
-void unmount_hid_keyboard(uint8_t dev_addr, uint8_t instance)
-{
-  hid_kb_devices[dev_addr].instances[instance].ready = false;
-  hid_kb_devices[dev_addr].instances[instance].init = false;
-  hid_kb_devices[dev_addr].instances[instance].leds = 0;
-}
+HID_SLOT_CTX_CHECK(kb_ctx_t);
 
 DeviceInterface hid_keyboard_interface = {
   .name = "HID Keyboard",
   .is_device = NULL,
+  .check_descriptor = check_descriptor_hid_keyboard,
   .init = NULL,
-  .task = task_hid_keyboard,
+  .task = output_hid_keyboard,
+  .task_poll_ms = 20,
   .process = process_hid_keyboard,
-  .unmount = unmount_hid_keyboard,
 };
@@ -0,0 +1,144 @@
+// hid_parse_cache.c
+// Cache of compiled report descriptors
+
+#include "hid_parse_cache.h"
+#include "core/services/metrics/metrics.h"
+#include <string.h>
+#include <stdio.h>
+
+#if CONFIG_HID_PARSE_CACHE_FLASH
+#include "core/services/storage/flash.h"
+#endif
+
+static hid_parse_cache_entry_t ram_entries[HID_PARSE_CACHE_RAM_ENTRIES];
+static bool ram_valid[HID_PARSE_CACHE_RAM_ENTRIES];
+static uint8_t ram_next = 0;     // Round-robin replacement
+
+uint32_t hid_parse_cache_hash(const uint8_t* desc, uint16_t len)
+{
+  uint32_t hash = 0x811C9DC5;
+  for (uint16_t i = 0; i < len; i++) {
+    hash = (hash ^ desc[i]) * 0x01000193;
+  }
+  return hash;
+}
+
+static bool key_matches(const hid_parse_cache_entry_t* e, uint16_t vid, uint16_t pid,
+                        uint32_t hash, uint16_t desc_len)
+{
+  return e->vid == vid && e->pid == pid && e->hash == hash && e->desc_len == desc_len;
+}
+
+static hid_parse_cache_entry_t* ram_insert(const hid_parse_cache_entry_t* entry)
+{
+  // Replace an existing entry for the same key, else the next slot
+  int slot = -1;
+  for (uint8_t i = 0; i < HID_PARSE_CACHE_RAM_ENTRIES; i++) {
+    if (ram_valid[i] && key_matches(&ram_entries[i], entry->vid, entry->pid,
+                                    entry->hash, entry->desc_len)) {
+      slot = i;
+      break;
+    }
+  }
+  if (slot < 0) {
+    slot = ram_next;
+    ram_next = (ram_next + 1) % HID_PARSE_CACHE_RAM_ENTRIES;
+  }
+
+  ram_entries[slot] = *entry;
+  ram_valid[slot] = true;
+  return &ram_entries[slot];
+}
+
+// ============================================================================
+// FLASH
+// ============================================================================
+
+#if CONFIG_HID_PARSE_CACHE_FLASH
+
+#define FLASH_ENTRY_MAGIC 0x31435048  // "HPC1"
+
+typedef struct {
+  uint32_t magic;
+  uint16_t entry_size;    // Rejects pages written by a build with another layout
+  uint16_t reserved;
+  hid_parse_cache_entry_t entry;
+} flash_entry_t;
+
+_Static_assert(sizeof(flash_entry_t) <= 256, "flash_entry_t must fit one flash page");
+
+static const flash_entry_t* flash_find(uint16_t vid, uint16_t pid, uint32_t hash, uint16_t desc_len)
+{
+  for (uint8_t i = 0; i < FLASH_CACHE_PAGE_COUNT; i++) {
+    const flash_entry_t* page = (const flash_entry_t*)flash_cache_page(i);
+    if (page->magic != FLASH_ENTRY_MAGIC) continue;
+    if (page->entry_size != sizeof(hid_parse_cache_entry_t)) continue;
+    if (key_matches(&page->entry, vid, pid, hash, desc_len)) return page;
+  }
+  return NULL;
+}
+
+static void flash_store(const hid_parse_cache_entry_t* entry)
+{
+  if (flash_find(entry->vid, entry->pid, entry->hash, entry->desc_len)) return;
+
+  int slot = -1;
+  for (uint8_t i = 0; i < FLASH_CACHE_PAGE_COUNT; i++) {
+    if (((const flash_entry_t*)flash_cache_page(i))->magic == 0xFFFFFFFF) {
+      slot = i;
+      break;
+    }
+  }
+
+  // Full - start over (skipped while BT is active; RAM still has it)
+  if (slot < 0) {
+    if (!flash_cache_erase()) return;
+    slot = 0;
+  }
+
+  static uint8_t page[256];
+  memset(page, 0xFF, sizeof(page));
+  flash_entry_t* fe = (flash_entry_t*)page;
+  fe->magic = FLASH_ENTRY_MAGIC;
+  fe->entry_size = sizeof(hid_parse_cache_entry_t);
+  fe->reserved = 0;
+  fe->entry = *entry;
+  flash_cache_write_page(slot, page);
+  printf("[hid_cache] %04x:%04x stored in flash page %d\n", entry->vid, entry->pid, slot);
+}
+
+#endif // CONFIG_HID_PARSE_CACHE_FLASH
+
+// ============================================================================
+// PUBLIC API
+// ============================================================================
+
+const hid_parse_cache_entry_t* hid_parse_cache_lookup(uint16_t vid, uint16_t pid,
+                                                      uint32_t hash, uint16_t desc_len)
+{
+  for (uint8_t i = 0; i < HID_PARSE_CACHE_RAM_ENTRIES; i++) {
+    if (ram_valid[i] && key_matches(&ram_entries[i], vid, pid, hash, desc_len)) {
+      METRIC_INC(HID_PARSE_CACHE_HITS);
+      return &ram_entries[i];
+    }
+  }
+
+#if CONFIG_HID_PARSE_CACHE_FLASH
+  const flash_entry_t* fe = flash_find(vid, pid, hash, desc_len);
+  if (fe) {
+    METRIC_INC(HID_PARSE_CACHE_HITS);
+    return ram_insert(&fe->entry);
+  }
+#endif
+
+  METRIC_INC(HID_PARSE_CACHE_MISSES);
+  return NULL;
+}
+
+void hid_parse_cache_store(const hid_parse_cache_entry_t* entry)
+{
+  ram_insert(entry);
+#if CONFIG_HID_PARSE_CACHE_FLASH
+  flash_store(entry);
+#endif
+}
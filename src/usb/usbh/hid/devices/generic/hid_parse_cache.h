@@ -0,0 +1,42 @@
+// hid_parse_cache.h
+// Cache of compiled report descriptors
+//
+// Keyed by VID/PID plus a hash and length of the raw report descriptor, so
+// identical pads on a hub, or a pad reconnecting after sleep, mount without
+// running the HID parser. Entries hold the compiled extraction program
+// (hid_extract.h) and the device classification.
+//
+// The RAM table is always on. Define CONFIG_HID_PARSE_CACHE_FLASH=1 to also
+// persist entries in the flash cache sector so they survive a reboot.
+// The key doesn't depend on transport, so BT HID can use the same cache.
+
+#ifndef HID_PARSE_CACHE_H
+#define HID_PARSE_CACHE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "hid_extract.h"
+
+#define HID_PARSE_CACHE_RAM_ENTRIES 8
+
+typedef struct {
+  uint16_t vid;
+  uint16_t pid;
+  uint32_t hash;          // hid_parse_cache_hash() of the report descriptor
+  uint16_t desc_len;
+  uint8_t type;           // HID_GAMEPAD / HID_MOUSE / HID_KEYBOARD
+  uint8_t reserved;
+  hid_extract_program_t prog;
+} hid_parse_cache_entry_t;
+
+// FNV-1a over the report descriptor
+uint32_t hid_parse_cache_hash(const uint8_t* desc, uint16_t len);
+
+// Returns the cached entry or NULL. Flash entries are promoted to RAM.
+const hid_parse_cache_entry_t* hid_parse_cache_lookup(uint16_t vid, uint16_t pid,
+                                                      uint32_t hash, uint16_t desc_len);
+
+// Insert (or refresh) an entry after a successful parse
+void hid_parse_cache_store(const hid_parse_cache_entry_t* entry);
+
+#endif // HID_PARSE_CACHE_H
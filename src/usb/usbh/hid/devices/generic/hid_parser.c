@@ -27,54 +27,78 @@
 #include "hid_parser.h"
 #include <string.h>
 #include <stdbool.h>
-#include <assert.h>
-
-#ifdef DYNAMIC
-#include <malloc.h>
-#define ACQUIRE_AND_RELEASE(structure, size) \
-__attribute__ ((always_inline)) static inline structure##_t* acquire_##structure() { return malloc(sizeof(structure##_t)); } \
-__attribute__ ((always_inline)) static inline void release_##structure(structure##_t* pointer) { free(pointer); }
-#else
-#define ACQUIRE_AND_RELEASE(structure, size) \
-enum { MAX_##structure =  size }; \
-static structure##_t structure##s[MAX_##structure]; \
-static bool structure##sAcquired[MAX_##structure]; \
-static structure##_t* acquire_##structure() \
-{\
-	for(uint8_t i=0; i < MAX_##structure; i++) \
-	{\
-	if(!structure##sAcquired[i])\
-		{\
-			structure##sAcquired[i] = true;\
-			return &structure##s[i];\
-		}\
-	}\
-	assert(false);\
-	return NULL;\
-}\
-static void release_##structure(structure##_t* pointer)\
-{\
-	structure##sAcquired[pointer - structure##s] = false;\
-}
-#endif
 
-ACQUIRE_AND_RELEASE(HID_ReportSizeInfo, 100);
-ACQUIRE_AND_RELEASE(HID_CollectionPath, 25);
-ACQUIRE_AND_RELEASE(HID_ReportInfo, 1);
-ACQUIRE_AND_RELEASE(HID_ReportItem, 50);
+/* Parse arena
+ *
+ * Everything the parser allocates comes from one bump arena that is reset at the start of each
+ * parse; callers compile what they need from the result and free it before the next mount, so
+ * nothing is shared between devices. Collection paths, report ID size entries and the ReportInfo
+ * header are reserved up front from a pre-scan of the descriptor. Report items (only the ones the
+ * filter callback keeps) get whatever is left; once that runs out further items are dropped and
+ * counted, while bit offsets keep being tracked so the kept items stay correct.
+ */
+#define ARENA_ALIGN(Size) (((Size) + sizeof(void*) - 1) & ~(sizeof(void*) - 1))
+
+static uint8_t ParserArena[HID_PARSER_ARENA_SIZE] __attribute__((aligned(8)));
+static uint16_t ArenaUsed;
+static uint16_t ArenaReserved;
+
+static void *Arena_Alloc(uint16_t Size, bool Reserved)
+{
+	Size = ARENA_ALIGN(Size);
 
-void USB_FreeReportInfo(HID_ReportInfo_t *ReportInfo)
+	if (Reserved && ArenaReserved >= Size)
+		ArenaReserved -= Size;
+	else if (ArenaUsed + Size + ArenaReserved > HID_PARSER_ARENA_SIZE)
+		return NULL;
+
+	void *Block = &ParserArena[ArenaUsed];
+	ArenaUsed += Size;
+	memset(Block, 0, Size);
+	return Block;
+}
+
+/* Bytes of structural data (everything but report items) the descriptor can need */
+static uint32_t Arena_PreScan(const uint8_t *ReportData, uint16_t ReportSize)
 {
-	if (ReportInfo)
+	uint16_t Collections = 0;
+	uint16_t ReportIDs = 1;
+
+	while (ReportSize)
 	{
-		HID_ReportItem_t *item = ReportInfo->FirstReportItem;
-		while (item)
+		uint8_t HIDReportItem = *ReportData;
+		uint8_t DataSize = (HIDReportItem & HID_RI_DATA_SIZE_MASK);
+		if (DataSize == HID_RI_DATA_BITS_32)
+			DataSize = 4;
+		if (1 + DataSize > ReportSize)
+			break;
+
+		switch (HIDReportItem & (HID_RI_TYPE_MASK | HID_RI_TAG_MASK))
 		{
-			HID_ReportItem_t *current = item;
-			item = item->Next;
-			release_HID_ReportItem(current);
+			case HID_RI_COLLECTION(0):
+				Collections++;
+				break;
+			case HID_RI_REPORT_ID(0):
+				ReportIDs++;
+				break;
 		}
-		release_HID_ReportInfo(ReportInfo);
+
+		ReportData += 1 + DataSize;
+		ReportSize -= 1 + DataSize;
+	}
+
+	return ARENA_ALIGN(sizeof(HID_ReportInfo_t)) +
+		   (uint32_t)MAX(Collections, 1) * ARENA_ALIGN(sizeof(HID_CollectionPath_t)) +
+		   (uint32_t)ReportIDs * ARENA_ALIGN(sizeof(HID_ReportSizeInfo_t));
+}
+
+void USB_FreeReportInfo(HID_ReportInfo_t *ReportInfo)
+{
+	if (ReportInfo && (uint8_t *)ReportInfo >= ParserArena &&
+		(uint8_t *)ReportInfo < &ParserArena[HID_PARSER_ARENA_SIZE])
+	{
+		ArenaUsed = 0;
+		ArenaReserved = 0;
 	}
 }
 
@@ -84,10 +108,17 @@ uint8_t USB_ProcessHIDReport(uint8_t dev_addr,
 							 uint16_t ReportSize,
 							 HID_ReportInfo_t **ParserDataOut)
 {
-	HID_ReportSizeInfo_t *FirstReportIDSize = acquire_HID_ReportSizeInfo();
-	HID_CollectionPath_t *FirstCollectionPath = acquire_HID_CollectionPath();
-	memset(FirstCollectionPath, 0, sizeof(HID_CollectionPath_t));
-	HID_ReportInfo_t *ParserData = acquire_HID_ReportInfo();
+	uint32_t Reserve = Arena_PreScan(ReportData, ReportSize);
+	if (Reserve > HID_PARSER_ARENA_SIZE)
+		return HID_PARSE_OutOfMemory;
+
+	ArenaUsed = 0;
+	ArenaReserved = Reserve;
+
+	HID_ReportInfo_t *ParserData = Arena_Alloc(sizeof(HID_ReportInfo_t), true);
+	HID_ReportSizeInfo_t *FirstReportIDSize = Arena_Alloc(sizeof(HID_ReportSizeInfo_t), true);
+	HID_CollectionPath_t *FirstCollectionPath = Arena_Alloc(sizeof(HID_CollectionPath_t), true);
+	uint16_t CollectionOverflowDepth = 0;
 	HID_StateTable_t StateTable[HID_STATETABLE_STACK_DEPTH];
 	HID_StateTable_t *CurrStateTable = &StateTable[0];
 	HID_CollectionPath_t *CurrCollectionPath = NULL;
@@ -96,9 +127,7 @@ uint8_t USB_ProcessHIDReport(uint8_t dev_addr,
 	uint8_t UsageListSize = 0;
 	HID_MinMax_t UsageMinMax = {0, 0};
 
-	memset(ParserData, 0x00, sizeof(HID_ReportInfo_t));
 	memset(CurrStateTable, 0x00, sizeof(HID_StateTable_t));
-	memset(CurrReportIDInfo, 0x00, sizeof(HID_ReportSizeInfo_t));
 
 	ParserData->TotalDeviceReports = 1;
 	uint8_t Result = HID_PARSE_Successful;
@@ -107,11 +136,16 @@ uint8_t USB_ProcessHIDReport(uint8_t dev_addr,
 	{
 		uint8_t HIDReportItem = *ReportData;
 		uint32_t ReportItemData;
+		uint8_t DataSize = (HIDReportItem & HID_RI_DATA_SIZE_MASK);
+
+		/* Truncated final item - stop at the last complete one */
+		if (1 + (DataSize == HID_RI_DATA_BITS_32 ? 4 : DataSize) > ReportSize)
+			break;
 
 		ReportData++;
 		ReportSize--;
 
-		switch (HIDReportItem & HID_RI_DATA_SIZE_MASK)
+		switch (DataSize)
 		{
 			case HID_RI_DATA_BITS_32:
 				ReportItemData = (((uint32_t)ReportData[3] << 24) | ((uint32_t)ReportData[2] << 16) |
@@ -221,8 +255,12 @@ uint8_t USB_ProcessHIDReport(uint8_t dev_addr,
 					if (CurrReportIDInfo == NULL)
 					{
 						ParserData->TotalDeviceReports++;
-						iterator->Next = CurrReportIDInfo = acquire_HID_ReportSizeInfo();
-						memset(CurrReportIDInfo, 0x00, sizeof(HID_ReportSizeInfo_t));
+						iterator->Next = CurrReportIDInfo = Arena_Alloc(sizeof(HID_ReportSizeInfo_t), true);
+						if (CurrReportIDInfo == NULL)
+						{
+							Result = HID_PARSE_OutOfMemory;
+							break;
+						}
 					}
 				}
 
@@ -253,6 +291,12 @@ uint8_t USB_ProcessHIDReport(uint8_t dev_addr,
 				break;
 
 			case HID_RI_COLLECTION(0):
+				if (CollectionOverflowDepth)
+				{
+					CollectionOverflowDepth++;
+					break;
+				}
+
 				if (CurrCollectionPath == NULL)
 				{
 					CurrCollectionPath = FirstCollectionPath;
@@ -266,10 +310,16 @@ uint8_t USB_ProcessHIDReport(uint8_t dev_addr,
 					{
 						CurrCollectionPath = CurrCollectionPath->Next;
 					}
-					HID_CollectionPath_t *NewCollectionPath = acquire_HID_CollectionPath();
+					HID_CollectionPath_t *NewCollectionPath = Arena_Alloc(sizeof(HID_CollectionPath_t), true);
+					if (NewCollectionPath == NULL)
+					{
+						/* Only nesting is tracked from here on */
+						CurrCollectionPath = ParentCollectionPath;
+						CollectionOverflowDepth = 1;
+						break;
+					}
 					CurrCollectionPath->Next = NewCollectionPath;
 					CurrCollectionPath = NewCollectionPath;
-					memset(CurrCollectionPath, 0, sizeof(HID_CollectionPath_t));
 					CurrCollectionPath->Parent = ParentCollectionPath;
 				}
 
@@ -293,17 +343,17 @@ uint8_t USB_ProcessHIDReport(uint8_t dev_addr,
 				break;
 
 			case HID_RI_END_COLLECTION(0):
+				if (CollectionOverflowDepth)
+				{
+					CollectionOverflowDepth--;
+					break;
+				}
 				if (CurrCollectionPath == NULL)
 				{
 					Result = HID_PARSE_UnexpectedEndCollection;
 					break;
 				}
 				CurrCollectionPath = CurrCollectionPath->Parent;
-				if (CurrCollectionPath)
-				{
-					release_HID_CollectionPath(CurrCollectionPath->Next);
-					CurrCollectionPath->Next = NULL;
-				}
 				break;
 
 			case HID_RI_INPUT(0):
@@ -351,16 +401,21 @@ uint8_t USB_ProcessHIDReport(uint8_t dev_addr,
 
 					if (!(ReportItemData & HID_IOF_CONSTANT) && CALLBACK_HIDParser_FilterHIDReportItem(dev_addr, instance, &NewReportItem))
 					{
-						if (!ParserData->FirstReportItem)
+						HID_ReportItem_t *StoredItem = NULL;
+						if (ParserData->TotalReportItems < UINT8_MAX)
+							StoredItem = Arena_Alloc(sizeof(HID_ReportItem_t), false);
+
+						if (StoredItem == NULL)
 						{
-							ParserData->FirstReportItem = acquire_HID_ReportItem();
-							ParserData->LastReportItem = ParserData->FirstReportItem;
+							ParserData->DroppedReportItems++;
+							continue;
 						}
+
+						if (!ParserData->FirstReportItem)
+							ParserData->FirstReportItem = StoredItem;
 						else
-						{
-							ParserData->LastReportItem->Next = acquire_HID_ReportItem();
-							ParserData->LastReportItem = ParserData->LastReportItem->Next;
-						}
+							ParserData->LastReportItem->Next = StoredItem;
+						ParserData->LastReportItem = StoredItem;
 						memcpy(ParserData->LastReportItem, &NewReportItem, sizeof(HID_ReportItem_t));
 						ParserData->LastReportItem->Next = NULL;
 						ParserData->TotalReportItems++;
@@ -395,21 +450,6 @@ uint8_t USB_ProcessHIDReport(uint8_t dev_addr,
 		*ParserDataOut = ParserData;
 	}
 
-	HID_ReportSizeInfo_t *iteratorReportIDSizes = FirstReportIDSize;
-	while (iteratorReportIDSizes)
-	{
-		HID_ReportSizeInfo_t *temp = iteratorReportIDSizes->Next;
-		release_HID_ReportSizeInfo(iteratorReportIDSizes);
-		iteratorReportIDSizes = temp;
-	}
-
-	HID_CollectionPath_t *iteratorCollectionPaths = FirstCollectionPath;
-	while (iteratorCollectionPaths)
-	{
-		HID_CollectionPath_t *temp = iteratorCollectionPaths->Next;
-		release_HID_CollectionPath(iteratorCollectionPaths);
-		iteratorCollectionPaths = temp;
-	}
 	return Result;
 }
 
@@ -150,6 +150,15 @@ extern "C"
  *  \return Concatenated version of the expanded input.
  */
 #define CONCAT_EXPANDED(x, y) CONCAT(x, y)
+#endif
+
+#if !defined(HID_PARSER_ARENA_SIZE) || defined(__DOXYGEN__)
+/** Size in bytes of the arena all parse results are allocated from. Collection paths and report ID
+ *  entries are reserved first (a descriptor needing more than the whole arena fails with
+ *  \ref HID_PARSE_OutOfMemory); report items use the remainder and are dropped, not failed, once it
+ *  runs out. Can be overridden with the -D compiler switch.
+ */
+#define HID_PARSER_ARENA_SIZE 4096
 #endif
 
 	/* Public Interface - May be used in end-application: */
@@ -163,6 +172,7 @@ extern "C"
 		HID_PARSE_UnexpectedEndCollection = 3,	   /**< An END COLLECTION item found without matching COLLECTION item. */
 		HID_PARSE_UsageListOverflow = 4,		   /**< More than \ref HID_USAGE_STACK_DEPTH usages listed in a row. */
 		HID_PARSE_NoUnfilteredReportItems = 5,	   /**< All report items from the device were filtered by the filtering callback routine. */
+		HID_PARSE_OutOfMemory = 6,				   /**< Collections/report IDs in the descriptor don't fit in \ref HID_PARSER_ARENA_SIZE. */
 	};
 
 	/* Private Interface - For use in library only: */
@@ -340,6 +350,7 @@ extern "C"
 	typedef struct 
 	{
 		uint8_t TotalReportItems;								   /**< Total number of report items stored in the \c ReportItems array. */
+		uint8_t DroppedReportItems;								   /**< Report items accepted by the filter but not stored (arena full). */
 		HID_ReportItem_t* FirstReportItem;		   /**< Report items array, including all IN, OUT
 																	*   and FEATURE items.
 																	*/
@@ -4,15 +4,13 @@
 #include "core/router/router.h"
 #include "core/input_event.h"
 
-// check if device is 8BitDo Wireless Adapter (D-input)
-bool is_8bitdo_bta(uint16_t vid, uint16_t pid) {
-  return ((vid == 0x2dc8 && (
-    pid == 0x3100 || // 8BitDo Wireless Adapter (Red)
-    pid == 0x3105 || // 8BitDo Wireless Adapter (Black) [05:HID_MODE]
-    pid == 0x3106 || // 8BitDo Wireless Adapter (Black) [06:RECV_MODE]
-    pid == 0x3107    // 8BitDo Wireless Adapter (Black) [07:IDLE_MODE]
-  )));
-}
+// 8BitDo wireless adapters
+static const hid_device_id_t bitdo_bta_ids[] = {
+  {0x2dc8, 0x3100}, // 8BitDo Wireless Adapter (Red)
+  {0x2dc8, 0x3105}, // 8BitDo Wireless Adapter (Black) [05:HID_MODE]
+  {0x2dc8, 0x3106}, // 8BitDo Wireless Adapter (Black) [06:RECV_MODE]
+  {0x2dc8, 0x3107}, // 8BitDo Wireless Adapter (Black) [07:IDLE_MODE]
+};
 
 // check if 2 reports are different enough
 bool diff_report_bta(bitdo_bta_report_t const* rpt1, bitdo_bta_report_t const* rpt2) {
@@ -31,15 +29,15 @@ bool diff_report_bta(bitdo_bta_report_t const* rpt1, bitdo_bta_report_t const* r
 }
 
 // process usb hid input reports
-void process_8bitdo_bta(uint8_t dev_addr, uint8_t instance, uint8_t const* report, uint16_t len) {
+void process_8bitdo_bta(uint8_t dev_addr, uint8_t instance, uint8_t const* report, uint16_t len, void* ctx) {
   uint32_t buttons;
   // previous report used to compare for changes
-  static bitdo_bta_report_t prev_report[5] = { 0 };
+  bitdo_bta_report_t* prev_report = ctx;
 
   bitdo_bta_report_t input_report;
   memcpy(&input_report, report, sizeof(input_report));
 
-  if ( diff_report_bta(&prev_report[dev_addr-1], &input_report) )
+  if ( diff_report_bta(prev_report, &input_report) )
   {
     TU_LOG1("(x1, y1, x2, y2, l2, r2) = (%u, %u, %u, %u, %u, %u)\r\n",
       input_report.x1, input_report.y1,
@@ -116,13 +114,15 @@ void process_8bitdo_bta(uint8_t dev_addr, uint8_t instance, uint8_t const* repor
     };
     router_submit_input(&event);
 
-    prev_report[dev_addr-1] = input_report;
+    *prev_report = input_report;
   }
 }
 
+HID_SLOT_CTX_CHECK(bitdo_bta_report_t);
+
 DeviceInterface bitdo_bta_interface = {
   .name = "8BitDo Wireless Adapter",
-  .is_device = is_8bitdo_bta,
+  HID_DEVICE_IDS(bitdo_bta_ids),
   .process = process_8bitdo_bta,
   .task = NULL,
   .init = NULL
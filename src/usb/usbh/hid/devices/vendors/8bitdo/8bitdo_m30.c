@@ -4,13 +4,11 @@
 #include "core/router/router.h"
 #include "core/input_event.h"
 
-// check if device is 8BitDo Bluetooth gamepad (D-input)
-bool is_8bitdo_m30(uint16_t vid, uint16_t pid) {
-  return ((vid == 0x2dc8 && (
-    pid == 0x5006 || // 8BitDo M30 Bluetooth
-    pid == 0x3104    // 8BitDo Bluetooth Adapter (Gray)
-  )));
-}
+// 8BitDo M30 and gray Bluetooth adapter
+static const hid_device_id_t bitdo_m30_ids[] = {
+  {0x2dc8, 0x5006}, // 8BitDo M30 Bluetooth
+  {0x2dc8, 0x3104}, // 8BitDo Bluetooth Adapter (Gray)
+};
 
 // check if 2 reports are different enough
 bool diff_report_m30(bitdo_m30_report_t const* rpt1, bitdo_m30_report_t const* rpt2) {
@@ -18,15 +16,15 @@ bool diff_report_m30(bitdo_m30_report_t const* rpt1, bitdo_m30_report_t const* r
 }
 
 // process usb hid input reports
-void process_8bitdo_m30(uint8_t dev_addr, uint8_t instance, uint8_t const* report, uint16_t len) {
+void process_8bitdo_m30(uint8_t dev_addr, uint8_t instance, uint8_t const* report, uint16_t len, void* ctx) {
   uint32_t buttons;
   // previous report used to compare for changes
-  static bitdo_m30_report_t prev_report[5] = { 0 };
+  bitdo_m30_report_t* prev_report = ctx;
 
   bitdo_m30_report_t input_report;
   memcpy(&input_report, report, sizeof(input_report));
 
-  if (diff_report_m30(&prev_report[dev_addr-1], &input_report)) {
+  if (diff_report_m30(prev_report, &input_report)) {
     TU_LOG1("(x1, y1, x2, y2) = (%u, %u, %u, %u)\r\n", input_report.x1, input_report.y1, input_report.x2, input_report.y2);
     TU_LOG1("DPad = %d ", input_report.dpad);
 
@@ -107,13 +105,15 @@ void process_8bitdo_m30(uint8_t dev_addr, uint8_t instance, uint8_t const* repor
     };
     router_submit_input(&event);
 
-    prev_report[dev_addr-1] = input_report;
+    *prev_report = input_report;
   }
 }
 
+HID_SLOT_CTX_CHECK(bitdo_m30_report_t);
+
 DeviceInterface bitdo_m30_interface = {
   .name = "8BitDo M30 Bluetooth",
-  .is_device = is_8bitdo_m30,
+  HID_DEVICE_IDS(bitdo_m30_ids),
   .process = process_8bitdo_m30,
   .task = NULL,
   .init = NULL
@@ -4,10 +4,11 @@
 #include "core/router/router.h"
 #include "core/input_event.h"
 
-// check if device is 8BitDo NeoGeo gamepad
-bool is_8bitdo_neo(uint16_t vid, uint16_t pid) {
-  return ((vid == 0x2dc8 && (pid == 0x9025 || pid == 0x9026))); // 8BitDo NeoGeo 2.4g Receiver
-}
+// 8BitDo NeoGeo 2.4g Receiver
+static const hid_device_id_t bitdo_neo_ids[] = {
+  {0x2dc8, 0x9025},
+  {0x2dc8, 0x9026},
+};
 
 // check if 2 reports are different enough
 bool diff_report_neo(bitdo_neo_report_t const* rpt1, bitdo_neo_report_t const* rpt2) {
@@ -15,23 +16,25 @@ bool diff_report_neo(bitdo_neo_report_t const* rpt1, bitdo_neo_report_t const* r
 }
 
 // process usb hid input reports
-void process_8bitdo_neo(uint8_t dev_addr, uint8_t instance, uint8_t const* report, uint16_t len) {
+void process_8bitdo_neo(uint8_t dev_addr, uint8_t instance, uint8_t const* report, uint16_t len, void* ctx) {
   uint32_t buttons;
   // previous report used to compare for changes
-  static bitdo_neo_report_t prev_report[5] = { 0 };
+  bitdo_neo_report_t* prev_report = ctx;
 
   bitdo_neo_report_t input_report;
   memcpy(&input_report, report, sizeof(input_report));
 
-  if (diff_report_neo(&prev_report[dev_addr-1], &input_report)) {
+  if (diff_report_neo(prev_report, &input_report)) {
     // TODO: Parse input_report and call router_submit_input() with INPUT_TYPE_GAMEPAD
-    prev_report[dev_addr-1] = input_report;
+    *prev_report = input_report;
   }
 }
 
+HID_SLOT_CTX_CHECK(bitdo_neo_report_t);
+
 DeviceInterface bitdo_neo_interface = {
   .name = "8BitDo NeoGeo 2.4g",
-  .is_device = is_8bitdo_neo,
+  HID_DEVICE_IDS(bitdo_neo_ids),
   .process = process_8bitdo_neo,
   .task = NULL,
   .init = NULL
@@ -4,10 +4,10 @@
 #include "core/router/router.h"
 #include "core/input_event.h"
 
-// check if device is 8BitDo PCE 2.4g controllers
-bool is_8bitdo_pce(uint16_t vid, uint16_t pid) {
-  return ((vid == 0x0f0d && pid == 0x0138)); // 8BitDo PCE 2.4g
-}
+// 8BitDo PCE 2.4g
+static const hid_device_id_t bitdo_pce_ids[] = {
+  {0x0f0d, 0x0138}, // 8BitDo PCE 2.4g
+};
 
 // check if 2 reports are different enough
 bool diff_report_pce(bitdo_pce_report_t const* rpt1, bitdo_pce_report_t const* rpt2) {
@@ -24,15 +24,15 @@ bool diff_report_pce(bitdo_pce_report_t const* rpt1, bitdo_pce_report_t const* r
 }
 
 // process usb hid input reports
-void process_8bitdo_pce(uint8_t dev_addr, uint8_t instance, uint8_t const* report, uint16_t len) {
+void process_8bitdo_pce(uint8_t dev_addr, uint8_t instance, uint8_t const* report, uint16_t len, void* ctx) {
   uint32_t buttons;
   // previous report used to compare for changes
-  static bitdo_pce_report_t prev_report[5] = { 0 };
+  bitdo_pce_report_t* prev_report = ctx;
 
   bitdo_pce_report_t pce_report;
   memcpy(&pce_report, report, sizeof(pce_report));
 
-  if (diff_report_pce(&prev_report[dev_addr-1], &pce_report)) {
+  if (diff_report_pce(prev_report, &pce_report)) {
     TU_LOG1("(x1, y1, x2, y2) = (%u, %u, %u, %u)\r\n", pce_report.x1, pce_report.y1, pce_report.x2, pce_report.y2);
     TU_LOG1("DPad = %d ", pce_report.dpad);
 
@@ -83,13 +83,15 @@ void process_8bitdo_pce(uint8_t dev_addr, uint8_t instance, uint8_t const* repor
     };
     router_submit_input(&event);
 
-    prev_report[dev_addr-1] = pce_report;
+    *prev_report = pce_report;
   }
 }
 
+HID_SLOT_CTX_CHECK(bitdo_pce_report_t);
+
 DeviceInterface bitdo_pce_interface = {
   .name = "8BitDo PCE 2.4g",
-  .is_device = is_8bitdo_pce,
+  HID_DEVICE_IDS(bitdo_pce_ids),
   .process = process_8bitdo_pce,
   .task = NULL,
   .init = NULL
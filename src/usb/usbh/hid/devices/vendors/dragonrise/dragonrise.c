@@ -4,10 +4,10 @@
 #include "core/router/router.h"
 #include "core/input_event.h"
 
-// check if device is generic NES USB Controller
-static inline bool is_dragonrise(uint16_t vid, uint16_t pid) {
-  return ((vid == 0x0079 && pid == 0x0011)); // Generic NES USB
-}
+// DragonRise generic controllers
+static const hid_device_id_t dragonrise_ids[] = {
+  {0x0079, 0x0011}, // Generic NES USB
+};
 
 // check if 2 reports are different enough
 bool dragonrise_diff_report(dragonrise_report_t const* rpt1, dragonrise_report_t const* rpt2)
@@ -25,15 +25,15 @@ bool dragonrise_diff_report(dragonrise_report_t const* rpt1, dragonrise_report_t
 }
 
 // process usb hid input reports
-void process_dragonrise(uint8_t dev_addr, uint8_t instance, uint8_t const* report, uint16_t len) {
+void process_dragonrise(uint8_t dev_addr, uint8_t instance, uint8_t const* report, uint16_t len, void* ctx) {
   uint32_t buttons;
   // previous report used to compare for changes
-  static dragonrise_report_t prev_report[5][5];
+  dragonrise_report_t* prev_report = ctx;
 
   dragonrise_report_t update_report;
   memcpy(&update_report, report, sizeof(update_report));
 
-  if ( dragonrise_diff_report(&prev_report[dev_addr-1][instance], &update_report) )
+  if ( dragonrise_diff_report(prev_report, &update_report) )
   {
     uint32_t buttons;
     TU_LOG1("(x1, y1, x2, y2) = (%u, %u, %u, %u)\r\n", update_report.axis0_x, update_report.axis0_y, update_report.axis1_x, update_report.axis1_y);
@@ -103,13 +103,15 @@ void process_dragonrise(uint8_t dev_addr, uint8_t instance, uint8_t const* repor
     };
     router_submit_input(&event);
 
-    prev_report[dev_addr-1][instance] = update_report;
+    *prev_report = update_report;
   }
 }
 
+HID_SLOT_CTX_CHECK(dragonrise_report_t);
+
 DeviceInterface dragonrise_interface = {
   .name = "DragonRise Generic",
-  .is_device = is_dragonrise,
+  HID_DEVICE_IDS(dragonrise_ids),
   .process = process_dragonrise,
   .task = NULL,
   .init = NULL
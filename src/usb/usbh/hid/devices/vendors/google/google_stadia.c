@@ -19,12 +19,11 @@ typedef struct {
 } stadia_device_t;
 
 static stadia_device_t stadia_devices[CFG_TUH_DEVICE_MAX + 1];
-static stadia_report_t prev_report[CFG_TUH_DEVICE_MAX + 1][CFG_TUH_HID];
 
-// Check if device is Google Stadia controller
-static bool is_google_stadia(uint16_t vid, uint16_t pid) {
-    return (vid == GOOGLE_VID && pid == STADIA_PID);
-}
+// Google Stadia controller
+static const hid_device_id_t google_stadia_ids[] = {
+    {GOOGLE_VID, STADIA_PID},
+};
 
 // Check if reports differ enough to process
 static bool diff_report_stadia(const stadia_report_t* rpt1, const stadia_report_t* rpt2) {
@@ -55,15 +54,17 @@ static bool diff_report_stadia(const stadia_report_t* rpt1, const stadia_report_
 // Initialize device on mount
 static bool init_google_stadia(uint8_t dev_addr, uint8_t instance) {
     printf("[Stadia] Device mounted: dev_addr=%d, instance=%d\n", dev_addr, instance);
-    memset(&prev_report[dev_addr][instance], 0, sizeof(stadia_report_t));
-    prev_report[dev_addr][instance].dpad = 8;  // Neutral
+    stadia_report_t* prev_report = hid_slot_ctx(dev_addr, instance);
+    if (prev_report) prev_report->dpad = 8;  // Neutral
     stadia_devices[dev_addr].instances[instance].rumble = 0;
     stadia_devices[dev_addr].instances[instance].player = 0xff;
     return true;
 }
 
 // Process input reports
-static void process_google_stadia(uint8_t dev_addr, uint8_t instance, uint8_t const* report, uint16_t len) {
+static void process_google_stadia(uint8_t dev_addr, uint8_t instance, uint8_t const* report, uint16_t len, void* ctx) {
+    stadia_report_t* prev_report = ctx;
+
     // Skip report ID if present (0x03 for input report)
     if (len == sizeof(stadia_report_t) + 1 && report[0] == 0x03) {
         report++;
@@ -75,7 +76,7 @@ static void process_google_stadia(uint8_t dev_addr, uint8_t instance, uint8_t co
     stadia_report_t stadia_report;
     memcpy(&stadia_report, report, sizeof(stadia_report_t));
 
-    if (diff_report_stadia(&prev_report[dev_addr][instance], &stadia_report)) {
+    if (diff_report_stadia(prev_report, &stadia_report)) {
         // Debug logging
         TU_LOG1("(lx, ly, rx, ry, l2, r2) = (%u, %u, %u, %u, %u, %u)\r\n",
                 stadia_report.left_x, stadia_report.left_y,
@@ -158,7 +159,7 @@ static void process_google_stadia(uint8_t dev_addr, uint8_t instance, uint8_t co
         };
         router_submit_input(&event);
 
-        prev_report[dev_addr][instance] = stadia_report;
+        *prev_report = stadia_report;
     }
 }
 
@@ -198,10 +199,12 @@ static void unmount_google_stadia(uint8_t dev_addr, uint8_t instance) {
     stadia_devices[dev_addr].instances[instance].player = 0xff;
 }
 
+HID_SLOT_CTX_CHECK(stadia_report_t);
+
 // Device interface
 DeviceInterface google_stadia_interface = {
     .name = "Google Stadia Controller",
-    .is_device = is_google_stadia,
+    HID_DEVICE_IDS(google_stadia_ids),
     .init = init_google_stadia,
     .process = process_google_stadia,
     .task = task_google_stadia,
@@ -5,11 +5,10 @@
 #include "core/input_event.h"
 
 // check if device is HORIPAD for Nintendo Switch 
-//                (or Sega Genesis mini controllers)
-bool is_hori_horipad(uint16_t vid, uint16_t pid)
-{
-  return ((vid == 0x0f0d && pid == 0x00c1)); // Switch HORI HORIPAD
-}
+// Switch HORI HORIPAD
+static const hid_device_id_t hori_horipad_ids[] = {
+  {0x0f0d, 0x00c1}, // Switch HORI HORIPAD
+};
 
 // check if 2 reports are different enough
 bool diff_report_horipad(hori_horipad_report_t const* rpt1, hori_horipad_report_t const* rpt2) {
@@ -25,15 +24,15 @@ bool diff_report_horipad(hori_horipad_report_t const* rpt1, hori_horipad_report_
 }
 
 // process usb hid input reports
-void process_hori_horipad(uint8_t dev_addr, uint8_t instance, uint8_t const* report, uint16_t len) {
+void process_hori_horipad(uint8_t dev_addr, uint8_t instance, uint8_t const* report, uint16_t len, void* ctx) {
   uint32_t buttons;
   // previous report used to compare for changes
-  static hori_horipad_report_t prev_report[5] = { 0 };
+  hori_horipad_report_t* prev_report = ctx;
 
   hori_horipad_report_t input_report;
   memcpy(&input_report, report, sizeof(input_report));
 
-  if (diff_report_horipad(&prev_report[dev_addr-1], &input_report)) {
+  if (diff_report_horipad(prev_report, &input_report)) {
     TU_LOG1("(x, y, z, rz) = (%d, %d, %d, %d) ", input_report.axis_x, input_report.axis_y, input_report.axis_z, input_report.axis_rz);
     TU_LOG1("DPad = %d ", input_report.dpad);
 
@@ -113,13 +112,15 @@ void process_hori_horipad(uint8_t dev_addr, uint8_t instance, uint8_t const* rep
     };
     router_submit_input(&event);
 
-    prev_report[dev_addr-1] = input_report;
+    *prev_report = input_report;
   }
 }
 
+HID_SLOT_CTX_CHECK(hori_horipad_report_t);
+
 DeviceInterface hori_horipad_interface = {
   .name = "HORI HORIPAD (or Genesis/MD Mini)",
-  .is_device = is_hori_horipad,
+  HID_DEVICE_IDS(hori_horipad_ids),
   .process = process_hori_horipad,
   .task = NULL,
   .init = NULL
@@ -4,10 +4,10 @@
 #include "core/router/router.h"
 #include "core/input_event.h"
 
-// check if device is HORI Pokken controller for Wii U
-static inline bool is_hori_pokken(uint16_t vid, uint16_t pid) {
-  return ((vid == 0x0f0d && pid == 0x0092)); // Wii U Pokken
-}
+// Wii U Pokken controller
+static const hid_device_id_t hori_pokken_ids[] = {
+  {0x0f0d, 0x0092}, // Wii U Pokken
+};
 
 // check if 2 reports are different enough
 bool diff_report_pokken(hori_pokken_report_t const* rpt1, hori_pokken_report_t const* rpt2) {
@@ -23,15 +23,15 @@ bool diff_report_pokken(hori_pokken_report_t const* rpt1, hori_pokken_report_t c
 }
 
 // process usb hid input reports
-void process_hori_pokken(uint8_t dev_addr, uint8_t instance, uint8_t const* report, uint16_t len) {
+void process_hori_pokken(uint8_t dev_addr, uint8_t instance, uint8_t const* report, uint16_t len, void* ctx) {
   uint32_t buttons;
   // previous report used to compare for changes
-  static hori_pokken_report_t prev_report[5][5];
+  hori_pokken_report_t* prev_report = ctx;
 
   hori_pokken_report_t update_report;
   memcpy(&update_report, report, sizeof(update_report));
 
-  if (diff_report_pokken(&prev_report[dev_addr-1][instance], &update_report)) {
+  if (diff_report_pokken(prev_report, &update_report)) {
     uint32_t buttons;
     TU_LOG1("(x, y, z, rz) = (%u, %u %u, %u)\r\n", update_report.x_axis, update_report.y_axis, update_report.z_axis, update_report.rz_axis);
     TU_LOG1("DPad = %d ", update_report.dpad);
@@ -97,13 +97,15 @@ void process_hori_pokken(uint8_t dev_addr, uint8_t instance, uint8_t const* repo
     };
     router_submit_input(&event);
 
-    prev_report[dev_addr-1][instance] = update_report;
+    *prev_report = update_report;
   }
 }
 
+HID_SLOT_CTX_CHECK(hori_pokken_report_t);
+
 DeviceInterface hori_pokken_interface = {
   .name = "HORI Pokken for Wii U",
-  .is_device = is_hori_pokken,
+  HID_DEVICE_IDS(hori_pokken_ids),
   .process = process_hori_pokken,
   .task = NULL,
   .init = NULL
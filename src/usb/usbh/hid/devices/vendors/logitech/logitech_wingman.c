@@ -4,10 +4,10 @@
 #include "core/router/router.h"
 #include "core/input_event.h"
 
-// check if device is Logitech WingMan Action controller
-static inline bool is_logitech_wingman(uint16_t vid, uint16_t pid) {
-  return ((vid == 0x046d && pid == 0xc20b)); // Logitech WingMan Action controller
-}
+// Logitech WingMan Action controller
+static const hid_device_id_t logitech_wingman_ids[] = {
+  {0x046d, 0xc20b}, // Logitech WingMan Action controller
+};
 
 // check if 2 reports are different enough
 bool diff_report_logitech_wingman(logitech_wingman_report_t const* rpt1, logitech_wingman_report_t const* rpt2) {
@@ -32,15 +32,15 @@ bool diff_report_logitech_wingman(logitech_wingman_report_t const* rpt1, logitec
 }
 
 // process usb hid input reports
-void process_logitech_wingman(uint8_t dev_addr, uint8_t instance, uint8_t const* report, uint16_t len) {
+void process_logitech_wingman(uint8_t dev_addr, uint8_t instance, uint8_t const* report, uint16_t len, void* ctx) {
   uint32_t buttons;
   // previous report used to compare for changes
-  static logitech_wingman_report_t prev_report[5] = { 0 };
+  logitech_wingman_report_t* prev_report = ctx;
 
   logitech_wingman_report_t wingman_report;
   memcpy(&wingman_report, report, sizeof(wingman_report));
 
-  if (diff_report_logitech_wingman(&prev_report[dev_addr-1], &wingman_report)) {
+  if (diff_report_logitech_wingman(prev_report, &wingman_report)) {
     TU_LOG1("(x, y, z) = (%u, %u, %u)\r\n", wingman_report.analog_x, wingman_report.analog_y, wingman_report.analog_z);
     TU_LOG1("DPad = %d ", wingman_report.dpad);
     if (wingman_report.a) TU_LOG1("A ");
@@ -114,13 +114,15 @@ void process_logitech_wingman(uint8_t dev_addr, uint8_t instance, uint8_t const*
     };
     router_submit_input(&event);
 
-    prev_report[dev_addr-1] = wingman_report;
+    *prev_report = wingman_report;
   }
 }
 
+HID_SLOT_CTX_CHECK(logitech_wingman_report_t);
+
 DeviceInterface logitech_wingman_interface = {
   .name = "Logitech WingMan Action",
-  .is_device = is_logitech_wingman,
+  HID_DEVICE_IDS(logitech_wingman_ids),
   .process = process_logitech_wingman,
   .task = NULL,
   .init = NULL
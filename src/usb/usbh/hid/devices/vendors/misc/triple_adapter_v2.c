@@ -41,15 +41,15 @@ bool diff_report_triple_adapter_v2(triple_adapter_v2_report_t const* rpt1, tripl
 }
 
 // process usb hid input reports
-void process_triple_adapter_v2(uint8_t dev_addr, uint8_t instance, uint8_t const* report, uint16_t len) {
+void process_triple_adapter_v2(uint8_t dev_addr, uint8_t instance, uint8_t const* report, uint16_t len, void* ctx) {
   uint32_t buttons;
   // previous report used to compare for changes
-  static triple_adapter_v2_report_t prev_report[5][5];
+  triple_adapter_v2_report_t* prev_report = ctx;
 
   triple_adapter_v2_report_t update_report;
   memcpy(&update_report, report, sizeof(update_report));
 
-  if (diff_report_triple_adapter_v2(&prev_report[dev_addr-1][instance], &update_report) )
+  if (diff_report_triple_adapter_v2(prev_report, &update_report) )
   {
     TU_LOG1("(x, y) = (%u, %u)\r\n", update_report.axis_x, update_report.axis_y);
     if (update_report.b) TU_LOG1("B ");
@@ -104,10 +104,12 @@ void process_triple_adapter_v2(uint8_t dev_addr, uint8_t instance, uint8_t const
     };
     router_submit_input(&event);
 
-    prev_report[dev_addr-1][instance] = update_report;
+    *prev_report = update_report;
   }
 }
 
+HID_SLOT_CTX_CHECK(triple_adapter_v2_report_t);
+
 DeviceInterface triple_adapter_v2_interface = {
   .name = "TripleController Adapter v2",
   .is_device = is_triple_adapter_v2,
@@ -6,10 +6,10 @@
 #include "core/input_event.h"
 #include "pico/time.h"
 
-// check if device is GameCube Adapter for WiiU/Switch
-static inline bool is_gamecube_adapter(uint16_t vid, uint16_t pid) {
-  return (vid == 0x057e && pid == 0x0337); // GameCube Adapter
-}
+// GameCube adapter for WiiU/Switch
+static const hid_device_id_t gamecube_adapter_ids[] = {
+  {0x057e, 0x0337}, // GameCube Adapter
+};
 
 // check if 2 reports are different enough
 bool diff_report_gamecube_adapter(gamecube_adapter_report_t const* rpt1, gamecube_adapter_report_t const* rpt2, uint8_t player) {
@@ -27,10 +27,10 @@ bool diff_report_gamecube_adapter(gamecube_adapter_report_t const* rpt1, gamecub
 }
 
 // process usb hid input reports
-void input_gamecube_adapter(uint8_t dev_addr, uint8_t instance, uint8_t const* report, uint16_t len) {
+void input_gamecube_adapter(uint8_t dev_addr, uint8_t instance, uint8_t const* report, uint16_t len, void* ctx) {
   uint32_t buttons;
-  // previous report used to compare for changes
-  static gamecube_adapter_report_t prev_report[5][4];
+  // previous report used to compare for changes, one per port
+  gamecube_adapter_report_t* prev_report = ctx;
 
   gamecube_adapter_report_t gamecube_report;
   memcpy(&gamecube_report, report, sizeof(gamecube_report));
@@ -39,7 +39,7 @@ void input_gamecube_adapter(uint8_t dev_addr, uint8_t instance, uint8_t const* r
     uint32_t buttons; // GameCube Controller Report
     for(int i = 0; i < 4; i++) {
       if (gamecube_report.port[i].connected) {
-        if (diff_report_gamecube_adapter(&prev_report[dev_addr-1][instance + i], &gamecube_report, i)) {
+        if (diff_report_gamecube_adapter(&prev_report[i], &gamecube_report, i)) {
           TU_LOG1("GAMECUBE[%d|%d]: Report ID = 0x%x\r\n", dev_addr, (instance + i), gamecube_report.report_id);
           TU_LOG1("(x, y, cx, cy, zl, zr) = (%u, %u, %u, %u, %u, %u)\r\n",
             gamecube_report.port[i].x1,
@@ -114,11 +114,11 @@ void input_gamecube_adapter(uint8_t dev_addr, uint8_t instance, uint8_t const* r
           };
           router_submit_input(&event);
 
-          prev_report[dev_addr-1][instance + i] = gamecube_report;
+          prev_report[i] = gamecube_report;
         }
-      } else if (prev_report[dev_addr-1][instance + i].port[i].connected) { // disconnected
+      } else if (prev_report[i].port[i].connected) { // disconnected
         remove_players_by_address(dev_addr, instance + i);
-        prev_report[dev_addr-1][instance + i] = gamecube_report;
+        prev_report[i] = gamecube_report;
       }
     }
   }
@@ -141,22 +141,12 @@ void output_gamecube_adapter(uint8_t dev_addr, uint8_t instance, device_output_c
   }
 }
 
-// process usb hid output reports
-void task_gamecube_adapter(uint8_t dev_addr, uint8_t instance, device_output_config_t* config) {
-  const uint32_t interval_ms = 20;
-  static uint32_t start_ms = 0;
-
-  uint32_t current_time_ms = to_ms_since_boot(get_absolute_time());
-  if (current_time_ms - start_ms >= interval_ms) {
-    start_ms = current_time_ms;
-    output_gamecube_adapter(dev_addr, instance, config);
-  }
-}
+HID_SLOT_CTX_CHECK(gamecube_adapter_report_t[4]);
 
 DeviceInterface gamecube_adapter_interface = {
   .name = "GameCube Adapter for WiiU/Switch",
-  .is_device = is_gamecube_adapter,
+  HID_DEVICE_IDS(gamecube_adapter_ids),
   .process = input_gamecube_adapter,
-  .task = task_gamecube_adapter,
+  .task = output_gamecube_adapter,
   .init = NULL
 };
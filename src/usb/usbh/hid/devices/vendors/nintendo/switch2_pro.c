@@ -74,7 +74,7 @@ typedef struct {
   bool calibrated;      // Whether we've seen enough range
 } trigger_cal_t;
 
-// Instance state
+// Per-interface context
 typedef struct {
   switch2_init_state_t state;
   uint8_t cmd_index;
@@ -95,29 +95,27 @@ typedef struct {
   uint8_t cal_samples;  // Number of samples collected for calibration
   // Trigger calibration (GameCube only)
   trigger_cal_t cal_lt, cal_rt;
-} switch2_instance_t;
-
-// Device state
-typedef struct {
-  switch2_instance_t instances[CFG_TUH_HID];
-  uint8_t instance_count;
-} switch2_device_t;
-
-static switch2_device_t switch2_devices[MAX_DEVICES] = { 0 };
+  // Bulk command buffer, per instance so several pads can init at once
+  uint8_t cmd_buf[32] CFG_TUH_MEM_ALIGN;
+} switch2_ctx_t;
 
 // Static buffers for USB operations
 static uint8_t switch2_config_buf[256] CFG_TUH_MEM_ALIGN;
-static uint8_t switch2_cmd_buf[32] CFG_TUH_MEM_ALIGN;
 static uint8_t switch2_haptic_buf[64] CFG_TUH_MEM_ALIGN;
 
+// Instance holding switch2_config_buf (dev_addr | instance << 8), 0 = free.
+// Other instances stay in FIND_ENDPOINT until it is released.
+static uint16_t switch2_config_owner = 0;
+
 // Haptic output packet counter (0x50-0x5F)
 static uint8_t haptic_counter = 0;
 
 // Check if device is Switch 2 controller (Pro or GameCube)
-// TODO: Add bcdDevice check to distinguish from Switch 1 Pro
-static bool is_switch2_pro(uint16_t vid, uint16_t pid) {
-  return (vid == 0x057e && (pid == SWITCH2_PRO_PID || pid == SWITCH2_GC_PID));
-}
+// Switch 2 Pro and GameCube controllers
+static const hid_device_id_t switch2_pro_ids[] = {
+  {0x057e, SWITCH2_PRO_PID},
+  {0x057e, SWITCH2_GC_PID},
+};
 
 // Effective stick range from center (different per controller type)
 #define STICK_RANGE_PRO      1610  // Pro Controller axis range
@@ -216,32 +214,18 @@ static const uint8_t* get_init_cmd(uint8_t index, uint8_t* len, uint8_t player_l
   }
 }
 
-// Find bulk OUT endpoint on interface 1
-static bool find_bulk_endpoint(uint8_t dev_addr, uint8_t* ep_out, uint8_t* itf_num) {
-  // Safety: check device is still mounted
-  if (!tuh_mounted(dev_addr)) {
-    printf("[SWITCH2] Device not mounted, skipping bulk endpoint search\r\n");
-    return false;
-  }
-
-  tusb_xfer_result_t result = tuh_descriptor_get_configuration_sync(
-    dev_addr, 0, switch2_config_buf, sizeof(switch2_config_buf));
-
-  if (result != XFER_RESULT_SUCCESS) {
-    printf("[SWITCH2] Failed to get config descriptor\r\n");
-    return false;
-  }
-
-  tusb_desc_configuration_t* cfg = (tusb_desc_configuration_t*)switch2_config_buf;
+// Find bulk OUT endpoint on interface 1 of a fetched config descriptor
+static bool find_bulk_endpoint(uint8_t const* desc, uint16_t desc_len, uint8_t* ep_out, uint8_t* itf_num) {
+  tusb_desc_configuration_t const* cfg = (tusb_desc_configuration_t const*)desc;
 
   // Safety: validate wTotalLength
-  if (cfg->wTotalLength > sizeof(switch2_config_buf) || cfg->wTotalLength < sizeof(tusb_desc_configuration_t)) {
+  if (cfg->wTotalLength > desc_len || cfg->wTotalLength < sizeof(tusb_desc_configuration_t)) {
     printf("[SWITCH2] Invalid config descriptor length: %d\r\n", cfg->wTotalLength);
     return false;
   }
 
-  uint8_t const* p_desc = switch2_config_buf;
-  uint8_t const* end = switch2_config_buf + cfg->wTotalLength;
+  uint8_t const* p_desc = desc;
+  uint8_t const* end = desc + cfg->wTotalLength;
 
   bool found_interface = false;
   while (p_desc < end) {
@@ -274,6 +258,57 @@ static bool find_bulk_endpoint(uint8_t dev_addr, uint8_t* ep_out, uint8_t* itf_n
   return false;
 }
 
+// Open the bulk OUT endpoint and start the init sequence, or give up on
+// rumble/LED and go straight to READY
+static void open_bulk_endpoint(uint8_t dev_addr, switch2_ctx_t* inst, uint8_t ep_out, uint8_t itf_num) {
+  tusb_desc_endpoint_t ep_desc = {
+    .bLength = sizeof(tusb_desc_endpoint_t),
+    .bDescriptorType = TUSB_DESC_ENDPOINT,
+    .bEndpointAddress = ep_out,
+    .bmAttributes = { .xfer = TUSB_XFER_BULK },
+    .wMaxPacketSize = 64,
+    .bInterval = 0
+  };
+
+  if (!tuh_edpt_open(dev_addr, &ep_desc)) {
+    printf("[SWITCH2] Failed to open endpoint 0x%02X - rumble/LED disabled\r\n", ep_out);
+    inst->state = SWITCH2_STATE_READY;
+    return;
+  }
+
+  printf("[SWITCH2] Opened bulk OUT endpoint 0x%02X\r\n", ep_out);
+  inst->ep_out = ep_out;
+  inst->itf_num = itf_num;
+  inst->state = SWITCH2_STATE_INIT_SEQUENCE;
+}
+
+// Config descriptor fetch complete
+static void config_xfer_complete_cb(tuh_xfer_t* xfer) {
+  uint8_t dev_addr = (uint8_t)(xfer->user_data & 0xFF);
+  uint8_t instance = (uint8_t)((xfer->user_data >> 8) & 0xFF);
+
+  if (switch2_config_owner != (uint16_t)xfer->user_data) {
+    return;  // Owner unmounted while the transfer was in flight
+  }
+  switch2_config_owner = 0;
+
+  switch2_ctx_t* inst = hid_slot_ctx(dev_addr, instance);
+  if (!inst || inst->state != SWITCH2_STATE_WAIT_CONFIG) {
+    return;
+  }
+
+  uint8_t ep_out = 0, itf_num = 0;
+  if (xfer->result != XFER_RESULT_SUCCESS) {
+    printf("[SWITCH2] Failed to get config descriptor\r\n");
+  } else if (find_bulk_endpoint(switch2_config_buf, xfer->actual_len, &ep_out, &itf_num)) {
+    open_bulk_endpoint(dev_addr, inst, ep_out, itf_num);
+    return;
+  }
+
+  printf("[SWITCH2] No bulk endpoint - rumble/LED disabled\r\n");
+  inst->state = SWITCH2_STATE_READY;
+}
+
 // Bulk transfer complete callback (for async transfers)
 static void bulk_xfer_complete_cb(tuh_xfer_t* xfer) {
   // Mark transfer as complete - the task function checks xfer_pending
@@ -286,23 +321,24 @@ static void bulk_xfer_complete_cb(tuh_xfer_t* xfer) {
     return;
   }
 
-  if (dev_addr < MAX_DEVICES && instance < CFG_TUH_HID) {
-    // Safety: check if device is still valid (ep_out != 0 means initialized)
-    switch2_instance_t* inst = &switch2_devices[dev_addr].instances[instance];
-    if (inst->ep_out != 0) {
-      inst->xfer_pending = false;
-    }
+  // Safety: check if device is still valid (ep_out != 0 means initialized)
+  switch2_ctx_t* inst = hid_slot_ctx(dev_addr, instance);
+  if (inst && inst->ep_out != 0) {
+    inst->xfer_pending = false;
   }
 }
 
 // Send command via bulk transfer (async)
 static bool send_command(uint8_t dev_addr, uint8_t instance, uint8_t ep_out, const uint8_t* cmd, uint8_t len) {
-  memcpy(switch2_cmd_buf, cmd, len);
+  switch2_ctx_t* inst = hid_slot_ctx(dev_addr, instance);
+  if (!inst) return false;
+  uint8_t* buf = inst->cmd_buf;
+  memcpy(buf, cmd, len);
 
   tuh_xfer_t xfer = {
     .daddr = dev_addr,
     .ep_addr = ep_out,
-    .buffer = switch2_cmd_buf,
+    .buffer = buf,
     .buflen = len,
     .complete_cb = bulk_xfer_complete_cb,
     .user_data = dev_addr | (instance << 8)
@@ -312,7 +348,7 @@ static bool send_command(uint8_t dev_addr, uint8_t instance, uint8_t ep_out, con
 }
 
 // Process input reports
-void input_switch2_pro(uint8_t dev_addr, uint8_t instance, uint8_t const* report, uint16_t len) {
+void input_switch2_pro(uint8_t dev_addr, uint8_t instance, uint8_t const* report, uint16_t len, void* ctx) {
   if (len < 12) return;
 
   uint8_t report_id = report[0];
@@ -323,7 +359,7 @@ void input_switch2_pro(uint8_t dev_addr, uint8_t instance, uint8_t const* report
     return;
   }
 
-  switch2_instance_t* inst = &switch2_devices[dev_addr].instances[instance];
+  switch2_ctx_t* inst = ctx;
   switch2_pro_report_t rpt;
   memcpy(&rpt, report, sizeof(rpt) < len ? sizeof(rpt) : len);
 
@@ -464,7 +500,8 @@ void input_switch2_pro(uint8_t dev_addr, uint8_t instance, uint8_t const* report
 #define HAPTIC_INTERVAL_MS 50
 
 static void output_rumble(uint8_t dev_addr, uint8_t instance, uint8_t rumble_left, uint8_t rumble_right) {
-  switch2_instance_t* inst = &switch2_devices[dev_addr].instances[instance];
+  switch2_ctx_t* inst = hid_slot_ctx(dev_addr, instance);
+  if (!inst) return;
   uint32_t now = to_ms_since_boot(get_absolute_time());
 
   // Check if we need to send:
@@ -540,7 +577,8 @@ static void output_rumble(uint8_t dev_addr, uint8_t instance, uint8_t rumble_lef
 // Re-run full init sequence on player assignment
 // This fixes haptics not working after fresh power cycle
 static void reinit_on_player_assign(uint8_t dev_addr, uint8_t instance) {
-  switch2_instance_t* inst = &switch2_devices[dev_addr].instances[instance];
+  switch2_ctx_t* inst = hid_slot_ctx(dev_addr, instance);
+  if (!inst) return;
 
   // Check endpoint is valid
   if (inst->ep_out == 0) {
@@ -562,7 +600,8 @@ static void reinit_on_player_assign(uint8_t dev_addr, uint8_t instance) {
 // GameCube: via HID output report (report ID 0x03)
 // LED command format: [0x09, 0x91, 0x00, 0x07, 0x00, 0x08, 0x00, 0x00, pattern, ...]
 static void output_player_led(uint8_t dev_addr, uint8_t instance, uint8_t player_index) {
-  switch2_instance_t* inst = &switch2_devices[dev_addr].instances[instance];
+  switch2_ctx_t* inst = hid_slot_ctx(dev_addr, instance);
+  if (!inst) return;
 
   // On first player assignment, re-run full init sequence
   // This fixes rumble not working after fresh power cycle
@@ -617,7 +656,8 @@ static void output_player_led(uint8_t dev_addr, uint8_t instance, uint8_t player
 
 // Task function - handles initialization state machine and output
 void task_switch2_pro(uint8_t dev_addr, uint8_t instance, device_output_config_t* config) {
-  switch2_instance_t* inst = &switch2_devices[dev_addr].instances[instance];
+  switch2_ctx_t* inst = hid_slot_ctx(dev_addr, instance);
+  if (!inst) return;
 
   // Debug: trace rumble calls
   if (config->rumble_left || config->rumble_right) {
@@ -640,35 +680,26 @@ void task_switch2_pro(uint8_t dev_addr, uint8_t instance, device_output_config_t
       return;
     }
 
-    printf("[SWITCH2] Deferred init: finding bulk endpoint...\r\n");
-
-    uint8_t ep_out = 0, itf_num = 0;
-    if (!find_bulk_endpoint(dev_addr, &ep_out, &itf_num)) {
-      printf("[SWITCH2] No bulk endpoint - rumble/LED disabled\r\n");
-      inst->state = SWITCH2_STATE_READY;
+    // Descriptor buffer is shared; queue behind another pad's fetch
+    if (switch2_config_owner != 0) {
       return;
     }
 
-    // Open endpoint
-    tusb_desc_endpoint_t ep_desc = {
-      .bLength = sizeof(tusb_desc_endpoint_t),
-      .bDescriptorType = TUSB_DESC_ENDPOINT,
-      .bEndpointAddress = ep_out,
-      .bmAttributes = { .xfer = TUSB_XFER_BULK },
-      .wMaxPacketSize = 64,
-      .bInterval = 0
-    };
-
-    if (!tuh_edpt_open(dev_addr, &ep_desc)) {
-      printf("[SWITCH2] Failed to open endpoint 0x%02X - rumble/LED disabled\r\n", ep_out);
-      inst->state = SWITCH2_STATE_READY;
+    // Safety: check device is still mounted
+    if (!tuh_mounted(dev_addr)) {
       return;
     }
 
-    printf("[SWITCH2] Opened bulk OUT endpoint 0x%02X\r\n", ep_out);
-    inst->ep_out = ep_out;
-    inst->itf_num = itf_num;
-    inst->state = SWITCH2_STATE_INIT_SEQUENCE;
+    printf("[SWITCH2] Deferred init: finding bulk endpoint...\r\n");
+
+    switch2_config_owner = dev_addr | (instance << 8);
+    inst->state = SWITCH2_STATE_WAIT_CONFIG;
+    if (!tuh_descriptor_get_configuration(dev_addr, 0, switch2_config_buf, sizeof(switch2_config_buf),
+                                          config_xfer_complete_cb, switch2_config_owner)) {
+      // Control pipe busy, retry next pass
+      switch2_config_owner = 0;
+      inst->state = SWITCH2_STATE_FIND_ENDPOINT;
+    }
     return;
   }
 
@@ -734,8 +765,8 @@ static bool init_switch2_pro(uint8_t dev_addr, uint8_t instance) {
   const char* type_str = (pid == SWITCH2_GC_PID) ? "GameCube" : "Pro";
   printf("[SWITCH2] Init %s dev=%d instance=%d (PID=0x%04X)\r\n", type_str, dev_addr, instance, pid);
 
-  switch2_instance_t* inst = &switch2_devices[dev_addr].instances[instance];
-  memset(inst, 0, sizeof(*inst));
+  switch2_ctx_t* inst = hid_slot_ctx(dev_addr, instance);
+  if (!inst) return false;
 
   // Store PID to identify controller type
   inst->pid = pid;
@@ -751,8 +782,6 @@ static bool init_switch2_pro(uint8_t dev_addr, uint8_t instance) {
   inst->cal_rt.min = 255;
   inst->cal_rt.max = 0;
 
-  switch2_devices[dev_addr].instance_count++;
-
   // Defer bulk endpoint init - do it in task() after device is fully ready
   // This avoids crashes on PIO USB when accessing config descriptor too early
   inst->state = SWITCH2_STATE_FIND_ENDPOINT;
@@ -765,24 +794,26 @@ static bool init_switch2_pro(uint8_t dev_addr, uint8_t instance) {
 void unmount_switch2_pro(uint8_t dev_addr, uint8_t instance) {
   printf("[SWITCH2] Unmount dev=%d instance=%d\r\n", dev_addr, instance);
 
-  // Clear ep_out first to signal to callbacks that device is gone
-  // This prevents the bulk_xfer_complete_cb from accessing stale state
-  switch2_devices[dev_addr].instances[instance].ep_out = 0;
-  switch2_devices[dev_addr].instances[instance].state = SWITCH2_STATE_IDLE;
-
-  // Now safe to clear the rest
-  memset(&switch2_devices[dev_addr].instances[instance], 0, sizeof(switch2_instance_t));
-
-  if (switch2_devices[dev_addr].instance_count > 0) {
-    switch2_devices[dev_addr].instance_count--;
+  // The context is freed after this returns; in-flight transfers find the
+  // slot gone (or ep_out cleared) and drop their completions
+  switch2_ctx_t* inst = hid_slot_ctx(dev_addr, instance);
+  if (inst) {
+    inst->ep_out = 0;
+    inst->state = SWITCH2_STATE_IDLE;
+  }
+  if (switch2_config_owner == (dev_addr | (instance << 8))) {
+    switch2_config_owner = 0;
   }
 }
 
+HID_SLOT_CTX_CHECK(switch2_ctx_t);
+
 DeviceInterface switch2_pro_interface = {
   .name = "Switch 2 Pro",
-  .is_device = is_switch2_pro,
+  HID_DEVICE_IDS(switch2_pro_ids),
   .init = init_switch2_pro,
   .process = input_switch2_pro,
   .task = task_switch2_pro,
+  .task_poll_ms = 2,
   .unmount = unmount_switch2_pro,
 };
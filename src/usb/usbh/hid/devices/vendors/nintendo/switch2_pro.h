@@ -16,6 +16,7 @@
 typedef enum {
   SWITCH2_STATE_IDLE = 0,
   SWITCH2_STATE_FIND_ENDPOINT,
+  SWITCH2_STATE_WAIT_CONFIG,
   SWITCH2_STATE_INIT_SEQUENCE,
   SWITCH2_STATE_READY,
   SWITCH2_STATE_FAILED
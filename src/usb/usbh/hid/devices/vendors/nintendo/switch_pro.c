@@ -11,9 +11,10 @@ typedef struct {
   uint16_t center;      // Calibrated center value
 } stick_cal_t;
 
-// Switch instance state
-typedef struct TU_ATTR_PACKED
+// Per-interface context
+typedef struct
 {
+  switch_pro_report_t prev_report;  // Previous report, to compare for changes
   bool conn_ack;
   bool baud;
   bool baud_ack;
@@ -25,29 +26,25 @@ typedef struct TU_ATTR_PACKED
   bool full_report_enabled;
   bool imu_enabled;
   bool command_ack;
+  bool is_pro;
+  bool detached;            // Disconnect event seen, left out of Joy-Con Grip merging
   uint8_t rumble_left;
   uint8_t rumble_right;
-  uint8_t player_led_set;
+  uint8_t output_sequence;  // Low 4 bits count every rumble/subcommand report
+  int16_t player_led_set;   // Player index the LEDs show, -1 = unassigned, 0xFF = none sent
+  uint32_t next_cmd_ms;     // Init subcommands are held off until this time
   // Stick calibration (captured on first reports assuming sticks at rest)
   stick_cal_t cal_lx, cal_ly, cal_rx, cal_ry;
   uint8_t cal_samples;
-} switch_instance_t;
-
-// Cached device report properties on mount
-typedef struct
-{
-  switch_instance_t instances[CFG_TUH_HID];
-  uint8_t instance_count;
-  uint8_t instance_root;
-  bool is_pro;
 
-  // Joy-Con Grip merging state (for instance_count > 1)
+  // Joy-Con Grip merging state, used in the root (lowest attached) instance
   input_event_t merged_event;        // Combined input from both Joy-Cons
   bool left_updated;                 // Left Joy-Con has reported
   bool right_updated;                // Right Joy-Con has reported
-} switch_device_t;
+} switch_ctx_t;
 
-static switch_device_t switch_devices[MAX_DEVICES] = { 0 };
+// Settle time the controller needs after each init subcommand
+#define SWITCH_INIT_CMD_GAP_MS 100
 
 // Encode HD Rumble data for one motor (4 bytes)
 // Format from OGX-Mini (working implementation):
@@ -80,15 +77,12 @@ static void encode_rumble(uint8_t intensity, uint8_t* out) {
   out[3] = 0x61;            // LF freq constant
 }
 
-// check if device is Nintendo Switch
-static inline bool is_switch_pro(uint16_t vid, uint16_t pid)
-{
-  return ((vid == 0x057e && (
-           pid == 0x2009 || // Nintendo Switch Pro
-           pid == 0x200e || // JoyCon Charge Grip
-           pid == 0x2017    // SNES Controller (NSO)
-  )));
-}
+// devices handled as Switch Pro
+static const hid_device_id_t switch_pro_ids[] = {
+  {0x057e, 0x2009}, // Nintendo Switch Pro
+  {0x057e, 0x200e}, // JoyCon Charge Grip
+  {0x057e, 0x2017}, // SNES Controller (NSO)
+};
 
 // check if 2 reports are different enough
 bool diff_report_switch_pro(switch_pro_report_t const* rpt1, switch_pro_report_t const* rpt2)
@@ -131,40 +125,41 @@ static uint8_t scale_analog_calibrated(uint16_t val, uint16_t center) {
   return (uint8_t)(scaled + 128);
 }
 
-// resets default values in case devices are hotswapped
-void unmount_switch_pro(uint8_t dev_addr, uint8_t instance)
+// restarts the init handshake after the controller reports a disconnect
+static void reset_switch_pro(uint8_t dev_addr, uint8_t instance, switch_ctx_t* sw)
 {
-  TU_LOG1("SWITCH[%d|%d]: Unmount Reset\r\n", dev_addr, instance);
-  switch_devices[dev_addr].instances[instance].conn_ack = false;
-  switch_devices[dev_addr].instances[instance].baud = false;
-  switch_devices[dev_addr].instances[instance].baud_ack = false;
-  switch_devices[dev_addr].instances[instance].handshake = false;
-  switch_devices[dev_addr].instances[instance].handshake_ack = false;
-  switch_devices[dev_addr].instances[instance].usb_enable = false;
-  switch_devices[dev_addr].instances[instance].usb_enable_ack = false;
-  switch_devices[dev_addr].instances[instance].home_led_set = false;
-  switch_devices[dev_addr].instances[instance].command_ack = true;
-  switch_devices[dev_addr].instances[instance].full_report_enabled = false;
-  switch_devices[dev_addr].instances[instance].imu_enabled = false;
-  switch_devices[dev_addr].instances[instance].rumble_left = 0;
-  switch_devices[dev_addr].instances[instance].rumble_right = 0;
-  switch_devices[dev_addr].instances[instance].player_led_set = 0xff;
-  switch_devices[dev_addr].is_pro = false;
-
-  if (switch_devices[dev_addr].instance_count > 1) {
-    switch_devices[dev_addr].instance_count--;
-  } else {
-    switch_devices[dev_addr].instance_count = 0;
-  }
+  TU_LOG1("SWITCH[%d|%d]: Disconnect Reset\r\n", dev_addr, instance);
+  sw->conn_ack = false;
+  sw->baud = false;
+  sw->baud_ack = false;
+  sw->handshake = false;
+  sw->handshake_ack = false;
+  sw->usb_enable = false;
+  sw->usb_enable_ack = false;
+  sw->home_led_set = false;
+  sw->command_ack = true;
+  sw->full_report_enabled = false;
+  sw->imu_enabled = false;
+  sw->rumble_left = 0;
+  sw->rumble_right = 0;
+  sw->player_led_set = 0xff;
+  sw->next_cmd_ms = 0;
+  sw->detached = true;
+}
 
-  // if (switch_devices[dev_addr].instance_count == 1 &&
-  //     switch_devices[dev_addr].instance_root == instance) {
-  //   if (switch_devices[dev_addr].instance_root == 1) {
-  //     switch_devices[dev_addr].instance_root = 0;
-  //   } else {
-  //     switch_devices[dev_addr].instance_root = 1;
-  //   }
-  // }
+// Root context of dev_addr's attached instances and how many there are.
+// A Joy-Con Grip mounts one instance per Joy-Con; they merge into the root.
+static switch_ctx_t* switch_root(uint8_t dev_addr, uint8_t* count)
+{
+  switch_ctx_t* root = NULL;
+  *count = 0;
+  for (uint8_t i = 0; i < CFG_TUH_HID; i++) {
+    switch_ctx_t* sw = hid_slot_ctx(dev_addr, i);
+    if (!sw || sw->detached) continue;
+    if (!root) root = sw;
+    (*count)++;
+  }
+  return root;
 }
 
 // prints raw switch pro input report byte data
@@ -178,18 +173,18 @@ void print_report_switch_pro(switch_pro_report_01_t* report, uint32_t length)
 }
 
 // process usb hid input reports
-void input_report_switch_pro(uint8_t dev_addr, uint8_t instance, uint8_t const* report, uint16_t len)
+void input_report_switch_pro(uint8_t dev_addr, uint8_t instance, uint8_t const* report, uint16_t len, void* ctx)
 {
   uint32_t buttons;
-  // previous report used to compare for changes
-  static switch_pro_report_t prev_report[5][5];
+  switch_ctx_t* sw = ctx;
+  switch_pro_report_t* prev_report = &sw->prev_report;
 
   switch_pro_report_t update_report;
   memcpy(&update_report, report, sizeof(update_report));
 
   if (update_report.report_id == 0x30) // Switch Controller Report
   {
-    switch_devices[dev_addr].instances[instance].usb_enable_ack = true;
+    sw->usb_enable_ack = true;
 
     update_report.left_x = (update_report.left_stick[0] & 0xFF) | ((update_report.left_stick[1] & 0x0F) << 8);
     update_report.left_y = ((update_report.left_stick[1] & 0xF0) >> 4) | ((update_report.left_stick[2] & 0xFF) << 4);
@@ -197,32 +192,31 @@ void input_report_switch_pro(uint8_t dev_addr, uint8_t instance, uint8_t const*
     update_report.right_y = ((update_report.right_stick[1] & 0xF0) >> 4) | ((update_report.right_stick[2] & 0xFF) << 4);
 
     // Auto-calibrate center on first reports (Pro controllers only, assumes sticks at rest)
-    switch_instance_t* inst = &switch_devices[dev_addr].instances[instance];
-    if (switch_devices[dev_addr].is_pro && inst->cal_samples < CAL_SAMPLES_NEEDED) {
-      if (inst->cal_samples == 0) {
-        inst->cal_lx.center = update_report.left_x;
-        inst->cal_ly.center = update_report.left_y;
-        inst->cal_rx.center = update_report.right_x;
-        inst->cal_ry.center = update_report.right_y;
+    if (sw->is_pro && sw->cal_samples < CAL_SAMPLES_NEEDED) {
+      if (sw->cal_samples == 0) {
+        sw->cal_lx.center = update_report.left_x;
+        sw->cal_ly.center = update_report.left_y;
+        sw->cal_rx.center = update_report.right_x;
+        sw->cal_ry.center = update_report.right_y;
       } else {
-        inst->cal_lx.center = (inst->cal_lx.center + update_report.left_x) / 2;
-        inst->cal_ly.center = (inst->cal_ly.center + update_report.left_y) / 2;
-        inst->cal_rx.center = (inst->cal_rx.center + update_report.right_x) / 2;
-        inst->cal_ry.center = (inst->cal_ry.center + update_report.right_y) / 2;
+        sw->cal_lx.center = (sw->cal_lx.center + update_report.left_x) / 2;
+        sw->cal_ly.center = (sw->cal_ly.center + update_report.left_y) / 2;
+        sw->cal_rx.center = (sw->cal_rx.center + update_report.right_x) / 2;
+        sw->cal_ry.center = (sw->cal_ry.center + update_report.right_y) / 2;
       }
-      inst->cal_samples++;
+      sw->cal_samples++;
 
-      if (inst->cal_samples >= CAL_SAMPLES_NEEDED) {
+      if (sw->cal_samples >= CAL_SAMPLES_NEEDED) {
         TU_LOG1("SWITCH[%d|%d]: Calibrated centers: L(%u,%u) R(%u,%u)\r\n",
                dev_addr, instance,
-               inst->cal_lx.center, inst->cal_ly.center,
-               inst->cal_rx.center, inst->cal_ry.center);
+               sw->cal_lx.center, sw->cal_ly.center,
+               sw->cal_rx.center, sw->cal_ry.center);
       }
-      prev_report[dev_addr-1][instance] = update_report;
+      *prev_report = update_report;
       return;  // Skip input during calibration
     }
 
-    if (diff_report_switch_pro(&prev_report[dev_addr-1][instance], &update_report))
+    if (diff_report_switch_pro(prev_report, &update_report))
     {
       TU_LOG1("SWITCH[%d|%d]: Report ID = 0x%x\r\n", dev_addr, instance, update_report.report_id);
       TU_LOG1("(lx, ly, rx, ry) = (%u, %u, %u, %u)\r\n", update_report.left_x, update_report.left_y, update_report.right_x, update_report.right_y);
@@ -273,12 +267,12 @@ void input_report_switch_pro(uint8_t dev_addr, uint8_t instance, uint8_t const*
       uint8_t rightX = 0;
       uint8_t rightY = 0;
 
-      if (switch_devices[dev_addr].is_pro) {
+      if (sw->is_pro) {
         // Use calibrated scaling for Pro controllers
-        leftX = scale_analog_calibrated(update_report.left_x, inst->cal_lx.center);
-        leftY = 255 - scale_analog_calibrated(update_report.left_y, inst->cal_ly.center);   // Invert Y
-        rightX = scale_analog_calibrated(update_report.right_x, inst->cal_rx.center);
-        rightY = 255 - scale_analog_calibrated(update_report.right_y, inst->cal_ry.center); // Invert Y
+        leftX = scale_analog_calibrated(update_report.left_x, sw->cal_lx.center);
+        leftY = 255 - scale_analog_calibrated(update_report.left_y, sw->cal_ly.center);   // Invert Y
+        rightX = scale_analog_calibrated(update_report.right_x, sw->cal_rx.center);
+        rightY = 255 - scale_analog_calibrated(update_report.right_y, sw->cal_ry.center); // Invert Y
       } else {
         bool is_left_joycon = (!update_report.right_x && !update_report.right_y);
         bool is_right_joycon = (!update_report.left_x && !update_report.left_y);
@@ -326,16 +320,18 @@ void input_report_switch_pro(uint8_t dev_addr, uint8_t instance, uint8_t const*
                  ((bttn_a2)              ? JP_BUTTON_A2 : 0));
 
       // Joy-Con Grip merging: combine both Joy-Con inputs into one controller
-      if (switch_devices[dev_addr].instance_count > 1) {
+      uint8_t instance_count;
+      switch_ctx_t* root = switch_root(dev_addr, &instance_count);
+      if (instance_count > 1) {
         // Multi-instance device (Joy-Con Grip) - merge before submitting
         bool is_left_joycon = (!update_report.right_x && !update_report.right_y);
         bool is_right_joycon = (!update_report.left_x && !update_report.left_y);
 
         if (is_left_joycon) {
           // Update left Joy-Con portion of merged event
-          switch_devices[dev_addr].merged_event.dev_addr = dev_addr;
-          switch_devices[dev_addr].merged_event.instance = 0;  // Merged instance
-          switch_devices[dev_addr].merged_event.type = INPUT_TYPE_GAMEPAD;
+          root->merged_event.dev_addr = dev_addr;
+          root->merged_event.instance = 0;  // Merged instance
+          root->merged_event.type = INPUT_TYPE_GAMEPAD;
 
           // Left Joy-Con: D-pad, left stick, L buttons
           uint32_t left_buttons = (((dpad_up)   ? JP_BUTTON_DU : 0) |
@@ -347,16 +343,16 @@ void input_report_switch_pro(uint8_t dev_addr, uint8_t instance, uint8_t const*
                                    ((update_report.lstick) ? JP_BUTTON_L3 : 0) |
                                    ((bttn_s1)   ? JP_BUTTON_S1 : 0));  // Minus button
 
-          switch_devices[dev_addr].merged_event.buttons |= left_buttons;
-          switch_devices[dev_addr].merged_event.analog[0] = leftX;  // Left stick X
-          switch_devices[dev_addr].merged_event.analog[1] = leftY;  // Left stick Y
-          switch_devices[dev_addr].left_updated = true;
+          root->merged_event.buttons |= left_buttons;
+          root->merged_event.analog[0] = leftX;  // Left stick X
+          root->merged_event.analog[1] = leftY;  // Left stick Y
+          root->left_updated = true;
         }
         else if (is_right_joycon) {
           // Update right Joy-Con portion of merged event
-          switch_devices[dev_addr].merged_event.dev_addr = dev_addr;
-          switch_devices[dev_addr].merged_event.instance = 0;  // Merged instance
-          switch_devices[dev_addr].merged_event.type = INPUT_TYPE_GAMEPAD;
+          root->merged_event.dev_addr = dev_addr;
+          root->merged_event.instance = 0;  // Merged instance
+          root->merged_event.type = INPUT_TYPE_GAMEPAD;
 
           // Right Joy-Con: Face buttons, right stick, R buttons
           uint32_t right_buttons = (((bttn_b1) ? JP_BUTTON_B1 : 0) |
@@ -370,20 +366,20 @@ void input_report_switch_pro(uint8_t dev_addr, uint8_t instance, uint8_t const*
                                     ((bttn_a1) ? JP_BUTTON_A1 : 0) |  // Home button
                                     ((bttn_a2) ? JP_BUTTON_A2 : 0));  // Capture button
 
-          switch_devices[dev_addr].merged_event.buttons |= right_buttons;
-          switch_devices[dev_addr].merged_event.analog[2] = rightX;  // Right stick X
-          switch_devices[dev_addr].merged_event.analog[3] = rightY;  // Right stick Y
-          switch_devices[dev_addr].right_updated = true;
+          root->merged_event.buttons |= right_buttons;
+          root->merged_event.analog[2] = rightX;  // Right stick X
+          root->merged_event.analog[3] = rightY;  // Right stick Y
+          root->right_updated = true;
         }
 
         // Submit merged event only when BOTH Joy-Cons have reported
-        if (switch_devices[dev_addr].left_updated && switch_devices[dev_addr].right_updated) {
-          router_submit_input(&switch_devices[dev_addr].merged_event);
+        if (root->left_updated && root->right_updated) {
+          router_submit_input(&root->merged_event);
 
           // Reset merge state for next frame
-          switch_devices[dev_addr].left_updated = false;
-          switch_devices[dev_addr].right_updated = false;
-          switch_devices[dev_addr].merged_event.buttons = 0x00000000;  // All released
+          root->left_updated = false;
+          root->right_updated = false;
+          root->merged_event.buttons = 0x00000000;  // All released
         }
       } else {
         // Single instance device (normal Switch Pro controller)
@@ -403,7 +399,7 @@ void input_report_switch_pro(uint8_t dev_addr, uint8_t instance, uint8_t const*
         router_submit_input(&event);
       }
 
-      prev_report[dev_addr-1][instance] = update_report;
+      *prev_report = update_report;
 
     }
   }
@@ -415,23 +411,24 @@ void input_report_switch_pro(uint8_t dev_addr, uint8_t instance, uint8_t const*
     // JC_INPUT_USB_RESPONSE (connection events & command acknowledgments)
     if (state_report.buf[0] == 0x81 && state_report.buf[1] == 0x01) { // JC_USB_CMD_CONN_STATUS
       if (state_report.buf[2] == 0x00) { // connect
-        switch_devices[dev_addr].instances[instance].conn_ack = true;
+        sw->conn_ack = true;
+        sw->detached = false;
       } else if (state_report.buf[2] == 0x03) { // disconnect
-        unmount_switch_pro(dev_addr, instance);
+        reset_switch_pro(dev_addr, instance, sw);
         remove_players_by_address(dev_addr, instance);
       }
     }
     else if (state_report.buf[0] == 0x81 && state_report.buf[1] == 0x02) { // JC_USB_CMD_HANDSHAKE
-      switch_devices[dev_addr].instances[instance].handshake_ack = true;
+      sw->handshake_ack = true;
     }
     else if (state_report.buf[0] == 0x81 && state_report.buf[1] == 0x03) { // JC_USB_CMD_BAUDRATE_3M
-      switch_devices[dev_addr].instances[instance].baud_ack = true;
+      sw->baud_ack = true;
     }
     else if (state_report.buf[0] == 0x81 && state_report.buf[1] == 0x92) { // command ack
-      switch_devices[dev_addr].instances[instance].command_ack = true;
+      sw->command_ack = true;
     }
     else if (state_report.buf[0] == 0x21) {
-      switch_devices[dev_addr].instances[instance].command_ack = true;
+      sw->command_ack = true;
     }
 
     TU_LOG1("SWITCH[%d|%d]: Report ID = 0x%x\r\n", dev_addr, instance, state_report.data.report_id);
@@ -449,50 +446,59 @@ void input_report_switch_pro(uint8_t dev_addr, uint8_t instance, uint8_t const*
 // process usb hid output reports
 void output_switch_pro(uint8_t dev_addr, uint8_t instance, device_output_config_t* config)
 {
-  static uint8_t output_sequence_counter = 0;
   // Nintendo Switch Pro/JoyCons Charging Grip initialization and subcommands (config->rumble|config->leds)
   // See: https://github.com/Dan611/hid-procon/
   //      https://github.com/felis/USB_Host_Shield_2.0/
   //      https://github.com/nicman23/dkms-hid-nintendo/
   //      https://github.com/dekuNukem/Nintendo_Switch_Reverse_Engineering/blob/master/USB-HID-Notes.md
 
-  if (true/*switch_devices[dev_addr].instances[instance].conn_ack*/) // bug fix for 3rd-party ctrls?
+  switch_ctx_t* sw = hid_slot_ctx(dev_addr, instance);
+  if (!sw) return;
+
+  // Pacing between init subcommands is per instance, so a hub full of pads
+  // runs its handshakes side by side instead of sleeping the whole USB task
+  uint32_t now_ms = to_ms_since_boot(get_absolute_time());
+  if ((int32_t)(now_ms - sw->next_cmd_ms) < 0) {
+    return;
+  }
+
+  if (true/*sw->conn_ack*/) // bug fix for 3rd-party ctrls?
   {
     // set the faster baud rate
-    // if (!switch_devices[dev_addr].instances[instance].baud) {
+    // if (!sw->baud) {
     //   TU_LOG1("SWITCH[%d|%d]: CMD_HID, USB_BAUD\r\n", dev_addr, instance);
 
     //   uint8_t baud_command[2] = {CMD_HID, SUBCMD_USB_BAUD};
 
-    //   switch_devices[dev_addr].instances[instance].baud = 
+    //   sw->baud = 
     //    tuh_hid_send_report(dev_addr, instance, 0, baud_command, sizeof(baud_command));
 
     // // wait for baud ask and then send init handshake
-    // } else if (!switch_devices[dev_addr].instances[instance].handshake && switch_devices[dev_addr].instances[instance].baud_ack) {
-    if (!switch_devices[dev_addr].instances[instance].handshake) {
+    // } else if (!sw->handshake && sw->baud_ack) {
+    if (!sw->handshake) {
       TU_LOG1("SWITCH[%d|%d]: CMD_HID, HANDSHAKE\r\n", dev_addr, instance);
 
       uint8_t handshake_command[2] = {CMD_HID, SUBCMD_HANDSHAKE};
 
-      switch_devices[dev_addr].instances[instance].handshake =
+      sw->handshake =
         tuh_hid_send_report(dev_addr, instance, 0, handshake_command, sizeof(handshake_command));
 
       tuh_hid_receive_report(dev_addr, instance);
 
     // wait for handshake ack and then send USB enable mode
-    } else if (!switch_devices[dev_addr].instances[instance].usb_enable && switch_devices[dev_addr].instances[instance].handshake_ack) {
+    } else if (!sw->usb_enable && sw->handshake_ack) {
       TU_LOG1("SWITCH[%d|%d]: CMD_HID, DISABLE_TIMEOUT\r\n", dev_addr, instance);
 
       uint8_t disable_timeout_cmd[2] = {CMD_HID, SUBCMD_DISABLE_TIMEOUT};
 
-      switch_devices[dev_addr].instances[instance].usb_enable =
+      sw->usb_enable =
         tuh_hid_send_report(dev_addr, instance, 0, disable_timeout_cmd, sizeof(disable_timeout_cmd));
 
-      sleep_ms(100);
+      sw->next_cmd_ms = now_ms + SWITCH_INIT_CMD_GAP_MS;
       tuh_hid_receive_report(dev_addr, instance);
 
     // wait for usb enabled acknowledgment
-    } else if (switch_devices[dev_addr].instances[instance].usb_enable) {
+    } else if (sw->usb_enable) {
 
       uint8_t report[14] = { 0 };
       uint8_t report_size = 10;
@@ -500,12 +506,12 @@ void output_switch_pro(uint8_t dev_addr, uint8_t instance, device_output_config_
       report[0x00] = CMD_RUMBLE_ONLY; // COMMAND
        // Lowest 4-bit is a sequence number, which needs to be increased for every report
 
-      if (!switch_devices[dev_addr].instances[instance].home_led_set) {
+      if (!sw->home_led_set) {
         TU_LOG1("SWITCH[%d|%d]: CMD_AND_RUMBLE, CMD_LED_HOME \r\n", dev_addr, instance);
         
         report_size = 14;
 
-        report[0x01] = output_sequence_counter++;
+        report[0x01] = sw->output_sequence++;
         report[0x00] = CMD_AND_RUMBLE;   // COMMAND
         report[0x0A + 0] = CMD_LED_HOME; // SUB_COMMAND
         
@@ -517,25 +523,25 @@ void output_switch_pro(uint8_t dev_addr, uint8_t instance, device_output_config_
         // It is possible set up to 15 mini cycles, but we simply just set the LED constantly on after momentary off.
         // See: https://github.com/dekuNukem/Nintendo_Switch_Reverse_Engineering/blob/master/bluetooth_hid_subcommands_notes.md#subcommand-0x38-set-home-light
 
-        switch_devices[dev_addr].instances[instance].home_led_set = true;
+        sw->home_led_set = true;
         tuh_hid_send_report(dev_addr, instance, 0, report, report_size);
-        sleep_ms(100);
+        sw->next_cmd_ms = now_ms + SWITCH_INIT_CMD_GAP_MS;
 
-      } else if (!switch_devices[dev_addr].instances[instance].full_report_enabled) {
+      } else if (!sw->full_report_enabled) {
         TU_LOG1("SWITCH[%d|%d]: CMD_AND_RUMBLE, CMD_MODE, FULL_REPORT_MODE \r\n", dev_addr, instance);
 
         report_size = 14;
 
-        report[0x01] = output_sequence_counter++;
+        report[0x01] = sw->output_sequence++;
         report[0x00] = CMD_AND_RUMBLE;              // COMMAND
         report[0x0A + 0] = CMD_MODE;                // SUB_COMMAND
         report[0x0A + 1] = SUBCMD_FULL_REPORT_MODE; // SUB_COMMAND ARGS
 
-        switch_devices[dev_addr].instances[instance].full_report_enabled = true;
+        sw->full_report_enabled = true;
         tuh_hid_send_report(dev_addr, instance, 0, report, report_size);
-        sleep_ms(100);
+        sw->next_cmd_ms = now_ms + SWITCH_INIT_CMD_GAP_MS;
 
-      // } else if (!switch_devices[dev_addr].instances[instance].imu_enabled) {
+      // } else if (!sw->imu_enabled) {
       //   TU_LOG1("SWITCH[%d|%d]: CMD_AND_RUMBLE, CMD_GYRO, 1 \r\n", dev_addr, instance);
 
       //   report_size = 12;
@@ -544,26 +550,26 @@ void output_switch_pro(uint8_t dev_addr, uint8_t instance, device_output_config_
       //   report[0x0A + 0] = CMD_GYRO;   // SUB_COMMAND
       //   report[0x0A + 1] = 1 ? 1 : 0;  // SUB_COMMAND ARGS
 
-      //   switch_devices[dev_addr].instances[instance].imu_enabled = true;
+      //   sw->imu_enabled = true;
       //   tuh_hid_send_report(dev_addr, instance, 0, report, report_size);
       //   sleep_ms(100);
 
-      // } else if (switch_devices[dev_addr].instances[instance].imu_enabled) {
-      } else if (switch_devices[dev_addr].instances[instance].full_report_enabled) {
+      // } else if (sw->imu_enabled) {
+      } else if (sw->full_report_enabled) {
         // Use player_index from USB output interface config
         int player_index = config->player_index;
 
         if (config->test ||
-          switch_devices[dev_addr].instances[instance].player_led_set != player_index
+          sw->player_led_set != player_index
         ) {
           TU_LOG1("SWITCH[%d|%d]: CMD_AND_RUMBLE, CMD_LED, %d (was %d)\r\n",
                   dev_addr, instance, player_index,
-                  switch_devices[dev_addr].instances[instance].player_led_set);
+                  sw->player_led_set);
 
           report_size = 12;
 
           report[0x00] = CMD_AND_RUMBLE; // COMMAND
-          report[0x01] = output_sequence_counter++;
+          report[0x01] = sw->output_sequence++;
 
           // Include current rumble state in CMD_AND_RUMBLE
           encode_rumble(config->rumble_left, &report[0x02]);       // Left motor
@@ -584,29 +590,29 @@ void output_switch_pro(uint8_t dev_addr, uint8_t instance, device_output_config_
             report[0x0A + 1] = (config->test & 0b00001111);
           }
 
-          switch_devices[dev_addr].instances[instance].player_led_set = player_index;
-          switch_devices[dev_addr].instances[instance].rumble_left = config->rumble_left;
-          switch_devices[dev_addr].instances[instance].rumble_right = config->rumble_right;
+          sw->player_led_set = player_index;
+          sw->rumble_left = config->rumble_left;
+          sw->rumble_right = config->rumble_right;
 
           tuh_hid_send_report(dev_addr, instance, 0, report, report_size);
         }
-        else if (switch_devices[dev_addr].instances[instance].rumble_left != config->rumble_left ||
-                 switch_devices[dev_addr].instances[instance].rumble_right != config->rumble_right)
+        else if (sw->rumble_left != config->rumble_left ||
+                 sw->rumble_right != config->rumble_right)
         {
           TU_LOG1("SWITCH[%d|%d]: CMD_RUMBLE_ONLY, L=%d R=%d\r\n", dev_addr, instance,
                   config->rumble_left, config->rumble_right);
 
           report_size = 10;
 
-          report[0x01] = output_sequence_counter++;
+          report[0x01] = sw->output_sequence++;
           report[0x00] = CMD_RUMBLE_ONLY; // COMMAND
 
           // Encode rumble with intensity passthrough
           encode_rumble(config->rumble_left, &report[0x02]);       // Left motor
           encode_rumble(config->rumble_right, &report[0x02 + 4]);  // Right motor
 
-          switch_devices[dev_addr].instances[instance].rumble_left = config->rumble_left;
-          switch_devices[dev_addr].instances[instance].rumble_right = config->rumble_right;
+          sw->rumble_left = config->rumble_left;
+          sw->rumble_right = config->rumble_right;
 
           tuh_hid_send_report(dev_addr, instance, 0, report, report_size);
         }
@@ -634,31 +640,32 @@ static inline bool init_switch_pro(uint8_t dev_addr, uint8_t instance)
 {
   TU_LOG1("SWITCH[%d|%d]: Mounted\r\n", dev_addr, instance);
 
-  switch_devices[dev_addr].instances[instance].command_ack = true;
-  // Initialize to 0xFF so first config comparison triggers output
-  switch_devices[dev_addr].instances[instance].rumble_left = 0xFF;
-  switch_devices[dev_addr].instances[instance].rumble_right = 0xFF;
-  switch_devices[dev_addr].instances[instance].player_led_set = 0xFF;
+  switch_ctx_t* sw = hid_slot_ctx(dev_addr, instance);
+  if (!sw) return false;
 
-  if ((++switch_devices[dev_addr].instance_count) == 1) {
-    switch_devices[dev_addr].instance_root = instance; // save initial root instance to merge extras into
-  }
+  sw->command_ack = true;
+  // Initialize to 0xFF so first config comparison triggers output
+  sw->rumble_left = 0xFF;
+  sw->rumble_right = 0xFF;
+  sw->player_led_set = 0xFF;
 
   uint16_t vid, pid;
   tuh_vid_pid_get(dev_addr, &vid, &pid);
   // Mark controllers with analog sticks as "Pro" for proper scaling
   if (pid == 0x2009) {  // Switch Pro
-    switch_devices[dev_addr].is_pro = true;
+    sw->is_pro = true;
   }
 
   return true;
 }
 
+HID_SLOT_CTX_CHECK(switch_ctx_t);
+
 DeviceInterface switch_pro_interface = {
   .name = "Switch Pro",
-  .is_device = is_switch_pro,
+  HID_DEVICE_IDS(switch_pro_ids),
   .process = input_report_switch_pro,
   .task = output_switch_pro,
-  .unmount = unmount_switch_pro,
+  .task_poll_ms = 10,
   .init = init_switch_pro,
 };
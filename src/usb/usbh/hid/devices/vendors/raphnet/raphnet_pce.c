@@ -37,28 +37,28 @@ typedef struct __attribute__((packed)) {
     uint16_t buttons;       // 16 button bits
 } raphnet_pce_report_t;
 
-// Previous report for change detection
-static raphnet_pce_report_t prev_report[5];
-
-// Check if device is Raphnet PCE adapter
-static bool is_raphnet_pce(uint16_t vid, uint16_t pid) {
-    return (vid == RAPHNET_VID && pid == RAPHNET_PCE_PID);
-}
+// Raphnet PCE adapter
+static const hid_device_id_t raphnet_pce_ids[] = {
+    {RAPHNET_VID, RAPHNET_PCE_PID},
+};
 
 // Process HID report
 static void process_raphnet_pce(uint8_t dev_addr, uint8_t instance,
-                                 uint8_t const* report, uint16_t len)
+                                 uint8_t const* report, uint16_t len, void* ctx)
 {
+    // Previous report for change detection
+    raphnet_pce_report_t* prev_report = ctx;
+
     if (len < sizeof(raphnet_pce_report_t)) return;
 
     raphnet_pce_report_t current;
     memcpy(&current, report, sizeof(current));
 
     // Only process if report changed
-    if (memcmp(&prev_report[dev_addr-1], &current, sizeof(current)) == 0) {
+    if (memcmp(prev_report, &current, sizeof(current)) == 0) {
         return;
     }
-    prev_report[dev_addr-1] = current;
+    *prev_report = current;
 
     // Debug: print raw values
     TU_LOG1("[raphnet_pce] X:%u Y:%u Z:%u Btn:0x%04X\n",
@@ -131,14 +131,13 @@ static void process_raphnet_pce(uint8_t dev_addr, uint8_t instance,
 static void unmount_raphnet_pce(uint8_t dev_addr, uint8_t instance)
 {
     TU_LOG1("[raphnet_pce] Unmounted addr=%d instance=%d\n", dev_addr, instance);
-    if (dev_addr > 0 && dev_addr <= 5) {
-        memset(&prev_report[dev_addr-1], 0, sizeof(raphnet_pce_report_t));
-    }
 }
 
+HID_SLOT_CTX_CHECK(raphnet_pce_report_t);
+
 DeviceInterface raphnet_pce_interface = {
     .name = "Raphnet PCE Adapter",
-    .is_device = is_raphnet_pce,
+    HID_DEVICE_IDS(raphnet_pce_ids),
     .process = process_raphnet_pce,
     .unmount = unmount_raphnet_pce,
     .init = NULL,
@@ -4,14 +4,12 @@
 #include "core/router/router.h"
 #include "core/input_event.h"
 
-// check if device is Sega Astro City mini controller
-static inline bool is_sega_astrocity(uint16_t vid, uint16_t pid) {
-  return ((vid == 0x0ca3 && (
-           pid == 0x0028 || // Astro City mini joystick
-           pid == 0x0027 || // Astro City mini controller
-           pid == 0x0024    // 8BitDo M30 6-button controller (2.4g)
-         )));
-}
+// Astro City mini controllers
+static const hid_device_id_t sega_astrocity_ids[] = {
+  {0x0ca3, 0x0028}, // Astro City mini joystick
+  {0x0ca3, 0x0027}, // Astro City mini controller
+  {0x0ca3, 0x0024}, // 8BitDo M30 6-button controller (2.4g)
+};
 
 // check if 2 reports are different enough
 bool diff_report_sega_astrocity(sega_astrocity_report_t const* rpt1, sega_astrocity_report_t const* rpt2) {
@@ -34,15 +32,15 @@ bool diff_report_sega_astrocity(sega_astrocity_report_t const* rpt1, sega_astroc
 }
 
 // process usb hid input reports
-void process_sega_astrocity(uint8_t dev_addr, uint8_t instance, uint8_t const* report, uint16_t len) {
+void process_sega_astrocity(uint8_t dev_addr, uint8_t instance, uint8_t const* report, uint16_t len, void* ctx) {
   uint32_t buttons;
   // previous report used to compare for changes
-  static sega_astrocity_report_t prev_report[5] = { 0 };
+  sega_astrocity_report_t* prev_report = ctx;
 
   sega_astrocity_report_t astro_report;
   memcpy(&astro_report, report, sizeof(astro_report));
 
-  if (diff_report_sega_astrocity(&prev_report[dev_addr-1], &astro_report)) {
+  if (diff_report_sega_astrocity(prev_report, &astro_report)) {
     TU_LOG1("DPad = x:%d, y:%d ", astro_report.x, astro_report.y);
     if (astro_report.a) TU_LOG1("A "); // X   <-M30 buttons
     if (astro_report.b) TU_LOG1("B "); // Y
@@ -106,13 +104,15 @@ void process_sega_astrocity(uint8_t dev_addr, uint8_t instance, uint8_t const* r
     };
     router_submit_input(&event);
 
-    prev_report[dev_addr-1] = astro_report;
+    *prev_report = astro_report;
   }
 }
 
+HID_SLOT_CTX_CHECK(sega_astrocity_report_t);
+
 DeviceInterface sega_astrocity_interface = {
   .name = "Sega Astro City Mini",
-  .is_device = is_sega_astrocity,
+  HID_DEVICE_IDS(sega_astrocity_ids),
   .process = process_sega_astrocity,
   .task = NULL,
   .init = NULL
@@ -27,9 +27,11 @@ typedef enum {
   DS3_STATE_READY           // Fully initialized
 } ds3_state_t;
 
-// DualShock3 instance state
-typedef struct TU_ATTR_PACKED
+// Per-interface context
+typedef struct
 {
+  sony_ds3_report_t prev_report;  // Previous report, to compare for changes
+  bool sent;                // Output sent since mount
   uint8_t rumble;
   uint8_t player;
   ds3_state_t init_state;
@@ -37,16 +39,8 @@ typedef struct TU_ATTR_PACKED
   bool input_received;      // Have we received input (DS3 is active)?
   bool button_pressed;      // Has user pressed any button? (for BT pairing trigger)
   bool verify_pending;      // Waiting for GET_REPORT callback?
-  uint32_t delay_start;     // For timing delays
-} ds3_instance_t;
-
-// Cached device report properties on mount
-typedef struct TU_ATTR_PACKED
-{
-  ds3_instance_t instances[CFG_TUH_HID];
-} ds3_device_t;
-
-static ds3_device_t ds3_devices[MAX_DEVICES] = { 0 };
+  uint32_t output_ms;       // Last output report
+} ds3_ctx_t;
 
 // Special PS3 Controller enable commands
 static const uint8_t ds3_init_cmd_buf[4] = {0x42, 0x0c, 0x00, 0x00};
@@ -57,15 +51,16 @@ static const uint8_t ds3_init_cmd_buf[4] = {0x42, 0x0c, 0x00, 0x00};
 
 // Called from sony_ds4.c when GET_REPORT 0xF5 completes
 void ds3_on_get_report_complete(uint8_t dev_addr, uint8_t instance) {
-  if (dev_addr < MAX_DEVICES && instance < CFG_TUH_HID) {
-    ds3_devices[dev_addr].instances[instance].verify_pending = false;
+  ds3_ctx_t* ds3 = hid_slot_ctx(dev_addr, instance);
+  if (ds3) {
+    ds3->verify_pending = false;
   }
 }
 
-// check if device is Sony PlayStation 3 controllers
-bool is_sony_ds3(uint16_t vid, uint16_t pid) {
-  return ((vid == 0x054c && pid == 0x0268)); // Sony DualShock3
-}
+// devices handled as DualShock 3
+static const hid_device_id_t sony_ds3_ids[] = {
+  {0x054c, 0x0268}, // Sony DualShock3
+};
 
 // check if 2 reports are different enough
 bool diff_report_ds3(sony_ds3_report_t const* rpt1, sony_ds3_report_t const* rpt2)
@@ -89,18 +84,18 @@ bool diff_report_ds3(sony_ds3_report_t const* rpt1, sony_ds3_report_t const* rpt
 }
 
 // process input input reports
-void input_sony_ds3(uint8_t dev_addr, uint8_t instance, uint8_t const* report, uint16_t len) {
+void input_sony_ds3(uint8_t dev_addr, uint8_t instance, uint8_t const* report, uint16_t len, void* ctx) {
   uint32_t buttons;
-  // previous report used to compare for changes
-  static sony_ds3_report_t prev_report[5] = { 0 };
+  ds3_ctx_t* ds3 = ctx;
+  sony_ds3_report_t* prev_report = &ds3->prev_report;
 
   // Mark that we've received input (DS3 is active and ready)
-  ds3_devices[dev_addr].instances[instance].input_received = true;
+  ds3->input_received = true;
 
   // Check if any button is pressed (bytes 1 and 2 are button bytes, byte 3 is PS)
   // report[0] is reportId, report[1-3] are button bytes
   if (len >= 4 && (report[1] != 0 || report[2] != 0 || report[3] != 0)) {
-    ds3_devices[dev_addr].instances[instance].button_pressed = true;
+    ds3->button_pressed = true;
   }
 
   uint8_t const report_id = report[0];
@@ -115,10 +110,10 @@ void input_sony_ds3(uint8_t dev_addr, uint8_t instance, uint8_t const* report, u
     memcpy(&ds3_report, report, len < sizeof(ds3_report) ? len : sizeof(ds3_report));
 
     // counter is +1, assign to make it easier to compare 2 report
-    prev_report[dev_addr-1].counter = ds3_report.counter;
+    prev_report->counter = ds3_report.counter;
 
     // Check if buttons/sticks changed (for debug logging)
-    bool buttons_changed = diff_report_ds3(&prev_report[dev_addr-1], &ds3_report);
+    bool buttons_changed = diff_report_ds3(prev_report, &ds3_report);
 
     // Parse motion data (SIXAXIS)
     // DS3 motion is at bytes 41-48 in original report (1-indexed with report ID at byte 0)
@@ -238,7 +233,7 @@ void input_sony_ds3(uint8_t dev_addr, uint8_t instance, uint8_t const* report, u
       };
       router_submit_input(&event);
 
-      prev_report[dev_addr-1] = ds3_report;
+      *prev_report = ds3_report;
     }
   }
 }
@@ -311,12 +306,17 @@ void output_sony_ds3(uint8_t dev_addr, uint8_t instance, device_output_config_t*
     output_report.data.rumble.right_duration = 128;
   }
 
-  if (ds3_devices[dev_addr].instances[instance].rumble != config->rumble ||
-      ds3_devices[dev_addr].instances[instance].player != output_report.data.leds_bitmap ||
+  ds3_ctx_t* ds3 = hid_slot_ctx(dev_addr, instance);
+  if (!ds3) return;
+
+  if (!ds3->sent ||
+      ds3->rumble != config->rumble ||
+      ds3->player != output_report.data.leds_bitmap ||
       config->test)
   {
-    ds3_devices[dev_addr].instances[instance].rumble = config->rumble;
-    ds3_devices[dev_addr].instances[instance].player = output_report.data.leds_bitmap;
+    ds3->sent = true;
+    ds3->rumble = config->rumble;
+    ds3->player = output_report.data.leds_bitmap;
 
     // Send report without the report ID, start at index 1 instead of 0
     tuh_hid_send_report(dev_addr, instance, output_report.data.report_id, &(output_report.buf[1]), sizeof(output_report) - 1);
@@ -324,89 +324,6 @@ void output_sony_ds3(uint8_t dev_addr, uint8_t instance, device_output_config_t*
   }
 }
 
-// Static buffer for control transfer (must persist until transfer completes)
-static uint8_t ds3_ctrl_buf[16];  // Extra space for report ID prefix
-static tusb_control_request_t ds3_ctrl_request;
-static volatile bool ds3_xfer_complete = false;
-static volatile bool ds3_xfer_success = false;
-
-// Callback for async control transfer
-static void ds3_ctrl_xfer_cb(tuh_xfer_t* xfer) {
-  printf("[DS3] Control transfer callback: result=%d xferred=%lu\n",
-         xfer->result, (unsigned long)xfer->actual_len);
-  ds3_xfer_success = (xfer->result == XFER_RESULT_SUCCESS);
-  ds3_xfer_complete = true;
-}
-
-// Raw USB control transfer for DS3 SET_REPORT (bypasses TinyUSB HID layer)
-// USB Host Shield uses: ctrlReq(addr, ep0, 0x21, 0x09, 0xF5, 0x03, 0x00, 8, 8, buf)
-static bool ds3_set_report_raw(uint8_t dev_addr, uint8_t instance, uint8_t report_id, uint8_t* data, uint16_t len) {
-  printf("[DS3] ds3_set_report_raw called: dev=%d inst=%d report=0x%02X len=%d\n",
-         dev_addr, instance, report_id, len);
-
-  // Get interface number from TinyUSB HID layer
-  tuh_itf_info_t itf_info;
-  bool got_info = tuh_hid_itf_get_info(dev_addr, instance, &itf_info);
-  printf("[DS3] tuh_hid_itf_get_info returned: %d\n", got_info);
-
-  uint8_t itf_num = 0;  // Default to interface 0
-  if (got_info) {
-    itf_num = itf_info.desc.bInterfaceNumber;
-  }
-  printf("[DS3] Using interface %d for SET_REPORT\n", itf_num);
-
-  // Copy to static buffer
-  memcpy(ds3_ctrl_buf, data, len);
-
-  ds3_ctrl_request = (tusb_control_request_t){
-    .bmRequestType_bit = {
-      .recipient = TUSB_REQ_RCPT_INTERFACE,
-      .type = TUSB_REQ_TYPE_CLASS,
-      .direction = TUSB_DIR_OUT
-    },
-    .bRequest = 0x09,  // HID_REQUEST_SET_REPORT
-    .wValue = tu_htole16((0x03 << 8) | report_id),  // Feature report (0x03) | report_id
-    .wIndex = tu_htole16(itf_num),
-    .wLength = len
-  };
-
-  ds3_xfer_complete = false;
-  ds3_xfer_success = false;
-
-  tuh_xfer_t xfer = {
-    .daddr = dev_addr,
-    .ep_addr = 0,
-    .setup = &ds3_ctrl_request,
-    .buffer = ds3_ctrl_buf,
-    .buflen = len,
-    .complete_cb = ds3_ctrl_xfer_cb,
-    .user_data = 0
-  };
-
-  printf("[DS3] Control xfer: wValue=0x%04X wIndex=0x%04X wLength=%d\n",
-         ds3_ctrl_request.wValue, ds3_ctrl_request.wIndex, ds3_ctrl_request.wLength);
-
-  bool queued = tuh_control_xfer(&xfer);
-  printf("[DS3] tuh_control_xfer queued: %d\n", queued);
-
-  if (!queued) {
-    return false;
-  }
-
-  // Wait for completion with timeout
-  uint32_t start = to_ms_since_boot(get_absolute_time());
-  while (!ds3_xfer_complete) {
-    tuh_task();  // Process USB events
-    if (to_ms_since_boot(get_absolute_time()) - start > 1000) {
-      printf("[DS3] Control transfer timeout!\n");
-      return false;
-    }
-  }
-
-  printf("[DS3] Control transfer complete: success=%d\n", ds3_xfer_success);
-  return ds3_xfer_success;
-}
-
 // Static buffer for SET_REPORT - must persist until async transfer completes!
 static uint8_t ds3_bt_addr_buf[8];
 
@@ -453,11 +370,10 @@ static inline bool init_sony_ds3(uint8_t dev_addr, uint8_t instance) {
   */
   printf("[DS3] Init..\n");
 
-  // Initialize state
-  ds3_devices[dev_addr].instances[instance].init_state = DS3_STATE_ACTIVATING;
-  ds3_devices[dev_addr].instances[instance].bt_addr_sent = false;
-  ds3_devices[dev_addr].instances[instance].input_received = false;
-  ds3_devices[dev_addr].instances[instance].button_pressed = false;
+  // Context is zeroed on mount, only the state machine needs starting
+  ds3_ctx_t* ds3 = hid_slot_ctx(dev_addr, instance);
+  if (!ds3) return false;
+  ds3->init_state = DS3_STATE_ACTIVATING;
 
   // Send activation report (0xF4) to enable input streaming
   // BT address will be set after first output report is sent
@@ -467,7 +383,8 @@ static inline bool init_sony_ds3(uint8_t dev_addr, uint8_t instance) {
 
 // process usb hid output reports
 void task_sony_ds3(uint8_t dev_addr, uint8_t instance, device_output_config_t* config) {
-  ds3_instance_t* inst = &ds3_devices[dev_addr].instances[instance];
+  ds3_ctx_t* inst = hid_slot_ctx(dev_addr, instance);
+  if (!inst) return;
 
   // Handle init state machine
   switch (inst->init_state) {
@@ -528,31 +445,21 @@ void task_sony_ds3(uint8_t dev_addr, uint8_t instance, device_output_config_t* c
 
   // Throttle output reports
   const uint32_t interval_ms = 20;
-  static uint32_t start_ms = 0;
 
   uint32_t current_time_ms = to_ms_since_boot(get_absolute_time());
-  if (current_time_ms - start_ms >= interval_ms) {
-    start_ms = current_time_ms;
+  if (current_time_ms - inst->output_ms >= interval_ms) {
+    inst->output_ms = current_time_ms;
     output_sony_ds3(dev_addr, instance, config);
   }
 }
 
-// resets default values in case devices are hotswapped
-void unmount_sony_ds3(uint8_t dev_addr, uint8_t instance)
-{
-  ds3_devices[dev_addr].instances[instance].rumble = 0;
-  ds3_devices[dev_addr].instances[instance].player = 0xff;
-  ds3_devices[dev_addr].instances[instance].init_state = DS3_STATE_IDLE;
-  ds3_devices[dev_addr].instances[instance].bt_addr_sent = false;
-  ds3_devices[dev_addr].instances[instance].input_received = false;
-  ds3_devices[dev_addr].instances[instance].button_pressed = false;
-}
+HID_SLOT_CTX_CHECK(ds3_ctx_t);
 
 DeviceInterface sony_ds3_interface = {
   .name = "Sony DualShock 3",
   .init = init_sony_ds3,
-  .is_device = is_sony_ds3,
+  HID_DEVICE_IDS(sony_ds3_ids),
   .process = input_sony_ds3,
   .task = task_sony_ds3,
-  .unmount = unmount_sony_ds3,
+  .task_poll_ms = 20,
 };
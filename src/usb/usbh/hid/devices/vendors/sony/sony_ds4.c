@@ -6,24 +6,7 @@
 #include "pico/time.h"
 #include "app_config.h"
 #include <string.h>
-
-static uint16_t tpadLastPos;
-static bool tpadDragging;
-
-// DualSense instance state
-typedef struct TU_ATTR_PACKED
-{
-  uint8_t rumble;
-  uint8_t player;
-} ds4_instance_t;
-
-// Cached device report properties on mount
-typedef struct TU_ATTR_PACKED
-{
-  ds4_instance_t instances[CFG_TUH_HID];
-} ds4_device_t;
-
-static ds4_device_t ds4_devices[MAX_DEVICES] = { 0 };
+#include <stddef.h>
 
 // ============================================================================
 // PS4 AUTH PASSTHROUGH STATE
@@ -76,15 +59,15 @@ static struct {
     uint8_t report_buffer[DS4_AUTH_REPORT_SIZE];
 } ds4_auth = { 0 };
 
-// check if device is Sony PlayStation 4 controllers
-bool is_sony_ds4(uint16_t vid, uint16_t pid) {
-  return ( (vid == 0x054c && (pid == 0x09cc || pid == 0x05c4)) // Sony DualShock4 
-    || (vid == 0x0f0d && pid == 0x005e) // Hori FC4 
-    || (vid == 0x0f0d && pid == 0x00ee) // Hori PS4 Mini (PS4-099U) 
-    || (vid == 0x1f4f && pid == 0x1002) // ASW GG xrd controller
-    || (vid == 0x1532 && pid == 0x0401) // Razer Panthera PS4 Controller (GP2040-CE PS4 Mode)
-  );
-}
+// devices handled as DualShock 4
+static const hid_device_id_t sony_ds4_ids[] = {
+  {0x054c, 0x09cc}, // Sony DualShock4
+  {0x054c, 0x05c4}, // Sony DualShock4
+  {0x0f0d, 0x005e}, // Hori FC4
+  {0x0f0d, 0x00ee}, // Hori PS4 Mini (PS4-099U)
+  {0x1f4f, 0x1002}, // ASW GG xrd controller
+  {0x1532, 0x0401}, // Razer Panthera PS4 Controller (GP2040-CE PS4 Mode)
+};
 
 // check if 2 reports are different enough
 bool diff_report_ds4(sony_ds4_report_t const* rpt1, sony_ds4_report_t const* rpt2)
@@ -106,12 +89,48 @@ bool diff_report_ds4(sony_ds4_report_t const* rpt1, sony_ds4_report_t const* rpt
   return result;
 }
 
+// raw report bits decoded from report ID 1: drops the counter, timestamp,
+// battery, IMU and touchpad event/counter bytes
+static const uint8_t ds4_report_mask[] = {
+  0xFF,                   // report id
+  0xFF, 0xFF, 0xFF, 0xFF, // x, y, z, rz
+  0xFF, 0xFF,             // dpad + face, shoulders + share/option/l3/r3
+  0x03,                   // ps, tpad (counter masked)
+  0xFF, 0xFF,             // l2, r2 triggers
+  0, 0, 0,                // timestamp, battery
+  0, 0, 0, 0, 0, 0,       // gyro
+  0, 0, 0, 0, 0, 0,       // accel
+  0, 0, 0, 0, 0,          // unknown_a
+  0, 0, 0,                // headset, unknown_b
+  0, 0,                   // tpad_event, tpad_counter
+  0x80,                   // tpad_f1_down (count masked)
+  0xFF, 0xFF, 0xFF,       // tpad_f1_pos
+};
+_Static_assert(sizeof(ds4_report_mask) == 1 + offsetof(sony_ds4_report_t, tpad_f1_pos) + 3,
+               "ds4_report_mask out of sync with sony_ds4_report_t");
+
+uint16_t report_mask_sony_ds4(uint8_t dev_addr, uint8_t instance, uint8_t* mask, uint16_t max_len)
+{
+  return copy_report_mask(ds4_report_mask, sizeof(ds4_report_mask), mask, max_len);
+}
+
+// Per-interface context
+typedef struct
+{
+  sony_ds4_report_t prev_report;  // Previous report, to compare for changes
+  uint16_t tpad_last_pos;
+  bool tpad_dragging;
+  bool sent;                      // Output sent since mount
+  uint8_t rumble;
+  uint8_t player;
+} ds4_ctx_t;
+
 // process usb hid input reports
-void input_sony_ds4(uint8_t dev_addr, uint8_t instance, uint8_t const* report, uint16_t len)
+void input_sony_ds4(uint8_t dev_addr, uint8_t instance, uint8_t const* report, uint16_t len, void* ctx)
 {
   uint32_t buttons;
-  // previous report used to compare for changes
-  static sony_ds4_report_t prev_report[5] = { 0 };
+  ds4_ctx_t* ds4 = ctx;
+  sony_ds4_report_t* prev_report = &ds4->prev_report;
 
   uint8_t const report_id = report[0];
   report++;
@@ -124,12 +143,12 @@ void input_sony_ds4(uint8_t dev_addr, uint8_t instance, uint8_t const* report, u
     memcpy(&ds4_report, report, sizeof(ds4_report));
 
     // counter is +1, assign to make it easier to compare 2 report
-    prev_report[dev_addr-1].counter = ds4_report.counter;
+    prev_report->counter = ds4_report.counter;
 
     // only print if changes since it is polled ~ 5ms
     // Since count+1 after each report and  x, y, z, rz fluctuate within 1 or 2
     // We need more than memcmp to check if report is different enough
-    if ( diff_report_ds4(&prev_report[dev_addr-1], &ds4_report) )
+    if ( diff_report_ds4(prev_report, &ds4_report) )
     {
       TU_LOG1("(x, y, z, rz, l, r) = (%u, %u, %u, %u, %u, %u)\r\n", ds4_report.x, ds4_report.y, ds4_report.z, ds4_report.rz, ds4_report.r2_trigger, ds4_report.l2_trigger);
       TU_LOG1("DPad = %s ", ds4_report.dpad);
@@ -201,10 +220,10 @@ void input_sony_ds4(uint8_t dev_addr, uint8_t instance, uint8_t const* report, u
       int8_t touchpad_delta_x = 0;
       if (!ds4_report.tpad_f1_down) {
         // Calculate horizontal swipe delta while finger is down
-        if (tpadDragging) {
+        if (ds4->tpad_dragging) {
           int16_t delta = 0;
-          if (tx >= tpadLastPos) delta = tx - tpadLastPos;
-          else delta = (-1) * (tpadLastPos - tx);
+          if (tx >= ds4->tpad_last_pos) delta = tx - ds4->tpad_last_pos;
+          else delta = (-1) * (ds4->tpad_last_pos - tx);
 
           // Clamp delta to reasonable range
           if (delta > 12) delta = 12;
@@ -213,10 +232,10 @@ void input_sony_ds4(uint8_t dev_addr, uint8_t instance, uint8_t const* report, u
           touchpad_delta_x = (int8_t)delta;
         }
 
-        tpadLastPos = tx;
-        tpadDragging = true;
+        ds4->tpad_last_pos = tx;
+        ds4->tpad_dragging = true;
       } else {
-        tpadDragging = false;
+        ds4->tpad_dragging = false;
       }
 
       // keep analog within range [1-255]
@@ -251,7 +270,7 @@ void input_sony_ds4(uint8_t dev_addr, uint8_t instance, uint8_t const* report, u
       };
       router_submit_input(&event);
 
-      prev_report[dev_addr-1] = ds4_report;
+      *prev_report = ds4_report;
     }
   }
 }
@@ -317,41 +336,30 @@ void output_sony_ds4(uint8_t dev_addr, uint8_t instance, device_output_config_t*
     output_report.motor_right = 0;
   }
 
-  if (ds4_devices[dev_addr].instances[instance].rumble != config->rumble ||
-      ds4_devices[dev_addr].instances[instance].player != config->player_index+1 ||
+  ds4_ctx_t* ds4 = hid_slot_ctx(dev_addr, instance);
+  if (!ds4) return;
+
+  if (!ds4->sent ||
+      ds4->rumble != config->rumble ||
+      ds4->player != config->player_index+1 ||
       config->test)
   {
-    ds4_devices[dev_addr].instances[instance].rumble = config->rumble;
-    ds4_devices[dev_addr].instances[instance].player = config->test ? config->test : config->player_index+1;
+    ds4->sent = true;
+    ds4->rumble = config->rumble;
+    ds4->player = config->test ? config->test : config->player_index+1;
     tuh_hid_send_report(dev_addr, instance, 5, &output_report, sizeof(output_report));
   }
 }
 
-// process usb hid output reports
-void task_sony_ds4(uint8_t dev_addr, uint8_t instance, device_output_config_t* config) {
-  const uint32_t interval_ms = 20;
-  static uint32_t start_ms = 0;
-
-  uint32_t current_time_ms = to_ms_since_boot(get_absolute_time());
-  if (current_time_ms - start_ms >= interval_ms) {
-    start_ms = current_time_ms;
-    output_sony_ds4(dev_addr, instance, config);
-  }
-}
-
-// resets default values in case devices are hotswapped
-void unmount_sony_ds4(uint8_t dev_addr, uint8_t instance)
-{
-  ds4_devices[dev_addr].instances[instance].rumble = 0;
-  ds4_devices[dev_addr].instances[instance].player = 0xff;
-}
+HID_SLOT_CTX_CHECK(ds4_ctx_t);
 
 DeviceInterface sony_ds4_interface = {
   .name = "Sony DualShock 4",
-  .is_device = is_sony_ds4,
+  HID_DEVICE_IDS(sony_ds4_ids),
   .process = input_sony_ds4,
-  .task = task_sony_ds4,
-  .unmount = unmount_sony_ds4,
+  .task = output_sony_ds4,
+  .feedback_interval_ms = 10,
+  .report_mask = report_mask_sony_ds4,
 };
 
 // ============================================================================
@@ -5,31 +5,14 @@
 #include "core/input_event.h"
 #include "pico/time.h"
 #include "app_config.h"
-
-static uint16_t tpadLastPos;
-static bool tpadDragging;
-
-// DualSense instance state
-typedef struct TU_ATTR_PACKED
-{
-  uint8_t rumble;
-  uint8_t player;
-} ds5_instance_t;
-
-// Cached device report properties on mount
-typedef struct TU_ATTR_PACKED
-{
-  ds5_instance_t instances[CFG_TUH_HID];
-} ds5_device_t;
-
-static ds5_device_t ds5_devices[MAX_DEVICES] = { 0 };
+#include <stddef.h>
 
 const char* dpad_str[] = { "N", "NE", "E", "SE", "S", "SW", "W", "NW", "none" };
 
-// check if device is Sony PlayStation 5 controllers
-bool is_sony_ds5(uint16_t vid, uint16_t pid) {
-  return ((vid == 0x054c && pid == 0x0ce6)); // Sony DualSense
-}
+// devices handled as DualSense
+static const hid_device_id_t sony_ds5_ids[] = {
+  {0x054c, 0x0ce6}, // Sony DualSense
+};
 
 // check if 2 reports are different enough
 bool diff_report_ds5(sony_ds5_report_t const* rpt1, sony_ds5_report_t const* rpt2) {
@@ -58,11 +41,45 @@ bool diff_report_ds5(sony_ds5_report_t const* rpt1, sony_ds5_report_t const* rpt
   return false;
 }
 
+// raw report bits decoded from report ID 1: drops rz, the counter, IMU and
+// touchpad event/counter bytes
+static const uint8_t ds5_report_mask[] = {
+  0xFF,                   // report id
+  0xFF, 0xFF, 0xFF, 0xFF, // x1, y1, x2, y2
+  0xFF, 0xFF, 0,          // rx, ry, rz
+  0xFF, 0xFF,             // dpad + face, shoulders + share/option/l3/r3
+  0x07,                   // ps, tpad, mute (counter masked)
+  0, 0, 0, 0, 0, 0,       // gyro
+  0, 0, 0, 0, 0, 0,       // accel
+  0, 0, 0, 0, 0,          // unknown_a
+  0, 0, 0,                // headset, unknown_b
+  0, 0,                   // tpad_event, tpad_counter
+  0x80,                   // tpad_f1_down (count masked)
+  0xFF, 0xFF, 0xFF,       // tpad_f1_pos
+};
+_Static_assert(sizeof(ds5_report_mask) == 1 + offsetof(sony_ds5_report_t, tpad_f1_pos) + 3,
+               "ds5_report_mask out of sync with sony_ds5_report_t");
+
+uint16_t report_mask_sony_ds5(uint8_t dev_addr, uint8_t instance, uint8_t* mask, uint16_t max_len) {
+  return copy_report_mask(ds5_report_mask, sizeof(ds5_report_mask), mask, max_len);
+}
+
+// Per-interface context
+typedef struct
+{
+  sony_ds5_report_t prev_report;  // Previous report, to compare for changes
+  uint16_t tpad_last_pos;
+  bool tpad_dragging;
+  bool sent;                      // Output sent since mount
+  uint8_t rumble;
+  uint8_t player;
+} ds5_ctx_t;
+
 // process usb hid input reports
-void input_sony_ds5(uint8_t dev_addr, uint8_t instance, uint8_t const* report, uint16_t len) {
+void input_sony_ds5(uint8_t dev_addr, uint8_t instance, uint8_t const* report, uint16_t len, void* ctx) {
   uint32_t buttons;
-  // previous report used to compare for changes
-  static sony_ds5_report_t prev_report[5] = { 0 };
+  ds5_ctx_t* ds5 = ctx;
+  sony_ds5_report_t* prev_report = &ds5->prev_report;
 
   uint8_t const report_id = report[0];
   report++;
@@ -75,9 +92,9 @@ void input_sony_ds5(uint8_t dev_addr, uint8_t instance, uint8_t const* report, u
     memcpy(&ds5_report, report, sizeof(ds5_report));
 
     // counter is +1, assign to make it easier to compare 2 report
-    prev_report[dev_addr-1].counter = ds5_report.counter;
+    prev_report->counter = ds5_report.counter;
 
-    if ( diff_report_ds5(&prev_report[dev_addr-1], &ds5_report) )
+    if ( diff_report_ds5(prev_report, &ds5_report) )
     {
       TU_LOG1("(x1, y1, x2, y2, rx, ry) = (%u, %u, %u, %u, %u, %u)\r\n", ds5_report.x1, ds5_report.y1, ds5_report.x2, ds5_report.y2, ds5_report.rx, ds5_report.ry);
       TU_LOG1("DPad = %s ", dpad_str[ds5_report.dpad]);
@@ -144,10 +161,10 @@ void input_sony_ds5(uint8_t dev_addr, uint8_t instance, uint8_t const* report, u
       int8_t touchpad_delta_x = 0;
       if (!ds5_report.tpad_f1_down) {
         // Calculate horizontal swipe delta while finger is down
-        if (tpadDragging) {
+        if (ds5->tpad_dragging) {
           int16_t delta = 0;
-          if (tx >= tpadLastPos) delta = tx - tpadLastPos;
-          else delta = (-1) * (tpadLastPos - tx);
+          if (tx >= ds5->tpad_last_pos) delta = tx - ds5->tpad_last_pos;
+          else delta = (-1) * (ds5->tpad_last_pos - tx);
 
           // Clamp delta to reasonable range
           if (delta > 12) delta = 12;
@@ -156,10 +173,10 @@ void input_sony_ds5(uint8_t dev_addr, uint8_t instance, uint8_t const* report, u
           touchpad_delta_x = (int8_t)delta;
         }
 
-        tpadLastPos = tx;
-        tpadDragging = true;
+        ds5->tpad_last_pos = tx;
+        ds5->tpad_dragging = true;
       } else {
-        tpadDragging = false;
+        ds5->tpad_dragging = false;
       }
 
       uint8_t analog_1x = ds5_report.x1;
@@ -194,7 +211,7 @@ void input_sony_ds5(uint8_t dev_addr, uint8_t instance, uint8_t const* report, u
       };
       router_submit_input(&event);
 
-      prev_report[dev_addr-1] = ds5_report;
+      *prev_report = ds5_report;
     }
   }
 }
@@ -304,39 +321,28 @@ void output_sony_ds5(uint8_t dev_addr, uint8_t instance, device_output_config_t*
     ds5_fb.rumble_r = 0;
   }
 
-  if (ds5_devices[dev_addr].instances[instance].rumble != config->rumble ||
-      ds5_devices[dev_addr].instances[instance].player != ds5_fb.player_led ||
+  ds5_ctx_t* ds5 = hid_slot_ctx(dev_addr, instance);
+  if (!ds5) return;
+
+  if (!ds5->sent ||
+      ds5->rumble != config->rumble ||
+      ds5->player != ds5_fb.player_led ||
       config->test)
   {
-    ds5_devices[dev_addr].instances[instance].rumble = config->rumble;
-    ds5_devices[dev_addr].instances[instance].player = ds5_fb.player_led & 0xff;
+    ds5->sent = true;
+    ds5->rumble = config->rumble;
+    ds5->player = ds5_fb.player_led & 0xff;
     tuh_hid_send_report(dev_addr, instance, 5, &ds5_fb, sizeof(ds5_fb));
   }
 }
 
-// process usb hid output reports
-void task_sony_ds5(uint8_t dev_addr, uint8_t instance, device_output_config_t* config) {
-  const uint32_t interval_ms = 20;
-  static uint32_t start_ms = 0;
-
-  uint32_t current_time_ms = to_ms_since_boot(get_absolute_time());
-  if (current_time_ms - start_ms >= interval_ms) {
-    start_ms = current_time_ms;
-    output_sony_ds5(dev_addr, instance, config);
-  }
-}
-
-// resets default values in case devices are hotswapped
-void unmount_sony_ds5(uint8_t dev_addr, uint8_t instance)
-{
-  ds5_devices[dev_addr].instances[instance].rumble = 0;
-  ds5_devices[dev_addr].instances[instance].player = 0xff;
-}
+HID_SLOT_CTX_CHECK(ds5_ctx_t);
 
 DeviceInterface sony_ds5_interface = {
   .name = "Sony DualSense",
-  .is_device = is_sony_ds5,
+  HID_DEVICE_IDS(sony_ds5_ids),
   .process = input_sony_ds5,
-  .task = task_sony_ds5,
-  .unmount = unmount_sony_ds5,
+  .task = output_sony_ds5,
+  .feedback_interval_ms = 10,
+  .report_mask = report_mask_sony_ds5,
 };
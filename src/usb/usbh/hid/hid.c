@@ -6,33 +6,150 @@
 #include "core/services/players/feedback.h"
 #include "core/services/profiles/profile_indicator.h"
 #include "core/services/codes/codes.h"
+#include "core/services/metrics/metrics.h"
 #include "usb/usbh/hid/hid_utils.h"
 #include "usb/usbh/hid/hid_registry.h"
+#include "usb/usbh/usbh_interval.h"
+#include "usb/usbh/usbh_feedback.h"
 #include "usb/usbh/hid/devices/vendors/sony/sony_ds4.h"
+#include "pico/time.h"
 
 // #define LANGUAGE_ID 0x0409
 #define MAX_REPORTS 5
+#define DEDUP_MAX_LEN 48  // Longest driver report mask (DS4 needs 39)
+#define HID_MAX_SLOTS CFG_TUH_HID  // TinyUSB's limit on mounted HID interfaces
+#define HID_MAX_ADDR (CFG_TUH_DEVICE_MAX + CFG_TUH_HUB)  // Highest address TinyUSB assigns
 
-// Each HID instance can have multiple reports
-typedef struct TU_ATTR_PACKED
+_Static_assert(HID_MAX_SLOTS <= 32, "visit_slots holds one bit per slot");
+
+// One record per mounted HID interface, allocated on mount
+typedef struct
 {
+  uint8_t dev_addr;     // 0 = free
+  uint8_t instance;
   dev_type_t type;
+
+  // Each HID instance can have multiple reports
   uint8_t report_count;
   tuh_hid_report_info_t report_info[MAX_REPORTS];
-} instance_t;
+  uint8_t report_id;    // ID stripped from the report being dispatched, 0 = none
+
+  // Raw report dedup (DeviceInterface.report_mask)
+  uint8_t dedup_mask_len;             // 0 = dedup off
+  uint16_t dedup_len;                 // Length of the last report, 0 = none yet
+  uint8_t dedup_mask[DEDUP_MAX_LEN];
+  uint8_t dedup_prev[DEDUP_MAX_LEN];  // Last report, already masked
+
+  // Feedback servicing (hid_task)
+  uint8_t next_active;                // Next slot + 1 on the active list, 0 = end
+  int8_t player_index;                // Player at the last visit, -1 = none
+  usbh_feedback_t feedback;           // Config last released to the driver
+  uint32_t task_due_ms;               // Next timed task() (DeviceInterface.task_poll_ms)
+
+  // Driver context (see HID_SLOT_CTX_CHECK), zeroed on mount
+  uint64_t ctx[HID_SLOT_CTX_SIZE / sizeof(uint64_t)];  // 8-byte aligned for any driver struct
+} hid_slot_t;
+
+static hid_slot_t slots[HID_MAX_SLOTS];
+static uint8_t slot_index[HID_MAX_ADDR + 1][CFG_TUH_HID];  // slot + 1, 0 = not mounted
+static uint8_t active_head = 0;  // First slot + 1 of the feedback list, 0 = empty
+static uint32_t visit_slots = 0;  // Slots (bit n = slots[n]) hid_task visits regardless of player changes
+static uint32_t next_poll_ms = 0; // Earliest task_due_ms on the feedback list
+int16_t spinner = 0;
+
+static void process_generic_report(hid_slot_t* slot, uint8_t const* report, uint16_t len);
+static void dedup_setup(hid_slot_t* slot);
+static bool dedup_unchanged(hid_slot_t* slot, uint8_t const* report, uint16_t len);
+
+//--------------------------------------------------------------------+
+// Slot Table
+//--------------------------------------------------------------------+
 
-// Cached device report properties on mount
-typedef struct TU_ATTR_PACKED
+static hid_slot_t* slot_get(uint8_t dev_addr, uint8_t instance)
 {
-  uint16_t vid, pid;
-  instance_t instances[CFG_TUH_HID];
-  // uint16_t serial[20];
-} device_t;
+  if (dev_addr > HID_MAX_ADDR || instance >= CFG_TUH_HID) return NULL;
+  uint8_t idx = slot_index[dev_addr][instance];
+  return idx ? &slots[idx - 1] : NULL;
+}
 
-static device_t devices[MAX_DEVICES] = { 0 };
-int16_t spinner = 0;
+static hid_slot_t* slot_alloc(uint8_t dev_addr, uint8_t instance)
+{
+  if (dev_addr > HID_MAX_ADDR || instance >= CFG_TUH_HID) return NULL;
+
+  for (uint8_t i = 0; i < HID_MAX_SLOTS; i++) {
+    if (slots[i].dev_addr == 0) {
+      hid_slot_t* slot = &slots[i];
+      memset(slot, 0, sizeof(*slot));
+      slot->dev_addr = dev_addr;
+      slot->instance = instance;
+      slot->type = CONTROLLER_UNKNOWN;
+      slot_index[dev_addr][instance] = i + 1;
+      return slot;
+    }
+  }
+  return NULL;
+}
+
+static void slot_free(hid_slot_t* slot)
+{
+  // Unlink from the feedback list
+  uint8_t idx = slot_index[slot->dev_addr][slot->instance];
+  for (uint8_t* link = &active_head; *link; link = &slots[*link - 1].next_active) {
+    if (*link == idx) {
+      *link = slot->next_active;
+      break;
+    }
+  }
+  slot->next_active = 0;
+  visit_slots &= ~(1u << (idx - 1));
 
-static void process_generic_report(uint8_t dev_addr, uint8_t instance, uint8_t const* report, uint16_t len);
+  slot_index[slot->dev_addr][slot->instance] = 0;
+  slot->dev_addr = 0;
+  slot->type = CONTROLLER_UNKNOWN;
+}
+
+// Types whose task() sends LEDs, rumble or init commands
+static bool has_feedback(dev_type_t type)
+{
+  switch (type)
+  {
+  case CONTROLLER_DUALSENSE: // send DS5 LED and rumble
+  case CONTROLLER_DUALSHOCK3: // send DS3 Init, LED and rumble
+  case CONTROLLER_DUALSHOCK4: // send DS4 LED and rumble
+  case CONTROLLER_GAMECUBE: // send GameCube WiiU/Switch Adapter rumble
+  case CONTROLLER_KEYBOARD: // send Keyboard LEDs
+  case CONTROLLER_SWITCH: // send Switch Pro init, LED and rumble commands
+  case CONTROLLER_SWITCH2: // send Switch 2 Pro init, LED and rumble commands
+    return device_interfaces[type] && device_interfaces[type]->task;
+  default:
+    return false;
+  }
+}
+
+// Put a classified slot on the feedback list hid_task walks
+static void slot_activate(hid_slot_t* slot)
+{
+  if (!has_feedback(slot->type)) return;
+
+  uint8_t idx = slot_index[slot->dev_addr][slot->instance];
+  slot->next_active = active_head;
+  slot->player_index = -1;
+  usbh_feedback_reset(&slot->feedback);  // First config always goes out
+  active_head = idx;
+  visit_slots |= 1u << (idx - 1);
+}
+
+void* hid_slot_ctx(uint8_t dev_addr, uint8_t instance)
+{
+  hid_slot_t* slot = slot_get(dev_addr, instance);
+  return slot ? slot->ctx : NULL;
+}
+
+uint8_t hid_slot_report_id(uint8_t dev_addr, uint8_t instance)
+{
+  hid_slot_t* slot = slot_get(dev_addr, instance);
+  return slot ? slot->report_id : 0;
+}
 
 void hid_init()
 {
@@ -41,71 +158,126 @@ void hid_init()
 
 void hid_task(void)
 {
+  // Inputs every pad's config depends on, as of the last pass
+  static uint8_t last_test_counter = 0;
+  static uint8_t last_trigger_threshold = 0;
+  static bool last_indicator_active = false;
+  static int8_t last_indicator_player = -1;
+
   // Process DS4 auth passthrough
   ds4_auth_task();
 
   // Get test mode counter (for LED test patterns)
   uint8_t test_counter = codes_get_test_counter();
 
-  // Iterate devices and instances that can receive responses
-  for(uint8_t dev_addr=1; dev_addr<MAX_DEVICES; dev_addr++)
+  // Get trigger threshold from output interface (profile-based adaptive triggers)
+  uint8_t trigger_threshold = 0;
+  if (active_output && active_output->get_trigger_threshold) {
+    trigger_threshold = active_output->get_trigger_threshold();
+  }
+
+  // Players whose feedback changed; a change to the shared inputs touches all
+  uint32_t changed = feedback_take_changed();
+  bool indicator_active = profile_indicator_is_active();
+  int8_t indicator_player = profile_indicator_get_display_player_index(-1);
+  if (test_counter != last_test_counter || trigger_threshold != last_trigger_threshold ||
+      indicator_active != last_indicator_active || indicator_player != last_indicator_player)
   {
-    for(uint8_t instance=0; instance<CFG_TUH_HID; instance++)
+    last_test_counter = test_counter;
+    last_trigger_threshold = trigger_threshold;
+    last_indicator_active = indicator_active;
+    last_indicator_player = indicator_player;
+    changed = FEEDBACK_CHANGED_ALL;
+  }
+
+  uint32_t now_ms = to_ms_since_boot(get_absolute_time());
+
+  // Nothing changed, no config held back and no timed task due
+  if (!changed && !visit_slots && (int32_t)(now_ms - next_poll_ms) < 0) return;
+
+  uint32_t visit = visit_slots;
+  visit_slots = 0;
+  next_poll_ms = now_ms + INT32_MAX;
+
+  // Only interfaces with an output task are on the list
+  for (uint8_t idx = active_head; idx; idx = slots[idx - 1].next_active)
+  {
+    hid_slot_t* slot = &slots[idx - 1];
+    uint8_t dev_addr = slot->dev_addr;
+    uint8_t instance = slot->instance;
+    const DeviceInterface* driver = device_interfaces[slot->type];
+
+    // Unassigned pads may have just been given any player
+    uint32_t player_bit = (slot->player_index >= 0) ? 1u << slot->player_index : FEEDBACK_CHANGED_ALL;
+    bool poll_due = driver->task_poll_ms && (int32_t)(now_ms - slot->task_due_ms) >= 0;
+    bool dirty = (visit & (1u << (idx - 1))) || (changed & player_bit) ||
+                 (poll_due && !slot->feedback.primed);
+    bool released = false;
+    device_output_config_t config;
+
+    if (dirty)
     {
       int8_t player_index = find_player_index(dev_addr, instance);
-      int8_t ctrl_type = devices[dev_addr].instances[instance].type;
-      switch (ctrl_type)
+      slot->player_index = player_index;
+
+      // Get per-player feedback state
+      feedback_state_t* fb = (player_index >= 0) ? feedback_get_state(player_index) : NULL;
+
+      // Derive player LED index from feedback pattern (for USB output passthrough)
+      // Pattern: 0x01=P1, 0x02=P2, 0x04=P3, 0x08=P4
+      int8_t led_player_index = -1;
+      if (fb && fb->led.pattern) {
+        if (fb->led.pattern & 0x01) led_player_index = 0;
+        else if (fb->led.pattern & 0x02) led_player_index = 1;
+        else if (fb->led.pattern & 0x04) led_player_index = 2;
+        else if (fb->led.pattern & 0x08) led_player_index = 3;
+      }
+
+      // Use feedback LED player if set, otherwise use profile indicator display
+      int8_t display_player_index = (led_player_index >= 0)
+        ? led_player_index
+        : profile_indicator_get_display_player_index(player_index);
+
+      // Build legacy device output configuration from feedback state
+      config = (device_output_config_t){
+        .player_index = display_player_index,
+        .rumble = fb ? (fb->rumble.left > fb->rumble.right ? fb->rumble.left : fb->rumble.right) : 0,
+        .rumble_left = fb ? fb->rumble.left : 0,
+        .rumble_right = fb ? fb->rumble.right : 0,
+        .leds = fb ? fb->led.pattern : 0,
+        .trigger_threshold = trigger_threshold,
+        .test = test_counter
+      };
+
+      // Release the config to the driver once the OUT pipe is idle and the
+      // driver's interval has passed; a held change is retried next pass
+      uint16_t interval_ms = driver->feedback_interval_ms ? driver->feedback_interval_ms
+                                                          : USBH_FEEDBACK_INTERVAL_MS;
+      if (usbh_feedback_due(&slot->feedback, &config, now_ms, interval_ms,
+                            tuh_hid_send_ready(dev_addr, instance)))
       {
-      case CONTROLLER_DUALSENSE: // send DS5 LED and rumble
-      case CONTROLLER_DUALSHOCK3: // send DS3 Init, LED and rumble
-      case CONTROLLER_DUALSHOCK4: // send DS4 LED and rumble
-      case CONTROLLER_GAMECUBE: // send GameCube WiiU/Switch Adapter rumble
-      case CONTROLLER_KEYBOARD: // send Keyboard LEDs
-      case CONTROLLER_SWITCH: // send Switch Pro init, LED and rumble commands
-      case CONTROLLER_SWITCH2: // send Switch 2 Pro init, LED and rumble commands
-        {
-          // Get per-player feedback state
-          feedback_state_t* fb = (player_index >= 0) ? feedback_get_state(player_index) : NULL;
-
-          // Derive player LED index from feedback pattern (for USB output passthrough)
-          // Pattern: 0x01=P1, 0x02=P2, 0x04=P3, 0x08=P4
-          int8_t led_player_index = -1;
-          if (fb && fb->led.pattern) {
-            if (fb->led.pattern & 0x01) led_player_index = 0;
-            else if (fb->led.pattern & 0x02) led_player_index = 1;
-            else if (fb->led.pattern & 0x04) led_player_index = 2;
-            else if (fb->led.pattern & 0x08) led_player_index = 3;
-          }
-
-          // Use feedback LED player if set, otherwise use profile indicator display
-          int8_t display_player_index = (led_player_index >= 0)
-            ? led_player_index
-            : profile_indicator_get_display_player_index(player_index);
-
-          // Get trigger threshold from output interface (profile-based adaptive triggers)
-          uint8_t trigger_threshold = 0;
-          if (active_output && active_output->get_trigger_threshold) {
-            trigger_threshold = active_output->get_trigger_threshold();
-          }
-
-          // Build legacy device output configuration from feedback state
-          device_output_config_t config = {
-            .player_index = display_player_index,
-            .rumble = fb ? (fb->rumble.left > fb->rumble.right ? fb->rumble.left : fb->rumble.right) : 0,
-            .rumble_left = fb ? fb->rumble.left : 0,
-            .rumble_right = fb ? fb->rumble.right : 0,
-            .leds = fb ? fb->led.pattern : 0,
-            .trigger_threshold = trigger_threshold,
-            .test = test_counter
-          };
-
-          device_interfaces[ctrl_type]->task(dev_addr, instance, &config);
-        }
-        break;
-      default:
-        break;
+        usbh_feedback_sent(&slot->feedback, &config, now_ms);
+        released = true;
+      }
+      else if (usbh_feedback_changed(&slot->feedback, &config))
+      {
+        visit_slots |= 1u << (idx - 1);
       }
     }
+
+    // Timed drivers also run their init/resend timers on their own
+    // deadline and see the last released config
+    if (released || poll_due)
+    {
+      if (driver->task_poll_ms) slot->task_due_ms = now_ms + driver->task_poll_ms;
+
+      device_output_config_t task_config = slot->feedback.primed ? slot->feedback.sent : config;
+      driver->task(dev_addr, instance, &task_config);
+    }
+
+    if (driver->task_poll_ms && (int32_t)(slot->task_due_ms - next_poll_ms) < 0) {
+      next_poll_ms = slot->task_due_ms;
+    }
   }
 }
 
@@ -115,12 +287,10 @@ dev_type_t get_dev_type(uint8_t dev_addr, uint8_t instance, uint8_t const* desc_
   tuh_vid_pid_get(dev_addr, &vid, &pid);
   printf("VID = %04x, PID = %04x\r\n", vid, pid);
 
-  for (int i = 0; i < CONTROLLER_TYPE_COUNT-2; i++) {
-    if (device_interfaces[i] &&
-        device_interfaces[i]->is_device(vid, pid)) {
-      printf("DEVICE:[%s]\n", device_interfaces[i]->name);
-      return (dev_type_t)i;
-    }
+  dev_type_t matched = hid_registry_match(vid, pid);
+  if (matched != CONTROLLER_UNKNOWN) {
+    printf("DEVICE:[%s]\n", device_interfaces[matched]->name);
+    return matched;
   }
 
   // Interface protocol (hid_interface_protocol_enum_t)
@@ -164,9 +334,18 @@ dev_type_t get_dev_type(uint8_t dev_addr, uint8_t instance, uint8_t const* desc_
 void tuh_hid_mount_cb(uint8_t dev_addr, uint8_t instance, uint8_t const* desc_report, uint16_t desc_len)
 {
   printf("HID device address = %d, instance = %d is mounted\r\n", dev_addr, instance);
+  METRIC_INC(USB_HID_MOUNTS);
+
+  // Allocated before classification so check_descriptor() can use the context
+  hid_slot_t* slot = slot_alloc(dev_addr, instance);
+  if (!slot)
+  {
+    printf("Error: no free HID slot for device %d instance %d\r\n", dev_addr, instance);
+    return;
+  }
 
   dev_type_t dev_type = get_dev_type(dev_addr, instance, desc_report, desc_len);
-  devices[dev_addr].instances[instance].type = dev_type;
+  slot->type = dev_type;
 
   // Set device type and defaults
   switch (dev_type)
@@ -184,16 +363,16 @@ void tuh_hid_mount_cb(uint8_t dev_addr, uint8_t instance, uint8_t const* desc_re
     break;
   }
 
+  dedup_setup(slot);
+  slot_activate(slot);
+
   if (dev_type == CONTROLLER_UNKNOWN)
   {
-    // Safe on ARM Cortex-M0+: suppress alignment warning for packed struct access
-    #pragma GCC diagnostic push
-    #pragma GCC diagnostic ignored "-Waddress-of-packed-member"
-    tuh_hid_report_info_t* report_info_ptr = devices[dev_addr].instances[instance].report_info;
-    devices[dev_addr].instances[instance].report_count =
-      tuh_hid_parse_report_descriptor(report_info_ptr, MAX_REPORTS, desc_report, desc_len);
-    #pragma GCC diagnostic pop
-    printf("HID has %u reports \r\n", devices[dev_addr].instances[instance].report_count);
+    slot->report_count = tuh_hid_parse_report_descriptor(slot->report_info, MAX_REPORTS, desc_report, desc_len);
+    printf("HID has %u reports \r\n", slot->report_count);
+
+    // Report-protocol keyboards (NKRO) don't follow the boot layout
+    device_interfaces[CONTROLLER_KEYBOARD]->check_descriptor(dev_addr, instance, desc_report, desc_len);
   }
 
   // gets serial for discovering some devices
@@ -201,7 +380,7 @@ void tuh_hid_mount_cb(uint8_t dev_addr, uint8_t instance, uint8_t const* desc_re
   // if (0 == tuh_descriptor_get_serial_string_sync(dev_addr, LANGUAGE_ID, temp_buf, sizeof(temp_buf)))
   // {
   //   for(int i=0; i<20; i++){
-  //     devices[dev_addr].serial[i] = temp_buf[i];
+  //     serial[i] = temp_buf[i];
   //   }
   // }
 
@@ -218,36 +397,42 @@ void tuh_hid_umount_cb(uint8_t dev_addr, uint8_t instance)
 {
   printf("HID device address = %d, instance = %d is unmounted\r\n", dev_addr, instance);
 
+  hid_slot_t* slot = slot_get(dev_addr, instance);
+  if (!slot) return;
+
   // Reset device states
-  dev_type_t dev_type = devices[dev_addr].instances[instance].type;
+  dev_type_t dev_type = slot->type;
   switch (dev_type)
   {
   case CONTROLLER_DINPUT:
-  case CONTROLLER_DUALSENSE:
-  case CONTROLLER_DUALSHOCK3:
-  case CONTROLLER_DUALSHOCK4:
-    device_interfaces[dev_type]->unmount(dev_addr, instance);
-    // Unregister DS4 from auth passthrough
-    if (dev_type == CONTROLLER_DUALSHOCK4) {
-      ds4_auth_unregister(dev_addr, instance);
-    }
-    break;
-  case CONTROLLER_KEYBOARD:
-  case CONTROLLER_SWITCH:
   case CONTROLLER_SWITCH2:
     device_interfaces[dev_type]->unmount(dev_addr, instance);
     break;
+  case CONTROLLER_DUALSHOCK4:
+    // Unregister DS4 from auth passthrough
+    ds4_auth_unregister(dev_addr, instance);
+    break;
   default:
     break;
   }
 
-  devices[dev_addr].instances[instance].type = CONTROLLER_UNKNOWN;
+  slot_free(slot);
 }
 
 // Invoked when received report from device via interrupt endpoint
 void tuh_hid_report_received_cb(uint8_t dev_addr, uint8_t instance, uint8_t const* report, uint16_t len)
 {
-  dev_type_t dev_type = devices[dev_addr].instances[instance].type;
+  METRIC_INC(USB_HID_REPORTS);
+
+  hid_slot_t* slot = slot_get(dev_addr, instance);
+  if (!slot) return;
+
+  // Polling probes count changes in the bytes the driver reads
+  usbh_interval_report(dev_addr, instance, report, len,
+                       slot->dedup_mask_len ? slot->dedup_mask : NULL, slot->dedup_mask_len);
+
+  dev_type_t dev_type = slot->type;
+  slot->report_id = 0;
   if (dev_type == CONTROLLER_UNKNOWN)
   {
     uint8_t const itf_protocol = tuh_hid_interface_protocol(dev_addr, instance);
@@ -255,24 +440,29 @@ void tuh_hid_report_received_cb(uint8_t dev_addr, uint8_t instance, uint8_t cons
     {
       case HID_ITF_PROTOCOL_KEYBOARD:
         TU_LOG1("HID receive boot keyboard report\r\n");
-        device_interfaces[CONTROLLER_KEYBOARD]->process(dev_addr, instance, report, len);
+        device_interfaces[CONTROLLER_KEYBOARD]->process(dev_addr, instance, report, len, slot->ctx);
       break;
 
       case HID_ITF_PROTOCOL_MOUSE:
         TU_LOG1("HID receive boot mouse report\r\n");
-        device_interfaces[CONTROLLER_MOUSE]->process(dev_addr, instance, report, len);
+        device_interfaces[CONTROLLER_MOUSE]->process(dev_addr, instance, report, len, slot->ctx);
       break;
 
       default:
         TU_LOG1("HID receive generic report\r\n");
-        process_generic_report(dev_addr, instance, report, len);
+        process_generic_report(slot, report, len);
       break;
     }
   }
+  else if (dedup_unchanged(slot, report, len))
+  {
+    // nothing the driver reads has changed, skip the decode
+    METRIC_INC(USB_HID_REPORTS_DEDUPED);
+  }
   else
   {
     // process known device interface reports
-    device_interfaces[dev_type]->process(dev_addr, instance, report, len);
+    device_interfaces[dev_type]->process(dev_addr, instance, report, len, slot->ctx);
   }
 
   // continue to request to receive report
@@ -282,20 +472,54 @@ void tuh_hid_report_received_cb(uint8_t dev_addr, uint8_t instance, uint8_t cons
   }
 }
 
+//--------------------------------------------------------------------+
+// Raw Report Dedup
+//--------------------------------------------------------------------+
+
+// Ask the driver which report bits it decodes
+static void dedup_setup(hid_slot_t* slot)
+{
+  slot->dedup_mask_len = 0;
+  slot->dedup_len = 0;
+
+  dev_type_t dev_type = slot->type;
+  if (dev_type == CONTROLLER_UNKNOWN) return;
+  if (!device_interfaces[dev_type] || !device_interfaces[dev_type]->report_mask) return;
+
+  uint16_t mask_len = device_interfaces[dev_type]->report_mask(slot->dev_addr, slot->instance,
+                                                               slot->dedup_mask, DEDUP_MAX_LEN);
+  slot->dedup_mask_len = (mask_len <= DEDUP_MAX_LEN) ? mask_len : 0;
+}
+
+// Returns true if the report matches the previous one under the driver's mask.
+// Always records the new report.
+static bool dedup_unchanged(hid_slot_t* slot, uint8_t const* report, uint16_t len)
+{
+  if (slot->dedup_mask_len == 0) return false;
+
+  bool unchanged = (len == slot->dedup_len);
+  uint16_t n = (len < slot->dedup_mask_len) ? len : slot->dedup_mask_len;
+  for (uint16_t i = 0; i < n; i++) {
+    uint8_t masked = report[i] & slot->dedup_mask[i];
+    if (masked != slot->dedup_prev[i]) {
+      slot->dedup_prev[i] = masked;
+      unchanged = false;
+    }
+  }
+  slot->dedup_len = len;
+  return unchanged;
+}
+
 //--------------------------------------------------------------------+
 // Generic Report
 //--------------------------------------------------------------------+
 
-static void process_generic_report(uint8_t dev_addr, uint8_t instance, uint8_t const* report, uint16_t len)
+static void process_generic_report(hid_slot_t* slot, uint8_t const* report, uint16_t len)
 {
-  (void) dev_addr;
-
-  uint8_t const rpt_count = devices[dev_addr].instances[instance].report_count;
-  // Safe on ARM Cortex-M0+: suppress alignment warning for packed struct access
-  #pragma GCC diagnostic push
-  #pragma GCC diagnostic ignored "-Waddress-of-packed-member"
-  tuh_hid_report_info_t* rpt_info_arr = devices[dev_addr].instances[instance].report_info;
-  #pragma GCC diagnostic pop
+  uint8_t const dev_addr = slot->dev_addr;
+  uint8_t const instance = slot->instance;
+  uint8_t const rpt_count = slot->report_count;
+  tuh_hid_report_info_t* rpt_info_arr = slot->report_info;
   tuh_hid_report_info_t* rpt_info = NULL;
 
   if ( rpt_count == 1 && rpt_info_arr[0].report_id == 0)
@@ -318,6 +542,7 @@ static void process_generic_report(uint8_t dev_addr, uint8_t instance, uint8_t c
       }
     }
 
+    slot->report_id = rpt_id;
     report++;
     len--;
   }
@@ -342,13 +567,13 @@ static void process_generic_report(uint8_t dev_addr, uint8_t instance, uint8_t c
       case HID_USAGE_DESKTOP_KEYBOARD:
         TU_LOG1("HID receive keyboard report\r\n");
         // Assume keyboard follow boot report layout
-        device_interfaces[CONTROLLER_KEYBOARD]->process(dev_addr, instance, report, len);
+        device_interfaces[CONTROLLER_KEYBOARD]->process(dev_addr, instance, report, len, slot->ctx);
       break;
 
       case HID_USAGE_DESKTOP_MOUSE:
         TU_LOG1("HID receive mouse report\r\n");
         // Assume mouse follow boot report layout
-        device_interfaces[CONTROLLER_MOUSE]->process(dev_addr, instance, report, len);
+        device_interfaces[CONTROLLER_MOUSE]->process(dev_addr, instance, report, len, slot->ctx);
       break;
 
       default: break;
@@ -360,8 +585,9 @@ static void process_generic_report(uint8_t dev_addr, uint8_t instance, uint8_t c
 // Returns -1 if invalid, otherwise returns dev_type_t enum value
 int hid_get_ctrl_type(uint8_t dev_addr, uint8_t instance)
 {
-  if (dev_addr >= MAX_DEVICES || instance >= CFG_TUH_HID) {
+  if (dev_addr > HID_MAX_ADDR || instance >= CFG_TUH_HID) {
     return -1;
   }
-  return devices[dev_addr].instances[instance].type;
+  hid_slot_t* slot = slot_get(dev_addr, instance);
+  return slot ? slot->type : CONTROLLER_UNKNOWN;
 }
@@ -25,20 +25,50 @@ typedef struct {
 // DEVICE INTERFACE
 // ============================================================================
 
+// Per-interface driver context, held in hid.c's slot table
+#define HID_SLOT_CTX_SIZE 256
+
+// File-scope check that a driver's context type fits a slot
+#define HID_SLOT_CTX_CHECK(type) \
+    _Static_assert(sizeof(type) <= HID_SLOT_CTX_SIZE, #type " must fit a HID slot context")
+
+// VID/PID pair claimed by a driver
+typedef struct {
+    uint16_t vid;
+    uint16_t pid;
+} hid_device_id_t;
+
+// .ids/.id_count initializer from a const hid_device_id_t array
+#define HID_DEVICE_IDS(table) \
+    .ids = (table), .id_count = sizeof(table) / sizeof((table)[0])
+
 typedef struct {
     const char* name;
 
     // Device identification
+    // ids are merged into one sorted table at boot (hid_registry.c), so
+    // matching costs one binary search regardless of the driver count.
+    // is_device is an optional fallback for matches a table can't express.
+    const hid_device_id_t* ids;
+    uint8_t id_count;
     bool (*is_device)(uint16_t vid, uint16_t pid);
     bool (*check_descriptor)(uint8_t dev_addr, uint8_t instance, uint8_t const* desc_report, uint16_t desc_len);
 
     // Input processing
-    void (*process)(uint8_t dev_addr, uint8_t instance, const uint8_t *report, uint16_t len);
+    // ctx is this interface's zeroed-on-mount context (HID_SLOT_CTX_SIZE bytes)
+    void (*process)(uint8_t dev_addr, uint8_t instance, const uint8_t *report, uint16_t len, void* ctx);
 
-    // Output/feedback task (called periodically)
+    // Output/feedback task
     // Legacy: receives device_output_config_t
     // New drivers should use feedback_get_state(player_index) internally
+    // hid.c releases a new config only when it changed, the interface's
+    // OUT pipe is idle and feedback_interval_ms has passed (rumble stops
+    // skip the wait), and calls task() once per release. Set task_poll_ms
+    // for drivers that also need task() on a timer (init handshakes, their
+    // own resend timers); they get the last released config each time.
     void (*task)(uint8_t dev_addr, uint8_t instance, device_output_config_t* config);
+    uint8_t task_poll_ms;          // 0 = called on releases only
+    uint8_t feedback_interval_ms;  // 0 = USBH_FEEDBACK_INTERVAL_MS
 
     // Lifecycle
     bool (*init)(uint8_t dev_addr, uint8_t instance);
@@ -46,6 +76,22 @@ typedef struct {
 
     // Device capabilities (optional, NULL = unknown)
     uint16_t (*get_capabilities)(void);  // Returns FEEDBACK_CAP_* flags
+
+    // Raw report dedup (optional, NULL = every report is decoded)
+    // Called once on mount. Fills a per-byte AND mask over the raw report
+    // (report ID included) that drops counters, timestamps and other bits
+    // the driver ignores, and returns its length; bytes past it are ignored.
+    // hid.c skips process() when the masked bytes and length are unchanged.
+    // Return 0 to disable dedup for this instance.
+    uint16_t (*report_mask)(uint8_t dev_addr, uint8_t instance, uint8_t* mask, uint16_t max_len);
 } DeviceInterface;
 
+// Context of a mounted interface, NULL if not mounted. For the callbacks
+// that don't receive it (check_descriptor, task, unmount, report_mask).
+void* hid_slot_ctx(uint8_t dev_addr, uint8_t instance);
+
+// Report ID hid.c stripped from the report being processed, 0 if the report
+// carried none. Only the generic report path strips IDs.
+uint8_t hid_slot_report_id(uint8_t dev_addr, uint8_t instance);
+
 #endif // DEVICE_INTERFACE_H
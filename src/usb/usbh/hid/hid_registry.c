@@ -24,9 +24,89 @@
 #include "devices/vendors/google/google_stadia.h"
 #include "devices/vendors/raphnet/raphnet_pce.h"
 // Include other devices here
+#include <stdio.h>
 
 DeviceInterface* device_interfaces[CONTROLLER_TYPE_COUNT] = {0};
 
+// ============================================================================
+// VID/PID INDEX
+// ============================================================================
+// Every registered driver's ids merged and sorted once at boot. Equal keys
+// keep registration-enum order, so the lower controller type still wins.
+
+#define HID_ID_INDEX_MAX 64
+
+typedef struct {
+    uint32_t key;       // vid << 16 | pid
+    dev_type_t type;
+} hid_id_entry_t;
+
+static hid_id_entry_t id_index[HID_ID_INDEX_MAX];
+static uint8_t id_index_count = 0;
+
+// Drivers with an is_device() predicate, tried when the index misses
+static dev_type_t predicate_types[CONTROLLER_TYPE_COUNT];
+static uint8_t predicate_count = 0;
+
+static void build_id_index(void) {
+    id_index_count = 0;
+    predicate_count = 0;
+
+    for (int t = 0; t < CONTROLLER_TYPE_COUNT; t++) {
+        const DeviceInterface* dev = device_interfaces[t];
+        if (!dev) continue;
+        if (dev->is_device) predicate_types[predicate_count++] = (dev_type_t)t;
+
+        for (uint8_t i = 0; i < dev->id_count; i++) {
+            if (id_index_count >= HID_ID_INDEX_MAX) {
+                printf("[hid] id index full, %s %04x:%04x dropped\n",
+                       dev->name, dev->ids[i].vid, dev->ids[i].pid);
+                continue;
+            }
+
+            // Insertion sort (stable, runs once)
+            uint32_t key = ((uint32_t)dev->ids[i].vid << 16) | dev->ids[i].pid;
+            int j = id_index_count++;
+            while (j > 0 && id_index[j - 1].key > key) {
+                id_index[j] = id_index[j - 1];
+                j--;
+            }
+            id_index[j].key = key;
+            id_index[j].type = (dev_type_t)t;
+
+            if (j > 0 && id_index[j - 1].key == key) {
+                printf("[hid] %04x:%04x claimed by %s and %s\n", dev->ids[i].vid, dev->ids[i].pid,
+                       device_interfaces[id_index[j - 1].type]->name, dev->name);
+            }
+        }
+    }
+}
+
+dev_type_t hid_registry_match(uint16_t vid, uint16_t pid) {
+    uint32_t key = ((uint32_t)vid << 16) | pid;
+
+    // Lower bound, so the first of equal keys is found
+    uint8_t lo = 0, hi = id_index_count;
+    while (lo < hi) {
+        uint8_t mid = (lo + hi) / 2;
+        if (id_index[mid].key < key) lo = mid + 1;
+        else hi = mid;
+    }
+    if (lo < id_index_count && id_index[lo].key == key) {
+        return id_index[lo].type;
+    }
+
+    for (uint8_t i = 0; i < predicate_count; i++) {
+        dev_type_t t = predicate_types[i];
+        if (device_interfaces[t]->is_device(vid, pid)) return t;
+    }
+    return CONTROLLER_UNKNOWN;
+}
+
+// ============================================================================
+// REGISTRATION
+// ============================================================================
+
 void register_devices() {
     device_interfaces[CONTROLLER_DUALSHOCK3] = &sony_ds3_interface;
     device_interfaces[CONTROLLER_DUALSHOCK4] = &sony_ds4_interface;
@@ -53,4 +133,6 @@ void register_devices() {
     // disabled devices
     // device_interfaces[CONTROLLER_DRAGONRISE] = &dragonrise_interface; // deprecated
     // device_interfaces[CONTROLLER_8BITDO_NEO] = &bitdo_neo_interface; // incomplete
+
+    build_id_index();
 }
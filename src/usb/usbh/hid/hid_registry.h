@@ -30,3 +30,7 @@ typedef enum {
 extern DeviceInterface* device_interfaces[CONTROLLER_TYPE_COUNT];
 
 void register_devices();
+
+// Driver claiming this VID/PID (sorted index, then is_device() predicates),
+// CONTROLLER_UNKNOWN if none
+dev_type_t hid_registry_match(uint16_t vid, uint16_t pid);
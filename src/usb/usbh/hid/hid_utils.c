@@ -1,4 +1,5 @@
 #include "hid_utils.h"
+#include <string.h>
 
 // check if different than 2
 bool diff_than_n(uint16_t x, uint16_t y, uint8_t n)
@@ -18,4 +19,12 @@ void ensureAllNonZero(uint8_t* axis_1x, uint8_t* axis_1y, uint8_t* axis_2x, uint
     ensureNonZero(axis_1y);
     ensureNonZero(axis_2x);
     ensureNonZero(axis_2y);
-}
\ No newline at end of file
+}
+
+// copy a constant report mask, 0 (dedup off) if it doesn't fit
+uint16_t copy_report_mask(const uint8_t* src, uint16_t src_len, uint8_t* mask, uint16_t max_len)
+{
+  if (src_len > max_len) return 0;
+  memcpy(mask, src, src_len);
+  return src_len;
+}
@@ -9,4 +9,7 @@ bool diff_than_n(uint16_t x, uint16_t y, uint8_t n);
 
 void ensureAllNonZero(uint8_t* axis_1x, uint8_t* axis_1y, uint8_t* axis_2x, uint8_t* axis_2y);
 
+// Copy a driver's constant report mask for DeviceInterface.report_mask
+uint16_t copy_report_mask(const uint8_t* src, uint16_t src_len, uint8_t* mask, uint16_t max_len);
+
 #endif // DEVICE_UTILS_H
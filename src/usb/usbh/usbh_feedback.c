@@ -0,0 +1,52 @@
+// usbh_feedback.c - Output feedback scheduling for USB host drivers
+#include "usbh_feedback.h"
+#include "core/services/metrics/metrics.h"
+#include <string.h>
+
+// Field-wise so struct padding can't read as a change
+static bool config_equal(const device_output_config_t* a, const device_output_config_t* b)
+{
+  return a->player_index == b->player_index &&
+         a->rumble == b->rumble &&
+         a->rumble_left == b->rumble_left &&
+         a->rumble_right == b->rumble_right &&
+         a->leds == b->leds &&
+         a->trigger_threshold == b->trigger_threshold &&
+         a->test == b->test;
+}
+
+static bool rumble_active(const device_output_config_t* cfg)
+{
+  return cfg->rumble || cfg->rumble_left || cfg->rumble_right;
+}
+
+void usbh_feedback_reset(usbh_feedback_t* fb)
+{
+  memset(fb, 0, sizeof(*fb));
+}
+
+bool usbh_feedback_changed(const usbh_feedback_t* fb, const device_output_config_t* cfg)
+{
+  return !fb->primed || !config_equal(cfg, &fb->sent);
+}
+
+bool usbh_feedback_due(const usbh_feedback_t* fb, const device_output_config_t* cfg,
+                       uint32_t now_ms, uint16_t interval_ms, bool out_ready)
+{
+  if (!fb->primed) return out_ready;
+  if (config_equal(cfg, &fb->sent)) return false;
+  if (!out_ready) return false;
+
+  // Stopping rumble can't wait
+  if (rumble_active(&fb->sent) && !rumble_active(cfg)) return true;
+
+  return now_ms - fb->sent_ms >= interval_ms;
+}
+
+void usbh_feedback_sent(usbh_feedback_t* fb, const device_output_config_t* cfg, uint32_t now_ms)
+{
+  fb->sent = *cfg;
+  fb->sent_ms = now_ms;
+  fb->primed = true;
+  METRIC_INC(USB_FEEDBACK_SENDS);
+}
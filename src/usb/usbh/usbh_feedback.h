@@ -0,0 +1,41 @@
+// usbh_feedback.h - Output feedback scheduling for USB host drivers
+//
+// Rumble and LED state is rebuilt every host task pass, but a pad only
+// needs an output report when that state changes, and one in flight is
+// enough. Each interface keeps a usbh_feedback_t with the config it was
+// last sent. The caller asks usbh_feedback_due() whether the current
+// config should go out now. That holds for a change once the previous
+// transfer is done and the driver's interval has passed since the last
+// send. A rumble stop skips the interval so motors never run on after
+// the game releases them. Changes that arrive while a send is held are
+// coalesced into the next one.
+
+#ifndef USBH_FEEDBACK_H
+#define USBH_FEEDBACK_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "usb/usbh/hid/hid_device.h"
+
+#define USBH_FEEDBACK_INTERVAL_MS 20  // Default minimum spacing of sends
+
+typedef struct {
+    device_output_config_t sent;  // Last config the device was sent
+    uint32_t sent_ms;
+    bool primed;                  // sent is valid
+} usbh_feedback_t;
+
+// Forget what was sent (mount/unmount); the next config always goes out
+void usbh_feedback_reset(usbh_feedback_t* fb);
+
+// cfg differs from the config last sent, or nothing was sent yet
+bool usbh_feedback_changed(const usbh_feedback_t* fb, const device_output_config_t* cfg);
+
+// out_ready: no output transfer in flight for this interface
+bool usbh_feedback_due(const usbh_feedback_t* fb, const device_output_config_t* cfg,
+                       uint32_t now_ms, uint16_t interval_ms, bool out_ready);
+
+// Record cfg as sent at now_ms
+void usbh_feedback_sent(usbh_feedback_t* fb, const device_output_config_t* cfg, uint32_t now_ms);
+
+#endif // USBH_FEEDBACK_H
@@ -0,0 +1,175 @@
+// usbh_interval.c - Per-device interrupt polling interval overrides
+#include "tusb.h"
+#include "pico/time.h"
+#include "usbh_interval.h"
+#include <stdio.h>
+#include <string.h>
+
+typedef enum {
+  INTERVAL_FIXED,   // Known good at the override rate
+  INTERVAL_PROBE,   // Verify on first mount, fall back if no gain
+} interval_mode_t;
+
+typedef struct {
+  uint16_t vid;
+  uint16_t pid;
+  uint8_t interval_ms;
+  interval_mode_t mode;
+} interval_override_t;
+
+static const interval_override_t overrides[] = {
+  {0x054c, 0x05c4, 1, INTERVAL_FIXED},  // Sony DualShock4 (bInterval 5)
+  {0x054c, 0x09cc, 1, INTERVAL_FIXED},  // Sony DualShock4 (bInterval 5)
+  {0x057e, 0x0337, 1, INTERVAL_FIXED},  // GameCube Adapter (bInterval 8)
+  {0x054c, 0x0ce6, 1, INTERVAL_PROBE},  // Sony DualSense
+  {0x045e, 0x028e, 1, INTERVAL_PROBE},  // Xbox 360 Wired (bInterval 4)
+};
+
+#define OVERRIDE_COUNT (sizeof(overrides) / sizeof(overrides[0]))
+
+// Probe verdicts, RAM only
+typedef enum {
+  VERDICT_NONE = 0,
+  VERDICT_PASSED,
+  VERDICT_FAILED,
+} verdict_t;
+
+static uint8_t verdicts[OVERRIDE_COUNT];
+
+// A changed report that follows the previous one by less than half the
+// descriptor interval is one the device couldn't have delivered before.
+#define PROBE_FRESH_REPORTS 256  // Changed reports to collect before failing
+#define PROBE_FAST_REPORTS  32   // Fast changed reports needed to pass
+
+typedef struct {
+  int8_t entry;            // overrides[] index, -1 = none
+  bool probing;
+  uint8_t desc_interval;   // Slowest original bInterval that was rewritten
+  uint8_t instance;        // Interface being measured, 0xFF = first to report
+  uint32_t last_hash;
+  uint32_t last_fresh_us;
+  uint16_t fresh;
+  uint16_t fast;
+} interval_state_t;
+
+// Device addresses are 1-based
+static interval_state_t states[CFG_TUH_DEVICE_MAX + 1];
+
+static int8_t find_override(uint16_t vid, uint16_t pid)
+{
+  for (uint8_t i = 0; i < OVERRIDE_COUNT; i++) {
+    if (overrides[i].vid == vid && overrides[i].pid == pid) return i;
+  }
+  return -1;
+}
+
+//--------------------------------------------------------------------+
+// Enumeration
+//--------------------------------------------------------------------+
+
+bool tuh_enum_descriptor_device_cb(uint8_t daddr, tusb_desc_device_t const* desc_device)
+{
+  if (daddr > CFG_TUH_DEVICE_MAX) return true;
+
+  interval_state_t* st = &states[daddr];
+  memset(st, 0, sizeof(*st));
+  st->instance = 0xFF;
+
+  int8_t entry = find_override(desc_device->idVendor, desc_device->idProduct);
+  if (entry >= 0 && verdicts[entry] == VERDICT_FAILED) {
+    printf("[usbh] %04x:%04x polling override disabled by earlier probe\n",
+           desc_device->idVendor, desc_device->idProduct);
+    entry = -1;
+  }
+  st->entry = entry;
+  return true;
+}
+
+// The descriptor sits in usbh's enumeration buffer and is parsed right after
+// this returns, so the rewrite reaches every endpoint the class drivers open.
+bool tuh_enum_descriptor_configuration_cb(uint8_t daddr, uint8_t cfg_index, tusb_desc_configuration_t const* desc_config)
+{
+  (void)cfg_index;
+  if (daddr > CFG_TUH_DEVICE_MAX) return true;
+
+  interval_state_t* st = &states[daddr];
+  if (st->entry < 0) return true;
+  const interval_override_t* ov = &overrides[st->entry];
+
+  uint8_t* p = (uint8_t*)desc_config;
+  uint8_t const* end = p + tu_le16toh(desc_config->wTotalLength);
+  uint8_t patched = 0;
+
+  while (p < end && tu_desc_len(p) >= 2) {
+    if (tu_desc_type(p) == TUSB_DESC_ENDPOINT) {
+      tusb_desc_endpoint_t* ep = (tusb_desc_endpoint_t*)p;
+      if (ep->bmAttributes.xfer == TUSB_XFER_INTERRUPT &&
+          tu_edpt_dir(ep->bEndpointAddress) == TUSB_DIR_IN &&
+          ep->bInterval > ov->interval_ms) {
+        if (ep->bInterval > st->desc_interval) st->desc_interval = ep->bInterval;
+        ep->bInterval = ov->interval_ms;
+        patched++;
+      }
+    }
+    p = (uint8_t*)tu_desc_next(p);
+  }
+
+  if (patched) {
+    st->probing = (ov->mode == INTERVAL_PROBE && verdicts[st->entry] == VERDICT_NONE);
+    printf("[usbh] %04x:%04x polling %dms -> %dms%s\n", ov->vid, ov->pid,
+           st->desc_interval, ov->interval_ms, st->probing ? " (probing)" : "");
+  }
+  return true;
+}
+
+//--------------------------------------------------------------------+
+// Probe
+//--------------------------------------------------------------------+
+
+static void probe_finish(interval_state_t* st, verdict_t verdict)
+{
+  const interval_override_t* ov = &overrides[st->entry];
+  verdicts[st->entry] = verdict;
+  st->probing = false;
+
+  printf("[usbh] %04x:%04x %dms probe %s (%d of %d changed reports were fast)\n",
+         ov->vid, ov->pid, ov->interval_ms,
+         verdict == VERDICT_PASSED ? "passed" : "failed, reverting on next mount",
+         st->fast, st->fresh);
+}
+
+void usbh_interval_report(uint8_t dev_addr, uint8_t instance, const void* report, uint16_t len,
+                          const uint8_t* mask, uint16_t mask_len)
+{
+  if (dev_addr > CFG_TUH_DEVICE_MAX) return;
+  interval_state_t* st = &states[dev_addr];
+  if (!st->probing) return;
+
+  // Reports from other interfaces would all look fresh
+  if (st->instance == 0xFF) st->instance = instance;
+  if (instance != st->instance) return;
+
+  // FNV-1a over the masked bytes; identical reports are just the device
+  // repeating itself, and a ticking counter alone isn't new input
+  const uint8_t* data = report;
+  uint16_t n = (mask && mask_len < len) ? mask_len : len;
+  uint32_t hash = (0x811C9DC5 ^ len) * 0x01000193;
+  for (uint16_t i = 0; i < n; i++) {
+    hash = (hash ^ (mask ? data[i] & mask[i] : data[i])) * 0x01000193;
+  }
+  if (st->fresh && hash == st->last_hash) return;
+  st->last_hash = hash;
+
+  uint32_t now_us = time_us_32();
+  if (st->fresh && now_us - st->last_fresh_us < st->desc_interval * 500u) {
+    st->fast++;
+  }
+  st->last_fresh_us = now_us;
+  st->fresh++;
+
+  if (st->fast >= PROBE_FAST_REPORTS) {
+    probe_finish(st, VERDICT_PASSED);
+  } else if (st->fresh >= PROBE_FRESH_REPORTS) {
+    probe_finish(st, VERDICT_FAILED);
+  }
+}
@@ -0,0 +1,28 @@
+// usbh_interval.h - Per-device interrupt polling interval overrides
+//
+// Many pads advertise a conservative bInterval (4-10ms) but answer fine at
+// 1ms, so the descriptor rather than the hardware sets the latency floor.
+// Devices listed in usbh_interval.c get the bInterval of their interrupt IN
+// endpoints rewritten during enumeration, before any class driver opens
+// them. Both the native and PIO-USB host controllers take the interval from
+// that descriptor.
+//
+// PROBE entries are unverified. The first mount measures how often the
+// device delivers changed reports (after its driver's report mask); if it never delivers them faster than
+// its own bInterval allowed, the override is dropped for that VID/PID from
+// the next enumeration on (until reboot). A probe cut short by an unplug
+// runs again on the next mount.
+
+#ifndef USBH_INTERVAL_H
+#define USBH_INTERVAL_H
+
+#include <stdint.h>
+
+// Feed every input report while a probe may be running (cheap otherwise).
+// mask is a per-byte AND mask over the report, like the one a HID driver's
+// report_mask fills, so counters, timestamps and IMU data don't count as
+// changes; bytes past mask_len are ignored. NULL compares the whole report.
+void usbh_interval_report(uint8_t dev_addr, uint8_t instance, const void* report, uint16_t len,
+                          const uint8_t* mask, uint16_t mask_len);
+
+#endif // USBH_INTERVAL_H
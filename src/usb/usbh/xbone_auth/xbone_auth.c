@@ -16,6 +16,7 @@
 
 #define REPORT_QUEUE_SIZE      16
 #define REPORT_QUEUE_INTERVAL  15  // ms
+#define DONGLE_BOOT_HOLDOFF    50  // ms to ignore reports after an invalid one
 
 // Power-on and rumble commands for dongle initialization
 static const uint8_t xb1_power_on[] = {
@@ -49,6 +50,7 @@ static uint8_t queue_head = 0;
 static uint8_t queue_tail = 0;
 static uint8_t queue_count = 0;
 static uint32_t last_report_queue_sent = 0;
+static uint32_t incoming_holdoff_until = 0;
 
 // ============================================================================
 // HELPER FUNCTIONS
@@ -169,7 +171,8 @@ void xbone_auth_task(void)
             last_report_queue_sent = now;
         } else {
             printf("[xbone_auth] Failed to send report to controller\n");
-            busy_wait_ms(REPORT_QUEUE_INTERVAL);
+            // Retry after the queue interval instead of stalling the USB task
+            last_report_queue_sent = now;
         }
     }
 }
@@ -218,12 +221,17 @@ void xbone_auth_report_received(uint8_t dev_addr, uint8_t instance,
         return;
     }
 
+    uint32_t now = to_ms_since_boot(get_absolute_time());
+    if ((int32_t)(now - incoming_holdoff_until) < 0) {
+        return;
+    }
+
     xgip_parse(&incoming_xgip, report, len);
 
     if (!xgip_validate(&incoming_xgip)) {
         printf("[xbone_auth] Invalid packet, resetting\n");
-        // First packet may be invalid, wait for dongle boot
-        busy_wait_ms(50);
+        // First packet may be invalid; drop reports while the dongle boots
+        incoming_holdoff_until = now + DONGLE_BOOT_HOLDOFF;
         xgip_reset(&incoming_xgip);
         return;
     }
@@ -6,8 +6,12 @@
 #include "core/services/players/manager.h"
 #include "core/services/players/feedback.h"
 #include "core/router/router.h"
+#include "core/services/metrics/metrics.h"
 #include "xinput_host.h"
+#include "xinput_decode.h"
 #include "chatpad.h"
+#include "usb/usbh/usbh_interval.h"
+#include "usb/usbh/usbh_feedback.h"
 #include "core/input_event.h"
 
 // Xbox One auth passthrough - weak stubs for non-USB-device builds
@@ -30,7 +34,13 @@ int last_player_count = 0; // used by xboxone
 // Size +1 because device addresses are 1-indexed (1 to CFG_TUH_DEVICE_MAX inclusive)
 static uint32_t chatpad_last_keepalive[CFG_TUH_DEVICE_MAX + 1][CFG_TUH_XINPUT];
 
-uint8_t byteScaleAnalog(int16_t xbox_val);
+// Rumble/LED last sent per device/instance (same indexing)
+static usbh_feedback_t xinput_feedback[CFG_TUH_DEVICE_MAX + 1][CFG_TUH_XINPUT];
+#define XINPUT_FEEDBACK_INTERVAL_MS 10
+
+// Interfaces tuh_xinput_mount_cb() accepted (same indexing). Players on other
+// USB drivers share dev_addr/instance numbering, so the task checks this first.
+static bool xinput_mounted[CFG_TUH_DEVICE_MAX + 1][CFG_TUH_XINPUT];
 
 //--------------------------------------------------------------------+
 // Custom USB Host Drivers
@@ -76,12 +86,36 @@ usbh_class_driver_t const* usbh_app_driver_get_cb(uint8_t* driver_count) {
 //--------------------------------------------------------------------+
 #if CFG_TUH_XINPUT
 
+// The decoder reads the 12-byte pad tusb_xinput copied out of the IN buffer
+_Static_assert(sizeof(xinput_gamepad_t) == XINPUT_PAD_LEN, "xinput_gamepad_t must be 12 bytes");
+
+// The nibble tables below follow the wButtons bit order
+_Static_assert(XINPUT_GAMEPAD_DPAD_UP == 0x0001 && XINPUT_GAMEPAD_DPAD_DOWN == 0x0002 &&
+               XINPUT_GAMEPAD_DPAD_LEFT == 0x0004 && XINPUT_GAMEPAD_DPAD_RIGHT == 0x0008 &&
+               XINPUT_GAMEPAD_START == 0x0010 && XINPUT_GAMEPAD_BACK == 0x0020 &&
+               XINPUT_GAMEPAD_LEFT_THUMB == 0x0040 && XINPUT_GAMEPAD_RIGHT_THUMB == 0x0080 &&
+               XINPUT_GAMEPAD_LEFT_SHOULDER == 0x0100 && XINPUT_GAMEPAD_RIGHT_SHOULDER == 0x0200 &&
+               XINPUT_GAMEPAD_GUIDE == 0x0400 && XINPUT_GAMEPAD_SHARE == 0x0800 &&
+               XINPUT_GAMEPAD_A == 0x1000 && XINPUT_GAMEPAD_B == 0x2000 &&
+               XINPUT_GAMEPAD_X == 0x4000 && XINPUT_GAMEPAD_Y == 0x8000,
+               "unexpected wButtons layout");
+
+// Note: No threshold-based L2/R2 - let output profiles handle analog-to-digital
+// Xbox triggers are purely analog; digital behavior is profile/output dependent
+static const xinput_decoder_t xinput_decoder = {{
+  XINPUT_NIBBLE(JP_BUTTON_DU, JP_BUTTON_DD, JP_BUTTON_DL, JP_BUTTON_DR),  // D-pad up, down, left, right
+  XINPUT_NIBBLE(JP_BUTTON_S2, JP_BUTTON_S1, JP_BUTTON_L3, JP_BUTTON_R3),  // Start, Back, LS, RS
+  XINPUT_NIBBLE(JP_BUTTON_L1, JP_BUTTON_R1, JP_BUTTON_A1, JP_BUTTON_A2),  // LB, RB, Guide, Share
+  XINPUT_NIBBLE(JP_BUTTON_B1, JP_BUTTON_B2, JP_BUTTON_B3, JP_BUTTON_B4),  // A, B, X, Y
+}};
+
 void tuh_xinput_report_received_cb(uint8_t dev_addr, uint8_t instance, xinputh_interface_t const* xid_itf, uint16_t len)
 {
-  uint32_t buttons;
   const xinput_gamepad_t *p = &xid_itf->pad;
   const char* type_str;
 
+  METRIC_INC(USB_XINPUT_REPORTS);
+
   if (xid_itf->last_xfer_result == XFER_RESULT_SUCCESS)
   {
     switch (xid_itf->type)
@@ -95,50 +129,22 @@ void tuh_xinput_report_received_cb(uint8_t dev_addr, uint8_t instance, xinputh_i
 
     if (xid_itf->connected && xid_itf->new_pad_data)
     {
+      usbh_interval_report(dev_addr, instance, p, sizeof(*p), NULL, 0);
+
       TU_LOG1("[%02x, %02x], Type: %s, Buttons %04x, LT: %02x RT: %02x, LX: %d, LY: %d, RX: %d, RY: %d\n",
         dev_addr, instance, type_str, p->wButtons, p->bLeftTrigger, p->bRightTrigger, p->sThumbLX, p->sThumbLY, p->sThumbRX, p->sThumbRY);
 
-      // Scale Xbox analog values to [1-255] range (platform-agnostic)
-      // XInput uses positive Y = UP, but internal format uses Y: 0=UP, 255=DOWN
-      // So we invert Y-axis values to match HID convention
-      uint8_t analog_1x = byteScaleAnalog(p->sThumbLX);
-      uint8_t analog_1y = 256 - byteScaleAnalog(p->sThumbLY);  // Invert Y
-      uint8_t analog_2x = byteScaleAnalog(p->sThumbRX);
-      uint8_t analog_2y = 256 - byteScaleAnalog(p->sThumbRY);  // Invert Y
-      uint8_t analog_l = p->bLeftTrigger;
-      uint8_t analog_r = p->bRightTrigger;
-
-      buttons = (((p->wButtons & XINPUT_GAMEPAD_DPAD_UP)       ? JP_BUTTON_DU : 0) |
-                ((p->wButtons & XINPUT_GAMEPAD_DPAD_DOWN)      ? JP_BUTTON_DD : 0) |
-                ((p->wButtons & XINPUT_GAMEPAD_DPAD_LEFT)      ? JP_BUTTON_DL : 0) |
-                ((p->wButtons & XINPUT_GAMEPAD_DPAD_RIGHT)     ? JP_BUTTON_DR : 0) |
-                ((p->wButtons & XINPUT_GAMEPAD_A)              ? JP_BUTTON_B1 : 0) |
-                ((p->wButtons & XINPUT_GAMEPAD_B)              ? JP_BUTTON_B2 : 0) |
-                ((p->wButtons & XINPUT_GAMEPAD_X)              ? JP_BUTTON_B3 : 0) |
-                ((p->wButtons & XINPUT_GAMEPAD_Y)              ? JP_BUTTON_B4 : 0) |
-                ((p->wButtons & XINPUT_GAMEPAD_LEFT_SHOULDER)  ? JP_BUTTON_L1 : 0) |
-                ((p->wButtons & XINPUT_GAMEPAD_RIGHT_SHOULDER) ? JP_BUTTON_R1 : 0) |
-                // Note: No threshold-based L2/R2 - let output profiles handle analog-to-digital
-                // Xbox triggers are purely analog; digital behavior is profile/output dependent
-                ((p->wButtons & XINPUT_GAMEPAD_BACK)           ? JP_BUTTON_S1 : 0) |
-                ((p->wButtons & XINPUT_GAMEPAD_START)          ? JP_BUTTON_S2 : 0) |
-                ((p->wButtons & XINPUT_GAMEPAD_LEFT_THUMB)     ? JP_BUTTON_L3 : 0) |
-                ((p->wButtons & XINPUT_GAMEPAD_RIGHT_THUMB)    ? JP_BUTTON_R3 : 0) |
-                ((p->wButtons & XINPUT_GAMEPAD_GUIDE)          ? JP_BUTTON_A1 : 0) |
-                ((p->wButtons & XINPUT_GAMEPAD_SHARE)          ? JP_BUTTON_A2 : 0));
-
       input_event_t event = {
         .dev_addr = dev_addr,
         .instance = instance,
         .type = INPUT_TYPE_GAMEPAD,
         .transport = INPUT_TRANSPORT_USB,
-        .buttons = buttons,
         .button_count = 10,  // Xbox: A, B, X, Y, LB, RB, LT, RT, L3, R3
-        .analog = {analog_1x, analog_1y, analog_2x, analog_2y, analog_l, analog_r},
         .keys = 0,
         .chatpad = {xid_itf->chatpad_data[0], xid_itf->chatpad_data[1], xid_itf->chatpad_data[2]},
         .has_chatpad = xid_itf->chatpad_enabled && xid_itf->chatpad_inited
       };
+      event.buttons = xinput_decode_pad(&xinput_decoder, (const uint8_t*)p, event.analog);
       router_submit_input(&event);
     }
   }
@@ -177,6 +183,12 @@ void tuh_xinput_mount_cb(uint8_t dev_addr, uint8_t instance, const xinputh_inter
     chatpad_last_keepalive[dev_addr][instance] = 0;
   }
 
+  if (dev_addr <= CFG_TUH_DEVICE_MAX && instance < CFG_TUH_XINPUT)
+  {
+    usbh_feedback_reset(&xinput_feedback[dev_addr][instance]);
+    xinput_mounted[dev_addr][instance] = true;
+  }
+
   tuh_xinput_set_led(dev_addr, instance, 0, true);
   // tuh_xinput_set_rumble(dev_addr, instance, 0, 0, true);
   tuh_xinput_receive_report(dev_addr, instance);
@@ -186,19 +198,15 @@ void tuh_xinput_umount_cb(uint8_t dev_addr, uint8_t instance)
 {
   printf("XINPUT UNMOUNTED %02x %d\n", dev_addr, instance);
 
+  if (dev_addr <= CFG_TUH_DEVICE_MAX && instance < CFG_TUH_XINPUT)
+  {
+    xinput_mounted[dev_addr][instance] = false;
+  }
+
   // Unregister from auth passthrough
   xbone_auth_unregister(dev_addr);
 }
 
-uint8_t byteScaleAnalog(int16_t xbox_val)
-{
-  // Scale the xbox value from [-32768, 32767] to [1, 255]
-  // Offset by 32768 to get in range [0, 65536], then divide by 256 to get in range [1, 255]
-  uint8_t scale_val = (xbox_val + 32768) / 256;
-  if (scale_val == 0) return 1;
-  return scale_val;
-}
-
 void xinput_task(void)
 {
   // Process Xbox One auth passthrough
@@ -212,6 +220,7 @@ void xinput_task(void)
   {
     for (uint8_t instance = 0; instance < CFG_TUH_XINPUT; instance++)
     {
+      if (!xinput_mounted[dev_addr][instance]) continue;
       if (now - chatpad_last_keepalive[dev_addr][instance] >= XINPUT_CHATPAD_KEEPALIVE_MS)
       {
         // tuh_xinput_chatpad_keepalive returns false if chatpad not enabled/inited
@@ -235,13 +244,38 @@ void xinput_task(void)
     uint8_t dev_addr = players[i].dev_addr;
     uint8_t instance = players[i].instance;
 
+    if (dev_addr > CFG_TUH_DEVICE_MAX || instance >= CFG_TUH_XINPUT) continue;
+    // HID pads and a wireless receiver with no pad connected have no
+    // XInput OUT pipe; sending to them would fail and retry every pass
+    if (!xinput_mounted[dev_addr][instance]) continue;
+
     // Get per-player feedback state
     feedback_state_t* fb = feedback_get_state(i);
     uint8_t rumble = fb ? (fb->rumble.left > fb->rumble.right ? fb->rumble.left : fb->rumble.right) : 0;
 
-    // TODO: throttle and only fire if device is xinput
-    tuh_xinput_set_led(dev_addr, instance, i+1, true);
-    tuh_xinput_set_rumble(dev_addr, instance, rumble, rumble, true);
+    device_output_config_t config = {
+      .player_index = i,
+      .rumble = rumble,
+    };
+
+    // LED and rumble share the OUT endpoint, so at most one goes out per
+    // pass; a send that can't claim the endpoint is retried next pass
+    usbh_feedback_t* sched = &xinput_feedback[dev_addr][instance];
+    if (!usbh_feedback_due(sched, &config, now, XINPUT_FEEDBACK_INTERVAL_MS, true)) continue;
+
+    if (!sched->primed || sched->sent.player_index != config.player_index)
+    {
+      if (tuh_xinput_set_led(dev_addr, instance, i+1, false))
+      {
+        device_output_config_t led_only = sched->sent;
+        led_only.player_index = config.player_index;
+        usbh_feedback_sent(sched, &led_only, now);
+      }
+    }
+    else if (tuh_xinput_set_rumble(dev_addr, instance, rumble, rumble, false))
+    {
+      usbh_feedback_sent(sched, &config, now);
+    }
   }
 }
 
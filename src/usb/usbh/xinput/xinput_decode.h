@@ -0,0 +1,59 @@
+// xinput_decode.h
+// Fixed-offset decoder for the XINPUT_GAMEPAD layout
+//
+// Every XInput flavour tusb_xinput supports (360 wired/wireless, OG Xbox,
+// Xbox One GIP) ends up as the same 12-byte little-endian gamepad block:
+//
+//   0-1 wButtons  2 LT  3 RT  4-5 LX  6-7 LY  8-9 RX  10-11 RY
+//
+// tusb_xinput copies each frame's block into the interface's pad; this reads
+// that pad with fixed-offset loads. The copy, and GIP's frame buffering, stay
+// in the submodule: its report callback hands over the pad, not the endpoint
+// buffer, so this is not a zero-copy path. Buttons go through four 16-entry nibble
+// tables laid out at compile time with XINPUT_NIBBLE(), and each stick axis
+// is a single byte load: the high byte of the int16 with its sign bit
+// flipped is already the 0-255 value.
+//
+// No TinyUSB dependency, so tools/xinput_decode_bench.c builds it on the host.
+
+#ifndef XINPUT_DECODE_H
+#define XINPUT_DECODE_H
+
+#include <stdint.h>
+
+#define XINPUT_PAD_LEN 12
+
+typedef struct {
+    uint32_t nibble[4][16];
+} xinput_decoder_t;
+
+// Entries for one wButtons nibble, given the buttons of its bits (LSB first)
+#define XINPUT_NIBBLE(b0, b1, b2, b3) { \
+    0, (b0), (b1), (b1) | (b0), (b2), (b2) | (b0), (b2) | (b1), (b2) | (b1) | (b0), \
+    (b3), (b3) | (b0), (b3) | (b1), (b3) | (b1) | (b0), \
+    (b3) | (b2), (b3) | (b2) | (b0), (b3) | (b2) | (b1), (b3) | (b2) | (b1) | (b0) }
+
+// 0 is reserved, so -32768 maps to 1 like the other drivers' [1-255] range
+static inline uint8_t xinput_decode_axis(uint8_t hi)
+{
+    uint8_t v = hi ^ 0x80;
+    return v ? v : 1;
+}
+
+// analog[] gets LX, LY, RX, RY, LT, RT in ANALOG_* order. Y is inverted
+// (XInput +Y is up, ours is 0 = up).
+static inline uint32_t xinput_decode_pad(const xinput_decoder_t* dec, const uint8_t* pad,
+                                         uint8_t analog[6])
+{
+    analog[0] = xinput_decode_axis(pad[5]);
+    analog[1] = (uint8_t)(256 - xinput_decode_axis(pad[7]));
+    analog[2] = xinput_decode_axis(pad[9]);
+    analog[3] = (uint8_t)(256 - xinput_decode_axis(pad[11]));
+    analog[4] = pad[2];
+    analog[5] = pad[3];
+
+    return dec->nibble[0][pad[0] & 0x0F] | dec->nibble[1][pad[0] >> 4] |
+           dec->nibble[2][pad[1] & 0x0F] | dec->nibble[3][pad[1] >> 4];
+}
+
+#endif // XINPUT_DECODE_H
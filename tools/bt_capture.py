@@ -0,0 +1,206 @@
+#!/usr/bin/env python3
+"""
+Bluetooth HCI Capture Client
+
+Records the HCI traffic between BTstack and the controller (USB dongle or
+CYW43) over the BT.CAPTURE.* commands (see src/bt/btstack/hci_capture.h)
+and writes it as a PacketLogger (.pklg) file. Wireshark opens the file
+directly; tools/bt_replay feeds it back through the host stack.
+
+Usage:
+    python3 bt_capture.py /dev/ttyACM0 session.pklg --boot
+    python3 bt_capture.py /dev/ttyACM0 session.pklg --seconds 30
+
+--boot reboots the device and captures from controller power-on, which is
+what a replay needs. Without it the capture starts mid-session (fine for
+Wireshark). Recording stops after --seconds or on Ctrl-C; the bytes still
+buffered on the device are drained before the file is closed.
+"""
+
+import argparse
+import json
+import os
+import struct
+import sys
+import time
+
+import serial
+
+from cdc_test import MSG_CMD, MSG_RSP, MSG_DAT, CDC_SYNC, build_packet, parse_packet
+
+DAT_STREAM_HCI_CAPTURE = 0x04
+PKLG_TYPES = {0x00: 'cmd', 0x01: 'evt', 0x02: 'acl>', 0x03: 'acl<'}
+
+
+class CaptureError(Exception):
+    pass
+
+
+class CaptureClient:
+    def __init__(self, port: str):
+        self.port = port
+        self.ser = serial.serial_for_url(port, 115200, timeout=0.5)
+        self.seq = 0
+        self.rx = bytes()
+        self.out = None
+        self.received = 0
+
+    def _read_packet(self, timeout: float = 1.0):
+        deadline = time.perf_counter() + timeout
+        while time.perf_counter() < deadline:
+            while len(self.rx) >= 7:
+                sync = self.rx.find(bytes([CDC_SYNC]))
+                if sync < 0:
+                    self.rx = bytes()
+                    break
+                self.rx = self.rx[sync:]
+                packet = parse_packet(self.rx)
+                if packet is None:
+                    break
+                self.rx = self.rx[packet['raw_len']:]
+                return packet
+            data = self.ser.read(self.ser.in_waiting or 1)
+            if data:
+                self.rx += data
+        return None
+
+    def _handle_data(self, packet: dict):
+        p = packet['payload']
+        if packet['type'] != MSG_DAT or p[:1] != bytes([DAT_STREAM_HCI_CAPTURE]):
+            return
+        offset = struct.unpack_from('<I', p, 1)[0]
+        if offset != self.received:
+            raise CaptureError(f'stream gap: expected offset {self.received}, got {offset}')
+        if self.out:
+            self.out.write(p[5:])
+        self.received += len(p) - 5
+
+    def command(self, cmd: str, **args) -> dict:
+        payload = {'cmd': cmd}
+        if args:
+            payload['args'] = args
+        seq = self.seq
+        self.seq = (self.seq + 1) & 0xFF
+        self.ser.write(build_packet(MSG_CMD, seq,
+                                    json.dumps(payload, separators=(',', ':')).encode()))
+        while True:
+            packet = self._read_packet(2.0)
+            if packet is None:
+                raise CaptureError(f'no response to {cmd}')
+            if packet['type'] == MSG_RSP and packet['seq'] == seq:
+                rsp = json.loads(packet['payload'].decode())
+                if 'error' in rsp:
+                    raise CaptureError(f"{cmd}: {rsp['error']}")
+                return rsp
+            self._handle_data(packet)
+
+    def reopen(self, timeout: float = 10.0):
+        """Wait for the device to come back after a reboot"""
+        self.ser.close()
+        time.sleep(0.5)
+        deadline = time.perf_counter() + timeout
+        while time.perf_counter() < deadline:
+            try:
+                self.ser = serial.serial_for_url(self.port, 115200, timeout=0.5)
+                self.rx = bytes()
+                return
+            except (serial.SerialException, OSError):
+                time.sleep(0.2)
+        raise CaptureError(f'{self.port} did not come back after reboot')
+
+    def record(self, path: str, boot: bool, seconds: float):
+        self.out = open(path, 'wb')
+        self.received = 0
+        try:
+            if boot:
+                self.command('BT.CAPTURE.START', boot=True)
+                self.reopen()
+            else:
+                self.command('BT.CAPTURE.START')
+
+            print(f"Capturing to {path} (Ctrl-C to stop)")
+            deadline = time.perf_counter() + seconds if seconds else None
+            last_report = time.perf_counter()
+            try:
+                while deadline is None or time.perf_counter() < deadline:
+                    packet = self._read_packet(0.2)
+                    if packet:
+                        self._handle_data(packet)
+                    if time.perf_counter() - last_report >= 1.0:
+                        last_report = time.perf_counter()
+                        print(f"  {self.received} bytes", end='\r', flush=True)
+            except KeyboardInterrupt:
+                pass
+
+            rsp = self.command('BT.CAPTURE.STOP')
+            total = rsp['bytes']
+            while self.received < total:
+                packet = self._read_packet(2.0)
+                if packet is None:
+                    raise CaptureError(f'drain stalled at {self.received}/{total} bytes')
+                self._handle_data(packet)
+            return rsp
+        finally:
+            self.out.close()
+            self.out = None
+
+    def close(self):
+        self.ser.close()
+
+
+def summarize(path: str) -> str:
+    """Count records per PacketLogger type"""
+    counts = {}
+    with open(path, 'rb') as f:
+        data = f.read()
+    pos = 0
+    first = last = None
+    while pos + 13 <= len(data):
+        length, sec, usec, ptype = struct.unpack_from('>IIIB', data, pos)
+        name = PKLG_TYPES.get(ptype, f'0x{ptype:02x}')
+        counts[name] = counts.get(name, 0) + 1
+        ts = sec + usec / 1e6
+        first = ts if first is None else first
+        last = ts
+        pos += 4 + length
+    span = (last - first) if first is not None else 0.0
+    parts = ', '.join(f'{counts[k]} {k}' for k in sorted(counts))
+    return f"{sum(counts.values())} records over {span:.2f} s ({parts})"
+
+
+# ============================================================================
+# Main
+# ============================================================================
+
+def main():
+    parser = argparse.ArgumentParser(description='Bluetooth HCI capture client')
+    parser.add_argument('port', help='CDC data port (e.g. /dev/ttyACM0)')
+    parser.add_argument('out', help='PacketLogger file to write')
+    parser.add_argument('--boot', action='store_true',
+                        help='reboot and capture from controller power-on')
+    parser.add_argument('--seconds', type=float, default=0, help='stop after N seconds')
+    args = parser.parse_args()
+
+    try:
+        client = CaptureClient(args.port)
+    except Exception as e:
+        print(f"Failed to open {args.port}: {e}")
+        sys.exit(1)
+
+    try:
+        rsp = client.record(args.out, args.boot, args.seconds)
+        print(f"\n{summarize(args.out)}")
+        if rsp.get('dropped'):
+            print(f"Warning: device dropped {rsp['dropped']} packets (ring full); "
+                  "this capture will not replay")
+    except CaptureError as e:
+        print(f"Error: {e}")
+        sys.exit(1)
+    finally:
+        client.close()
+        if os.path.exists(args.out) and os.path.getsize(args.out) == 0:
+            os.remove(args.out)
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,691 @@
+// bt_replay.c - Deterministic replay of an HCI capture through the BT host stack
+//
+// Links BTstack and the firmware's Bluetooth host code unmodified
+// (btstack_host.c, the USB dongle bt_transport, bthid with every BT device
+// driver, router, player manager and metrics) against a replay transport
+// that stands in for hci_transport_h2_tinyusb. The capture is a PacketLogger
+// file from tools/bt_capture.py --boot and supplies the controller's side of
+// the conversation:
+//
+//   - Events and incoming ACL are handed to BTstack in capture order, one per
+//     transport pass like the USB transport does, and only once every packet
+//     the host sent before them in the capture has been matched. A reply
+//     never arrives before the request it answers.
+//   - Every command and outgoing ACL packet the host sends is compared with
+//     the next unmatched host packet in the capture. Sends driven by timers
+//     may interleave a little differently, so a match up to -w host packets
+//     ahead is accepted and counted as reordered. Anything else is a
+//     divergence: both packets are printed and the replay stops (-k goes on).
+//
+// Time is virtual. hal_time_ms() and time_us_64() read a replay clock that
+// stands still while packets are due and otherwise moves 1ms per pass, so
+// BTstack and driver timers fire where they did on the device. A controller
+// packet is held until the clock reaches its capture time. A host packet the
+// capture expects but that doesn't come within 2 s of its capture time is a
+// divergence too.
+//
+// Classic link keys are restored from the Link_Key_Request_Reply commands in
+// the capture, so reconnects of bonded pads replay. BLE bonds are not; a BLE
+// reconnect only replays if the capture includes the pairing. Neither are the
+// SDP and GATT caches (sdp_cache.c, gatt_cache.c): the replay starts with
+// them empty, so a reconnect the device served from a cache diverges at the
+// host's PnP query or GATT discovery.
+//
+// Reported: match statistics, a timeline of HCI up / connects / first HID
+// report in capture time, HID report and router event counts, and host CPU
+// time per delivered event and ACL packet (relative, not RP2040 cycles).
+// Exit status is 0 when the whole capture replayed without divergence.
+//
+// Build (bash) and run from the repo root, BTstack from the pico-sdk submodule:
+//   B=src/lib/pico-sdk/lib/btstack
+//   gcc -O2 -DENABLE_BTSTACK=1 -DBT_MAX_CONNECTIONS=6
+//       -Itools/bt_replay/stubs -Itools/usbh_stress/stubs -Isrc -Isrc/bt/btstack
+//       -I$B/src -I$B/src/ble -I$B/platform/embedded
+//       -I$B/3rd-party/micro-ecc -I$B/3rd-party/rijndael -o /tmp/bt_replay
+//       tools/bt_replay/bt_replay.c src/bt/btstack/{btstack_host,sdp_cache,gatt_cache,tlv_slots}.c
+//       src/bt/transport/bt_transport.c src/bt/transport/bt_transport_usb.c
+//       src/bt/bthid/*.c src/bt/bthid/devices/generic/*.c
+//       src/bt/bthid/devices/vendors/*/*.c
+//       src/usb/usbh/hid/devices/generic/{hid_parser,hid_extract,hid_parse_cache}.c
+//       src/core/router/router.c src/core/services/players/{manager,feedback}.c
+//       src/core/services/metrics/metrics.c
+//       $B/src/{btstack_linked_list,btstack_memory,btstack_memory_pool}.c
+//       $B/src/{btstack_run_loop,btstack_run_loop_base,btstack_util}.c
+//       $B/src/{btstack_tlv,btstack_crypto,hci,hci_cmd,hci_dump}.c
+//       $B/src/{hci_event,hci_event_builder,l2cap,l2cap_signaling,ad_parser}.c
+//       $B/src/ble/{sm,att_dispatch,att_db,gatt_client,gatt_service_client}.c
+//       $B/src/ble/{le_device_db_memory,le_device_db_tlv}.c
+//       $B/src/ble/gatt-service/hids_client.c
+//       $B/src/classic/{sdp_client,sdp_server,sdp_util,device_id_server}.c
+//       $B/src/classic/{hid_host,btstack_link_key_db_memory,btstack_link_key_db_tlv}.c
+//       $B/3rd-party/micro-ecc/uECC.c $B/3rd-party/rijndael/rijndael.c
+//       $B/platform/embedded/{btstack_run_loop_embedded,btstack_tlv_flash_bank}.c
+//       $B/platform/embedded/hal_flash_bank_memory.c
+//   /tmp/bt_replay [-k] [-w window] [-v] capture.pklg
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "btstack_config.h"
+#include "bluetooth.h"
+#include "btstack_defines.h"
+#include "btstack_util.h"
+#include "btstack_run_loop_embedded.h"
+#include "hci_transport.h"
+#include "hal_flash_bank_memory.h"
+#include "gap.h"
+
+#include "pico/time.h"
+#include "hardware/flash.h"
+#include "pico/btstack_flash_bank.h"
+#include "bt/transport/bt_transport.h"
+#include "bt/btstack/btstack_host.h"
+#include "core/output_interface.h"
+#include "core/router/router.h"
+#include "core/services/players/manager.h"
+#include "core/services/metrics/metrics.h"
+#include "core/services/storage/flash.h"
+#include "usb/usbh/hid/devices/generic/hid_parser.h"
+
+extern const bt_transport_t bt_transport_usb;
+
+#define MAX_RECORDS       65536
+#define RX_BUF_SIZE       1100      // Largest event or ACL packet in a capture
+#define REORDER_WINDOW    16        // Host packets a send may be matched ahead
+#define HOST_SLACK_US     2000000   // How late an expected host packet may be
+#define TAIL_PASSES       2000      // Passes run after the last record (2 s)
+#define LOOP_LIMIT_US     (24ull * 3600 * 1000000)
+
+// PacketLogger record types
+#define PKLG_COMMAND      0x00
+#define PKLG_EVENT        0x01
+#define PKLG_ACL_OUT      0x02
+#define PKLG_ACL_IN       0x03
+
+// Link key type assumed for keys restored from the capture (HID pads pair
+// with Just Works; the type isn't on the wire)
+#define RESTORED_KEY_TYPE UNAUTHENTICATED_COMBINATION_KEY_GENERATED_FROM_P192
+
+// ============================================================================
+// CAPTURE
+// ============================================================================
+
+typedef struct {
+  uint8_t type;       // HCI packet type
+  bool from_host;     // Host -> controller
+  bool done;          // Matched (host) or delivered (controller)
+  uint16_t len;
+  uint64_t us;        // Capture time relative to the first record
+  const uint8_t* data;
+} record_t;
+
+static uint8_t* capture_buf;
+static record_t records[MAX_RECORDS];
+static int record_count;
+static int cursor;              // First record not yet done
+
+static struct {
+  uint32_t commands, events, acl_out, acl_in, skipped;
+} capture_stats;
+
+static bool load_capture(const char* path)
+{
+  FILE* f = fopen(path, "rb");
+  if (!f) {
+    perror(path);
+    return false;
+  }
+  fseek(f, 0, SEEK_END);
+  long size = ftell(f);
+  fseek(f, 0, SEEK_SET);
+  capture_buf = malloc(size > 0 ? (size_t)size : 1);
+  if (!capture_buf || fread(capture_buf, 1, (size_t)size, f) != (size_t)size) {
+    fprintf(stderr, "%s: read failed\n", path);
+    fclose(f);
+    return false;
+  }
+  fclose(f);
+
+  uint64_t first_us = 0;
+  long pos = 0;
+  while (pos + 13 <= size && record_count < MAX_RECORDS) {
+    const uint8_t* p = &capture_buf[pos];
+    uint32_t rec_len = big_endian_read_32(p, 0);
+    if (rec_len < 9 || pos + 4 + (long)rec_len > size) {
+      fprintf(stderr, "%s: truncated record at offset %ld\n", path, pos);
+      return false;
+    }
+    uint64_t us = big_endian_read_32(p, 4) * 1000000ull + big_endian_read_32(p, 8);
+    uint8_t pklg_type = p[12];
+    const uint8_t* data = p + 13;
+    uint16_t len = (uint16_t)(rec_len - 9);
+    pos += 4 + rec_len;
+
+    record_t r = { .len = len, .data = data };
+    switch (pklg_type) {
+      case PKLG_COMMAND: r.type = HCI_COMMAND_DATA_PACKET; r.from_host = true; capture_stats.commands++; break;
+      case PKLG_EVENT:   r.type = HCI_EVENT_PACKET; capture_stats.events++; break;
+      case PKLG_ACL_OUT: r.type = HCI_ACL_DATA_PACKET; r.from_host = true; capture_stats.acl_out++; break;
+      case PKLG_ACL_IN:  r.type = HCI_ACL_DATA_PACKET; capture_stats.acl_in++; break;
+      default:
+        // Log lines, SCO, ISO
+        capture_stats.skipped++;
+        continue;
+    }
+    // Stack-internal events, if the capture came from a tool that logs them
+    if (r.type == HCI_EVENT_PACKET && len > 0 &&
+        data[0] >= BTSTACK_EVENT_STATE && data[0] != HCI_EVENT_VENDOR_SPECIFIC) {
+      capture_stats.events--;
+      capture_stats.skipped++;
+      continue;
+    }
+    if (!r.from_host && len > RX_BUF_SIZE) {
+      fprintf(stderr, "%s: %u byte packet at offset %ld exceeds the receive buffer\n",
+              path, len, pos);
+      return false;
+    }
+
+    if (record_count == 0) first_us = us;
+    r.us = us >= first_us ? us - first_us : 0;
+    records[record_count++] = r;
+  }
+  if (record_count == 0) {
+    fprintf(stderr, "%s: no HCI packets\n", path);
+    return false;
+  }
+  return true;
+}
+
+// Restore Classic link keys the host handed to the controller in the capture
+static int restore_link_keys(void)
+{
+  int restored = 0;
+  for (int i = 0; i < record_count; i++) {
+    const record_t* r = &records[i];
+    if (r->type != HCI_COMMAND_DATA_PACKET || r->len < 3 + 6 + 16) continue;
+    if (little_endian_read_16(r->data, 0) != HCI_OPCODE_HCI_LINK_KEY_REQUEST_REPLY) continue;
+
+    bd_addr_t addr;
+    link_key_t key;
+    reverse_bd_addr(&r->data[3], addr);
+    memcpy(key, &r->data[9], sizeof(key));
+    gap_store_link_key_for_bd_addr(addr, key, RESTORED_KEY_TYPE);
+    restored++;
+  }
+  return restored;
+}
+
+// ============================================================================
+// VIRTUAL CLOCK
+// ============================================================================
+
+static uint64_t now_us = 0;
+
+uint64_t time_us_64(void)
+{
+  return now_us;
+}
+
+// A driver that sleeps stalls the loop; time moves on without it
+void sleep_us(uint64_t us)
+{
+  now_us += us;
+}
+
+// btstack_run_loop_embedded HAL (btstack_hal.c on the device)
+uint32_t hal_time_ms(void)
+{
+  return (uint32_t)(now_us / 1000);
+}
+
+void hal_cpu_disable_irqs(void) {}
+void hal_cpu_enable_irqs(void) {}
+void hal_cpu_enable_irqs_and_sleep(void) {}
+
+static double wall_ns(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+// ============================================================================
+// FLASH (BTstack TLV banks in RAM)
+// ============================================================================
+
+uint8_t replay_flash_banks[FLASH_BANKS_SIZE];
+static hal_flash_bank_memory_t flash_bank_context;
+static const hal_flash_bank_t* flash_bank;
+
+void flash_range_erase(uint32_t flash_offs, size_t count)
+{
+  uint32_t base = PICO_FLASH_SIZE_BYTES - FLASH_BANKS_SIZE;
+  if (flash_offs < base || flash_offs - base + count > FLASH_BANKS_SIZE) return;
+  memset(&replay_flash_banks[flash_offs - base], 0xFF, count);
+}
+
+const hal_flash_bank_t* pico_flash_bank_instance(void)
+{
+  if (!flash_bank) {
+    flash_bank = hal_flash_bank_memory_init_instance(&flash_bank_context,
+                                                     replay_flash_banks, FLASH_BANKS_SIZE);
+  }
+  return flash_bank;
+}
+
+// ============================================================================
+// REPLAY TRANSPORT
+// ============================================================================
+
+static void (*host_handler)(uint8_t packet_type, uint8_t* packet, uint16_t size);
+static bool transport_opened;
+static bool cmd_pending;
+static bool acl_out_pending;
+static uint8_t rx_buf[HCI_INCOMING_PRE_BUFFER_SIZE + RX_BUF_SIZE];
+
+static struct {
+  uint32_t matched, reordered, divergences, extra;
+  uint32_t delivered_events, delivered_acl;
+  uint64_t event_ns, acl_ns;
+} replay_stats;
+
+static bool keep_going = false;
+static int reorder_window = REORDER_WINDOW;
+static bool stop = false;
+
+static void print_packet(const char* label, uint8_t type, const uint8_t* data, uint16_t len)
+{
+  fprintf(stderr, "  %-8s %s", label, type == HCI_COMMAND_DATA_PACKET ? "cmd" : "acl");
+  if (type == HCI_COMMAND_DATA_PACKET && len >= 2) {
+    fprintf(stderr, " opcode 0x%04x", little_endian_read_16(data, 0));
+  } else if (type == HCI_ACL_DATA_PACKET && len >= 8) {
+    fprintf(stderr, " handle 0x%03x cid 0x%04x",
+            little_endian_read_16(data, 0) & 0x0FFF, little_endian_read_16(data, 6));
+  }
+  fprintf(stderr, " (%u):", len);
+  for (uint16_t i = 0; i < len && i < 32; i++) fprintf(stderr, " %02x", data[i]);
+  fprintf(stderr, "%s\n", len > 32 ? " ..." : "");
+}
+
+static void divergence(int index, const char* what)
+{
+  const record_t* r = &records[index];
+  replay_stats.divergences++;
+  fprintf(stderr, "divergence at record %d (%.3f s): %s\n", index, r->us / 1e6, what);
+  print_packet("capture", r->type, r->data, r->len);
+  if (!keep_going) stop = true;
+}
+
+static void advance_cursor(void)
+{
+  while (cursor < record_count && records[cursor].done) cursor++;
+}
+
+static void match_host_packet(uint8_t type, const uint8_t* packet, uint16_t len)
+{
+  int expected = -1;
+  int seen = 0;
+  for (int i = cursor; i < record_count && seen < reorder_window; i++) {
+    record_t* r = &records[i];
+    if (r->done || !r->from_host) continue;
+    if (expected < 0) expected = i;
+    seen++;
+    if (r->type == type && r->len == len && memcmp(r->data, packet, len) == 0) {
+      r->done = true;
+      replay_stats.matched++;
+      if (i != expected) replay_stats.reordered++;
+      advance_cursor();
+      return;
+    }
+  }
+
+  if (expected < 0) {
+    // Host kept talking after the capture ended
+    replay_stats.extra++;
+    return;
+  }
+  divergence(expected, "host sent something else");
+  print_packet("host", type, packet, len);
+  if (keep_going) {
+    records[expected].done = true;
+    advance_cursor();
+  }
+}
+
+static void transport_init(const void* transport_config)
+{
+  (void)transport_config;
+}
+
+static int transport_open(void)
+{
+  transport_opened = true;
+  return 0;
+}
+
+static int transport_close(void)
+{
+  transport_opened = false;
+  return 0;
+}
+
+static void transport_register_packet_handler(void (*handler)(uint8_t packet_type, uint8_t* packet, uint16_t size))
+{
+  host_handler = handler;
+}
+
+static int transport_can_send_packet_now(uint8_t packet_type)
+{
+  if (!transport_opened) return 0;
+  switch (packet_type) {
+    case HCI_COMMAND_DATA_PACKET: return !cmd_pending;
+    case HCI_ACL_DATA_PACKET: return !acl_out_pending;
+    default: return 0;
+  }
+}
+
+static int transport_send_packet(uint8_t packet_type, uint8_t* packet, int size)
+{
+  if (!transport_opened) return -1;
+  switch (packet_type) {
+    case HCI_COMMAND_DATA_PACKET:
+      if (cmd_pending) return -1;
+      cmd_pending = true;
+      break;
+    case HCI_ACL_DATA_PACKET:
+      if (acl_out_pending) return -1;
+      acl_out_pending = true;
+      break;
+    default:
+      return -1;
+  }
+  match_host_packet(packet_type, packet, (uint16_t)size);
+  return 0;
+}
+
+static const hci_transport_t replay_transport = {
+  .name = "REPLAY",
+  .init = transport_init,
+  .open = transport_open,
+  .close = transport_close,
+  .register_packet_handler = transport_register_packet_handler,
+  .can_send_packet_now = transport_can_send_packet_now,
+  .send_packet = transport_send_packet,
+  .set_baudrate = NULL,
+  .reset_link = NULL,
+  .set_sco_config = NULL,
+};
+
+// bt_transport_usb.c binds to the dongle transport by these names
+const void* hci_transport_h2_tinyusb_instance(void)
+{
+  return &replay_transport;
+}
+
+static void emit_packet_sent(void)
+{
+  static uint8_t packet_sent_event[] = { HCI_EVENT_TRANSPORT_PACKET_SENT, 0 };
+  host_handler(HCI_EVENT_PACKET, packet_sent_event, sizeof(packet_sent_event));
+}
+
+// Called from btstack_host_process() every pass: send completions first, then
+// at most one controller packet, as the USB transport would deliver them
+void hci_transport_h2_tinyusb_process(void)
+{
+  if (!transport_opened || !host_handler) return;
+
+  if (cmd_pending) {
+    cmd_pending = false;
+    emit_packet_sent();
+  }
+  if (acl_out_pending) {
+    acl_out_pending = false;
+    emit_packet_sent();
+  }
+
+  advance_cursor();
+  if (cursor >= record_count) return;
+  record_t* r = &records[cursor];
+  if (r->from_host || r->us > now_us) return;
+
+  r->done = true;
+  uint8_t* packet = &rx_buf[HCI_INCOMING_PRE_BUFFER_SIZE];
+  memcpy(packet, r->data, r->len);
+  double t0 = wall_ns();
+  host_handler(r->type, packet, r->len);
+  btstack_run_loop_embedded_execute_once();
+  uint64_t ns = (uint64_t)(wall_ns() - t0);
+  if (r->type == HCI_EVENT_PACKET) {
+    replay_stats.delivered_events++;
+    replay_stats.event_ns += ns;
+  } else {
+    replay_stats.delivered_acl++;
+    replay_stats.acl_ns += ns;
+  }
+  advance_cursor();
+}
+
+// ============================================================================
+// FIRMWARE SERVICES OUTSIDE THE BT HOST PATH
+// ============================================================================
+
+const OutputInterface* active_output = NULL;
+
+// Capturing the replay would only record the capture again
+void hci_capture_init(void) {}
+
+uint8_t codes_get_test_counter(void) { return 0; }
+void profile_indicator_init(void) {}
+void profile_indicator_task(void) {}
+bool profile_indicator_is_active_for_player(uint8_t player_index) { (void)player_index; return false; }
+int8_t profile_indicator_get_display_player_index(int8_t actual_player_index) { return actual_player_index; }
+
+// Settings flash: nothing stored, saves dropped
+bool flash_load(flash_t* settings) { (void)settings; return false; }
+void flash_save(const flash_t* settings) { (void)settings; }
+void flash_on_bt_disconnect(void) {}
+
+// HID parser item filter from the USB DirectInput driver (hid_gamepad.c),
+// which isn't linked; the BT generic driver compiles descriptors with it
+bool CALLBACK_HIDParser_FilterHIDReportItem(uint8_t dev_addr, uint8_t instance, HID_ReportItem_t *const CurrentItem)
+{
+  (void)dev_addr;
+  (void)instance;
+  if (CurrentItem->ItemType != HID_REPORT_ITEM_In) return false;
+  if (CurrentItem->Attributes.Usage.Page == 0x09) return true;
+  if (CurrentItem->Attributes.Usage.Page != 0x01) return false;
+  uint16_t usage = CurrentItem->Attributes.Usage.Usage;
+  return (usage >= 0x30 && usage <= 0x35) || usage == 0x39 ||
+         (usage >= 0x90 && usage <= 0x93) || usage == 0x02 || usage == 0x06 || usage == 0x38;
+}
+
+static uint32_t router_events;
+
+static void router_tap(output_target_t output, uint8_t player_index, const input_event_t* event)
+{
+  (void)output;
+  (void)player_index;
+  (void)event;
+  router_events++;
+}
+
+// ============================================================================
+// TIMELINE
+// ============================================================================
+
+static struct {
+  bool powered;
+  uint32_t connects;
+  uint32_t reports;
+  uint32_t devices;
+  uint64_t first_report_us;
+  uint64_t last_report_us;
+} seen;
+
+static void timeline(const char* what, uint32_t n)
+{
+  fprintf(stderr, "  %9.3f s  %s", now_us / 1e6, what);
+  if (n) fprintf(stderr, " %u", n);
+  fprintf(stderr, "\n");
+}
+
+static void timeline_poll(void)
+{
+  if (!seen.powered && btstack_host_is_powered_on()) {
+    seen.powered = true;
+    timeline("HCI up", 0);
+  }
+  uint32_t connects = metrics_scalars[METRIC_BT_CONNECTS];
+  if (connects != seen.connects) {
+    seen.connects = connects;
+    timeline("connect", connects);
+  }
+  uint32_t devices = metrics_scalars[METRIC_BT_DEVICES];
+  if (devices != seen.devices) {
+    seen.devices = devices;
+    timeline("devices", devices);
+  }
+  uint32_t reports = metrics_scalars[METRIC_BT_HID_REPORTS];
+  if (reports != seen.reports) {
+    if (seen.reports == 0) {
+      seen.first_report_us = now_us;
+      timeline("first HID report", 0);
+    }
+    seen.reports = reports;
+    seen.last_report_us = now_us;
+  }
+}
+
+// ============================================================================
+// MAIN
+// ============================================================================
+
+static void usage(const char* argv0)
+{
+  fprintf(stderr,
+    "usage: %s [-k] [-w window] [-v] capture.pklg\n"
+    "  -k  keep going after a divergence (substitute the host's packet)\n"
+    "  -w  host packets a send may be matched ahead (default %d)\n"
+    "  -v  keep firmware and BTstack logging\n", argv0, REORDER_WINDOW);
+}
+
+int main(int argc, char** argv)
+{
+  bool verbose = false;
+
+  int opt;
+  while ((opt = getopt(argc, argv, "kw:vh")) != -1) {
+    switch (opt) {
+      case 'k': keep_going = true; break;
+      case 'w': reorder_window = atoi(optarg); break;
+      case 'v': verbose = true; break;
+      default: usage(argv[0]); return 2;
+    }
+  }
+  if (optind != argc - 1) {
+    usage(argv[0]);
+    return 2;
+  }
+  if (reorder_window < 1) reorder_window = 1;
+  if (!load_capture(argv[optind])) return 1;
+
+  // Firmware logging goes to stdout; the results go to stderr
+  if (!verbose) {
+    fflush(stdout);
+    if (!freopen("/dev/null", "w", stdout)) return 1;
+  }
+
+  memset(replay_flash_banks, 0xFF, sizeof(replay_flash_banks));
+
+  router_config_t router_cfg = {
+    .mode = ROUTING_MODE_SIMPLE,
+    .max_players_per_output = { [OUTPUT_TARGET_USB_DEVICE] = MAX_PLAYERS_PER_OUTPUT },
+  };
+  router_init(&router_cfg);
+  router_add_route(INPUT_SOURCE_BLE_CENTRAL, OUTPUT_TARGET_USB_DEVICE, 0);
+  router_set_tap(OUTPUT_TARGET_USB_DEVICE, router_tap);
+  player_config_t player_cfg = {
+    .slot_mode = PLAYER_SLOT_FIXED,
+    .max_slots = MAX_PLAYERS_PER_OUTPUT,
+    .auto_assign_on_press = true,
+  };
+  players_init_with_config(&player_cfg);
+
+  fprintf(stderr, "%s: %d records over %.3f s (%u cmd, %u evt, %u acl out, %u acl in, %u skipped)\n",
+          argv[optind], record_count, records[record_count - 1].us / 1e6,
+          capture_stats.commands, capture_stats.events,
+          capture_stats.acl_out, capture_stats.acl_in, capture_stats.skipped);
+
+  // The app's BT init, then the dongle "mounts"
+  bt_init(&bt_transport_usb);
+  int keys = restore_link_keys();
+  if (keys) fprintf(stderr, "restored %d link key%s\n", keys, keys == 1 ? "" : "s");
+  fprintf(stderr, "\n");
+  btstack_host_power_on();
+
+  uint64_t task_ns = 0;
+  uint32_t passes = 0;
+  uint32_t tail = 0;
+  double wall_start = wall_ns();
+
+  while (!stop && now_us < LOOP_LIMIT_US) {
+    uint32_t before = replay_stats.matched + replay_stats.delivered_events +
+                      replay_stats.delivered_acl + replay_stats.extra;
+
+    double t0 = wall_ns();
+    bt_task();
+    task_ns += (uint64_t)(wall_ns() - t0);
+    passes++;
+    timeline_poll();
+
+    advance_cursor();
+    if (cursor >= record_count) {
+      if (++tail > TAIL_PASSES) break;
+    } else if (records[cursor].from_host && now_us > records[cursor].us + HOST_SLACK_US) {
+      divergence(cursor, "host never sent");
+      if (keep_going) {
+        records[cursor].done = true;
+        advance_cursor();
+      }
+    }
+
+    // The clock stands still while packets flow
+    uint32_t after = replay_stats.matched + replay_stats.delivered_events +
+                     replay_stats.delivered_acl + replay_stats.extra;
+    if (after == before && !cmd_pending && !acl_out_pending) now_us += 1000;
+  }
+  double wall = wall_ns() - wall_start;
+  fflush(stdout);
+
+  // ==========================================================================
+  // REPORT
+  // ==========================================================================
+
+  int unmatched = 0;
+  for (int i = 0; i < record_count; i++) {
+    if (!records[i].done) unmatched++;
+  }
+
+  fprintf(stderr, "\nreplayed to %.3f s in %.2f s wall, %u passes\n", now_us / 1e6, wall / 1e9, passes);
+  fprintf(stderr, "  host packets   %u matched (%u reordered), %u past the end of the capture\n",
+          replay_stats.matched, replay_stats.reordered, replay_stats.extra);
+  fprintf(stderr, "  controller     %u events, %u ACL delivered\n",
+          replay_stats.delivered_events, replay_stats.delivered_acl);
+  fprintf(stderr, "  records left   %d\n", unmatched);
+  fprintf(stderr, "  divergences    %u\n", replay_stats.divergences);
+
+  double span = (seen.last_report_us - seen.first_report_us) / 1e6;
+  fprintf(stderr, "  HID reports    %u", seen.reports);
+  if (span > 0) fprintf(stderr, " (%.0f/s)", seen.reports / span);
+  fprintf(stderr, ", router events %u\n", router_events);
+
+  fprintf(stderr, "  host cost      %.0f ns/event, %.0f ns/ACL, %.0f ns/pass\n",
+          replay_stats.delivered_events ? (double)replay_stats.event_ns / replay_stats.delivered_events : 0.0,
+          replay_stats.delivered_acl ? (double)replay_stats.acl_ns / replay_stats.delivered_acl : 0.0,
+          passes ? (double)task_ns / passes : 0.0);
+
+  return (replay_stats.divergences == 0 && unmatched == 0) ? 0 : 1;
+}
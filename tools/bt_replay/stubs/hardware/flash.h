@@ -0,0 +1,21 @@
+// hardware/flash.h - Flash for the HCI replay
+//
+// BTstack's two TLV banks live in a RAM array (bt_replay.c). XIP_BASE is
+// placed so that the firmware's "XIP_BASE + end of flash - 8KB" lands on it.
+#ifndef BT_REPLAY_HARDWARE_FLASH_H
+#define BT_REPLAY_HARDWARE_FLASH_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define PICO_FLASH_SIZE_BYTES   (2 * 1024 * 1024)
+#define FLASH_SECTOR_SIZE       4096u
+#define FLASH_BANKS_SIZE        (FLASH_SECTOR_SIZE * 2)
+
+extern uint8_t replay_flash_banks[FLASH_BANKS_SIZE];
+
+#define XIP_BASE ((uintptr_t)replay_flash_banks - (PICO_FLASH_SIZE_BYTES - FLASH_BANKS_SIZE))
+
+void flash_range_erase(uint32_t flash_offs, size_t count);
+
+#endif // BT_REPLAY_HARDWARE_FLASH_H
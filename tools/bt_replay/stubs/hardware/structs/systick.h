@@ -0,0 +1,21 @@
+// hardware/structs/systick.h - SysTick for bthid's report cycle counts in the
+// HCI replay (never counts; host cost comes from the replay's own timing)
+#ifndef BT_REPLAY_HARDWARE_STRUCTS_SYSTICK_H
+#define BT_REPLAY_HARDWARE_STRUCTS_SYSTICK_H
+
+#include <stdint.h>
+
+#define M0PLUS_SYST_CSR_ENABLE_BITS    0x00000001u
+#define M0PLUS_SYST_CSR_CLKSOURCE_BITS 0x00000004u
+
+typedef struct {
+    volatile uint32_t csr;
+    volatile uint32_t rvr;
+    volatile uint32_t cvr;
+    volatile uint32_t calib;
+} systick_hw_t;
+
+static systick_hw_t replay_systick_hw;
+#define systick_hw (&replay_systick_hw)
+
+#endif // BT_REPLAY_HARDWARE_STRUCTS_SYSTICK_H
@@ -0,0 +1,9 @@
+// pico/btstack_flash_bank.h - Flash bank HAL for the HCI replay (RAM backed)
+#ifndef BT_REPLAY_PICO_BTSTACK_FLASH_BANK_H
+#define BT_REPLAY_PICO_BTSTACK_FLASH_BANK_H
+
+#include "hal_flash_bank.h"
+
+const hal_flash_bank_t* pico_flash_bank_instance(void);
+
+#endif // BT_REPLAY_PICO_BTSTACK_FLASH_BANK_H
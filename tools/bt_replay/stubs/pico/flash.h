@@ -0,0 +1,17 @@
+// pico/flash.h - flash_safe_execute() for the HCI replay (runs func directly)
+#ifndef BT_REPLAY_PICO_FLASH_H
+#define BT_REPLAY_PICO_FLASH_H
+
+#include <stdint.h>
+
+#define PICO_OK 0
+#define __no_inline_not_in_flash_func(x) x
+
+static inline int flash_safe_execute(void (*func)(void*), void* param, uint32_t enter_exit_timeout_ms)
+{
+    (void)enter_exit_timeout_ms;
+    func(param);
+    return PICO_OK;
+}
+
+#endif // BT_REPLAY_PICO_FLASH_H
@@ -0,0 +1,16 @@
+// tusb.h - What the BT host path needs from TinyUSB, for the HCI replay
+//
+// player manager.h includes tusb.h for TU_ATTR_PACKED only; the full TinyUSB
+// headers would clash with BTstack's HID definitions.
+#ifndef BT_REPLAY_TUSB_H
+#define BT_REPLAY_TUSB_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define TU_ATTR_PACKED __attribute__((packed))
+#define TU_ARRAY_SIZE(a) (sizeof(a) / sizeof(a[0]))
+
+#define CFG_TUD_CDC 0
+
+#endif // BT_REPLAY_TUSB_H
@@ -0,0 +1,120 @@
+#!/usr/bin/env python3
+"""
+CDC Command Round-Trip Benchmark
+
+Sends representative command payloads to a Joypad device and reports
+command round-trip times (send CMD -> receive matching RSP).
+
+Usage:
+    python3 cdc_bench.py /dev/ttyACM0
+    python3 cdc_bench.py /dev/ttyACM0 --count 500
+
+Only read-only commands are used, so flash is never written.
+"""
+
+import argparse
+import json
+import statistics
+import sys
+import time
+
+import serial
+
+from cdc_test import MSG_CMD, MSG_RSP, build_packet, parse_packet, CDC_SYNC
+
+# Representative payloads, in the shape the web config sends them
+# (JSON.stringify -> compact, args nested under "args")
+PAYLOADS = {
+    'PING': {'cmd': 'PING'},
+    'MODE.GET': {'cmd': 'MODE.GET'},
+    'PROFILE.GET': {'cmd': 'PROFILE.GET', 'args': {'index': 0}},
+    # Near the end of the old linear table
+    'SETTINGS.GET': {'cmd': 'SETTINGS.GET'},
+    # Large payload with many keys - exercises the key index
+    'UNKNOWN (large)': {
+        'cmd': 'BENCH.UNKNOWN',
+        'args': {
+            'index': 255,
+            'name': 'Benchmark',
+            'button_map': list(range(18)),
+            'left_stick_sens': 100,
+            'right_stick_sens': 100,
+            'flags': 0,
+            **{f'pad{i}': i for i in range(12)},
+        },
+    },
+}
+
+
+class Client:
+    def __init__(self, port: str):
+        self.ser = serial.Serial(port, 115200, timeout=1.0)
+        self.seq = 0
+        self.rx = bytes()
+
+    def command(self, payload: dict) -> float:
+        """Send one command, return round-trip time in ms"""
+        data = json.dumps(payload, separators=(',', ':')).encode('utf-8')
+        seq = self.seq
+        self.seq = (self.seq + 1) & 0xFF
+
+        start = time.perf_counter()
+        self.ser.write(build_packet(MSG_CMD, seq, data))
+
+        deadline = start + 2.0
+        while time.perf_counter() < deadline:
+            chunk = self.ser.read(self.ser.in_waiting or 1)
+            if chunk:
+                self.rx += chunk
+            while len(self.rx) >= 7:
+                sync = self.rx.find(bytes([CDC_SYNC]))
+                if sync < 0:
+                    self.rx = bytes()
+                    break
+                self.rx = self.rx[sync:]
+                packet = parse_packet(self.rx)
+                if packet is None:
+                    break
+                self.rx = self.rx[packet['raw_len']:]
+                if packet['type'] == MSG_RSP and packet['seq'] == seq:
+                    return (time.perf_counter() - start) * 1000.0
+        raise TimeoutError(f"no response to {payload['cmd']}")
+
+    def close(self):
+        self.ser.close()
+
+
+def percentile(values, pct):
+    ordered = sorted(values)
+    idx = min(len(ordered) - 1, int(round(pct / 100.0 * (len(ordered) - 1))))
+    return ordered[idx]
+
+
+def main():
+    parser = argparse.ArgumentParser(description='CDC command round-trip benchmark')
+    parser.add_argument('port', help='CDC data port (e.g. /dev/ttyACM0)')
+    parser.add_argument('--count', type=int, default=200, help='iterations per payload')
+    args = parser.parse_args()
+
+    try:
+        client = Client(args.port)
+    except Exception as e:
+        print(f"Failed to open {args.port}: {e}")
+        sys.exit(1)
+
+    print(f"{'command':<18} {'bytes':>5} {'min':>7} {'p50':>7} {'p95':>7} {'max':>7}  (ms)")
+    try:
+        for name, payload in PAYLOADS.items():
+            size = len(json.dumps(payload, separators=(',', ':')))
+            client.command(payload)  # Warm up
+            times = [client.command(payload) for _ in range(args.count)]
+            print(f"{name:<18} {size:>5} {min(times):7.3f} {statistics.median(times):7.3f} "
+                  f"{percentile(times, 95):7.3f} {max(times):7.3f}")
+    except (TimeoutError, KeyboardInterrupt) as e:
+        print(f"Stopped: {e}")
+
+    client.close()
+
+
+if __name__ == '__main__':
+    main()
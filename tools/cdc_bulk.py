@@ -0,0 +1,279 @@
+#!/usr/bin/env python3
+"""
+CDC Bulk Transfer Client
+
+Uploads and reads back binary images over the BULK.* commands
+(see src/usb/usbd/cdc/cdc_bulk.h).
+
+Usage:
+    python3 cdc_bulk.py /dev/ttyACM0 read [--out profiles.bin]
+    python3 cdc_bulk.py /dev/ttyACM0 write profiles.bin
+    python3 cdc_bulk.py /dev/ttyACM0 sync profiles.json
+    python3 cdc_bulk.py /dev/ttyACM0 stress --size 4096 --count 20
+
+'sync' builds a profile set image from JSON:
+    {"active": 1, "profiles": [{"name": "Fighter", "button_map": [...18],
+      "left_stick_sens": 100, "right_stick_sens": 100, "flags": 0}, ...]}
+
+'stress' uploads random images of the given size (up to the device buffer),
+drops chunks on purpose to exercise NAK/resume, checks every byte is
+acknowledged and aborts instead of committing, so flash is never written.
+"""
+
+import argparse
+import json
+import os
+import random
+import struct
+import sys
+import time
+
+import serial
+
+from cdc_test import (MSG_CMD, MSG_RSP, MSG_ACK, MSG_NAK, MSG_DAT, CDC_SYNC,
+                      build_packet, parse_packet, crc16_ccitt)
+
+DAT_STREAM_BULK = 0x02
+TARGET_PROFILES = 0
+TARGET_PROFILE_BLOB = 1
+
+PROFILES_VERSION = 1
+PROFILE_NAME_LEN = 12
+PROFILE_BUTTON_COUNT = 18
+PROFILE_SIZE = 56
+ACTIVE_KEEP = 0xFF
+
+
+class BulkError(Exception):
+    pass
+
+
+class BulkClient:
+    def __init__(self, port: str, window: int = 4):
+        self.ser = serial.Serial(port, 115200, timeout=0.5)
+        self.seq = 0
+        self.rx = bytes()
+        self.window = window
+
+    def _next_seq(self) -> int:
+        seq = self.seq
+        self.seq = (self.seq + 1) & 0xFF
+        return seq
+
+    def _read_packet(self, timeout: float = 2.0):
+        deadline = time.perf_counter() + timeout
+        while time.perf_counter() < deadline:
+            while len(self.rx) >= 7:
+                sync = self.rx.find(bytes([CDC_SYNC]))
+                if sync < 0:
+                    self.rx = bytes()
+                    break
+                self.rx = self.rx[sync:]
+                packet = parse_packet(self.rx)
+                if packet is None:
+                    break
+                self.rx = self.rx[packet['raw_len']:]
+                return packet
+            chunk = self.ser.read(self.ser.in_waiting or 1)
+            if chunk:
+                self.rx += chunk
+        raise BulkError('timeout waiting for device')
+
+    def command(self, cmd: str, **args) -> dict:
+        payload = {'cmd': cmd}
+        if args:
+            payload['args'] = args
+        seq = self._next_seq()
+        self.ser.write(build_packet(MSG_CMD, seq,
+                                    json.dumps(payload, separators=(',', ':')).encode()))
+        while True:
+            packet = self._read_packet()
+            if packet['type'] == MSG_RSP and packet['seq'] == seq:
+                rsp = json.loads(packet['payload'].decode())
+                if 'error' in rsp:
+                    raise BulkError(f"{cmd}: {rsp['error']}")
+                return rsp
+
+    def _send_chunk(self, image: bytes, offset: int, chunk: int) -> int:
+        data = image[offset:offset + chunk]
+        payload = bytes([DAT_STREAM_BULK]) + struct.pack('<H', offset) + data
+        seq = self._next_seq()
+        self.ser.write(build_packet(MSG_DAT, seq, payload))
+        return offset + len(data)
+
+    def upload(self, target: int, image: bytes, drop_rate: float = 0.0) -> dict:
+        """Upload image, pipelining up to `window` chunks. Returns stats."""
+        crc = crc16_ccitt(image)
+        rsp = self.command('BULK.BEGIN', target=target, size=len(image), crc=crc)
+        chunk = rsp['chunk']
+        acked = rsp['offset']
+        sent = acked
+        in_flight = 0
+        stats = {'chunks': 0, 'naks': 0, 'resumed_at': acked}
+
+        while acked < len(image):
+            while in_flight < self.window and sent < len(image):
+                if drop_rate and random.random() < drop_rate:
+                    # Skip a chunk - device must NAK the next one
+                    sent = min(sent + chunk, len(image))
+                    continue
+                sent = self._send_chunk(image, sent, chunk)
+                in_flight += 1
+                stats['chunks'] += 1
+
+            if in_flight == 0:
+                # Everything left was dropped - rewind to last ack
+                sent = acked
+                continue
+
+            packet = self._read_packet()
+            if packet['type'] not in (MSG_ACK, MSG_NAK):
+                continue
+            in_flight -= 1
+            if len(packet['payload']) < 2:
+                raise BulkError('chunk rejected (no upload in progress?)')
+            next_offset = struct.unpack('<H', packet['payload'][:2])[0]
+            acked = max(acked, next_offset)
+            if packet['type'] == MSG_NAK:
+                stats['naks'] += 1
+                # Drain chunks already in flight, then rewind
+                while in_flight > 0:
+                    self._read_packet()
+                    in_flight -= 1
+                sent = acked
+
+        return stats
+
+    def read(self, target: int) -> bytes:
+        rsp = self.command('BULK.READ', target=target)
+        size, crc = rsp['size'], rsp['crc']
+        image = bytearray(size)
+        received = 0
+        while received < size:
+            packet = self._read_packet()
+            if packet['type'] != MSG_DAT or packet['payload'][:1] != bytes([DAT_STREAM_BULK]):
+                continue
+            offset = struct.unpack('<H', packet['payload'][1:3])[0]
+            data = packet['payload'][3:]
+            image[offset:offset + len(data)] = data
+            received = offset + len(data)
+        if crc16_ccitt(bytes(image)) != crc:
+            raise BulkError('read-back CRC mismatch')
+        return bytes(image)
+
+    def close(self):
+        self.ser.close()
+
+
+# ============================================================================
+# Profile set image
+# ============================================================================
+
+def build_profiles_image(doc: dict) -> bytes:
+    profiles = doc.get('profiles', [])
+    if len(profiles) > 4:
+        raise ValueError('at most 4 custom profiles')
+    active = doc.get('active', ACTIVE_KEEP)
+    out = bytearray([PROFILES_VERSION, len(profiles), active, 0])
+    for p in profiles:
+        name = p.get('name', '').encode('utf-8')[:PROFILE_NAME_LEN - 1]
+        button_map = p.get('button_map', [0] * PROFILE_BUTTON_COUNT)
+        if len(button_map) != PROFILE_BUTTON_COUNT:
+            raise ValueError(f"{p.get('name')}: button_map needs {PROFILE_BUTTON_COUNT} entries")
+        entry = name.ljust(PROFILE_NAME_LEN, b'\0') + bytes(button_map)
+        entry += bytes([p.get('left_stick_sens', 100), p.get('right_stick_sens', 100),
+                        p.get('flags', 0)])
+        out += entry.ljust(PROFILE_SIZE, b'\0')
+    return bytes(out)
+
+
+def describe_profiles_image(image: bytes) -> str:
+    version, count, active = image[0], image[1], image[2]
+    lines = [f"version={version} count={count} active={active}"]
+    for i in range(count):
+        entry = image[4 + i * PROFILE_SIZE:4 + (i + 1) * PROFILE_SIZE]
+        name = entry[:PROFILE_NAME_LEN].split(b'\0')[0].decode('utf-8', 'replace')
+        lines.append(f"  [{i + 1}] {name}")
+    return '\n'.join(lines)
+
+
+# ============================================================================
+# Main
+# ============================================================================
+
+def main():
+    parser = argparse.ArgumentParser(description='CDC bulk transfer client')
+    parser.add_argument('port', help='CDC data port (e.g. /dev/ttyACM0)')
+    parser.add_argument('--window', type=int, default=4, help='chunks in flight')
+    sub = parser.add_subparsers(dest='action', required=True)
+
+    p_read = sub.add_parser('read', help='read profile set image')
+    p_read.add_argument('--out', help='write image to file')
+
+    p_write = sub.add_parser('write', help='upload raw profile set image')
+    p_write.add_argument('file')
+
+    p_sync = sub.add_parser('sync', help='upload profile set from JSON')
+    p_sync.add_argument('file')
+
+    p_stress = sub.add_parser('stress', help='repeated large uploads (no commit)')
+    p_stress.add_argument('--size', type=int, default=4096)
+    p_stress.add_argument('--count', type=int, default=10)
+    p_stress.add_argument('--drop', type=float, default=0.05, help='chunk drop rate')
+
+    args = parser.parse_args()
+
+    try:
+        client = BulkClient(args.port, args.window)
+    except Exception as e:
+        print(f"Failed to open {args.port}: {e}")
+        sys.exit(1)
+
+    try:
+        if args.action == 'read':
+            image = client.read(TARGET_PROFILES)
+            print(describe_profiles_image(image))
+            if args.out:
+                with open(args.out, 'wb') as f:
+                    f.write(image)
+
+        elif args.action in ('write', 'sync'):
+            if args.action == 'write':
+                with open(args.file, 'rb') as f:
+                    image = f.read()
+            else:
+                with open(args.file) as f:
+                    image = build_profiles_image(json.load(f))
+
+            start = time.perf_counter()
+            stats = client.upload(TARGET_PROFILES, image)
+            client.command('BULK.COMMIT')
+            elapsed = (time.perf_counter() - start) * 1000.0
+            print(f"Uploaded {len(image)} bytes in {stats['chunks']} chunks, "
+                  f"{elapsed:.1f} ms")
+
+            if client.read(TARGET_PROFILES)[4:] != image[4:]:
+                raise BulkError('read-back does not match upload')
+            print("Read-back verified")
+
+        elif args.action == 'stress':
+            total = 0
+            start = time.perf_counter()
+            for i in range(args.count):
+                image = os.urandom(args.size)
+                stats = client.upload(TARGET_PROFILES, image, drop_rate=args.drop)
+                client.command('BULK.ABORT')
+                total += len(image)
+                print(f"  #{i + 1}: {stats['chunks']} chunks, {stats['naks']} NAKs")
+            elapsed = time.perf_counter() - start
+            print(f"{total} bytes in {elapsed:.2f} s ({total / elapsed / 1024:.1f} KiB/s)")
+
+    except (BulkError, ValueError) as e:
+        print(f"Error: {e}")
+        sys.exit(1)
+    finally:
+        client.close()
+
+
+if __name__ == '__main__':
+    main()
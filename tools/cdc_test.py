@@ -7,6 +7,14 @@ Tests the binary framed CDC protocol for Joypad configuration.
 Usage:
     python3 cdc_test.py /dev/tty.usbmodem*
     python3 cdc_test.py /dev/ttyACM0
+    python3 cdc_test.py /dev/ttyACM0 --latency 1000 --save build_a.json
+    python3 cdc_test.py /dev/ttyACM0 --latency 1000 --compare build_a.json
+
+The port may also be a pyserial URL (e.g. socket://localhost:7000) to talk
+to a host-native build that exposes the protocol on a socket.
+
+--latency injects synthetic input events into the router (LOOPBACK.SET) and
+reports per-stage device timings plus host round-trip as percentiles.
 
 Commands:
     info, ping, reboot
@@ -17,6 +25,7 @@ Commands:
     quit - exit
 """
 
+import argparse
 import serial
 import struct
 import sys
@@ -33,6 +42,14 @@ MSG_ACK = 0x04
 MSG_NAK = 0x05
 MSG_DAT = 0x10
 
+# DAT stream IDs (first payload byte)
+DAT_STREAM_METRICS = 0x01
+DAT_STREAM_LOOPBACK = 0x03
+
+LOOPBACK_STAGES = ['router', 'readout', 'profile', 'encode', 'total']
+LOOPBACK_FLAG_DELIVERED = 0x01
+LOOPBACK_FLAG_ENCODED = 0x02
+
 
 def crc16_ccitt(data: bytes) -> int:
     """CRC-16-CCITT (poly 0x1021, init 0xFFFF)"""
@@ -93,7 +110,7 @@ def parse_packet(data: bytes) -> dict:
 
 class CDCProtocol:
     def __init__(self, port: str, baudrate: int = 115200):
-        self.ser = serial.Serial(port, baudrate, timeout=0.5)
+        self.ser = serial.serial_for_url(port, baudrate, timeout=0.5)
         self.seq = 0
         self.rx_buffer = bytes()
         self.running = True
@@ -134,8 +151,22 @@ class CDCProtocol:
             self.rx_buffer = self.rx_buffer[packet['raw_len']:]
             self._handle_packet(packet)
 
+    def _handle_metrics(self, payload: bytes):
+        """Decode a metrics DAT packet: [time_ms:4][slot:1][value:4]..."""
+        time_ms = struct.unpack_from('<I', payload, 0)[0]
+        values = []
+        for pos in range(4, len(payload) - 4, 5):
+            slot = payload[pos]
+            value = struct.unpack_from('<I', payload, pos + 1)[0]
+            values.append(f"{slot}={value}")
+        print(f"<< [METRICS] t={time_ms}ms {' '.join(values)}")
+
     def _handle_packet(self, packet: dict):
         """Handle a received packet"""
+        if packet['type'] == MSG_DAT and packet['payload'][:1] == bytes([DAT_STREAM_METRICS]):
+            self._handle_metrics(packet['payload'][1:])
+            return
+
         type_names = {MSG_RSP: 'RSP', MSG_EVT: 'EVT', MSG_ACK: 'ACK', MSG_NAK: 'NAK'}
         type_name = type_names.get(packet['type'], f"0x{packet['type']:02x}")
 
@@ -165,13 +196,174 @@ class CDCProtocol:
         self.ser.close()
 
 
+# ============================================================================
+# Latency measurement (loopback mode)
+# ============================================================================
+
+class LatencyProbe:
+    """Synchronous client for LOOPBACK.SET / loopback DAT packets"""
+
+    def __init__(self, port: str):
+        self.ser = serial.serial_for_url(port, 115200, timeout=0.5)
+        self.seq = 0
+        self.rx = bytes()
+
+    def _send(self, msg_type: int, payload: bytes) -> int:
+        seq = self.seq
+        self.seq = (self.seq + 1) & 0xFF
+        self.ser.write(build_packet(msg_type, seq, payload))
+        return seq
+
+    def _read_packet(self, timeout: float = 1.0):
+        deadline = time.perf_counter() + timeout
+        while time.perf_counter() < deadline:
+            while len(self.rx) >= 7:
+                sync = self.rx.find(bytes([CDC_SYNC]))
+                if sync < 0:
+                    self.rx = bytes()
+                    break
+                self.rx = self.rx[sync:]
+                packet = parse_packet(self.rx)
+                if packet is None:
+                    break
+                self.rx = self.rx[packet['raw_len']:]
+                return packet
+            data = self.ser.read(self.ser.in_waiting or 1)
+            if data:
+                self.rx += data
+        return None
+
+    def command(self, cmd: str, **args) -> dict:
+        payload = {'cmd': cmd}
+        if args:
+            payload['args'] = args
+        seq = self._send(MSG_CMD, json.dumps(payload, separators=(',', ':')).encode())
+        while True:
+            packet = self._read_packet(2.0)
+            if packet is None:
+                raise TimeoutError(f"no response to {cmd}")
+            if packet['type'] == MSG_RSP and packet['seq'] == seq:
+                return json.loads(packet['payload'].decode())
+
+    def sample(self, sample_id: int, buttons: int, axes=(128, 128, 128, 128, 0, 0)):
+        """Inject one event; returns dict of stage timings (us) or None on timeout"""
+        payload = struct.pack('<BII6B', DAT_STREAM_LOOPBACK, sample_id, buttons, *axes)
+        start = time.perf_counter()
+        self._send(MSG_DAT, payload)
+        while True:
+            packet = self._read_packet()
+            if packet is None:
+                return None
+            p = packet['payload']
+            if packet['type'] != MSG_DAT or p[:1] != bytes([DAT_STREAM_LOOPBACK]):
+                continue
+            rid, flags = struct.unpack_from('<IB', p, 1)
+            if rid != sample_id:
+                continue
+            values = struct.unpack_from('<6I', p, 6)
+            result = dict(zip(LOOPBACK_STAGES, values[:5]))
+            result['rtt'] = (time.perf_counter() - start) * 1e6
+            result['flags'] = flags
+            return result
+
+    def close(self):
+        self.ser.close()
+
+
+def percentile(values, pct):
+    ordered = sorted(values)
+    if not ordered:
+        return 0
+    idx = min(len(ordered) - 1, int(round(pct / 100.0 * (len(ordered) - 1))))
+    return ordered[idx]
+
+
+def latency_summary(samples: list) -> dict:
+    summary = {}
+    for stage in LOOPBACK_STAGES + ['rtt']:
+        values = [s[stage] for s in samples if s['flags'] & LOOPBACK_FLAG_DELIVERED]
+        summary[stage] = {
+            'min': min(values, default=0),
+            'p50': percentile(values, 50),
+            'p90': percentile(values, 90),
+            'p99': percentile(values, 99),
+            'max': max(values, default=0),
+        }
+    return summary
+
+
+def print_latency_report(summary: dict, baseline: dict = None):
+    cols = ['min', 'p50', 'p90', 'p99', 'max']
+    print(f"{'stage (us)':<10}" + ''.join(f"{c:>10}" for c in cols) +
+          ("   p50 delta   p99 delta" if baseline else ''))
+    for stage, stats in summary.items():
+        line = f"{stage:<10}" + ''.join(f"{stats[c]:>10.1f}" for c in cols)
+        if baseline and stage in baseline:
+            line += f"  {stats['p50'] - baseline[stage]['p50']:>+10.1f}"
+            line += f"  {stats['p99'] - baseline[stage]['p99']:>+10.1f}"
+        print(line)
+
+
+def run_latency(port: str, count: int, save: str = None, compare: str = None):
+    probe = LatencyProbe(port)
+    try:
+        rsp = probe.command('LOOPBACK.SET', enable=True)
+        if not rsp.get('ok'):
+            print(f"Loopback not available: {rsp}")
+            return
+        print(f"Loopback enabled (output {rsp.get('output')}), {count} samples")
+
+        # Press a button first so the probe gets a player slot
+        probe.sample(0, 1 << 0)
+
+        samples, lost = [], 0
+        for i in range(1, count + 1):
+            # Alternate press/release so every sample changes state
+            result = probe.sample(i, (1 << 0) if i & 1 else 0)
+            if result is None:
+                lost += 1
+                continue
+            samples.append(result)
+    finally:
+        try:
+            probe.command('LOOPBACK.SET', enable=False)
+        except TimeoutError:
+            pass
+        probe.close()
+
+    delivered = sum(1 for s in samples if s['flags'] & LOOPBACK_FLAG_DELIVERED)
+    encoded = sum(1 for s in samples if s['flags'] & LOOPBACK_FLAG_ENCODED)
+    print(f"received {len(samples)}/{count}, lost {lost}, "
+          f"delivered {delivered}, encoded {encoded}")
+
+    summary = latency_summary(samples)
+    baseline = None
+    if compare:
+        with open(compare) as f:
+            baseline = json.load(f)['summary']
+    print_latency_report(summary, baseline)
+
+    if save:
+        with open(save, 'w') as f:
+            json.dump({'count': count, 'lost': lost, 'summary': summary,
+                       'samples': samples}, f, indent=1)
+        print(f"Saved to {save}")
+
+
 def main():
-    if len(sys.argv) < 2:
-        print("Usage: python3 cdc_test.py <serial_port>")
-        print("Example: python3 cdc_test.py /dev/tty.usbmodem11301")
-        sys.exit(1)
+    parser = argparse.ArgumentParser(description='CDC protocol test tool')
+    parser.add_argument('port', help='serial port or pyserial URL')
+    parser.add_argument('--latency', type=int, metavar='N',
+                        help='run N loopback latency samples and exit')
+    parser.add_argument('--save', help='save latency results to JSON')
+    parser.add_argument('--compare', help='compare against saved latency results')
+    args = parser.parse_args()
+
+    port = args.port
+    if args.latency:
+        run_latency(port, args.latency, args.save, args.compare)
+        return
 
-    port = sys.argv[1]
     print(f"Connecting to {port}...")
 
     try:
@@ -205,6 +397,7 @@ def main():
                 print("  profile, profile.set <n>, profiles")
                 print("  settings, reset")
                 print("  stream - enable input streaming")
+                print("  metrics, metrics.sub <ms> - list / stream metrics (0 = stop)")
                 print("  raw <hex> - send raw bytes")
                 print("  quit - exit")
             elif cmd == 'info':
@@ -231,6 +424,10 @@ def main():
                 proto.send_cmd('SETTINGS.RESET')
             elif cmd == 'stream':
                 proto.send_cmd('INPUT.STREAM', {'enable': True})
+            elif cmd == 'metrics':
+                proto.send_cmd('METRICS.LIST')
+            elif cmd == 'metrics.sub' and len(parts) > 1:
+                proto.send_cmd('METRICS.SUBSCRIBE', {'interval_ms': int(parts[1])})
             elif cmd == 'raw' and len(parts) > 1:
                 proto.ser.write(bytes.fromhex(parts[1]))
             else:
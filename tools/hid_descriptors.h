@@ -0,0 +1,145 @@
+// hid_descriptors.h - Report descriptor corpus for the host HID tools
+//
+// Real-world report descriptors (input reports only; trailing output and
+// feature items trimmed) shared by hid_extract_bench.c and hid_parser_fuzz.c.
+
+#ifndef HID_DESCRIPTORS_H
+#define HID_DESCRIPTORS_H
+
+#include <stdint.h>
+
+// ============================================================================
+// GAMEPADS
+// ============================================================================
+
+// DragonRise generic USB gamepad (0079:0006): 5 axes, 4-bit hat, 12 buttons
+static const uint8_t desc_dragonrise[] = {
+  0x05, 0x01, 0x09, 0x04, 0xA1, 0x01, 0xA1, 0x02,
+  0x75, 0x08, 0x95, 0x05, 0x15, 0x00, 0x26, 0xFF, 0x00, 0x35, 0x00, 0x46, 0xFF, 0x00,
+  0x09, 0x30, 0x09, 0x31, 0x09, 0x32, 0x09, 0x32, 0x09, 0x35, 0x81, 0x02,
+  0x75, 0x04, 0x95, 0x01, 0x25, 0x07, 0x46, 0x3B, 0x01, 0x65, 0x14, 0x09, 0x39, 0x81, 0x42,
+  0x65, 0x00, 0x75, 0x01, 0x95, 0x0C, 0x25, 0x01, 0x45, 0x01,
+  0x05, 0x09, 0x19, 0x01, 0x29, 0x0C, 0x81, 0x02,
+  0x06, 0x00, 0xFF, 0x75, 0x01, 0x95, 0x08, 0x25, 0x01, 0x45, 0x01, 0x09, 0x01, 0x81, 0x02,
+  0xC0, 0xC0,
+};
+
+// Sony DualShock 4 (054C:05C4), report ID 1
+static const uint8_t desc_ds4[] = {
+  0x05, 0x01, 0x09, 0x05, 0xA1, 0x01, 0x85, 0x01,
+  0x09, 0x30, 0x09, 0x31, 0x09, 0x32, 0x09, 0x35, 0x15, 0x00, 0x26, 0xFF, 0x00,
+  0x75, 0x08, 0x95, 0x04, 0x81, 0x02,
+  0x09, 0x39, 0x15, 0x00, 0x25, 0x07, 0x35, 0x00, 0x46, 0x3B, 0x01, 0x65, 0x14,
+  0x75, 0x04, 0x95, 0x01, 0x81, 0x42, 0x65, 0x00,
+  0x05, 0x09, 0x19, 0x01, 0x29, 0x0E, 0x15, 0x00, 0x25, 0x01, 0x75, 0x01, 0x95, 0x0E, 0x81, 0x02,
+  0x06, 0x00, 0xFF, 0x09, 0x20, 0x75, 0x06, 0x95, 0x01, 0x15, 0x00, 0x25, 0x7F, 0x81, 0x02,
+  0x05, 0x01, 0x09, 0x33, 0x09, 0x34, 0x15, 0x00, 0x26, 0xFF, 0x00, 0x75, 0x08, 0x95, 0x02, 0x81, 0x02,
+  0x06, 0x00, 0xFF, 0x09, 0x21, 0x95, 0x36, 0x81, 0x02,
+  0xC0,
+};
+
+// HORI Pokken / Switch-style pad (0F0D:0092): 14 buttons, padding, hat, 4 axes
+static const uint8_t desc_hori[] = {
+  0x05, 0x01, 0x09, 0x05, 0xA1, 0x01,
+  0x15, 0x00, 0x25, 0x01, 0x35, 0x00, 0x45, 0x01, 0x75, 0x01, 0x95, 0x0E,
+  0x05, 0x09, 0x19, 0x01, 0x29, 0x0E, 0x81, 0x02,
+  0x95, 0x02, 0x81, 0x01,
+  0x05, 0x01, 0x25, 0x07, 0x46, 0x3B, 0x01, 0x75, 0x04, 0x95, 0x01, 0x65, 0x14,
+  0x09, 0x39, 0x81, 0x42, 0x65, 0x00, 0x95, 0x01, 0x81, 0x01,
+  0x26, 0xFF, 0x00, 0x46, 0xFF, 0x00, 0x09, 0x30, 0x09, 0x31, 0x09, 0x32, 0x09, 0x35,
+  0x75, 0x08, 0x95, 0x04, 0x81, 0x02,
+  0x06, 0x00, 0xFF, 0x09, 0x20, 0x95, 0x01, 0x81, 0x02,
+  0xC0,
+};
+
+// Logitech Extreme 3D Pro (046D:C215): 10-bit X/Y, hat, twist, split buttons
+static const uint8_t desc_extreme3d[] = {
+  0x05, 0x01, 0x09, 0x04, 0xA1, 0x01, 0xA1, 0x02,
+  0x75, 0x0A, 0x95, 0x02, 0x15, 0x00, 0x26, 0xFF, 0x03, 0x35, 0x00, 0x46, 0xFF, 0x03,
+  0x09, 0x30, 0x09, 0x31, 0x81, 0x02,
+  0x75, 0x04, 0x95, 0x01, 0x25, 0x07, 0x46, 0x3B, 0x01, 0x65, 0x14, 0x09, 0x39, 0x81, 0x42,
+  0x65, 0x00, 0x75, 0x08, 0x95, 0x01, 0x26, 0xFF, 0x00, 0x46, 0xFF, 0x00, 0x09, 0x35, 0x81, 0x02,
+  0x05, 0x09, 0x75, 0x01, 0x95, 0x08, 0x25, 0x01, 0x45, 0x01, 0x19, 0x01, 0x29, 0x08, 0x81, 0x02,
+  0x05, 0x01, 0x75, 0x08, 0x95, 0x01, 0x26, 0xFF, 0x00, 0x46, 0xFF, 0x00, 0x09, 0x36, 0x81, 0x02,
+  0x05, 0x09, 0x75, 0x01, 0x95, 0x04, 0x25, 0x01, 0x45, 0x01, 0x19, 0x09, 0x29, 0x0C, 0x81, 0x02,
+  0x95, 0x04, 0x81, 0x01,
+  0xC0, 0xC0,
+};
+
+// Pad with 16-bit little-endian sticks and triggers, report ID 3
+static const uint8_t desc_wide[] = {
+  0x05, 0x01, 0x09, 0x05, 0xA1, 0x01, 0x85, 0x03,
+  0x15, 0x00, 0x27, 0xFF, 0xFF, 0x00, 0x00, 0x75, 0x10, 0x95, 0x06,
+  0x09, 0x30, 0x09, 0x31, 0x09, 0x32, 0x09, 0x35, 0x09, 0x33, 0x09, 0x34, 0x81, 0x02,
+  0x05, 0x09, 0x19, 0x01, 0x29, 0x10, 0x15, 0x00, 0x25, 0x01, 0x75, 0x01, 0x95, 0x10, 0x81, 0x02,
+  0x05, 0x01, 0x09, 0x39, 0x15, 0x00, 0x25, 0x07, 0x75, 0x04, 0x95, 0x01, 0x81, 0x42,
+  0x75, 0x04, 0x95, 0x01, 0x81, 0x01,
+  0xC0,
+};
+
+// ============================================================================
+// LARGE DESCRIPTORS
+// ============================================================================
+
+// NKRO keyboard: boot-style report (ID 1) plus a 240-key bitmap (ID 2)
+static const uint8_t desc_nkro_keyboard[] = {
+  0x05, 0x01, 0x09, 0x06, 0xA1, 0x01, 0x85, 0x01,
+  0x05, 0x07, 0x19, 0xE0, 0x29, 0xE7, 0x15, 0x00, 0x25, 0x01, 0x75, 0x01, 0x95, 0x08, 0x81, 0x02,
+  0x95, 0x01, 0x75, 0x08, 0x81, 0x01,
+  0x95, 0x06, 0x75, 0x08, 0x15, 0x00, 0x26, 0xFF, 0x00, 0x05, 0x07, 0x19, 0x00, 0x2A, 0xFF, 0x00, 0x81, 0x00,
+  0xC0,
+  0x05, 0x01, 0x09, 0x06, 0xA1, 0x01, 0x85, 0x02,
+  0x05, 0x07, 0x19, 0x00, 0x29, 0xEF, 0x15, 0x00, 0x25, 0x01, 0x75, 0x01, 0x95, 0xF0, 0x81, 0x02,
+  0xC0,
+};
+
+// Racing wheel (G29-style): 16-bit wheel, 3 pedals, 25 buttons, hat
+static const uint8_t desc_wheel[] = {
+  0x05, 0x01, 0x09, 0x04, 0xA1, 0x01, 0xA1, 0x02, 0x85, 0x01,
+  0x09, 0x30, 0x15, 0x00, 0x27, 0xFF, 0xFF, 0x00, 0x00, 0x35, 0x00, 0x47, 0xFF, 0xFF, 0x00, 0x00,
+  0x75, 0x10, 0x95, 0x01, 0x81, 0x02,
+  0x09, 0x31, 0x09, 0x32, 0x09, 0x35, 0x26, 0xFF, 0x00, 0x46, 0xFF, 0x00, 0x75, 0x08, 0x95, 0x03, 0x81, 0x02,
+  0x05, 0x09, 0x19, 0x01, 0x29, 0x19, 0x25, 0x01, 0x45, 0x01, 0x75, 0x01, 0x95, 0x19, 0x81, 0x02,
+  0x75, 0x07, 0x95, 0x01, 0x81, 0x01,
+  0x05, 0x01, 0x09, 0x39, 0x25, 0x07, 0x46, 0x3B, 0x01, 0x65, 0x14, 0x75, 0x04, 0x95, 0x01, 0x81, 0x42,
+  0x65, 0x00, 0x75, 0x04, 0x81, 0x01,
+  0x06, 0x00, 0xFF, 0x09, 0x01, 0xA1, 0x02, 0x26, 0xFF, 0x00, 0x75, 0x08, 0x95, 0x07, 0x09, 0x03, 0x91, 0x02, 0xC0,
+  0xC0, 0xC0,
+};
+
+// HOTAS stick (Warthog-style): nested collections, 8 axes, 32 buttons, hat
+static const uint8_t desc_hotas[] = {
+  0x05, 0x01, 0x09, 0x04, 0xA1, 0x01, 0x85, 0x01,
+  0xA1, 0x00, 0x09, 0x30, 0x09, 0x31, 0x15, 0x00, 0x27, 0xFF, 0xFF, 0x00, 0x00,
+  0x75, 0x10, 0x95, 0x02, 0x81, 0x02, 0xC0,
+  0xA1, 0x00, 0x09, 0x32, 0x09, 0x33, 0x09, 0x34, 0x09, 0x35, 0x09, 0x36, 0x09, 0x37,
+  0x75, 0x10, 0x95, 0x06, 0x81, 0x02, 0xC0,
+  0xA1, 0x02, 0x05, 0x09, 0x19, 0x01, 0x29, 0x20, 0x15, 0x00, 0x25, 0x01, 0x75, 0x01, 0x95, 0x20, 0x81, 0x02, 0xC0,
+  0xA1, 0x02, 0x05, 0x01, 0x09, 0x39, 0x15, 0x01, 0x25, 0x08, 0x35, 0x00, 0x46, 0x3B, 0x01, 0x65, 0x14,
+  0x75, 0x04, 0x95, 0x01, 0x81, 0x42, 0x65, 0x00, 0x75, 0x04, 0x95, 0x01, 0x81, 0x01, 0xC0,
+  0xC0,
+};
+
+typedef struct {
+  const char* name;
+  const uint8_t* desc;
+  uint16_t desc_len;
+} hid_corpus_desc_t;
+
+#define DESC(name, d) { name, d, sizeof(d) }
+
+// Gamepads first; the extraction benchmark uses only those
+#define HID_CORPUS_GAMEPADS 5
+
+static const hid_corpus_desc_t hid_corpus[] = {
+  DESC("DragonRise 0079:0006", desc_dragonrise),
+  DESC("DualShock 4 054C:05C4", desc_ds4),
+  DESC("HORI Pokken 0F0D:0092", desc_hori),
+  DESC("Extreme 3D 046D:C215", desc_extreme3d),
+  DESC("16-bit axes (ID 3)", desc_wide),
+  DESC("NKRO keyboard", desc_nkro_keyboard),
+  DESC("Racing wheel", desc_wheel),
+  DESC("HOTAS stick", desc_hotas),
+};
+
+#endif // HID_DESCRIPTORS_H
@@ -0,0 +1,143 @@
+// hid_extract_bench.c - Host benchmark for compiled HID report extraction
+//
+// Parses the gamepad descriptors from hid_descriptors.h with the firmware's
+// HID parser, compiles each into an extraction program (hid_extract.c) and
+// compares it against the parser's per-item bit walk
+// (USB_GetHIDReportItemInfo). Every random report is checked for identical
+// results before timing.
+//
+// Build and run from the repo root:
+//   D=src/usb/usbh/hid/devices/generic
+//   gcc -O2 -I$D -o /tmp/hid_extract_bench tools/hid_extract_bench.c
+//       $D/hid_extract.c $D/hid_parser.c
+//   /tmp/hid_extract_bench [iterations]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "hid_parser.h"
+#include "hid_extract.h"
+#include "hid_descriptors.h"
+
+// ============================================================================
+// REFERENCE (parser per-item walk)
+// ============================================================================
+
+// Same filter as hid_gamepad.c
+bool CALLBACK_HIDParser_FilterHIDReportItem(uint8_t dev_addr, uint8_t instance, HID_ReportItem_t *const CurrentItem)
+{
+  (void)dev_addr;
+  (void)instance;
+  if (CurrentItem->ItemType != HID_REPORT_ITEM_In) return false;
+  if (CurrentItem->Attributes.Usage.Page == 0x09) return true;
+  if (CurrentItem->Attributes.Usage.Page != 0x01) return false;
+  uint16_t usage = CurrentItem->Attributes.Usage.Usage;
+  return (usage >= 0x30 && usage <= 0x35) || usage == 0x39;
+}
+
+static void reference_extract(HID_ReportInfo_t* info, uint8_t report_id,
+                              const uint8_t* report, hid_extract_values_t* out)
+{
+  static const uint8_t slot[] = {
+    HID_EXTRACT_X, HID_EXTRACT_Y, HID_EXTRACT_Z,
+    HID_EXTRACT_RX, HID_EXTRACT_RY, HID_EXTRACT_RZ,
+  };
+  const uint8_t* data = report_id ? report + 1 : report;
+
+  memset(out, 0, sizeof(*out));
+  out->hat = HID_EXTRACT_HAT_RELEASED;
+
+  for (HID_ReportItem_t* item = info->FirstReportItem; item; item = item->Next) {
+    if (!USB_GetHIDReportItemInfo(report_id, data, item)) continue;
+    uint16_t page = item->Attributes.Usage.Page;
+    uint16_t usage = item->Attributes.Usage.Usage;
+    if (page == 0x09) {
+      if (usage >= 1 && usage <= HID_EXTRACT_MAX_BUTTONS && (item->Value & 1)) {
+        out->buttons |= 1 << (usage - 1);
+      }
+    } else if (usage == 0x39) {
+      out->hat = item->Value;
+    } else {
+      out->axis[slot[usage - 0x30]] = item->Value;
+    }
+  }
+}
+
+// ============================================================================
+// MAIN
+// ============================================================================
+
+static double now_ns(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+#define REPORT_POOL 64
+
+int main(int argc, char** argv)
+{
+  long iterations = argc > 1 ? atol(argv[1]) : 1000000;
+  int failures = 0;
+  volatile uint32_t sink = 0;
+
+  printf("%-24s %4s %4s %4s %12s %12s %8s\n",
+         "descriptor", "len", "item", "ops", "walk ns", "compiled ns", "speedup");
+
+  for (size_t d = 0; d < HID_CORPUS_GAMEPADS; d++) {
+    const hid_corpus_desc_t* bd = &hid_corpus[d];
+    HID_ReportInfo_t* info = NULL;
+
+    if (USB_ProcessHIDReport(1, 0, bd->desc, bd->desc_len, &info) != HID_PARSE_Successful) {
+      printf("%-24s parse failed\n", bd->name);
+      failures++;
+      continue;
+    }
+
+    hid_extract_program_t prog;
+    hid_extract_compile(info, &prog);
+
+    // Random reports carrying the right report ID
+    static uint8_t reports[REPORT_POOL][64];
+    uint16_t len = prog.min_len;
+    for (int r = 0; r < REPORT_POOL; r++) {
+      for (int i = 0; i < 64; i++) reports[r][i] = rand();
+      if (prog.report_id) reports[r][0] = prog.report_id;
+    }
+
+    // Equivalence
+    for (int r = 0; r < REPORT_POOL; r++) {
+      hid_extract_values_t a, b;
+      reference_extract(info, prog.report_id, reports[r], &a);
+      if (!hid_extract_run(&prog, reports[r], len, &b) || memcmp(&a, &b, sizeof(a)) != 0) {
+        printf("%-24s MISMATCH on report %d\n", bd->name, r);
+        failures++;
+        break;
+      }
+    }
+
+    hid_extract_values_t v;
+    double t0 = now_ns();
+    for (long i = 0; i < iterations; i++) {
+      reference_extract(info, prog.report_id, reports[i % REPORT_POOL], &v);
+      sink += v.buttons;
+    }
+    double t1 = now_ns();
+    for (long i = 0; i < iterations; i++) {
+      hid_extract_run(&prog, reports[i % REPORT_POOL], len, &v);
+      sink += v.buttons;
+    }
+    double t2 = now_ns();
+
+    double walk = (t1 - t0) / iterations;
+    double compiled = (t2 - t1) / iterations;
+    printf("%-24s %4d %4d %4d %12.1f %12.1f %7.1fx\n", bd->name, len,
+           info->TotalReportItems, prog.op_count, walk, compiled, walk / compiled);
+
+    USB_FreeReportInfo(info);
+  }
+
+  return failures ? 1 : 0;
+}
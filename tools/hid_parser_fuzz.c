@@ -0,0 +1,172 @@
+// hid_parser_fuzz.c - Host fuzzer for the HID report descriptor parser
+//
+// Runs every descriptor in hid_descriptors.h, then random mutations of them
+// (bit flips, byte insert/delete, truncation, splices between descriptors),
+// through the firmware's HID parser and the extraction compiler. The filter
+// keeps every input item, so large descriptors also exercise the
+// arena-full path. Build with sanitizers so bad accesses abort:
+//
+//   D=src/usb/usbh/hid/devices/generic
+//   gcc -O1 -g -fsanitize=address,undefined -I$D -o /tmp/hid_parser_fuzz
+//       tools/hid_parser_fuzz.c $D/hid_parser.c $D/hid_extract.c
+//   /tmp/hid_parser_fuzz [iterations] [seed]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "hid_parser.h"
+#include "hid_extract.h"
+#include "hid_descriptors.h"
+
+#define CORPUS_COUNT (sizeof(hid_corpus) / sizeof(hid_corpus[0]))
+#define MAX_DESC 1024
+
+bool CALLBACK_HIDParser_FilterHIDReportItem(uint8_t dev_addr, uint8_t instance, HID_ReportItem_t *const CurrentItem)
+{
+  (void)dev_addr;
+  (void)instance;
+  return CurrentItem->ItemType == HID_REPORT_ITEM_In;
+}
+
+// ============================================================================
+// MUTATION
+// ============================================================================
+
+static uint16_t mutate(uint8_t* buf, uint16_t len)
+{
+  int rounds = 1 + rand() % 4;
+  for (int r = 0; r < rounds; r++) {
+    switch (rand() % 6) {
+      case 0:   // Bit flip
+        if (len) buf[rand() % len] ^= 1 << (rand() % 8);
+        break;
+      case 1:   // Random byte
+        if (len) buf[rand() % len] = rand();
+        break;
+      case 2: { // Insert
+        if (len >= MAX_DESC) break;
+        uint16_t at = len ? rand() % len : 0;
+        memmove(&buf[at + 1], &buf[at], len - at);
+        buf[at] = rand();
+        len++;
+        break;
+      }
+      case 3: { // Delete
+        if (!len) break;
+        uint16_t at = rand() % len;
+        memmove(&buf[at], &buf[at + 1], len - at - 1);
+        len--;
+        break;
+      }
+      case 4:   // Truncate
+        if (len) len = rand() % len;
+        break;
+      case 5: { // Splice another descriptor's tail
+        const hid_corpus_desc_t* other = &hid_corpus[rand() % CORPUS_COUNT];
+        uint16_t at = len ? rand() % len : 0;
+        uint16_t from = rand() % other->desc_len;
+        uint16_t n = other->desc_len - from;
+        if (at + n > MAX_DESC) n = MAX_DESC - at;
+        memcpy(&buf[at], &other->desc[from], n);
+        len = at + n;
+        break;
+      }
+    }
+  }
+  return len;
+}
+
+// ============================================================================
+// CHECKS
+// ============================================================================
+
+static int run_one(const uint8_t* desc, uint16_t len, uint16_t* items, uint16_t* dropped)
+{
+  HID_ReportInfo_t* info = NULL;
+  uint8_t ret = USB_ProcessHIDReport(1, 0, desc, len, &info);
+  if (ret != HID_PARSE_Successful) return ret;
+
+  // Item list must be consistent with the count
+  uint16_t walked = 0;
+  for (HID_ReportItem_t* item = info->FirstReportItem; item; item = item->Next) {
+    walked++;
+    if (walked > info->TotalReportItems) break;
+  }
+  if (walked != info->TotalReportItems) {
+    printf("item list has %d entries, TotalReportItems=%d\n", walked, info->TotalReportItems);
+    abort();
+  }
+
+  // Compiled program must stay inside the report it claims to need
+  hid_extract_program_t prog;
+  hid_extract_compile(info, &prog);
+  for (uint8_t i = 0; i < prog.op_count; i++) {
+    const hid_extract_op_t* op = &prog.ops[i];
+    if (op->byte + op->nbytes > prog.min_len || op->nbytes == 0 || op->nbytes > 4) {
+      printf("op %d out of range (byte %d x%d, min_len %d)\n", i, op->byte, op->nbytes, prog.min_len);
+      abort();
+    }
+  }
+
+  // Run it over exactly-sized and short reports
+  uint8_t* report = malloc(prog.min_len + 1);
+  for (uint16_t i = 0; i <= prog.min_len; i++) report[i] = rand();
+  if (prog.report_id) report[0] = prog.report_id;
+  hid_extract_values_t values;
+  hid_extract_run(&prog, report, prog.min_len, &values);
+  if (prog.min_len && hid_extract_run(&prog, report, prog.min_len - 1, &values)) {
+    printf("short report accepted\n");
+    abort();
+  }
+  free(report);
+
+  *items += info->TotalReportItems;
+  *dropped += info->DroppedReportItems;
+  USB_FreeReportInfo(info);
+  return ret;
+}
+
+// ============================================================================
+// MAIN
+// ============================================================================
+
+int main(int argc, char** argv)
+{
+  long iterations = argc > 1 ? atol(argv[1]) : 200000;
+  unsigned seed = argc > 2 ? (unsigned)atol(argv[2]) : 1;
+  srand(seed);
+
+  // Unmodified corpus must parse
+  int failures = 0;
+  for (size_t d = 0; d < CORPUS_COUNT; d++) {
+    uint16_t items = 0, dropped = 0;
+    int ret = run_one(hid_corpus[d].desc, hid_corpus[d].desc_len, &items, &dropped);
+    printf("%-24s %4d bytes  ret=%d items=%d dropped=%d\n", hid_corpus[d].name,
+           hid_corpus[d].desc_len, ret, items, dropped);
+    if (ret != HID_PARSE_Successful) failures++;
+  }
+
+  // Mutations must never crash; parse errors are fine
+  static uint8_t buf[MAX_DESC];
+  long results[8] = {0};
+  uint16_t items = 0, dropped = 0;
+  for (long i = 0; i < iterations; i++) {
+    const hid_corpus_desc_t* base = &hid_corpus[rand() % CORPUS_COUNT];
+    memcpy(buf, base->desc, base->desc_len);
+    uint16_t len = mutate(buf, base->desc_len);
+
+    int ret = run_one(buf, len, &items, &dropped);
+    results[ret < 7 ? ret : 7]++;
+  }
+
+  printf("\n%ld mutated descriptors (seed %u):\n", iterations, seed);
+  static const char* names[] = {
+    "ok", "stack overflow", "stack underflow", "unexpected end collection",
+    "usage list overflow", "no items", "out of memory", "other",
+  };
+  for (int r = 0; r < 8; r++) {
+    if (results[r]) printf("  %-26s %ld\n", names[r], results[r]);
+  }
+
+  return failures ? 1 : 0;
+}
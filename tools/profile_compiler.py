@@ -0,0 +1,322 @@
+#!/usr/bin/env python3
+"""
+Profile Compiler
+
+Compiles a human-readable JSON profile description into the binary
+profile blob format loaded by the firmware
+(see src/core/services/profiles/profile_blob.h).
+
+Usage:
+    python3 profile_compiler.py ssbm.json -o ssbm.bin
+    python3 profile_compiler.py ssbm.json --dump
+    python3 profile_compiler.py ssbm.json --upload /dev/ttyACM0
+
+As a module (e.g. from tests):
+    from profile_compiler import compile_profile, decode_blob
+    blob = compile_profile({'name': 'Test', 'map': {'B1': 'B2'}})
+    assert decode_blob(blob)['map'][0]['input'] == ['B1']
+
+Description format (every key optional):
+    {
+      "name": "SSBM",                          # up to 16 bytes
+      "map": {
+        "B1": "B2",                            # simple remap
+        "R2": ["L2", "R2"],                    # one button -> several
+        "L1": {"buttons": "L2", "analog": "L2_CUSTOM", "value": 43},
+        "A2": null                             # disabled
+      },
+      "combos": [
+        {"inputs": ["S1", "S2"], "output": "A1", "consume": true, "exclusive": false}
+      ],
+      "triggers": {
+        "l2": {"behavior": "light_press", "threshold": 128, "value": 43},
+        "r2": {"behavior": "passthrough"}
+      },
+      "sticks": {
+        "left": {"sensitivity": 100,
+                 "modifiers": [{"trigger": "L3", "sensitivity": 50, "consume": true}]},
+        "right": {"sensitivity": 100}
+      },
+      "socd": "neutral",
+      "adaptive_triggers": false
+    }
+"""
+
+import argparse
+import json
+import struct
+import sys
+
+# ============================================================================
+# Format constants (must match profile_blob.h / profile.h)
+# ============================================================================
+
+MAGIC = 0x4250504A  # "JPPB"
+VERSION = 1
+HEADER_SIZE = 32
+SETTINGS_SIZE = 12
+NAME_LEN = 16
+
+MAX_BUTTON_MAPPINGS = 24
+MAX_BUTTON_COMBOS = 8
+MAX_MODIFIERS = 4
+
+FLAG_ADAPTIVE_TRIGGERS = 1 << 0
+COMBO_CONSUME = 1 << 0
+COMBO_EXCLUSIVE = 1 << 1
+MOD_CONSUME = 1 << 0
+
+# JP_BUTTON_* (core/buttons.h)
+BUTTONS = {
+    'B1': 0, 'B2': 1, 'B3': 2, 'B4': 3,
+    'L1': 4, 'R1': 5, 'L2': 6, 'R2': 7,
+    'S1': 8, 'S2': 9, 'L3': 10, 'R3': 11,
+    'DU': 12, 'DD': 13, 'DL': 14, 'DR': 15,
+    'A1': 16, 'A2': 17, 'A3': 18, 'A4': 19,
+    'L4': 20, 'R4': 21,
+}
+
+# analog_target_t
+ANALOG_TARGETS = [
+    'NONE', 'LX_MIN', 'LX_MAX', 'LY_MIN', 'LY_MAX',
+    'RX_MIN', 'RX_MAX', 'RY_MIN', 'RY_MAX',
+    'L2_FULL', 'R2_FULL', 'L2_CUSTOM', 'R2_CUSTOM',
+]
+
+# trigger_behavior_t
+TRIGGER_BEHAVIORS = ['passthrough', 'digital_only', 'full_press',
+                     'light_press', 'instant', 'disabled']
+
+# socd_mode_t
+SOCD_MODES = ['passthrough', 'neutral', 'up_priority', 'last_win']
+
+
+class ProfileError(ValueError):
+    pass
+
+
+# ============================================================================
+# Compiler
+# ============================================================================
+
+def _buttons(value, where: str) -> int:
+    """Button name, list of names, or null -> JP_BUTTON_* mask"""
+    if value is None:
+        return 0
+    names = [value] if isinstance(value, str) else value
+    mask = 0
+    for name in names:
+        if name.upper() not in BUTTONS:
+            raise ProfileError(f"{where}: unknown button '{name}'")
+        mask |= 1 << BUTTONS[name.upper()]
+    return mask
+
+
+def _enum(value, table, where: str) -> int:
+    try:
+        return table.index(value)
+    except ValueError:
+        raise ProfileError(f"{where}: '{value}' is not one of {', '.join(table)}")
+
+
+def _byte(value, where: str, hi: int = 255) -> int:
+    if not isinstance(value, int) or not 0 <= value <= hi:
+        raise ProfileError(f"{where}: expected integer 0-{hi}, got {value!r}")
+    return value
+
+
+def _compile_modifiers(stick: dict, side: str) -> bytes:
+    mods = stick.get('modifiers', [])
+    if len(mods) > MAX_MODIFIERS:
+        raise ProfileError(f"sticks.{side}: at most {MAX_MODIFIERS} modifiers")
+    out = b''
+    for i, mod in enumerate(mods):
+        where = f"sticks.{side}.modifiers[{i}]"
+        flags = MOD_CONSUME if mod.get('consume', True) else 0
+        out += struct.pack('<IBB', _buttons(mod['trigger'], where),
+                           _byte(mod.get('sensitivity', 50), where, 100), flags)
+    return out
+
+
+def compile_profile(desc: dict) -> bytes:
+    """Compile a profile description into a blob"""
+    name = desc.get('name', 'Custom').encode('utf-8')
+    if len(name) > NAME_LEN:
+        raise ProfileError(f"name: at most {NAME_LEN} bytes")
+
+    # Button maps
+    maps = b''
+    for button, target in desc.get('map', {}).items():
+        where = f"map.{button}"
+        analog, value = 0, 0
+        if isinstance(target, dict):
+            output = _buttons(target.get('buttons'), where)
+            analog = _enum(target.get('analog', 'NONE').upper(), ANALOG_TARGETS, where)
+            value = _byte(target.get('value', 0), where)
+        else:
+            output = _buttons(target, where)
+        maps += struct.pack('<IIBB', _buttons(button, where), output, analog, value)
+    map_count = len(desc.get('map', {}))
+    if map_count > MAX_BUTTON_MAPPINGS:
+        raise ProfileError(f"map: at most {MAX_BUTTON_MAPPINGS} entries")
+
+    # Combos
+    combos = b''
+    combo_list = desc.get('combos', [])
+    if len(combo_list) > MAX_BUTTON_COMBOS:
+        raise ProfileError(f"combos: at most {MAX_BUTTON_COMBOS} entries")
+    for i, combo in enumerate(combo_list):
+        where = f"combos[{i}]"
+        flags = (COMBO_CONSUME if combo.get('consume', True) else 0) | \
+                (COMBO_EXCLUSIVE if combo.get('exclusive', False) else 0)
+        combos += struct.pack('<IIB', _buttons(combo['inputs'], where),
+                              _buttons(combo.get('output'), where), flags)
+
+    # Settings
+    triggers = desc.get('triggers', {})
+    l2 = triggers.get('l2', {})
+    r2 = triggers.get('r2', {})
+    sticks = desc.get('sticks', {})
+    left = sticks.get('left', {})
+    right = sticks.get('right', {})
+    flags = FLAG_ADAPTIVE_TRIGGERS if desc.get('adaptive_triggers', False) else 0
+
+    settings = struct.pack(
+        '<BBBBBBBBBBxx',
+        _enum(l2.get('behavior', 'passthrough'), TRIGGER_BEHAVIORS, 'triggers.l2'),
+        _enum(r2.get('behavior', 'passthrough'), TRIGGER_BEHAVIORS, 'triggers.r2'),
+        _byte(l2.get('threshold', 128), 'triggers.l2.threshold'),
+        _byte(r2.get('threshold', 128), 'triggers.r2.threshold'),
+        _byte(l2.get('value', 0), 'triggers.l2.value'),
+        _byte(r2.get('value', 0), 'triggers.r2.value'),
+        _byte(left.get('sensitivity', 100), 'sticks.left.sensitivity', 100),
+        _byte(right.get('sensitivity', 100), 'sticks.right.sensitivity', 100),
+        _enum(desc.get('socd', 'passthrough'), SOCD_MODES, 'socd'),
+        flags,
+    )
+
+    lmods = _compile_modifiers(left, 'left')
+    rmods = _compile_modifiers(right, 'right')
+
+    body = settings + maps + combos + lmods + rmods
+    size = HEADER_SIZE + len(body)
+    header = struct.pack('<IBBHHBBBBxx16s', MAGIC, VERSION, HEADER_SIZE, size, 0,
+                         map_count, len(combo_list), len(lmods) // 6, len(rmods) // 6,
+                         name.ljust(NAME_LEN, b'\0'))
+    blob = bytearray(header + body)
+    struct.pack_into('<H', blob, 8, crc16_ccitt(bytes(blob)))
+    return bytes(blob)
+
+
+def crc16_ccitt(data: bytes) -> int:
+    """CRC-16-CCITT (poly 0x1021, init 0xFFFF) over data with the crc field zeroed"""
+    crc = 0xFFFF
+    for i, byte in enumerate(data):
+        if i in (8, 9):
+            byte = 0
+        crc ^= byte << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x1021) if crc & 0x8000 else crc << 1
+            crc &= 0xFFFF
+    return crc
+
+
+# ============================================================================
+# Decoder (mirrors the firmware loader - for tests and --dump)
+# ============================================================================
+
+def _names(mask: int) -> list:
+    return [name for name, bit in BUTTONS.items() if mask & (1 << bit)]
+
+
+def decode_blob(blob: bytes) -> dict:
+    if len(blob) < HEADER_SIZE + SETTINGS_SIZE:
+        raise ProfileError('blob too short')
+    (magic, version, header_size, size, crc, n_maps, n_combos, n_lmods, n_rmods,
+     name) = struct.unpack_from('<IBBHHBBBBxx16s', blob, 0)
+    if magic != MAGIC or version != VERSION or header_size != HEADER_SIZE:
+        raise ProfileError('not a version 1 profile blob')
+    if size != len(blob):
+        raise ProfileError('size mismatch')
+    if crc != crc16_ccitt(blob):
+        raise ProfileError('crc mismatch')
+
+    s = struct.unpack_from('<BBBBBBBBBB', blob, HEADER_SIZE)
+    out = {
+        'name': name.rstrip(b'\0').decode('utf-8', 'replace'),
+        'triggers': {
+            'l2': {'behavior': TRIGGER_BEHAVIORS[s[0]], 'threshold': s[2], 'value': s[4]},
+            'r2': {'behavior': TRIGGER_BEHAVIORS[s[1]], 'threshold': s[3], 'value': s[5]},
+        },
+        'sticks': {'left': {'sensitivity': s[6], 'modifiers': []},
+                   'right': {'sensitivity': s[7], 'modifiers': []}},
+        'socd': SOCD_MODES[s[8]],
+        'adaptive_triggers': bool(s[9] & FLAG_ADAPTIVE_TRIGGERS),
+        'map': [],
+        'combos': [],
+    }
+
+    pos = HEADER_SIZE + SETTINGS_SIZE
+    for _ in range(n_maps):
+        inp, outp, analog, value = struct.unpack_from('<IIBB', blob, pos)
+        out['map'].append({'input': _names(inp), 'buttons': _names(outp),
+                           'analog': ANALOG_TARGETS[analog], 'value': value})
+        pos += 10
+    for _ in range(n_combos):
+        inputs, outp, flags = struct.unpack_from('<IIB', blob, pos)
+        out['combos'].append({'inputs': _names(inputs), 'output': _names(outp),
+                              'consume': bool(flags & COMBO_CONSUME),
+                              'exclusive': bool(flags & COMBO_EXCLUSIVE)})
+        pos += 9
+    for side, count in (('left', n_lmods), ('right', n_rmods)):
+        for _ in range(count):
+            trigger, sens, flags = struct.unpack_from('<IBB', blob, pos)
+            out['sticks'][side]['modifiers'].append(
+                {'trigger': _names(trigger), 'sensitivity': sens,
+                 'consume': bool(flags & MOD_CONSUME)})
+            pos += 6
+    return out
+
+
+# ============================================================================
+# Main
+# ============================================================================
+
+def main():
+    parser = argparse.ArgumentParser(description='Compile a JSON profile to a binary blob')
+    parser.add_argument('input', help='profile description (.json)')
+    parser.add_argument('-o', '--output', help='write blob to file')
+    parser.add_argument('--dump', action='store_true', help='print decoded blob')
+    parser.add_argument('--upload', metavar='PORT', help='upload and activate over CDC')
+    args = parser.parse_args()
+
+    try:
+        with open(args.input) as f:
+            blob = compile_profile(json.load(f))
+    except (OSError, json.JSONDecodeError, ProfileError, KeyError) as e:
+        print(f"Error: {e}")
+        sys.exit(1)
+
+    print(f"Compiled {args.input}: {len(blob)} bytes")
+
+    if args.output:
+        with open(args.output, 'wb') as f:
+            f.write(blob)
+    if args.dump:
+        print(json.dumps(decode_blob(blob), indent=2))
+    if args.upload:
+        from cdc_bulk import BulkClient, BulkError, TARGET_PROFILE_BLOB
+        client = BulkClient(args.upload)
+        try:
+            client.upload(TARGET_PROFILE_BLOB, blob)
+            client.command('BULK.COMMIT')
+            print("Profile activated")
+        except BulkError as e:
+            print(f"Error: {e}")
+            sys.exit(1)
+        finally:
+            client.close()
+
+
+if __name__ == '__main__':
+    main()
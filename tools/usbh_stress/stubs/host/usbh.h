@@ -0,0 +1,34 @@
+// host/usbh.h - TinyUSB raw endpoint API for the USB host stress harness
+#ifndef USBH_STRESS_HOST_USBH_H
+#define USBH_STRESS_HOST_USBH_H
+
+#include "tusb.h"
+
+typedef enum {
+  XFER_RESULT_SUCCESS = 0,
+  XFER_RESULT_FAILED,
+  XFER_RESULT_STALLED,
+  XFER_RESULT_TIMEOUT,
+} xfer_result_t;
+
+typedef struct tuh_xfer_s tuh_xfer_t;
+typedef void (*tuh_xfer_cb_t)(tuh_xfer_t* xfer);
+
+struct tuh_xfer_s {
+  uint8_t daddr;
+  uint8_t ep_addr;
+  xfer_result_t result;
+  uint32_t actual_len;
+  void const* setup;
+  uint8_t* buffer;
+  uint32_t buflen;
+  tuh_xfer_cb_t complete_cb;
+  uintptr_t user_data;
+};
+
+bool tuh_edpt_open(uint8_t daddr, tusb_desc_endpoint_t const* desc_ep);
+bool tuh_edpt_xfer(tuh_xfer_t* xfer);
+bool tuh_descriptor_get_configuration(uint8_t daddr, uint8_t index, void* buffer, uint16_t len,
+                                      tuh_xfer_cb_t complete_cb, uintptr_t user_data);
+
+#endif // USBH_STRESS_HOST_USBH_H
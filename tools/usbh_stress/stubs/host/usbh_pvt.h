@@ -0,0 +1,7 @@
+// host/usbh_pvt.h - TinyUSB host internals (nothing the drivers use here)
+#ifndef USBH_STRESS_HOST_USBH_PVT_H
+#define USBH_STRESS_HOST_USBH_PVT_H
+
+#include "host/usbh.h"
+
+#endif // USBH_STRESS_HOST_USBH_PVT_H
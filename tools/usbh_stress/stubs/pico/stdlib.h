@@ -0,0 +1,13 @@
+// pico/stdlib.h - pico-sdk basics for the USB host stress harness
+#ifndef USBH_STRESS_PICO_STDLIB_H
+#define USBH_STRESS_PICO_STDLIB_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "pico/time.h"
+
+#define __not_in_flash_func(x) x
+#define __no_inline_not_in_flash_func(x) x
+#define __time_critical_func(x) x
+
+#endif // USBH_STRESS_PICO_STDLIB_H
@@ -0,0 +1,24 @@
+// pico/time.h - Virtual clock for the USB host stress harness
+//
+// The harness drives time; sleeps advance it instead of waiting.
+#ifndef USBH_STRESS_PICO_TIME_H
+#define USBH_STRESS_PICO_TIME_H
+
+#include <stdint.h>
+
+typedef uint64_t absolute_time_t;
+
+uint64_t time_us_64(void);
+void sleep_us(uint64_t us);
+
+static inline uint32_t time_us_32(void) { return (uint32_t)time_us_64(); }
+static inline absolute_time_t get_absolute_time(void) { return time_us_64(); }
+static inline uint32_t to_ms_since_boot(absolute_time_t t) { return (uint32_t)(t / 1000); }
+static inline uint64_t to_us_since_boot(absolute_time_t t) { return t; }
+static inline int64_t absolute_time_diff_us(absolute_time_t from, absolute_time_t to) { return (int64_t)(to - from); }
+static inline absolute_time_t make_timeout_time_ms(uint32_t ms) { return time_us_64() + ms * 1000ull; }
+static inline void sleep_ms(uint32_t ms) { sleep_us(ms * 1000ull); }
+static inline void busy_wait_us(uint64_t us) { sleep_us(us); }
+static inline void busy_wait_ms(uint32_t ms) { sleep_us(ms * 1000ull); }
+
+#endif // USBH_STRESS_PICO_TIME_H
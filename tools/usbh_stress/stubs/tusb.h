@@ -0,0 +1,328 @@
+// tusb.h - TinyUSB host surface for the USB host stress harness
+//
+// Only what the HID host drivers use: descriptor layouts, HID class
+// constants and the tuh_* calls usbh_stress.c implements against its
+// simulated host controller. Values match TinyUSB's.
+
+#ifndef USBH_STRESS_TUSB_H
+#define USBH_STRESS_TUSB_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+
+// ============================================================================
+// CONFIG (src/tusb_config.h, host side)
+// ============================================================================
+
+#define CFG_TUH_HUB                 1
+#define CFG_TUH_HID                 8
+#define CFG_TUH_XINPUT              4
+#define CFG_TUH_DEVICE_MAX          (4*CFG_TUH_HUB + 1)
+#define CFG_TUH_ENUMERATION_BUFSIZE 1280
+#define CFG_TUH_HID_EPIN_BUFSIZE    64
+#define CFG_TUH_HID_EPOUT_BUFSIZE   64
+#define CFG_TUH_MEM_ALIGN           __attribute__ ((aligned(4)))
+#define CFG_TUD_CDC                 0
+
+#define TU_ATTR_PACKED              __attribute__ ((packed))
+#define TU_ARRAY_SIZE(_arr)         (sizeof(_arr) / sizeof(_arr[0]))
+#define TU_LOG1(...)                do { } while (0)
+#define tu_le16toh(_x)              (_x)
+
+// ============================================================================
+// DESCRIPTORS
+// ============================================================================
+
+typedef enum {
+  TUSB_DIR_OUT = 0,
+  TUSB_DIR_IN  = 1,
+} tusb_dir_t;
+
+typedef enum {
+  TUSB_XFER_CONTROL = 0,
+  TUSB_XFER_ISOCHRONOUS,
+  TUSB_XFER_BULK,
+  TUSB_XFER_INTERRUPT,
+} tusb_xfer_type_t;
+
+enum {
+  TUSB_DESC_DEVICE        = 0x01,
+  TUSB_DESC_CONFIGURATION = 0x02,
+  TUSB_DESC_INTERFACE     = 0x04,
+  TUSB_DESC_ENDPOINT      = 0x05,
+};
+
+typedef struct TU_ATTR_PACKED {
+  uint8_t  bLength;
+  uint8_t  bDescriptorType;
+  uint16_t bcdUSB;
+  uint8_t  bDeviceClass;
+  uint8_t  bDeviceSubClass;
+  uint8_t  bDeviceProtocol;
+  uint8_t  bMaxPacketSize0;
+  uint16_t idVendor;
+  uint16_t idProduct;
+  uint16_t bcdDevice;
+  uint8_t  iManufacturer;
+  uint8_t  iProduct;
+  uint8_t  iSerialNumber;
+  uint8_t  bNumConfigurations;
+} tusb_desc_device_t;
+
+typedef struct TU_ATTR_PACKED {
+  uint8_t  bLength;
+  uint8_t  bDescriptorType;
+  uint16_t wTotalLength;
+  uint8_t  bNumInterfaces;
+  uint8_t  bConfigurationValue;
+  uint8_t  iConfiguration;
+  uint8_t  bmAttributes;
+  uint8_t  bMaxPower;
+} tusb_desc_configuration_t;
+
+typedef struct TU_ATTR_PACKED {
+  uint8_t bLength;
+  uint8_t bDescriptorType;
+  uint8_t bInterfaceNumber;
+  uint8_t bAlternateSetting;
+  uint8_t bNumEndpoints;
+  uint8_t bInterfaceClass;
+  uint8_t bInterfaceSubClass;
+  uint8_t bInterfaceProtocol;
+  uint8_t iInterface;
+} tusb_desc_interface_t;
+
+typedef struct TU_ATTR_PACKED {
+  uint8_t bLength;
+  uint8_t bDescriptorType;
+  uint8_t bEndpointAddress;
+  struct TU_ATTR_PACKED {
+    uint8_t xfer  : 2;
+    uint8_t sync  : 2;
+    uint8_t usage : 2;
+    uint8_t       : 2;
+  } bmAttributes;
+  uint16_t wMaxPacketSize;
+  uint8_t  bInterval;
+} tusb_desc_endpoint_t;
+
+static inline uint8_t tu_desc_len(void const* desc) { return ((uint8_t const*)desc)[0]; }
+static inline uint8_t tu_desc_type(void const* desc) { return ((uint8_t const*)desc)[1]; }
+static inline uint8_t const* tu_desc_next(void const* desc) { return (uint8_t const*)desc + tu_desc_len(desc); }
+static inline tusb_dir_t tu_edpt_dir(uint8_t addr) { return (addr & 0x80) ? TUSB_DIR_IN : TUSB_DIR_OUT; }
+
+// ============================================================================
+// HID CLASS
+// ============================================================================
+
+typedef enum {
+  HID_ITF_PROTOCOL_NONE     = 0,
+  HID_ITF_PROTOCOL_KEYBOARD = 1,
+  HID_ITF_PROTOCOL_MOUSE    = 2,
+} hid_interface_protocol_enum_t;
+
+typedef enum {
+  HID_REPORT_TYPE_INVALID = 0,
+  HID_REPORT_TYPE_INPUT,
+  HID_REPORT_TYPE_OUTPUT,
+  HID_REPORT_TYPE_FEATURE,
+} hid_report_type_t;
+
+enum {
+  HID_USAGE_PAGE_DESKTOP  = 0x01,
+  HID_USAGE_PAGE_KEYBOARD = 0x07,
+  HID_USAGE_PAGE_BUTTON   = 0x09,
+};
+
+enum {
+  HID_USAGE_DESKTOP_MOUSE        = 0x02,
+  HID_USAGE_DESKTOP_JOYSTICK     = 0x04,
+  HID_USAGE_DESKTOP_GAMEPAD      = 0x05,
+  HID_USAGE_DESKTOP_KEYBOARD     = 0x06,
+  HID_USAGE_DESKTOP_X            = 0x30,
+  HID_USAGE_DESKTOP_Y            = 0x31,
+  HID_USAGE_DESKTOP_Z            = 0x32,
+  HID_USAGE_DESKTOP_RX           = 0x33,
+  HID_USAGE_DESKTOP_RY           = 0x34,
+  HID_USAGE_DESKTOP_RZ           = 0x35,
+  HID_USAGE_DESKTOP_WHEEL        = 0x38,
+  HID_USAGE_DESKTOP_HAT_SWITCH   = 0x39,
+  HID_USAGE_DESKTOP_DPAD_UP      = 0x90,
+  HID_USAGE_DESKTOP_DPAD_DOWN    = 0x91,
+  HID_USAGE_DESKTOP_DPAD_RIGHT   = 0x92,
+  HID_USAGE_DESKTOP_DPAD_LEFT    = 0x93,
+};
+
+typedef struct TU_ATTR_PACKED {
+  uint8_t modifier;
+  uint8_t reserved;
+  uint8_t keycode[6];
+} hid_keyboard_report_t;
+
+typedef struct TU_ATTR_PACKED {
+  uint8_t buttons;
+  int8_t  x;
+  int8_t  y;
+  int8_t  wheel;
+  int8_t  pan;
+} hid_mouse_report_t;
+
+typedef enum {
+  KEYBOARD_MODIFIER_LEFTCTRL   = 1 << 0,
+  KEYBOARD_MODIFIER_LEFTSHIFT  = 1 << 1,
+  KEYBOARD_MODIFIER_LEFTALT    = 1 << 2,
+  KEYBOARD_MODIFIER_LEFTGUI    = 1 << 3,
+  KEYBOARD_MODIFIER_RIGHTCTRL  = 1 << 4,
+  KEYBOARD_MODIFIER_RIGHTSHIFT = 1 << 5,
+  KEYBOARD_MODIFIER_RIGHTALT   = 1 << 6,
+  KEYBOARD_MODIFIER_RIGHTGUI   = 1 << 7,
+} hid_keyboard_modifier_bm_t;
+
+typedef enum {
+  KEYBOARD_LED_NUMLOCK    = 1 << 0,
+  KEYBOARD_LED_CAPSLOCK   = 1 << 1,
+  KEYBOARD_LED_SCROLLLOCK = 1 << 2,
+} hid_keyboard_led_bm_t;
+
+typedef enum {
+  MOUSE_BUTTON_LEFT     = 1 << 0,
+  MOUSE_BUTTON_RIGHT    = 1 << 1,
+  MOUSE_BUTTON_MIDDLE   = 1 << 2,
+  MOUSE_BUTTON_BACKWARD = 1 << 3,
+  MOUSE_BUTTON_FORWARD  = 1 << 4,
+} hid_mouse_button_bm_t;
+
+// Keyboard usages (HID usage page 0x07)
+#define HID_KEY_NONE          0x00
+#define HID_KEY_A             0x04
+#define HID_KEY_B             0x05
+#define HID_KEY_C             0x06
+#define HID_KEY_D             0x07
+#define HID_KEY_E             0x08
+#define HID_KEY_F             0x09
+#define HID_KEY_G             0x0A
+#define HID_KEY_H             0x0B
+#define HID_KEY_I             0x0C
+#define HID_KEY_J             0x0D
+#define HID_KEY_K             0x0E
+#define HID_KEY_L             0x0F
+#define HID_KEY_M             0x10
+#define HID_KEY_N             0x11
+#define HID_KEY_O             0x12
+#define HID_KEY_P             0x13
+#define HID_KEY_Q             0x14
+#define HID_KEY_R             0x15
+#define HID_KEY_S             0x16
+#define HID_KEY_T             0x17
+#define HID_KEY_U             0x18
+#define HID_KEY_V             0x19
+#define HID_KEY_W             0x1A
+#define HID_KEY_X             0x1B
+#define HID_KEY_Y             0x1C
+#define HID_KEY_Z             0x1D
+#define HID_KEY_1             0x1E
+#define HID_KEY_2             0x1F
+#define HID_KEY_3             0x20
+#define HID_KEY_4             0x21
+#define HID_KEY_5             0x22
+#define HID_KEY_6             0x23
+#define HID_KEY_7             0x24
+#define HID_KEY_8             0x25
+#define HID_KEY_9             0x26
+#define HID_KEY_0             0x27
+#define HID_KEY_ENTER         0x28
+#define HID_KEY_ESCAPE        0x29
+#define HID_KEY_BACKSPACE     0x2A
+#define HID_KEY_TAB           0x2B
+#define HID_KEY_SPACE         0x2C
+#define HID_KEY_MINUS         0x2D
+#define HID_KEY_EQUAL         0x2E
+#define HID_KEY_BRACKET_LEFT  0x2F
+#define HID_KEY_BRACKET_RIGHT 0x30
+#define HID_KEY_BACKSLASH     0x31
+#define HID_KEY_SEMICOLON     0x33
+#define HID_KEY_APOSTROPHE    0x34
+#define HID_KEY_GRAVE         0x35
+#define HID_KEY_COMMA         0x36
+#define HID_KEY_PERIOD        0x37
+#define HID_KEY_SLASH         0x38
+#define HID_KEY_CAPS_LOCK     0x39
+#define HID_KEY_F1            0x3A
+#define HID_KEY_F2            0x3B
+#define HID_KEY_F3            0x3C
+#define HID_KEY_F4            0x3D
+#define HID_KEY_F5            0x3E
+#define HID_KEY_F6            0x3F
+#define HID_KEY_F7            0x40
+#define HID_KEY_F8            0x41
+#define HID_KEY_F9            0x42
+#define HID_KEY_F10           0x43
+#define HID_KEY_F11           0x44
+#define HID_KEY_F12           0x45
+#define HID_KEY_PRINT_SCREEN  0x46
+#define HID_KEY_SCROLL_LOCK   0x47
+#define HID_KEY_PAUSE         0x48
+#define HID_KEY_INSERT        0x49
+#define HID_KEY_HOME          0x4A
+#define HID_KEY_PAGE_UP       0x4B
+#define HID_KEY_DELETE        0x4C
+#define HID_KEY_END           0x4D
+#define HID_KEY_PAGE_DOWN     0x4E
+#define HID_KEY_ARROW_RIGHT   0x4F
+#define HID_KEY_ARROW_LEFT    0x50
+#define HID_KEY_ARROW_DOWN    0x51
+#define HID_KEY_ARROW_UP      0x52
+#define HID_KEY_CONTROL_LEFT  0xE0
+#define HID_KEY_SHIFT_LEFT    0xE1
+#define HID_KEY_ALT_LEFT      0xE2
+#define HID_KEY_GUI_LEFT      0xE3
+#define HID_KEY_CONTROL_RIGHT 0xE4
+#define HID_KEY_SHIFT_RIGHT   0xE5
+#define HID_KEY_ALT_RIGHT     0xE6
+#define HID_KEY_GUI_RIGHT     0xE7
+
+// The keyboard driver only prints with this table; empty keeps it linkable
+#define HID_KEYCODE_TO_ASCII  {0}
+
+// ============================================================================
+// HOST API (implemented by usbh_stress.c)
+// ============================================================================
+
+typedef struct {
+  uint8_t  report_id;
+  uint8_t  usage;
+  uint16_t usage_page;
+} tuh_hid_report_info_t;
+
+typedef struct {
+  uint8_t daddr;
+  uint8_t itf_num;
+  uint8_t ep_in;
+  uint8_t ep_out;
+  tusb_desc_interface_t desc;
+} tuh_itf_info_t;
+
+bool tuh_mounted(uint8_t daddr);
+bool tuh_vid_pid_get(uint8_t daddr, uint16_t* vid, uint16_t* pid);
+
+uint8_t tuh_hid_interface_protocol(uint8_t dev_addr, uint8_t idx);
+bool tuh_hid_itf_get_info(uint8_t daddr, uint8_t idx, tuh_itf_info_t* itf_info);
+uint8_t tuh_hid_parse_report_descriptor(tuh_hid_report_info_t* report_info_arr, uint8_t arr_count,
+                                        uint8_t const* desc_report, uint16_t desc_len);
+bool tuh_hid_receive_report(uint8_t dev_addr, uint8_t idx);
+bool tuh_hid_send_ready(uint8_t dev_addr, uint8_t idx);
+bool tuh_hid_send_report(uint8_t dev_addr, uint8_t idx, uint8_t report_id, void const* report, uint16_t len);
+bool tuh_hid_set_report(uint8_t dev_addr, uint8_t idx, uint8_t report_id, uint8_t report_type,
+                        void* report, uint16_t len);
+bool tuh_hid_get_report(uint8_t dev_addr, uint8_t idx, uint8_t report_id, uint8_t report_type,
+                        void* report, uint16_t len);
+
+// Application callbacks (hid.c, drivers)
+void tuh_hid_mount_cb(uint8_t dev_addr, uint8_t idx, uint8_t const* report_desc, uint16_t desc_len);
+void tuh_hid_umount_cb(uint8_t dev_addr, uint8_t idx);
+void tuh_hid_report_received_cb(uint8_t dev_addr, uint8_t idx, uint8_t const* report, uint16_t len);
+
+#endif // USBH_STRESS_TUSB_H
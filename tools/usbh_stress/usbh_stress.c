@@ -0,0 +1,1149 @@
+// usbh_stress.c - Multi-controller stress harness for the USB host HID path
+//
+// Links the firmware's HID host code unmodified (hid.c, the device registry,
+// every vendor driver, the generic gamepad/keyboard/mouse drivers, the
+// polling-interval overrides, the feedback scheduler, router, player manager
+// and metrics) against a simulated host controller that stands in for
+// TinyUSB. Virtual devices are mounted through tuh_hid_mount_cb() with their
+// report descriptors, then stream input reports at their own rate; the
+// controller polls each interrupt IN endpoint on its bInterval (after the
+// override table had its say), one report per poll, only while the driver
+// has re-armed it with tuh_hid_receive_report().
+//
+// Time is virtual and moves in 1ms USB frames. The main loop runs once per
+// frame: completed transfers are dispatched to tuh_hid_report_received_cb(),
+// then hid_task() runs. A driver that sleeps advances the clock while the
+// frames keep going, exactly like a blocked loop on the device. Each callback
+// and hid_task() pass is timed on the host CPU, which gives relative per-report
+// costs, not RP2040 cycle counts.
+//
+// Reported per device:
+//   gen      reports the device produced
+//   dlv      reports handed to the driver
+//   lost     reports overwritten on the device before the host polled them
+//            (endpoint not re-armed in time, loop stalled, or device faster
+//            than the poll interval)
+//   ns/rpt   host time spent in tuh_hid_report_received_cb()
+//   out      output reports sent; busy = sends refused with the OUT pipe busy
+//   events   input events the router delivered for the device
+//   ready    ms from mount until the pad works: its first report reached the
+//            driver, or for pads with an init handshake, the driver lit its
+//            player LEDs (the last init step)
+//
+// Device streams are synthetic models of the real pads (sticks walk, buttons
+// are held for a few reports, IMU bytes and counters change every report) or
+// are replayed from a capture file:
+//
+//   # comment
+//   device <name> <vid>:<pid> [protocol] [interval_ms] [report_us]
+//   desc <hex bytes>        report descriptor (repeatable, appended)
+//   report <hex bytes>      input report (repeatable, replayed in a loop)
+//
+// Switch Pro and Switch 2 Pro model their USB init: the Switch Pro acks the
+// handshake and stays silent until full report mode; the Switch 2 Pro only
+// streams after its HID init command arrives on the bulk OUT endpoint of
+// interface 1, which the driver finds by fetching the config descriptor over
+// the control pipe. Bulk and control transfers complete in later frames, so
+// several pads on a hub run their init side by side through the real drivers.
+//
+// captures/ has an example. The firmware's limits apply: CFG_TUH_DEVICE_MAX
+// devices, five player slots.
+//
+// Build (bash) and run from the repo root:
+//   gcc -O2 -DCONFIG_USB_HOST '-D__not_in_flash_func(x)=x'
+//       -Itools/usbh_stress/stubs -Itools -Isrc -Isrc/apps/usb2usb
+//       -Isrc/usb/usbh/hid/devices/generic -o /tmp/usbh_stress
+//       tools/usbh_stress/usbh_stress.c src/usb/usbh/usbh_interval.c
+//       src/usb/usbh/usbh_feedback.c src/usb/usbh/hid/hid*.c
+//       src/usb/usbh/hid/devices/generic/*.c
+//       src/usb/usbh/hid/devices/vendors/{8bitdo/8bitdo_{bta,m30,pce},nintendo/*,sony/*,hori/*,logitech/*,sega/*,google/*,raphnet/*}.c
+//       src/core/router/router.c src/core/services/players/{manager,feedback}.c
+//       src/core/services/metrics/metrics.c
+//   /tmp/usbh_stress [-d devices] [-m model,...] [-t seconds] [-r rate%]
+//                    [-s every_ms:stall_ms] [-c churn_ms] [-f feedback_ms] [-v] [capture...]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <time.h>
+#include <unistd.h>
+#include "pico/time.h"
+#include "tusb.h"
+#include "host/usbh.h"
+#include "core/output_interface.h"
+#include "core/router/router.h"
+#include "core/services/players/manager.h"
+#include "core/services/players/feedback.h"
+#include "core/services/metrics/metrics.h"
+#include "hid_descriptors.h"
+
+// hid.c entry points (called from the app main loop on the device)
+void hid_init(void);
+void hid_task(void);
+
+// usbh_interval.c enumeration hooks (TinyUSB calls these during enumeration)
+bool tuh_enum_descriptor_device_cb(uint8_t daddr, tusb_desc_device_t const* desc_device);
+bool tuh_enum_descriptor_configuration_cb(uint8_t daddr, uint8_t cfg_index,
+                                          tusb_desc_configuration_t const* desc_config);
+
+// Completion callbacks owned by the DS3/DS4 drivers
+void tuh_hid_get_report_complete_cb(uint8_t dev_addr, uint8_t idx, uint8_t report_id,
+                                    uint8_t report_type, uint16_t len);
+void tuh_hid_set_report_complete_cb(uint8_t dev_addr, uint8_t idx, uint8_t report_id,
+                                    uint8_t report_type, uint16_t len);
+
+#define FRAME_US        1000
+#define MAX_VDEVS       CFG_TUH_DEVICE_MAX   // Device addresses 1..CFG_TUH_DEVICE_MAX
+#define REPORT_MAX      CFG_TUH_HID_EPIN_BUFSIZE
+#define REPLY_MAX       4
+#define OUT_BUSY_US     FRAME_US             // OUT pipe held for one frame per send
+#define CTRL_BUSY_US    (2 * FRAME_US)       // SET/GET_REPORT data + status stages
+#define BULK_BUSY_US    FRAME_US             // Bulk OUT command acked next frame
+#define CONFIG_MAX      64
+#define FIELD_MAX       12
+#define CAPTURE_MAX     8
+#define CAPTURE_REPORTS 4096
+#define DESC_MAX        512
+#define REPLUG_US       (50 * FRAME_US)      // Unplugged time plus enumeration
+
+// ============================================================================
+// DEVICE MODELS
+// ============================================================================
+
+typedef enum {
+  FIELD_NONE,      // End of list
+  FIELD_STICK,     // Random walk around center
+  FIELD_TRIGGER,   // Ramps up and down
+  FIELD_BUTTONS,   // Random bits under mask, held for a few reports
+  FIELD_COUNTER,   // +1 per report under mask
+  FIELD_NOISE,     // Random every report (IMU, timestamps)
+  FIELD_KEY,       // Keyboard usage slot, held for a few reports
+  FIELD_DELTA,     // Small signed relative motion
+} field_kind_t;
+
+typedef struct {
+  uint8_t offset;
+  field_kind_t kind;
+  uint8_t mask;
+} field_t;
+
+typedef struct vdev_s vdev_t;
+
+typedef struct {
+  const char* name;
+  uint16_t vid;
+  uint16_t pid;
+  uint8_t protocol;        // HID_ITF_PROTOCOL_*
+  uint8_t interval_ms;     // bInterval the device advertises
+  uint16_t report_us;      // How often the device has new data
+  const uint8_t* desc;
+  uint16_t desc_len;
+  const uint8_t* idle;     // Report with nothing held
+  uint8_t len;
+  field_t fields[FIELD_MAX];
+  bool needs_init;         // Silent until the driver finishes its handshake
+  void (*respond)(vdev_t* dev, uint8_t report_id, const uint8_t* data, uint16_t len);
+  void (*bulk)(vdev_t* dev, const uint8_t* data, uint16_t len);  // Bulk OUT on interface 1
+
+  // Capture replay
+  const uint8_t (*reports)[REPORT_MAX];
+  const uint8_t* report_lens;
+  uint16_t report_count;
+} profile_t;
+
+struct vdev_s {
+  const profile_t* profile;
+  uint8_t dev_addr;
+  bool mounted;
+  bool streaming;
+  uint64_t replug_us;        // Unplugged, enumerates again at this time (0 = no)
+  uint8_t poll_ms;           // bInterval after usbh_interval.c
+  uint32_t report_us;
+
+  // Device side
+  uint64_t next_report_us;
+  uint8_t state[REPORT_MAX];
+  uint16_t seq;
+  bool pending;
+  uint8_t pending_buf[REPORT_MAX];
+  uint8_t pending_len;
+  uint8_t reply_count;
+  uint8_t replies[REPLY_MAX][REPORT_MAX];
+  uint8_t reply_lens[REPLY_MAX];
+
+  // Host controller side
+  bool armed;
+  bool complete;             // Waiting for tuh_task() to run the callback
+  uint8_t xfer_buf[REPORT_MAX];
+  uint8_t xfer_len;
+  uint64_t out_busy_until;
+  uint64_t ctrl_busy_until;
+  bool ctrl_pending;
+  bool ctrl_done;            // Waiting for tuh_task() to run the callback
+  bool ctrl_is_get;
+  uint8_t ctrl_report_id;
+  uint8_t ctrl_report_type;
+  uint16_t ctrl_len;
+  bool ctrl_is_desc;         // GET_DESCRIPTOR(configuration) into ctrl_xfer
+  tuh_xfer_t ctrl_xfer;
+  bool bulk_pending;
+  bool bulk_done;            // Waiting for tuh_task() to run the callback
+  uint64_t bulk_busy_until;
+  tuh_xfer_t bulk_xfer;
+
+  // Stats
+  uint32_t generated;
+  uint32_t delivered;
+  uint32_t lost;
+  uint32_t rearm_busy;
+  uint32_t sends;
+  uint32_t send_busy;
+  uint32_t controls;
+  uint32_t events;
+  uint64_t cb_ns;
+  uint64_t mount_us;
+  uint64_t ready_us;         // 0 = not ready yet
+};
+
+// Switch Pro over USB: handshake ack, then silent until full report mode
+static void switch_pro_respond(vdev_t* dev, uint8_t report_id, const uint8_t* data, uint16_t len)
+{
+  (void)report_id;
+  if (dev->reply_count >= REPLY_MAX || len < 2) return;
+
+  uint8_t* reply = dev->replies[dev->reply_count];
+  memset(reply, 0, REPORT_MAX);
+  if (data[0] == 0x80 && data[1] == 0x02) {           // Handshake
+    reply[0] = 0x81;
+    reply[1] = 0x02;
+    dev->reply_lens[dev->reply_count++] = REPORT_MAX;
+  } else if (data[0] == 0x01 && len > 0x0B) {         // Subcommand
+    reply[0] = 0x21;
+    reply[14] = data[0x0A];
+    dev->reply_lens[dev->reply_count++] = REPORT_MAX;
+    if (data[0x0A] == 0x03 && data[0x0B] == 0x30) dev->streaming = true;
+    if (data[0x0A] == 0x30 && !dev->ready_us) dev->ready_us = time_us_64();  // Player LEDs
+  }
+}
+
+// Switch 2 Pro over USB: HID reports start with the init command, the player
+// LED command carries a non-zero pattern once the driver picked a player
+static void switch2_bulk(vdev_t* dev, const uint8_t* data, uint16_t len)
+{
+  if (len < 9) return;
+  if (data[0] == 0x03) dev->streaming = true;
+  if (data[0] == 0x09 && data[8] && !dev->ready_us) dev->ready_us = time_us_64();
+}
+
+static const uint8_t idle_ds4[64] = {
+  0x01, 0x80, 0x80, 0x80, 0x80, 0x08, 0x00, 0x00, 0x00, 0x00,
+};
+static const uint8_t idle_ds5[64] = {
+  0x01, 0x80, 0x80, 0x80, 0x80, 0x00, 0x00, 0x00, 0x08, 0x00, 0x00,
+};
+static const uint8_t idle_switch_pro[64] = {
+  0x30, 0x00, 0x91, 0x00, 0x00, 0x00, 0x00, 0x08, 0x80, 0x00, 0x08, 0x80,
+};
+static const uint8_t idle_switch2_pro[64] = {
+  0x09, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x08, 0x80, 0x00, 0x08, 0x80,
+};
+static const uint8_t idle_gc_adapter[37] = {
+  0x21,
+  0x10, 0x00, 0x00, 0x80, 0x80, 0x80, 0x80, 0x00, 0x00,
+  0x10, 0x00, 0x00, 0x80, 0x80, 0x80, 0x80, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x80, 0x80, 0x80, 0x80, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x80, 0x80, 0x80, 0x80, 0x00, 0x00,
+};
+static const uint8_t idle_dragonrise[8] = { 0x80, 0x80, 0x80, 0x80, 0x80, 0x0F, 0x00, 0x00 };
+static const uint8_t idle_keyboard[8] = { 0 };
+static const uint8_t idle_mouse[4] = { 0 };
+
+#define ST(o)      {o, FIELD_STICK, 0xFF}
+#define TR(o)      {o, FIELD_TRIGGER, 0xFF}
+#define BT(o, m)   {o, FIELD_BUTTONS, m}
+#define CT(o, m)   {o, FIELD_COUNTER, m}
+#define NZ(o)      {o, FIELD_NOISE, 0xFF}
+
+static const profile_t builtin_profiles[] = {
+  {
+    .name = "DualShock 4", .vid = 0x054c, .pid = 0x05c4,
+    .protocol = HID_ITF_PROTOCOL_NONE, .interval_ms = 5, .report_us = 1000,
+    .desc = desc_ds4, .desc_len = sizeof(desc_ds4),
+    .idle = idle_ds4, .len = sizeof(idle_ds4),
+    .fields = { ST(1), ST(2), ST(3), ST(4), BT(5, 0xF0), BT(6, 0xFF), CT(7, 0xFC), TR(8), TR(9),
+                NZ(10), NZ(13), NZ(19) },
+  },
+  {
+    .name = "DualSense", .vid = 0x054c, .pid = 0x0ce6,
+    .protocol = HID_ITF_PROTOCOL_NONE, .interval_ms = 4, .report_us = 1000,
+    .idle = idle_ds5, .len = sizeof(idle_ds5),
+    .fields = { ST(1), ST(2), ST(3), ST(4), TR(5), TR(6), CT(7, 0xFF), BT(8, 0xF0), BT(9, 0xFF),
+                NZ(12), NZ(16), NZ(22) },
+  },
+  {
+    .name = "Switch Pro", .vid = 0x057e, .pid = 0x2009,
+    .protocol = HID_ITF_PROTOCOL_NONE, .interval_ms = 8, .report_us = 8000,
+    .idle = idle_switch_pro, .len = sizeof(idle_switch_pro),
+    .fields = { CT(1, 0xFF), BT(3, 0xCF), BT(4, 0x3F), BT(5, 0xCF), ST(7), ST(8), ST(10), ST(11), NZ(13), NZ(19) },
+    .needs_init = true,
+    .respond = switch_pro_respond,
+  },
+  {
+    .name = "Switch2 Pro", .vid = 0x057e, .pid = 0x2069,
+    .protocol = HID_ITF_PROTOCOL_NONE, .interval_ms = 4, .report_us = 4000,
+    .idle = idle_switch2_pro, .len = sizeof(idle_switch2_pro),
+    .fields = { CT(1, 0xFF), BT(3, 0xFF), BT(4, 0xFF), BT(5, 0x1F), ST(6), ST(8), ST(9), ST(11),
+                NZ(12), NZ(18), NZ(24) },
+    .needs_init = true,
+    .bulk = switch2_bulk,
+  },
+  {
+    .name = "GameCube Adapter", .vid = 0x057e, .pid = 0x0337,
+    .protocol = HID_ITF_PROTOCOL_NONE, .interval_ms = 8, .report_us = 1000,
+    .idle = idle_gc_adapter, .len = sizeof(idle_gc_adapter),
+    .fields = { BT(2, 0xFF), BT(3, 0x0F), ST(4), ST(5), ST(6), ST(7), TR(8),
+                BT(11, 0xFF), ST(13), ST(14), TR(17) },
+  },
+  {
+    .name = "DragonRise", .vid = 0x0079, .pid = 0x0006,
+    .protocol = HID_ITF_PROTOCOL_NONE, .interval_ms = 10, .report_us = 10000,
+    .desc = desc_dragonrise, .desc_len = sizeof(desc_dragonrise),
+    .idle = idle_dragonrise, .len = sizeof(idle_dragonrise),
+    .fields = { ST(0), ST(1), ST(3), ST(4), BT(5, 0xF0), BT(6, 0xFF) },
+  },
+  {
+    .name = "Keyboard (boot)", .vid = 0x04d9, .pid = 0x0024,
+    .protocol = HID_ITF_PROTOCOL_KEYBOARD, .interval_ms = 10, .report_us = 10000,
+    .idle = idle_keyboard, .len = sizeof(idle_keyboard),
+    .fields = { BT(0, 0x22), {2, FIELD_KEY, 0}, {3, FIELD_KEY, 0} },
+  },
+  {
+    .name = "Mouse (boot)", .vid = 0x046d, .pid = 0xc077,
+    .protocol = HID_ITF_PROTOCOL_MOUSE, .interval_ms = 8, .report_us = 8000,
+    .idle = idle_mouse, .len = sizeof(idle_mouse),
+    .fields = { BT(0, 0x03), {1, FIELD_DELTA, 0}, {2, FIELD_DELTA, 0}, {3, FIELD_DELTA, 0} },
+  },
+};
+
+#undef ST
+#undef TR
+#undef BT
+#undef CT
+#undef NZ
+
+#define BUILTIN_COUNT (sizeof(builtin_profiles) / sizeof(builtin_profiles[0]))
+
+// ============================================================================
+// CAPTURE FILES
+// ============================================================================
+
+typedef struct {
+  char name[32];
+  uint8_t desc[DESC_MAX];
+  uint8_t reports[CAPTURE_REPORTS][REPORT_MAX];
+  uint8_t report_lens[CAPTURE_REPORTS];
+} capture_t;
+
+static capture_t* captures[CAPTURE_MAX];
+static profile_t capture_profiles[CAPTURE_MAX];
+static int capture_count = 0;
+
+static uint16_t parse_hex(const char* s, uint8_t* out, uint16_t max)
+{
+  uint16_t n = 0;
+  while (*s && n < max) {
+    while (*s == ' ' || *s == '\t' || *s == ',') s++;
+    if (s[0] == '0' && (s[1] == 'x' || s[1] == 'X')) s += 2;
+    char* end;
+    unsigned long v = strtoul(s, &end, 16);
+    if (end == s) break;
+    out[n++] = (uint8_t)v;
+    s = end;
+  }
+  return n;
+}
+
+static bool load_capture(const char* path)
+{
+  FILE* f = fopen(path, "r");
+  if (!f) {
+    perror(path);
+    return false;
+  }
+
+  char line[1024];
+  profile_t* pr = NULL;
+  capture_t* cap = NULL;
+  int lineno = 0;
+
+  while (fgets(line, sizeof(line), f)) {
+    lineno++;
+    char* s = line;
+    while (*s == ' ' || *s == '\t') s++;
+    if (*s == '#' || *s == '\n' || *s == '\0') continue;
+
+    if (strncmp(s, "device", 6) == 0) {
+      if (capture_count >= CAPTURE_MAX) {
+        fprintf(stderr, "%s:%d: too many capture devices\n", path, lineno);
+        break;
+      }
+      cap = calloc(1, sizeof(*cap));
+      pr = &capture_profiles[capture_count];
+      captures[capture_count++] = cap;
+
+      unsigned vid = 0, pid = 0, proto = 0, interval = 8, report_us = 0;
+      if (sscanf(s + 6, "%31s %x:%x %u %u %u", cap->name, &vid, &pid, &proto, &interval, &report_us) < 3) {
+        fprintf(stderr, "%s:%d: expected device <name> <vid>:<pid>\n", path, lineno);
+        fclose(f);
+        return false;
+      }
+      memset(pr, 0, sizeof(*pr));
+      pr->name = cap->name;
+      pr->vid = vid;
+      pr->pid = pid;
+      pr->protocol = proto;
+      pr->interval_ms = interval ? interval : 1;
+      pr->report_us = report_us ? report_us : pr->interval_ms * 1000;
+      pr->desc = cap->desc;
+      pr->reports = (const uint8_t (*)[REPORT_MAX])cap->reports;
+      pr->report_lens = cap->report_lens;
+    } else if (!pr) {
+      fprintf(stderr, "%s:%d: data before any device line\n", path, lineno);
+      fclose(f);
+      return false;
+    } else if (strncmp(s, "desc", 4) == 0) {
+      pr->desc_len += parse_hex(s + 4, cap->desc + pr->desc_len, DESC_MAX - pr->desc_len);
+    } else if (strncmp(s, "report", 6) == 0 && pr->report_count < CAPTURE_REPORTS) {
+      uint16_t n = parse_hex(s + 6, cap->reports[pr->report_count], REPORT_MAX);
+      if (n) cap->report_lens[pr->report_count++] = n;
+    }
+  }
+  fclose(f);
+
+  for (int i = 0; i < capture_count; i++) {
+    if (!capture_profiles[i].report_count) {
+      fprintf(stderr, "%s: device %s has no reports\n", path, capture_profiles[i].name);
+      return false;
+    }
+  }
+  return true;
+}
+
+// ============================================================================
+// SIMULATED HOST CONTROLLER
+// ============================================================================
+
+static vdev_t vdevs[MAX_VDEVS + 1];   // Indexed by device address
+static int vdev_count = 0;
+static uint64_t now_us = 0;
+static uint64_t next_frame_us = 0;
+static uint32_t rng = 0x12345678;
+static bool verbose = false;
+
+static uint32_t rnd(void)
+{
+  rng ^= rng << 13;
+  rng ^= rng >> 17;
+  rng ^= rng << 5;
+  return rng;
+}
+
+static vdev_t* vdev_get(uint8_t dev_addr)
+{
+  if (dev_addr == 0 || dev_addr > MAX_VDEVS) return NULL;
+  vdev_t* dev = &vdevs[dev_addr];
+  return dev->mounted ? dev : NULL;
+}
+
+// Next report from the device's model
+static void device_generate(vdev_t* dev)
+{
+  const profile_t* pr = dev->profile;
+
+  if (pr->report_count) {
+    uint16_t i = dev->seq % pr->report_count;
+    dev->pending_len = pr->report_lens[i];
+    memcpy(dev->pending_buf, pr->reports[i], dev->pending_len);
+    dev->seq++;
+    return;
+  }
+
+  uint8_t* st = dev->state;
+  bool hold_over = (dev->seq % 16) == 0;
+  for (int i = 0; i < FIELD_MAX; i++) {
+    const field_t* fd = &pr->fields[i];
+    if (fd->kind == FIELD_NONE) break;
+    if (fd->offset >= pr->len) continue;
+    uint8_t* b = &st[fd->offset];
+
+    switch (fd->kind) {
+      case FIELD_STICK: {
+        // Held sticks sit still most of the time
+        if (rnd() & 3) break;
+        int v = *b + (int)(rnd() % 7) - 3;
+        *b = v < 0 ? 0 : v > 255 ? 255 : v;
+        break;
+      }
+      case FIELD_TRIGGER: {
+        uint8_t ramp = (uint8_t)(dev->seq >> 3);
+        *b = (dev->seq & 0x800) ? (uint8_t)~ramp : ramp;
+        break;
+      }
+      case FIELD_BUTTONS:
+        if (hold_over) *b = (pr->idle[fd->offset] & ~fd->mask) | (rnd() & rnd() & fd->mask);
+        break;
+      case FIELD_COUNTER:
+        *b = (*b & ~fd->mask) | ((*b + (fd->mask & -fd->mask)) & fd->mask);
+        break;
+      case FIELD_NOISE:
+        *b = rnd();
+        break;
+      case FIELD_KEY:
+        if (hold_over) *b = (rnd() & 3) ? 0 : HID_KEY_A + rnd() % 36;
+        break;
+      case FIELD_DELTA:
+        *b = (uint8_t)((int)(rnd() % 9) - 4);
+        break;
+      case FIELD_NONE:
+        break;
+    }
+  }
+
+  dev->pending_len = pr->len;
+  memcpy(dev->pending_buf, st, pr->len);
+  dev->seq++;
+}
+
+// One USB frame of hardware: devices produce data, armed endpoints get polled
+// and control transfers finish. No firmware code runs here.
+static void hw_frame(uint64_t frame_us)
+{
+  uint32_t frame = (uint32_t)(frame_us / FRAME_US);
+
+  for (uint8_t a = 1; a <= MAX_VDEVS; a++) {
+    vdev_t* dev = vdev_get(a);
+    if (!dev) continue;
+
+    while (dev->next_report_us <= frame_us) {
+      if (dev->streaming) {
+        if (dev->pending) dev->lost++;
+        device_generate(dev);
+        dev->pending = true;
+        dev->generated++;
+      }
+      dev->next_report_us += dev->report_us;
+    }
+
+    if (dev->ctrl_pending && frame_us >= dev->ctrl_busy_until) {
+      dev->ctrl_pending = false;
+      dev->ctrl_done = true;
+    }
+    if (dev->bulk_pending && frame_us >= dev->bulk_busy_until) {
+      dev->bulk_pending = false;
+      dev->bulk_done = true;
+    }
+
+    if (!dev->armed || dev->complete || frame % dev->poll_ms) continue;
+
+    if (dev->reply_count) {
+      dev->xfer_len = dev->reply_lens[0];
+      memcpy(dev->xfer_buf, dev->replies[0], dev->xfer_len);
+      dev->reply_count--;
+      memmove(dev->replies[0], dev->replies[1], (size_t)dev->reply_count * REPORT_MAX);
+      memmove(dev->reply_lens, dev->reply_lens + 1, dev->reply_count);
+    } else if (dev->pending) {
+      dev->xfer_len = dev->pending_len;
+      memcpy(dev->xfer_buf, dev->pending_buf, dev->xfer_len);
+      dev->pending = false;
+    } else {
+      continue;  // NAK
+    }
+    dev->armed = false;
+    dev->complete = true;
+  }
+}
+
+// Move the clock, running every frame boundary that passes
+static void clock_advance(uint64_t to_us)
+{
+  while (next_frame_us <= to_us) {
+    now_us = next_frame_us;
+    hw_frame(next_frame_us);
+    next_frame_us += FRAME_US;
+  }
+  if (to_us > now_us) now_us = to_us;
+}
+
+uint64_t time_us_64(void)
+{
+  return now_us;
+}
+
+void sleep_us(uint64_t us)
+{
+  clock_advance(now_us + us);
+}
+
+// Configuration descriptor: the HID interface, plus a vendor interface 1 with
+// a bulk OUT endpoint for models that take commands there
+static uint16_t vdev_config(const vdev_t* dev, uint8_t* buf)
+{
+  const profile_t* pr = dev->profile;
+  struct TU_ATTR_PACKED {
+    tusb_desc_configuration_t cfg;
+    tusb_desc_interface_t itf;
+    tusb_desc_endpoint_t ep;
+    tusb_desc_interface_t bulk_itf;
+    tusb_desc_endpoint_t bulk_ep;
+  } cd = {
+    .cfg = { sizeof(cd.cfg), TUSB_DESC_CONFIGURATION, 0, 1, 1, 0, 0x80, 50 },
+    .itf = { sizeof(cd.itf), TUSB_DESC_INTERFACE, 0, 0, 1, 3, 0, pr->protocol, 0 },
+    .ep = { .bLength = sizeof(cd.ep), .bDescriptorType = TUSB_DESC_ENDPOINT,
+            .bEndpointAddress = 0x81, .wMaxPacketSize = REPORT_MAX, .bInterval = pr->interval_ms },
+    .bulk_itf = { sizeof(cd.bulk_itf), TUSB_DESC_INTERFACE, 1, 0, 1, 0xFF, 0, 0, 0 },
+    .bulk_ep = { .bLength = sizeof(cd.bulk_ep), .bDescriptorType = TUSB_DESC_ENDPOINT,
+                 .bEndpointAddress = 0x02, .wMaxPacketSize = 64 },
+  };
+  cd.ep.bmAttributes.xfer = TUSB_XFER_INTERRUPT;
+  cd.bulk_ep.bmAttributes.xfer = TUSB_XFER_BULK;
+  if (pr->bulk) {
+    cd.cfg.bNumInterfaces = 2;
+    cd.cfg.wTotalLength = sizeof(cd);
+  } else {
+    cd.cfg.wTotalLength = sizeof(cd) - sizeof(cd.bulk_itf) - sizeof(cd.bulk_ep);
+  }
+  memcpy(buf, &cd, cd.cfg.wTotalLength);
+  return cd.cfg.wTotalLength;
+}
+
+// ============================================================================
+// TINYUSB HOST API
+// ============================================================================
+
+bool tuh_mounted(uint8_t daddr)
+{
+  return vdev_get(daddr) != NULL;
+}
+
+bool tuh_vid_pid_get(uint8_t daddr, uint16_t* vid, uint16_t* pid)
+{
+  vdev_t* dev = vdev_get(daddr);
+  *vid = dev ? dev->profile->vid : 0;
+  *pid = dev ? dev->profile->pid : 0;
+  return dev != NULL;
+}
+
+uint8_t tuh_hid_interface_protocol(uint8_t dev_addr, uint8_t idx)
+{
+  vdev_t* dev = vdev_get(dev_addr);
+  return (dev && idx == 0) ? dev->profile->protocol : HID_ITF_PROTOCOL_NONE;
+}
+
+bool tuh_hid_itf_get_info(uint8_t daddr, uint8_t idx, tuh_itf_info_t* itf_info)
+{
+  vdev_t* dev = vdev_get(daddr);
+  if (!dev || idx != 0) return false;
+  memset(itf_info, 0, sizeof(*itf_info));
+  itf_info->daddr = daddr;
+  itf_info->ep_in = 0x81;
+  itf_info->ep_out = 0x02;
+  itf_info->desc.bLength = sizeof(tusb_desc_interface_t);
+  itf_info->desc.bDescriptorType = TUSB_DESC_INTERFACE;
+  itf_info->desc.bNumEndpoints = 2;
+  itf_info->desc.bInterfaceClass = 3;
+  itf_info->desc.bInterfaceProtocol = dev->profile->protocol;
+  return true;
+}
+
+bool tuh_hid_receive_report(uint8_t dev_addr, uint8_t idx)
+{
+  vdev_t* dev = vdev_get(dev_addr);
+  if (!dev || idx != 0) return false;
+  if (dev->armed || dev->complete) {
+    dev->rearm_busy++;
+    return false;
+  }
+  dev->armed = true;
+  return true;
+}
+
+bool tuh_hid_send_ready(uint8_t dev_addr, uint8_t idx)
+{
+  vdev_t* dev = vdev_get(dev_addr);
+  return dev && idx == 0 && now_us >= dev->out_busy_until;
+}
+
+bool tuh_hid_send_report(uint8_t dev_addr, uint8_t idx, uint8_t report_id, void const* report, uint16_t len)
+{
+  vdev_t* dev = vdev_get(dev_addr);
+  if (!dev || idx != 0) return false;
+  if (now_us < dev->out_busy_until) {
+    dev->send_busy++;
+    return false;
+  }
+  dev->out_busy_until = now_us + OUT_BUSY_US;
+  dev->sends++;
+  if (dev->profile->respond) dev->profile->respond(dev, report_id, report, len);
+  return true;
+}
+
+static bool control_start(uint8_t dev_addr, uint8_t idx, uint8_t report_id, uint8_t report_type,
+                          uint16_t len, bool is_get)
+{
+  vdev_t* dev = vdev_get(dev_addr);
+  if (!dev || idx != 0 || dev->ctrl_pending || dev->ctrl_done) return false;
+  dev->ctrl_pending = true;
+  dev->ctrl_is_desc = false;
+  dev->ctrl_is_get = is_get;
+  dev->ctrl_report_id = report_id;
+  dev->ctrl_report_type = report_type;
+  dev->ctrl_len = len;
+  dev->ctrl_busy_until = now_us + CTRL_BUSY_US;
+  dev->controls++;
+  return true;
+}
+
+bool tuh_hid_set_report(uint8_t dev_addr, uint8_t idx, uint8_t report_id, uint8_t report_type,
+                        void* report, uint16_t len)
+{
+  (void)report;
+  return control_start(dev_addr, idx, report_id, report_type, len, false);
+}
+
+bool tuh_hid_get_report(uint8_t dev_addr, uint8_t idx, uint8_t report_id, uint8_t report_type,
+                        void* report, uint16_t len)
+{
+  memset(report, 0, len);
+  return control_start(dev_addr, idx, report_id, report_type, len, true);
+}
+
+// Raw endpoints: only the bulk OUT endpoint of interface 1 on models that have one
+bool tuh_edpt_open(uint8_t daddr, tusb_desc_endpoint_t const* desc_ep)
+{
+  vdev_t* dev = vdev_get(daddr);
+  return dev && dev->profile->bulk && desc_ep->bEndpointAddress == 0x02;
+}
+
+// One transfer in flight per endpoint, like usbh_edpt_claim()
+bool tuh_edpt_xfer(tuh_xfer_t* xfer)
+{
+  vdev_t* dev = vdev_get(xfer->daddr);
+  if (!dev || !dev->profile->bulk || xfer->ep_addr != 0x02) return false;
+  if (dev->bulk_pending || dev->bulk_done) return false;
+  dev->bulk_xfer = *xfer;
+  dev->bulk_pending = true;
+  dev->bulk_busy_until = now_us + BULK_BUSY_US;
+  dev->sends++;
+  dev->profile->bulk(dev, xfer->buffer, (uint16_t)xfer->buflen);
+  return true;
+}
+
+// Shares the device's control pipe with SET/GET_REPORT
+bool tuh_descriptor_get_configuration(uint8_t daddr, uint8_t index, void* buffer, uint16_t len,
+                                      tuh_xfer_cb_t complete_cb, uintptr_t user_data)
+{
+  vdev_t* dev = vdev_get(daddr);
+  if (!dev || index != 0 || dev->ctrl_pending || dev->ctrl_done) return false;
+  dev->ctrl_pending = true;
+  dev->ctrl_is_desc = true;
+  dev->ctrl_xfer = (tuh_xfer_t) {
+    .daddr = daddr, .buffer = buffer, .buflen = len,
+    .complete_cb = complete_cb, .user_data = user_data,
+  };
+  dev->ctrl_busy_until = now_us + CTRL_BUSY_US;
+  dev->controls++;
+  return true;
+}
+
+// Same walk as TinyUSB: one entry per top-level collection or report ID
+uint8_t tuh_hid_parse_report_descriptor(tuh_hid_report_info_t* report_info_arr, uint8_t arr_count,
+                                        uint8_t const* desc_report, uint16_t desc_len)
+{
+  if (!arr_count || !desc_report) return 0;
+  memset(report_info_arr, 0, arr_count * sizeof(tuh_hid_report_info_t));
+
+  tuh_hid_report_info_t* info = report_info_arr;
+  uint8_t report_num = 0;
+  uint8_t depth = 0;
+
+  while (desc_len && report_num < arr_count) {
+    uint8_t header = *desc_report;
+    uint8_t size = header & 0x03;
+    if (size == 3) size = 4;
+    uint8_t type = (header >> 2) & 0x03;
+    uint8_t tag = header >> 4;
+    if (desc_len < 1u + size) break;
+    uint32_t data = 0;
+    for (uint8_t i = 0; i < size; i++) data |= (uint32_t)desc_report[1 + i] << (8 * i);
+
+    if (type == 0) {                              // Main
+      if (tag == 0x0A) depth++;                    // Collection
+      else if (tag == 0x0C && depth && --depth == 0) {
+        info++;
+        report_num++;
+      }
+    } else if (type == 1) {                       // Global
+      if (tag == 0x08) {                           // Report ID
+        if (info->report_id > 0 && report_num + 1 < arr_count) {
+          info[1].usage = info->usage;
+          info[1].usage_page = info->usage_page;
+          info++;
+          report_num++;
+        }
+        info->report_id = (uint8_t)data;
+      } else if (tag == 0x00 && depth == 0) {      // Usage Page
+        info->usage_page = (uint16_t)data;
+      }
+    } else if (type == 2 && tag == 0x00 && depth == 0) {  // Local Usage
+      info->usage = (uint8_t)data;
+    }
+
+    desc_report += 1 + size;
+    desc_len -= 1 + size;
+  }
+  return report_num;
+}
+
+// ============================================================================
+// FIRMWARE SERVICES OUTSIDE THE HOST PATH
+// ============================================================================
+
+const OutputInterface* active_output = NULL;
+
+uint8_t codes_get_test_counter(void) { return 0; }
+void profile_indicator_init(void) {}
+void profile_indicator_task(void) {}
+bool profile_indicator_is_active(void) { return false; }
+bool profile_indicator_is_active_for_player(uint8_t player_index) { (void)player_index; return false; }
+int8_t profile_indicator_get_display_player_index(int8_t actual_player_index) { return actual_player_index; }
+
+static void router_tap(output_target_t output, uint8_t player_index, const input_event_t* event)
+{
+  (void)output;
+  (void)player_index;
+  vdev_t* dev = (event->dev_addr <= MAX_VDEVS) ? &vdevs[event->dev_addr] : NULL;
+  if (dev) dev->events++;
+}
+
+// ============================================================================
+// MOUNT / UNMOUNT
+// ============================================================================
+
+// Enumeration: the override table may rewrite bInterval before the class opens
+static void vdev_mount(vdev_t* dev)
+{
+  const profile_t* pr = dev->profile;
+
+  tusb_desc_device_t dd = {
+    .bLength = sizeof(dd), .bDescriptorType = TUSB_DESC_DEVICE,
+    .idVendor = pr->vid, .idProduct = pr->pid,
+  };
+  uint8_t cd[CONFIG_MAX];
+  vdev_config(dev, cd);
+
+  tuh_enum_descriptor_device_cb(dev->dev_addr, &dd);
+  tuh_enum_descriptor_configuration_cb(dev->dev_addr, 0, (tusb_desc_configuration_t*)cd);
+
+  // The HID endpoint follows the configuration and interface descriptors
+  const tusb_desc_endpoint_t* ep = (const tusb_desc_endpoint_t*)
+      (cd + sizeof(tusb_desc_configuration_t) + sizeof(tusb_desc_interface_t));
+  dev->poll_ms = ep->bInterval ? ep->bInterval : 1;
+  dev->mounted = true;
+  dev->streaming = !pr->needs_init;
+  dev->armed = dev->complete = dev->pending = false;
+  dev->reply_count = 0;
+  dev->out_busy_until = dev->ctrl_busy_until = 0;
+  dev->ctrl_pending = dev->ctrl_done = false;
+  dev->bulk_pending = dev->bulk_done = false;
+  dev->mount_us = now_us;
+  dev->ready_us = 0;
+  dev->next_report_us = now_us + dev->report_us;
+  memcpy(dev->state, pr->idle ? pr->idle : pr->reports[0], pr->idle ? pr->len : pr->report_lens[0]);
+
+  tuh_hid_mount_cb(dev->dev_addr, 0, pr->desc, pr->desc_len);
+}
+
+static void vdev_unmount(vdev_t* dev)
+{
+  tuh_hid_umount_cb(dev->dev_addr, 0);
+  remove_players_by_address(dev->dev_addr, 0);
+  dev->mounted = false;
+}
+
+// ============================================================================
+// MAIN LOOP
+// ============================================================================
+
+static double wall_ns(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static uint64_t task_ns = 0;
+static uint32_t task_passes = 0;
+
+// tuh_task() then the app tasks, as on the device
+static void loop_pass(void)
+{
+  for (uint8_t a = 1; a <= MAX_VDEVS; a++) {
+    vdev_t* dev = vdev_get(a);
+    if (!dev) continue;
+
+    if (dev->complete) {
+      dev->complete = false;
+      dev->delivered++;
+      if (!dev->profile->needs_init && !dev->ready_us) dev->ready_us = now_us;
+      double t0 = wall_ns();
+      tuh_hid_report_received_cb(a, 0, dev->xfer_buf, dev->xfer_len);
+      dev->cb_ns += (uint64_t)(wall_ns() - t0);
+    }
+
+    if (dev->bulk_done) {
+      dev->bulk_done = false;
+      dev->bulk_xfer.result = XFER_RESULT_SUCCESS;
+      dev->bulk_xfer.actual_len = dev->bulk_xfer.buflen;
+      if (dev->bulk_xfer.complete_cb) dev->bulk_xfer.complete_cb(&dev->bulk_xfer);
+    }
+
+    if (!dev->ctrl_done) continue;
+    dev->ctrl_done = false;
+    if (dev->ctrl_is_desc) {
+      uint8_t cd[CONFIG_MAX];
+      uint16_t len = vdev_config(dev, cd);
+      tuh_xfer_t* xfer = &dev->ctrl_xfer;
+      xfer->actual_len = len < xfer->buflen ? len : xfer->buflen;
+      memcpy(xfer->buffer, cd, xfer->actual_len);
+      xfer->result = XFER_RESULT_SUCCESS;
+      xfer->complete_cb(xfer);
+    } else if (dev->ctrl_is_get) {
+      tuh_hid_get_report_complete_cb(a, 0, dev->ctrl_report_id, dev->ctrl_report_type, dev->ctrl_len);
+    } else {
+      tuh_hid_set_report_complete_cb(a, 0, dev->ctrl_report_id, dev->ctrl_report_type, dev->ctrl_len);
+    }
+  }
+
+  double t0 = wall_ns();
+  hid_task();
+  task_ns += (uint64_t)(wall_ns() - t0);
+  task_passes++;
+}
+
+// Games change rumble and player LEDs far more often than pads need it
+static void feedback_churn(uint32_t step)
+{
+  for (uint8_t a = 1; a <= MAX_VDEVS; a++) {
+    vdev_t* dev = vdev_get(a);
+    if (!dev) continue;
+    int player = find_player_index(a, 0);
+    if (player < 0) continue;
+    uint8_t level = (step & 1) ? (uint8_t)(64 + (rnd() & 0x7F)) : 0;
+    feedback_set_rumble(player, level, level / 2);
+    if ((step & 7) == 0) feedback_set_led_player(player, (uint8_t)(player + 1));
+  }
+}
+
+static void usage(const char* argv0)
+{
+  fprintf(stderr,
+    "usage: %s [-d devices] [-m model,...] [-t seconds] [-r rate%%]\n"
+    "          [-s every_ms:stall_ms] [-c churn_ms] [-f feedback_ms] [-v] [capture...]\n"
+    "  -d  virtual devices, up to %d (default: one per model, captures first)\n"
+    "  -m  built-in models by name prefix, repeated to fill -d (dualshock,\n"
+    "      dualsense,switch,switch2,gamecube,dragonrise,keyboard,mouse)\n"
+    "  -t  simulated seconds (default 10)\n"
+    "  -r  device report rate in percent of the model's rate (default 100)\n"
+    "  -s  stall the main loop for stall_ms every every_ms\n"
+    "  -c  unplug and replug one device every churn_ms\n"
+    "  -f  change rumble/LEDs every feedback_ms, 0 = never (default 50)\n"
+    "  -v  keep firmware logging\n", argv0, MAX_VDEVS);
+}
+
+int main(int argc, char** argv)
+{
+  int want_devices = -1;
+  const char* models = NULL;
+  double seconds = 10;
+  unsigned rate_pct = 100;
+  unsigned stall_every = 0, stall_ms = 0;
+  unsigned churn_ms = 0;
+  unsigned feedback_ms = 50;
+
+  int opt;
+  while ((opt = getopt(argc, argv, "d:m:t:r:s:c:f:vh")) != -1) {
+    switch (opt) {
+      case 'd': want_devices = atoi(optarg); break;
+      case 'm': models = optarg; break;
+      case 't': seconds = atof(optarg); break;
+      case 'r': rate_pct = (unsigned)atoi(optarg); break;
+      case 's': sscanf(optarg, "%u:%u", &stall_every, &stall_ms); break;
+      case 'c': churn_ms = (unsigned)atoi(optarg); break;
+      case 'f': feedback_ms = (unsigned)atoi(optarg); break;
+      case 'v': verbose = true; break;
+      default: usage(argv[0]); return 2;
+    }
+  }
+  for (int i = optind; i < argc; i++) {
+    if (!load_capture(argv[i])) return 1;
+  }
+  if (rate_pct == 0) rate_pct = 1;
+
+  // Captures first, then the built-in models, one device per address
+  const profile_t* pool[CAPTURE_MAX + BUILTIN_COUNT];
+  int pool_count = 0;
+  for (int i = 0; i < capture_count; i++) pool[pool_count++] = &capture_profiles[i];
+  if (models) {
+    char list[256];
+    snprintf(list, sizeof(list), "%s", models);
+    for (char* tok = strtok(list, ","); tok && pool_count < (int)TU_ARRAY_SIZE(pool); tok = strtok(NULL, ",")) {
+      size_t i = 0;
+      while (i < BUILTIN_COUNT && strncasecmp(builtin_profiles[i].name, tok, strlen(tok)) != 0) i++;
+      if (i == BUILTIN_COUNT) {
+        fprintf(stderr, "unknown model '%s'\n", tok);
+        return 2;
+      }
+      pool[pool_count++] = &builtin_profiles[i];
+    }
+  } else {
+    for (size_t i = 0; i < BUILTIN_COUNT; i++) pool[pool_count++] = &builtin_profiles[i];
+  }
+  if (!pool_count) return 2;
+  vdev_count = want_devices < 0 ? pool_count : want_devices;
+  if (vdev_count > MAX_VDEVS) vdev_count = MAX_VDEVS;
+
+  // Firmware logging goes to stdout; the results go to stderr
+  if (!verbose) {
+    fflush(stdout);
+    if (!freopen("/dev/null", "w", stdout)) return 1;
+  }
+
+  router_config_t router_cfg = {
+    .mode = ROUTING_MODE_SIMPLE,
+    .max_players_per_output = { [OUTPUT_TARGET_USB_DEVICE] = MAX_PLAYERS_PER_OUTPUT },
+  };
+  router_init(&router_cfg);
+  router_add_route(INPUT_SOURCE_USB_HOST, OUTPUT_TARGET_USB_DEVICE, 0);
+  router_set_tap(OUTPUT_TARGET_USB_DEVICE, router_tap);
+  player_config_t player_cfg = {
+    .slot_mode = PLAYER_SLOT_FIXED,
+    .max_slots = MAX_PLAYERS_PER_OUTPUT,
+    .auto_assign_on_press = true,
+  };
+  players_init_with_config(&player_cfg);
+  hid_init();
+
+  // Devices enumerate one at a time, one frame apart
+  for (int i = 0; i < vdev_count; i++) {
+    vdev_t* dev = &vdevs[i + 1];
+    memset(dev, 0, sizeof(*dev));
+    dev->profile = pool[i % pool_count];
+    dev->dev_addr = (uint8_t)(i + 1);
+    dev->report_us = dev->profile->report_us * 100u / rate_pct;
+    if (dev->report_us < 125) dev->report_us = 125;
+    clock_advance(next_frame_us);
+    vdev_mount(dev);
+  }
+
+  uint64_t end_us = now_us + (uint64_t)(seconds * 1e6);
+  uint64_t next_stall = stall_every ? now_us + stall_every * 1000ull : UINT64_MAX;
+  uint64_t next_churn = churn_ms ? now_us + churn_ms * 1000ull : UINT64_MAX;
+  uint64_t next_feedback = feedback_ms ? now_us + feedback_ms * 1000ull : UINT64_MAX;
+  uint32_t feedback_step = 0;
+  int churn_next = 1;
+  uint32_t churns = 0;
+  double wall_start = wall_ns();
+
+  while (now_us < end_us) {
+    clock_advance(next_frame_us);
+
+    if (now_us >= next_stall) {
+      clock_advance(now_us + stall_ms * 1000ull);
+      next_stall += stall_every * 1000ull;
+    }
+    if (now_us >= next_churn && vdev_count) {
+      vdev_t* dev = &vdevs[churn_next];
+      if (dev->mounted) {
+        vdev_unmount(dev);
+        dev->replug_us = now_us + REPLUG_US;
+        churns++;
+      }
+      churn_next = churn_next % vdev_count + 1;
+      next_churn += churn_ms * 1000ull;
+    }
+    for (int i = 1; i <= vdev_count; i++) {
+      if (vdevs[i].replug_us && now_us >= vdevs[i].replug_us) {
+        vdevs[i].replug_us = 0;
+        vdev_mount(&vdevs[i]);
+      }
+    }
+    if (now_us >= next_feedback) {
+      feedback_churn(feedback_step++);
+      next_feedback += feedback_ms * 1000ull;
+    }
+
+    loop_pass();
+  }
+  double wall = wall_ns() - wall_start;
+
+  fflush(stdout);
+
+  // ==========================================================================
+  // REPORT
+  // ==========================================================================
+
+  fprintf(stderr, "%.1f s simulated, %d devices, rate %u%%, feedback every %u ms",
+          seconds, vdev_count, rate_pct, feedback_ms);
+  if (stall_every) fprintf(stderr, ", %u ms stall every %u ms", stall_ms, stall_every);
+  if (churn_ms) fprintf(stderr, ", replug every %u ms (%u)", churn_ms, churns);
+  fprintf(stderr, "\n\n");
+
+  fprintf(stderr, "%-2s %-18s %4s %8s %8s %7s %6s %8s %7s %6s %7s %6s %6s\n",
+          "#", "device", "poll", "gen", "dlv", "lost", "lost%", "ns/rpt", "out", "busy", "events", "rearm",
+          "ready");
+
+  uint64_t total_gen = 0, total_dlv = 0, total_lost = 0, total_ns = 0, total_out = 0;
+  uint64_t first_mount_us = UINT64_MAX, first_ready_us = UINT64_MAX, last_ready_us = 0;
+  int ready_count = 0;
+  for (int i = 1; i <= vdev_count; i++) {
+    vdev_t* dev = &vdevs[i];
+    total_gen += dev->generated;
+    total_dlv += dev->delivered;
+    total_lost += dev->lost;
+    total_ns += dev->cb_ns;
+    total_out += dev->sends;
+    if (dev->mount_us < first_mount_us) first_mount_us = dev->mount_us;
+    char ready[24] = "-";
+    if (dev->ready_us) {
+      snprintf(ready, sizeof(ready), "%llums", (unsigned long long)((dev->ready_us - dev->mount_us) / 1000));
+      if (dev->ready_us < first_ready_us) first_ready_us = dev->ready_us;
+      if (dev->ready_us > last_ready_us) last_ready_us = dev->ready_us;
+      ready_count++;
+    }
+    fprintf(stderr, "%-2d %-18.18s %3ums %8u %8u %7u %5.1f%% %8.0f %7u %6u %7u %6u %6s\n",
+            i, dev->profile->name, dev->poll_ms, dev->generated, dev->delivered, dev->lost,
+            dev->generated ? 100.0 * dev->lost / dev->generated : 0.0,
+            dev->delivered ? (double)dev->cb_ns / dev->delivered : 0.0,
+            dev->sends, dev->send_busy, dev->events, dev->rearm_busy, ready);
+  }
+
+  fprintf(stderr, "\ntotal: %llu reports delivered (%.0f/s simulated), %llu lost (%.2f%%), %llu output reports\n",
+          (unsigned long long)total_dlv, total_dlv / seconds, (unsigned long long)total_lost,
+          total_gen ? 100.0 * total_lost / total_gen : 0.0, (unsigned long long)total_out);
+  if (ready_count) {
+    fprintf(stderr, "ready: %d of %d devices, first %llu ms, all %llu ms after the first mount\n",
+            ready_count, vdev_count,
+            (unsigned long long)((first_ready_us - first_mount_us) / 1000),
+            (unsigned long long)((last_ready_us - first_mount_us) / 1000));
+  }
+  fprintf(stderr, "host cpu: %.0f ns/report in callbacks, %.0f ns per hid_task pass, %.0f reports/s wall\n",
+          total_dlv ? (double)total_ns / total_dlv : 0.0,
+          task_passes ? (double)task_ns / task_passes : 0.0,
+          wall > 0 ? total_dlv / (wall / 1e9) : 0.0);
+  fprintf(stderr, "metrics: hid.reports %u, deduped %u, router.events %u, unassigned %u, feedback.sends %u, mounts %u\n",
+          metrics_scalars[METRIC_USB_HID_REPORTS], metrics_scalars[METRIC_USB_HID_REPORTS_DEDUPED],
+          metrics_scalars[METRIC_ROUTER_EVENTS], metrics_scalars[METRIC_ROUTER_UNASSIGNED],
+          metrics_scalars[METRIC_USB_FEEDBACK_SENDS], metrics_scalars[METRIC_USB_HID_MOUNTS]);
+  return 0;
+}
@@ -0,0 +1,199 @@
+// xinput_decode_bench.c - Host benchmark for the fixed-offset XInput decoder
+//
+// Builds a report stream shaped like an Xbox 360 wireless receiver with
+// four pads (29-byte frames, gamepad block at offset 6, pads interleaved)
+// with sticks sweeping and buttons toggling as in play. Both paths start
+// the way the firmware does, by copying the frame's block into a pad like
+// tusb_xinput fills xid_itf->pad, then decode that pad:
+//   branch - the per-button branch chain and int16 scaling xinput.c used
+//   table  - xinput_decode_pad() on the pad, as xinput.c does now
+// Every frame is checked for identical buttons and axes before timing.
+//
+// Build and run from the repo root:
+//   gcc -O2 -Isrc -Isrc/usb/usbh/xinput -o /tmp/xinput_decode_bench
+//       tools/xinput_decode_bench.c
+//   /tmp/xinput_decode_bench [iterations]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "core/buttons.h"
+#include "xinput_decode.h"
+
+// wButtons bits (XInput; SHARE is tusb_xinput's Series X|S extension)
+#define XI_DPAD_UP    0x0001
+#define XI_DPAD_DOWN  0x0002
+#define XI_DPAD_LEFT  0x0004
+#define XI_DPAD_RIGHT 0x0008
+#define XI_START      0x0010
+#define XI_BACK       0x0020
+#define XI_LTHUMB     0x0040
+#define XI_RTHUMB     0x0080
+#define XI_LB         0x0100
+#define XI_RB         0x0200
+#define XI_GUIDE      0x0400
+#define XI_SHARE      0x0800
+#define XI_A          0x1000
+#define XI_B          0x2000
+#define XI_X          0x4000
+#define XI_Y          0x8000
+
+typedef struct {
+  uint16_t wButtons;
+  uint8_t bLeftTrigger;
+  uint8_t bRightTrigger;
+  int16_t sThumbLX;
+  int16_t sThumbLY;
+  int16_t sThumbRX;
+  int16_t sThumbRY;
+} pad_t;
+
+#define FRAME_LEN   29
+#define PAD_OFFSET  6
+#define PADS        4
+#define FRAMES      4096
+
+// ============================================================================
+// DECODERS
+// ============================================================================
+
+static uint8_t scale(int16_t v)
+{
+  uint8_t s = (v + 32768) / 256;
+  return s ? s : 1;
+}
+
+static uint32_t branch_decode(const uint8_t* frame, uint8_t analog[6])
+{
+  pad_t pad;
+  memcpy(&pad, frame + PAD_OFFSET, sizeof(pad));
+  const pad_t* p = &pad;
+
+  analog[0] = scale(p->sThumbLX);
+  analog[1] = 256 - scale(p->sThumbLY);
+  analog[2] = scale(p->sThumbRX);
+  analog[3] = 256 - scale(p->sThumbRY);
+  analog[4] = p->bLeftTrigger;
+  analog[5] = p->bRightTrigger;
+
+  return ((p->wButtons & XI_DPAD_UP)    ? JP_BUTTON_DU : 0) |
+         ((p->wButtons & XI_DPAD_DOWN)  ? JP_BUTTON_DD : 0) |
+         ((p->wButtons & XI_DPAD_LEFT)  ? JP_BUTTON_DL : 0) |
+         ((p->wButtons & XI_DPAD_RIGHT) ? JP_BUTTON_DR : 0) |
+         ((p->wButtons & XI_A)          ? JP_BUTTON_B1 : 0) |
+         ((p->wButtons & XI_B)          ? JP_BUTTON_B2 : 0) |
+         ((p->wButtons & XI_X)          ? JP_BUTTON_B3 : 0) |
+         ((p->wButtons & XI_Y)          ? JP_BUTTON_B4 : 0) |
+         ((p->wButtons & XI_LB)         ? JP_BUTTON_L1 : 0) |
+         ((p->wButtons & XI_RB)         ? JP_BUTTON_R1 : 0) |
+         ((p->wButtons & XI_BACK)       ? JP_BUTTON_S1 : 0) |
+         ((p->wButtons & XI_START)      ? JP_BUTTON_S2 : 0) |
+         ((p->wButtons & XI_LTHUMB)     ? JP_BUTTON_L3 : 0) |
+         ((p->wButtons & XI_RTHUMB)     ? JP_BUTTON_R3 : 0) |
+         ((p->wButtons & XI_GUIDE)      ? JP_BUTTON_A1 : 0) |
+         ((p->wButtons & XI_SHARE)      ? JP_BUTTON_A2 : 0);
+}
+
+// Same table as xinput.c
+static const xinput_decoder_t decoder = {{
+  XINPUT_NIBBLE(JP_BUTTON_DU, JP_BUTTON_DD, JP_BUTTON_DL, JP_BUTTON_DR),
+  XINPUT_NIBBLE(JP_BUTTON_S2, JP_BUTTON_S1, JP_BUTTON_L3, JP_BUTTON_R3),
+  XINPUT_NIBBLE(JP_BUTTON_L1, JP_BUTTON_R1, JP_BUTTON_A1, JP_BUTTON_A2),
+  XINPUT_NIBBLE(JP_BUTTON_B1, JP_BUTTON_B2, JP_BUTTON_B3, JP_BUTTON_B4),
+}};
+
+static uint32_t table_decode(const uint8_t* frame, uint8_t analog[6])
+{
+  pad_t pad;
+  memcpy(&pad, frame + PAD_OFFSET, sizeof(pad));
+  return xinput_decode_pad(&decoder, (const uint8_t*)&pad, analog);
+}
+
+// ============================================================================
+// STREAM
+// ============================================================================
+
+static void put16(uint8_t* p, int16_t v)
+{
+  p[0] = (uint16_t)v & 0xFF;
+  p[1] = (uint16_t)v >> 8;
+}
+
+// Receiver frames round-robin over the pads; each pad sweeps its sticks,
+// rolls its triggers and holds buttons for a few frames at a time
+static void build_stream(uint8_t frames[FRAMES][FRAME_LEN])
+{
+  uint16_t held[PADS] = {0};
+
+  for (int f = 0; f < FRAMES; f++) {
+    int pad = f % PADS;
+    int t = f / PADS;
+    uint8_t* fr = frames[f];
+
+    memset(fr, 0, FRAME_LEN);
+    fr[1] = 0x01;   // Pad data
+    fr[3] = 0xF0;
+    fr[5] = 0x13;
+
+    if (t % 8 == 0) held[pad] = rand() & rand();
+    uint8_t* p = fr + PAD_OFFSET;
+    put16(p, held[pad]);
+    p[2] = (t * 3 + pad * 40) & 0xFF;
+    p[3] = (t % 64 < 32) ? 0 : 255;
+    put16(p + 4, (int16_t)(t * 517 + pad * 9000));
+    put16(p + 6, (int16_t)(-t * 311));
+    put16(p + 8, (f % 97 == 0) ? -32768 : (int16_t)(rand() - RAND_MAX / 2));
+    put16(p + 10, (f % 89 == 0) ? 32767 : (int16_t)(t * 1021));
+  }
+}
+
+// ============================================================================
+// MAIN
+// ============================================================================
+
+static double now_ns(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+int main(int argc, char** argv)
+{
+  long iterations = argc > 1 ? atol(argv[1]) : 10000000;
+  volatile uint32_t sink = 0;
+
+  static uint8_t frames[FRAMES][FRAME_LEN];
+  build_stream(frames);
+
+  // Equivalence
+  for (int f = 0; f < FRAMES; f++) {
+    uint8_t a[6], b[6];
+    uint32_t ba = branch_decode(frames[f], a);
+    uint32_t bb = table_decode(frames[f], b);
+    if (ba != bb || memcmp(a, b, sizeof(a)) != 0) {
+      printf("MISMATCH on frame %d\n", f);
+      return 1;
+    }
+  }
+
+  uint8_t analog[6];
+  double t0 = now_ns();
+  for (long i = 0; i < iterations; i++) {
+    sink += branch_decode(frames[i % FRAMES], analog);
+    sink += analog[i % 6];
+  }
+  double t1 = now_ns();
+  for (long i = 0; i < iterations; i++) {
+    sink += table_decode(frames[i % FRAMES], analog);
+    sink += analog[i % 6];
+  }
+  double t2 = now_ns();
+
+  double branch = (t1 - t0) / iterations;
+  double table = (t2 - t1) / iterations;
+  printf("%d frames, %d pads: branch %.2f ns, table %.2f ns (%.1fx)\n",
+         FRAMES, PADS, branch, table, branch / table);
+  return 0;
+}